@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build-opt/scratch/subdir/ns3-dev-subdir-optimized', 'build-opt/scratch/ns3-dev-scratch-simulator-optimized']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
@@ -0,0 +1,6 @@
+#include <unistd.h>
+
+int main(int argc, char **argv) {
+	(void)argc; (void)argv;
+	return 0;
+}
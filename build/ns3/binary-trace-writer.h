@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_WRITER_H
+#define BINARY_TRACE_WRITER_H
+
+#include <ostream>
+#include <istream>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief Write the events of the default ascii trace sinks as fixed-size
+ *        binary records.
+ *
+ * Each event is stored as a 40-byte record holding the time, the node
+ * and device indices, the event type ('+', '-', 'd' or 'r'), the packet
+ * uid and size, and the identifier of the trace context. The first
+ * record which uses a context is preceded by a record defining the
+ * context string. When snapshots are enabled, each record is followed
+ * by the serialized packet (see Packet::Serialize), which allows
+ * ConvertToAscii to reproduce the ascii trace byte for byte.
+ *
+ * The records are written in the byte order of the host.
+ *
+ * \see AsciiTraceHelper::CreateBinaryFileStream
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  /**
+   * \param os the stream to write the records to. It must outlive
+   *        this writer.
+   * \param snapshots whether to store the serialized packet of each
+   *        event.
+   */
+  BinaryTraceWriter (std::ostream *os, bool snapshots);
+
+  /**
+   * \param event the ascii event type: '+', '-', 'd' or 'r'.
+   * \param context the trace context, empty if the sink does not
+   *        receive a context.
+   * \param p the packet traced.
+   */
+  void Write (char event, std::string const &context, Ptr<const Packet> p);
+
+  /**
+   * \param in the binary trace to read.
+   * \param out the stream to write the ascii trace to.
+   * \returns false if the input is not a binary trace or is truncated.
+   *
+   * The events recorded with a snapshot are printed exactly as the
+   * default sinks of AsciiTraceHelper print them: the header types of
+   * the packets must be registered in the program which converts the
+   * trace. The events recorded without a snapshot are printed with the
+   * uid and the size of their packet in place of the packet contents.
+   */
+  static bool ConvertToAscii (std::istream &in, std::ostream &out);
+
+private:
+  struct Context
+  {
+    uint32_t id;
+    uint32_t node;
+    uint32_t device;
+  };
+
+  Context const &LookupContext (std::string const &context);
+
+  std::ostream *m_os;
+  bool m_snapshots;
+  std::map<std::string, struct Context> m_contexts;
+  // the last context used, to avoid a lookup per event.
+  std::map<std::string, struct Context>::const_iterator m_last;
+  std::vector<uint32_t> m_snapshot;
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_WRITER_H */
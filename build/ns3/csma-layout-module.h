@@ -0,0 +1,11 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_CSMA_LAYOUT
+    
+
+// Module headers:
+#include "csma-star-helper.h"
+#endif
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef IPV4_END_POINT_DEMUX_H
+#define IPV4_END_POINT_DEMUX_H
+
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <vector>
+#include "ns3/ipv4-address.h"
+#include "ns3/hash.h"
+#include "ipv4-interface.h"
+#include "end-point-hash-table.h"
+
+namespace ns3 {
+
+class Ipv4EndPoint;
+
+/**
+ * \brief Demultiplexes packets to various transport layer endpoints
+ *
+ * This class serves as a lookup table to match partial or full information
+ * about a four-tuple to an ns3::Ipv4EndPoint.  It internally contains a list
+ * of endpoints, and has APIs to add and find endpoints in this demux.  This
+ * code is shared in common to TCP and UDP protocols in ns3.  This demux
+ * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints whose four-tuple is fully specified (connections) are
+ * indexed by a hash table of their four-tuple, and the other endpoints
+ * (listeners and wildcard bindings) by a hash table of their local
+ * port, so that a lookup only examines the endpoints which may match.
+ * The endpoints tell their demux when their addresses or ports change,
+ * to be indexed again. Among several matching endpoints of the same
+ * precedence, the lookups return them in the order of their allocation.
+ */
+
+class Ipv4EndPointDemux {
+public:
+  typedef std::list<Ipv4EndPoint *> EndPoints;
+  typedef std::list<Ipv4EndPoint *>::iterator EndPointsI;
+
+  Ipv4EndPointDemux ();
+  ~Ipv4EndPointDemux ();
+
+  EndPoints GetAllEndPoints (void);
+  bool LookupPortLocal (uint16_t port);
+  bool LookupLocal (Ipv4Address addr, uint16_t port);
+  EndPoints Lookup (Ipv4Address daddr, 
+                    uint16_t dport, 
+                    Ipv4Address saddr, 
+                    uint16_t sport,
+                    Ptr<Ipv4Interface> incomingInterface);
+
+  Ipv4EndPoint *SimpleLookup (Ipv4Address daddr, 
+                              uint16_t dport, 
+                              Ipv4Address saddr, 
+                              uint16_t sport);
+
+  Ipv4EndPoint *Allocate (void);
+  Ipv4EndPoint *Allocate (Ipv4Address address);
+  Ipv4EndPoint *Allocate (uint16_t port);
+  Ipv4EndPoint *Allocate (Ipv4Address address, uint16_t port);
+  Ipv4EndPoint *Allocate (Ipv4Address localAddress, 
+                          uint16_t localPort,
+                          Ipv4Address peerAddress, 
+                          uint16_t peerPort);
+
+  void DeAllocate (Ipv4EndPoint *endPoint);
+
+private:
+  friend class Ipv4EndPoint;
+
+  uint16_t AllocateEphemeralPort (void);
+  /**
+   * Add a new endpoint to the demux.
+   */
+  void Add (Ipv4EndPoint *endPoint);
+  /**
+   * Add an endpoint to the hash tables, according to its current
+   * four-tuple.
+   */
+  void Index (Ipv4EndPoint *endPoint);
+  /**
+   * Remove an endpoint from the hash tables, before its four-tuple
+   * changes or it is deallocated.
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
+  /**
+   * \param localAddress the local address.
+   * \param localPort the local port.
+   * \param peerAddress the peer address.
+   * \param peerPort the peer port.
+   * eturns the endpoints which may have this four-tuple, in the
+   *          order of their allocation. They are the connections with
+   *          the same hash and all the other endpoints of the local port.
+   */
+  std::vector<Ipv4EndPoint *> const &GetCandidates (Ipv4Address localAddress, uint16_t localPort,
+                                                    Ipv4Address peerAddress, uint16_t peerPort);
+  /**
+   * eturns true if the four-tuple of the endpoint is fully specified.
+   */
+  static bool IsConnection (Ipv4EndPoint *endPoint);
+  /**
+   * eturns true if a was allocated before b.
+   */
+  static bool IsAllocatedBefore (Ipv4EndPoint *a, Ipv4EndPoint *b);
+  uint32_t GetHash (Ipv4Address localAddress, uint16_t localPort,
+                    Ipv4Address peerAddress, uint16_t peerPort);
+  uint32_t GetHash (uint16_t localPort);
+
+  uint16_t m_ephemeral;
+  uint16_t m_portLast;
+  uint16_t m_portFirst;
+  /// All the endpoints, by order of allocation.
+  std::map<uint64_t, Ipv4EndPoint *> m_endPoints;
+  uint64_t m_nAllocated;
+  /// The connections, by hash of their four-tuple.
+  EndPointHashTable<Ipv4EndPoint> m_connections;
+  /// The other endpoints, by hash of their local port.
+  EndPointHashTable<Ipv4EndPoint> m_listeners;
+  /// The number of endpoints bound to each local port.
+  std::map<uint16_t, uint32_t> m_nPortEndPoints;
+  /// The number of endpoints bound to each local address and port.
+  std::map<std::pair<Ipv4Address, uint16_t>, uint32_t> m_nLocalEndPoints;
+  std::vector<Ipv4EndPoint *> m_candidates;
+  Hasher m_hasher;
+};
+
+} // namespace ns3
+
+#endif /* IPV4_END_POINTS_H */
@@ -0,0 +1,380 @@
+// -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*-
+//
+// Copyright (c) 2008 University of Washington
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//
+
+#ifndef IPV4_GLOBAL_ROUTING_H
+#define IPV4_GLOBAL_ROUTING_H
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ptr.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+class Packet;
+class NetDevice;
+class Ipv4Interface;
+class Ipv4Address;
+class Ipv4Header;
+class Ipv4MulticastRoutingTableEntry;
+class Node;
+
+
+/**
+ * \brief Global routing protocol for IP version 4 stacks.
+ *
+ * In ns-3 we have the concept of a pluggable routing protocol.  Routing
+ * protocols are added to a list maintained by the Ipv4L3Protocol.  Every 
+ * stack gets one routing protocol for free -- the Ipv4StaticRouting routing
+ * protocol is added in the constructor of the Ipv4L3Protocol (this is the 
+ * piece of code that implements the functionality of the IP layer).
+ *
+ * As an option to running a dynamic routing protocol, a GlobalRouteManager
+ * object has been created to allow users to build routes for all participating
+ * nodes.  One can think of this object as a "routing oracle"; it has
+ * an omniscient view of the topology, and can construct shortest path
+ * routes between all pairs of nodes.  These routes must be stored 
+ * somewhere in the node, so therefore this class Ipv4GlobalRouting
+ * is used as one of the pluggable routing protocols.  It is kept distinct
+ * from Ipv4StaticRouting because these routes may be dynamically cleared
+ * and rebuilt in the middle of the simulation, while manually entered
+ * routes into the Ipv4StaticRouting may need to be kept distinct.
+ *
+ * This class deals with Ipv4 unicast routes only.
+ *
+ * The consecutive routes to the same destination, such as the equal-cost
+ * routes added by the GlobalRouteManager, are stored as a 16-byte record
+ * which refers to their next hops by an index into a pool of next hop
+ * groups shared by all the instances of this class: the nodes of a large
+ * topology, a fat tree for instance, have many routes but few distinct
+ * groups of next hops, each the pair of a gateway and an interface. The host,
+ * network and external routes are each indexed by a hash table keyed by
+ * destination network and mask, which a lookup probes once per distinct
+ * mask of the table, so that the cost of a lookup does not depend on the
+ * number of routes.
+ *
+ * When several routes match a destination, the first one is selected, or
+ * one at random if the RandomEcmpRouting attribute is set, or one chosen by
+ * a hash of the flow of the packet if the FlowEcmpRouting attribute is set,
+ * so that the packets of a flow follow the same path and are not
+ * reordered. The flow is the source and destination addresses and the
+ * protocol of the packet, and the ports of the TCP and UDP packets which
+ * are forwarded unfragmented: the packets sent by the node are routed
+ * before their ports are known.
+ *
+ * \see Ipv4RoutingProtocol
+ * \see GlobalRouteManager
+ */
+class Ipv4GlobalRouting : public Ipv4RoutingProtocol
+{
+public:
+  static TypeId GetTypeId (void);
+/**
+ * \brief Construct an empty Ipv4GlobalRouting routing protocol,
+ *
+ * The Ipv4GlobalRouting class supports host and network unicast routes.
+ * This method initializes the lists containing these routes to empty.
+ *
+ * \see Ipv4GlobalRouting
+ */
+  Ipv4GlobalRouting ();
+  virtual ~Ipv4GlobalRouting ();
+
+  // These methods inherited from base class
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+
+  virtual bool RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                            UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                            LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const;
+
+/**
+ * \brief Add a host route to the global routing table.
+ *
+ * \param dest The Ipv4Address destination for this route.
+ * \param nextHop The Ipv4Address of the next hop in the route.
+ * \param interface The network interface index used to send packets to the
+ * destination.
+ *
+ * \see Ipv4Address
+ */
+  void AddHostRouteTo (Ipv4Address dest, 
+                       Ipv4Address nextHop, 
+                       uint32_t interface);
+/**
+ * \brief Add a host route to the global routing table.
+ *
+ * \param dest The Ipv4Address destination for this route.
+ * \param interface The network interface index used to send packets to the
+ * destination.
+ *
+ * \see Ipv4Address
+ */
+  void AddHostRouteTo (Ipv4Address dest, 
+                       uint32_t interface);
+
+/**
+ * \brief Add a network route to the global routing table.
+ *
+ * \param network The Ipv4Address network for this route.
+ * \param networkMask The Ipv4Mask to extract the network.
+ * \param nextHop The next hop in the route to the destination network.
+ * \param interface The network interface index used to send packets to the
+ * destination.
+ *
+ * \see Ipv4Address
+ */
+  void AddNetworkRouteTo (Ipv4Address network, 
+                          Ipv4Mask networkMask, 
+                          Ipv4Address nextHop, 
+                          uint32_t interface);
+
+/**
+ * \brief Add a network route to the global routing table.
+ *
+ * \param network The Ipv4Address network for this route.
+ * \param networkMask The Ipv4Mask to extract the network.
+ * \param interface The network interface index used to send packets to the
+ * destination.
+ *
+ * \see Ipv4Address
+ */
+  void AddNetworkRouteTo (Ipv4Address network, 
+                          Ipv4Mask networkMask, 
+                          uint32_t interface);
+
+/**
+ * \brief Add an external route to the global routing table.
+ *
+ * \param network The Ipv4Address network for this route.
+ * \param networkMask The Ipv4Mask to extract the network.
+ * \param nextHop The next hop Ipv4Address
+ * \param interface The network interface index used to send packets to the
+ * destination.
+ */
+  void AddASExternalRouteTo (Ipv4Address network,
+                             Ipv4Mask networkMask,
+                             Ipv4Address nextHop,
+                             uint32_t interface);
+
+/**
+ * \brief Get the number of individual unicast routes that have been added
+ * to the routing table.
+ *
+ * \warning The default route counts as one of the routes.
+ */
+  uint32_t GetNRoutes (void) const;
+
+/**
+ * \brief Get a route from the global unicast routing table.
+ *
+ * Externally, the unicast global routing table appears simply as a table with
+ * n entries.  The one subtlety of note is that if a default route has been set
+ * it will appear as the zeroth entry in the table.  This means that if you
+ * add only a default route, the table will have one entry that can be accessed
+ * either by explicitly calling GetDefaultRoute () or by calling GetRoute (0).
+ * 
+ * Similarly, if the default route has been set, calling RemoveRoute (0) will
+ * remove the default route.
+ *
+ * \param i The index (into the routing table) of the route to retrieve.  If
+ * the default route has been set, it will occupy index zero.
+ * \return If route is set, a pointer to that Ipv4RoutingTableEntry is returned, otherwise
+ * a zero pointer is returned.  The entry stays valid until the route is
+ * removed, and the changes made to it apply to the route.
+ *
+ * \see Ipv4RoutingTableEntry
+ * \see Ipv4GlobalRouting::RemoveRoute
+ */
+  Ipv4RoutingTableEntry *GetRoute (uint32_t i) const;
+
+/**
+ * \brief Remove a route from the global unicast routing table.
+ *
+ * Externally, the unicast global routing table appears simply as a table with
+ * n entries.  The one subtlety of note is that if a default route has been set
+ * it will appear as the zeroth entry in the table.  This means that if the
+ * default route has been set, calling RemoveRoute (0) will remove the
+ * default route.
+ *
+ * \param i The index (into the routing table) of the route to remove.  If
+ * the default route has been set, it will occupy index zero.
+ *
+ * \see Ipv4RoutingTableEntry
+ * \see Ipv4GlobalRouting::GetRoute
+ * \see Ipv4GlobalRouting::AddRoute
+ */
+  void RemoveRoute (uint32_t i);
+
+ /**
+  * Assign a fixed random variable stream number to the random variables
+  * used by this model.  Return the number of streams (possibly zero) that
+  * have been assigned.
+  *
+  * \param stream first stream index to use
+  * \return the number of stream indices assigned by this model
+  */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  void DoDispose (void);
+
+private:
+  /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
+  bool m_randomEcmpRouting;
+  /// Set to true if packets are routed among ECMP by a hash of their flow
+  bool m_flowEcmpRouting;
+  /// Mixed into the flow hashes, so that the nodes do not all select the same paths
+  uint32_t m_flowHashSalt;
+  /// Set to true if this interface should respond to interface events by globallly recomputing routes 
+  bool m_respondToInterfaceEvents;
+  /// A uniform random number generator for randomly routing packets among ECMP 
+  Ptr<UniformRandomVariable> m_rand;
+
+  /**
+   * \brief A table of routes, indexed by destination network.
+   *
+   * The routes are kept in insertion order. The consecutive routes to the
+   * same network and mask form a run, which refers to the group of their
+   * next hops in the shared pool. The index is an open addressing hash
+   * table of the first run to each (network, mask) pair, the runs to the
+   * same pair being chained in insertion order. Removing a run invalidates
+   * the index, which is rebuilt by the next lookup, so that removing all
+   * the routes costs linear time. The entries handed out by GetRoute ()
+   * are kept with their routes; the changes made to them are applied by
+   * the next lookup.
+   */
+  class RouteTable
+  {
+public:
+    RouteTable ();
+    ~RouteTable ();
+    void Add (Ipv4Address network, Ipv4Mask mask, Ipv4Address nextHop, uint32_t interface);
+    void Remove (uint32_t i);
+    void Clear (void);
+    uint32_t GetN (void) const;
+    Ipv4RoutingTableEntry Get (uint32_t i) const;
+    /**
+     * \returns the entry of the route i, created when first asked for,
+     *          and deleted with the route. The changes made to it are
+     *          applied to the route by the next Match ().
+     */
+    Ipv4RoutingTableEntry *GetEntry (uint32_t i) const;
+    /**
+     * \param dest the destination to look up.
+     * \param runs set to the runs whose network contains dest, in
+     *        increasing order.
+     */
+    void Match (Ipv4Address dest, std::vector<uint32_t> &runs);
+    Ipv4Address GetNetwork (uint32_t run) const;
+    /// \returns the indices in the shared pool of the next hops of the run.
+    std::vector<uint32_t> const &GetGroup (uint32_t run) const;
+
+private:
+    RouteTable (RouteTable const &);
+    RouteTable &operator = (RouteTable const &);
+
+    static const uint32_t NONE = 0xffffffff;
+    struct Run
+    {
+      uint32_t network;
+      uint32_t mask;
+      uint32_t group;   ///< the index of the next hop group in the shared pool
+      uint32_t next;    ///< the next run to the same network, or NONE
+    };
+
+    static uint32_t Hash (uint32_t network, uint32_t mask);
+    /// \returns the slot of the network, or of the empty slot where it belongs.
+    uint32_t FindSlot (uint32_t network, uint32_t mask) const;
+    void Index (uint32_t i);
+    void Rebuild (void);
+    /**
+     * \param i the index of a route, set to its index in its run.
+     * \returns the index of the run of the route.
+     */
+    uint32_t Locate (uint32_t &i) const;
+    /// \returns the route i as it is stored, whatever its entry.
+    Ipv4RoutingTableEntry Decode (uint32_t i) const;
+    /// Apply the changes made to the entries returned by GetEntry.
+    void Sync (void);
+    /// Clear the routes, but not the entries.
+    void ClearRoutes (void);
+
+    std::deque<Run> m_runs;
+    uint32_t m_nRoutes;
+    std::vector<uint32_t> m_slots;
+    uint32_t m_nNetworks;
+    std::vector<uint32_t> m_masks; ///< the distinct masks of the runs
+    bool m_valid;
+    /// The index of the first route of each run, rebuilt when needed.
+    mutable std::vector<uint32_t> m_firsts;
+    mutable bool m_firstsValid;
+    /// The entry of each route, or zero, or no entry at all if none was asked for.
+    mutable std::deque<Ipv4RoutingTableEntry *> m_entries;
+    /// The routes which have an entry, in increasing order.
+    mutable std::vector<uint32_t> m_entryRoutes;
+  };
+
+  /**
+   * \param index the index of a route, as in GetRoute ().
+   * \returns a copy of the route, without creating its entry.
+   */
+  Ipv4RoutingTableEntry CopyRoute (uint32_t index) const;
+
+  /**
+   * \param header the header of the packet to route.
+   * \param p the packet being forwarded, whose payload starts with the
+   *        transport header, or zero.
+   * \param oif the output device, or zero for any device.
+   * \returns the route, or zero.
+   */
+  Ptr<Ipv4Route> LookupGlobal (Ipv4Header const &header, Ptr<const Packet> p, Ptr<NetDevice> oif = 0);
+  /**
+   * \param runs the runs of the table which match the destination.
+   * \param first true to add only the first route on the output device.
+   */
+  void AddCandidates (RouteTable const &table, std::vector<uint32_t> const &runs,
+                      Ptr<NetDevice> oif, bool first);
+  uint32_t GetFlowHash (Ipv4Header const &header, Ptr<const Packet> p);
+
+  RouteTable m_hostRoutes;
+  RouteTable m_networkRoutes;
+  RouteTable m_ASexternalRoutes; // External routes imported
+  /// The runs matched by the last lookup
+  std::vector<uint32_t> m_matches;
+  /// The destinations and next hops of the routes of the last lookup
+  std::vector<std::pair<Ipv4Address, uint32_t> > m_candidates;
+
+  Ptr<Ipv4> m_ipv4;
+};
+
+} // Namespace ns3
+
+#endif /* IPV4_GLOBAL_ROUTING_H */
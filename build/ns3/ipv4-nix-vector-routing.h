@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009 The Georgia Institute of Technology 
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Josh Pelkey <jpelkey@gatech.edu>
+ */
+
+#ifndef IPV4_NIX_VECTOR_ROUTING_H
+#define IPV4_NIX_VECTOR_ROUTING_H
+
+#include <map>
+#include <vector>
+
+#include "ns3/channel.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/nix-vector.h"
+#include "ns3/bridge-net-device.h"
+
+namespace ns3 {
+
+/**
+ * Map of Ipv4Address to NixVector
+ */
+typedef std::map<Ipv4Address, Ptr<NixVector> > NixMap_t;
+/**
+ * Map of Ipv4Address to Ipv4Route
+ */
+typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
+
+/**
+ * Nix-vector routing protocol
+ *
+ * The nix-vectors are cached by source node and destination address in a
+ * cache shared by all the nodes, along with the devices through which
+ * their paths leave each node. When an interface or the link of a device
+ * goes down, only the paths which leave its node through its device are
+ * flushed; when an address is added or removed, only the paths to that
+ * address. When an interface or a link goes up, all the paths are
+ * flushed, since the new link may shorten any of them. The links watched
+ * are those of the devices of the nodes using nix-vector routing. The
+ * breadth first searches run on a copy of the topology, read again after
+ * each of these changes. Failed searches are not cached, so that a
+ * destination becomes reachable as soon as a link to it comes up.
+ *
+ * The nix-vectors of a known traffic matrix may be computed in advance,
+ * in parallel threads, by PrecomputeNixVectors.
+ */
+class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
+{
+public:
+  Ipv4NixVectorRouting ();
+  ~Ipv4NixVectorRouting ();
+  /**
+   * @brief The Interface ID of the Global Router interface.
+   *
+   * @see Object::GetObject ()
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * @brief Set the Node pointer of the node for which this
+   * routing protocol is to be placed
+   *
+   * @param node Node pointer
+   */
+  void SetNode (Ptr<Node> node);
+
+  /**
+   * @brief Called when run-time link topology change occurs
+   * which flushes the nix-vectors of all the nodes, and
+   * their Ipv4Route caches
+   *
+   */
+  void FlushGlobalNixRoutingCache (void);
+
+  /**
+   * @brief Compute the nix-vectors of a traffic matrix in advance
+   *
+   * The paths from each source node are found by a single breadth
+   * first search, the searches running in parallel threads (see the
+   * NixVectorRoutingThreads global value). The nix-vectors are then
+   * cached as if each flow had sent its first packet.
+   *
+   * @param flows the source nodes and destination addresses of the flows
+   */
+  static void PrecomputeNixVectors (std::vector<std::pair<Ptr<Node>, Ipv4Address> > const &flows);
+
+private:
+  /* the nix-vectors of all the nodes and the topology from which they
+   * were computed, defined in the .cc file */
+  struct SharedCache;
+  static SharedCache &GetSharedCache (void);
+
+  /* reads the topology again if it changed since it was last read */
+  static void ReadTopology (void);
+
+  /* caches the nix-vector of the path from the source node to the
+   * destination address, with the node and device indices of the links
+   * through which it leaves each node */
+  static void AddPath (Ipv4Address dest, uint32_t source, Ptr<NixVector> nixVector,
+                       std::vector<std::pair<uint32_t, uint32_t> > const &links);
+
+  /* flushes the nix-vectors of the paths which leave the node through
+   * the device, and the Ipv4Routes of their destination on the nodes
+   * of these paths */
+  static void FlushPathsThrough (uint32_t node, uint32_t device);
+
+  /* flushes the nix-vectors of the paths to the destination */
+  static void FlushPathsTo (Ipv4Address dest);
+
+  /* flushes the nix-vectors of the paths which leave the node through
+   * any of its devices */
+  static void FlushPathsOf (uint32_t node);
+
+  /* flushes all the nix-vectors and Ipv4Routes */
+  static void FlushAllPaths (void);
+
+  /* registers NotifyLinkChange with the devices of the node which are
+   * not watched yet */
+  void WatchDevices (void);
+
+  /* called when the link of the device of the node goes up or down */
+  static void NotifyLinkChange (uint32_t node, uint32_t device);
+
+  /* flushes the cache which stores the Ipv4 route
+   * based on the destination IP */
+  void FlushIpv4RouteCache (void);
+
+  /* upon a run-time topology change caches are
+   * flushed and the total number of neighbors is
+   * reset to zero */
+  void ResetTotalNeighbors (void);
+
+  /*  takes in the source node and dest IP and calls GetNodeByIp,
+   *  a breadth first search, accounting for any output interface
+   *  specified, and finally caches and returns the built nix-vector */
+  Ptr<NixVector> GetNixVector (Ptr<Node>, Ipv4Address, Ptr<NetDevice>);
+
+  /* checks the shared cache based on this node and dest IP for the
+   * nix-vector, returns false if not cached */
+  bool GetNixVectorInCache (Ipv4Address, Ptr<NixVector> &);
+
+  /* checks the cache based on dest IP for the Ipv4Route */
+  Ptr<Ipv4Route> GetIpv4RouteInCache (Ipv4Address);
+
+  /* given a net-device returns all the adjacent net-devices,
+   * essentially getting the neighbors on that channel */
+  static void GetAdjacentNetDevices (Ptr<NetDevice>, Ptr<Channel>, NetDeviceContainer &);
+
+  /* iterates through the node list and finds the one
+   * corresponding to the given Ipv4Address */
+  static Ptr<Node> GetNodeByIp (Ipv4Address);
+
+  /* special variation of BuildNixVector for when a node is sending to itself */
+  bool BuildNixVectorLocal (Ptr<NixVector> nixVector);
+
+  /* simple iterates through the nodes net-devices and determines
+   * how many neighbors it has */
+  uint32_t FindTotalNeighbors (void);
+
+  /* determine if the netdevice is bridged */
+  static Ptr<BridgeNetDevice> NetDeviceIsBridged (Ptr<NetDevice> nd);
+
+
+  /* Nix index is with respect to the neighbors.  The net-device index must be
+   * derived from this */
+  uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp);
+
+  void DoDispose (void);
+
+  /* From Ipv4RoutingProtocol */
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const;
+
+
+  /* cache stores Ipv4Routes based on destination ip */
+  Ipv4RouteMap_t m_ipv4RouteCache;
+
+  /* the generation of the shared cache of the Ipv4Routes, which
+   * are all flushed when the generation changes */
+  uint32_t m_ipv4RouteCacheGeneration;
+
+  Ptr<Ipv4> m_ipv4;
+  Ptr<Node> m_node;
+
+  /* the number of devices of the node whose link changes are watched */
+  uint32_t m_watchedDevices;
+
+  /* total neighbors used for nix-vector to determine
+   * number of bits */
+  uint32_t m_totalNeighbors;
+};
+} // namespace ns3
+
+#endif /* IPV4_NIX_VECTOR_ROUTING_H */
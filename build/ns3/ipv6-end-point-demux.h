@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2007-2009 Strasbourg University
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
+ */
+
+#ifndef IPV6_END_POINT_DEMUX_H
+#define IPV6_END_POINT_DEMUX_H
+
+#include <stdint.h>
+#include <list>
+#include <map>
+#include <vector>
+#include "ns3/ipv6-address.h"
+#include "ns3/hash.h"
+#include "ipv6-interface.h"
+#include "end-point-hash-table.h"
+
+namespace ns3 {
+
+class Ipv6EndPoint;
+
+/**
+ * \class Ipv6EndPointDemux
+ * \brief Demultiplexor for end points.
+ *
+ * The end points whose four-tuple is fully specified are indexed by a
+ * hash table of their four-tuple, and the other end points by a hash
+ * table of their local port. Among several matching end points of the
+ * same precedence, the lookups return them in the order of their
+ * allocation.
+ */
+class Ipv6EndPointDemux
+{
+public:
+  typedef std::list<Ipv6EndPoint *>EndPoints;
+  typedef std::list<Ipv6EndPoint *>::iterator EndPointsI;
+
+  /**
+   * \brief Constructor.
+   */
+  Ipv6EndPointDemux ();
+
+  /**
+   * \brief Destructor.
+   */
+  ~Ipv6EndPointDemux ();
+
+  /**
+   * \brief Lookup for port local.
+   * \param port port to test
+   * \return true if a port local is in EndPoints, false otherwise
+   */
+  bool LookupPortLocal (uint16_t port);
+
+  /**
+   * \brief Lookup for address and port.
+   * \param addr address to test
+   * \param port port to test
+   * \return true if there is a match in EndPoints, false otherwise
+   */
+  bool LookupLocal (Ipv6Address addr, uint16_t port);
+
+  /**
+   * \brief lookup for a match with all the parameters.
+   * \param dst destination address to test
+   * \param dport destination port to test
+   * \param src source address to test
+   * \param sport source port to test
+   * \param incomingInterface the incoming interface
+   * \return list en IPv6EndPoints (could be 0 element)
+   */
+  EndPoints Lookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport, Ptr<Ipv6Interface> incomingInterface);
+
+  /**
+   * \brief Simple lookup for a four-tuple match.
+   * \param dst destination address to test
+   * \param dport destination port to test
+   * \param src source address to test
+   * \param sport source port to test
+   * \return match or 0 if not found
+   */
+  Ipv6EndPoint* SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \return an empty Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (void);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param address IPv6 address
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address address);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param port local port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param address local address
+   * \param port local port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address address, uint16_t port);
+
+  /**
+   * \brief Allocate a Ipv6EndPoint.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return an Ipv6EndPoint instance
+   */
+  Ipv6EndPoint * Allocate (Ipv6Address localAddress, uint16_t localPort, Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Remove a end point.
+   * \param endPoint the end point to remove
+   */
+  void DeAllocate (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the entire list of end points registered.
+   * \return list of Ipv6EndPoint
+   */
+  EndPoints GetEndPoints () const;
+
+private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Allocate a ephemeral port.
+   * \return a port
+   */
+  uint16_t AllocateEphemeralPort ();
+
+  /**
+   * \brief Add a new end point to the demux.
+   * \param endPoint the end point
+   */
+  void Add (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the hash tables.
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the hash tables, before its
+   * four-tuple changes or it is deallocated.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the end points which may have a four-tuple.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the fully specified end points with the same hash and all
+   * the other end points of the local port, in the order of allocation
+   */
+  std::vector<Ipv6EndPoint *> const &GetCandidates (Ipv6Address localAddress, uint16_t localPort,
+                                                    Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Is the four-tuple of an end point fully specified ?
+   * \param endPoint the end point
+   * \return true if it is
+   */
+  static bool IsConnection (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Compare the allocation order of two end points.
+   * \param a an end point
+   * \param b another end point
+   * \return true if a was allocated before b
+   */
+  static bool IsAllocatedBefore (Ipv6EndPoint *a, Ipv6EndPoint *b);
+
+  /**
+   * \brief Hash a four-tuple.
+   */
+  uint32_t GetHash (Ipv6Address localAddress, uint16_t localPort,
+                    Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Hash a local port.
+   */
+  uint32_t GetHash (uint16_t localPort);
+
+  /**
+   * \brief The ephemeral port.
+   */
+  uint16_t m_ephemeral;
+
+  /**
+   * \brief The first ephemeral port.
+   */
+  uint16_t m_portFirst;
+
+  /**
+   * \brief The last ephemeral port.
+   */
+  uint16_t m_portLast;
+
+  /**
+   * \brief The IPv6 end points, by order of allocation.
+   */
+  std::map<uint64_t, Ipv6EndPoint *> m_endPoints;
+
+  /**
+   * \brief The number of end points allocated.
+   */
+  uint64_t m_nAllocated;
+
+  /**
+   * \brief The fully specified end points, by hash of their four-tuple.
+   */
+  EndPointHashTable<Ipv6EndPoint> m_connections;
+
+  /**
+   * \brief The other end points, by hash of their local port.
+   */
+  EndPointHashTable<Ipv6EndPoint> m_listeners;
+
+  /**
+   * \brief The number of end points bound to each local port.
+   */
+  std::map<uint16_t, uint32_t> m_nPortEndPoints;
+
+  /**
+   * \brief The number of end points bound to each local address and port.
+   */
+  std::map<std::pair<Ipv6Address, uint16_t>, uint32_t> m_nLocalEndPoints;
+
+  /**
+   * \brief The result of GetCandidates.
+   */
+  std::vector<Ipv6EndPoint *> m_candidates;
+
+  /**
+   * \brief The hash function of the four-tuples.
+   */
+  Hasher m_hasher;
+};
+
+} /* namespace ns3 */
+
+#endif /* IPV6_END_POINT_DEMUX_H */
+
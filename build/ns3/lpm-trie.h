@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LPM_TRIE_H
+#define LPM_TRIE_H
+
+#include <list>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A path-compressed binary trie (Patricia trie) of prefixes, for
+ *        longest prefix matching.
+ *
+ * The prefixes are at most 128 bits long and are stored in network
+ * byte order, most significant bit first. Each prefix holds a list of
+ * values, in the order in which they were inserted. Only the nodes
+ * which hold values or branch are allocated, so that a lookup visits at
+ * most one node per distinct prefix length on the path to the key.
+ *
+ * \tparam T the type of the values, which must be comparable with ==.
+ */
+template <typename T>
+class LpmTrie
+{
+public:
+  /// The values stored with a prefix, in insertion order.
+  typedef std::list<T> Values;
+
+  /// The maximum length of the prefixes, in bits.
+  static const uint32_t MAX_LENGTH = 128;
+
+  LpmTrie ();
+  ~LpmTrie ();
+
+  /**
+   * \param key the prefix, at least (length + 7) / 8 bytes long. The
+   *        bits after the prefix length are ignored.
+   * \param length the length of the prefix, in bits.
+   * \param value the value to append to the values of the prefix.
+   */
+  void Insert (uint8_t const *key, uint32_t length, T const &value);
+  /**
+   * \param key the prefix.
+   * \param length the length of the prefix, in bits.
+   * \param value the value to remove from the values of the prefix.
+   * \returns true if the value was found.
+   */
+  bool Remove (uint8_t const *key, uint32_t length, T const &value);
+  /**
+   * Remove all the prefixes.
+   */
+  void Clear (void);
+  /**
+   * \param key the key to match, length bits long.
+   * \param length the length of the key, in bits.
+   * \param matches an array of at least length + 1 entries, set to the
+   *        values of the prefixes of the key, from the shortest to the
+   *        longest prefix.
+   * \returns the number of prefixes of the key which hold values.
+   */
+  uint32_t Match (uint8_t const *key, uint32_t length, Values const *matches[]) const;
+
+private:
+  struct Node
+  {
+    uint8_t key[MAX_LENGTH / 8];
+    uint32_t length;
+    Node *child[2];
+    Values values;
+  };
+
+  LpmTrie (LpmTrie const &);
+  LpmTrie &operator = (LpmTrie const &);
+
+  static Node *CreateNode (uint8_t const *key, uint32_t length);
+  static void DeleteNode (Node *node);
+  static uint32_t GetBit (uint8_t const *key, uint32_t bit);
+  /**
+   * \returns the number of leading bits, up to length, common to a and b.
+   */
+  static uint32_t GetCommonLength (uint8_t const *a, uint8_t const *b, uint32_t length);
+
+  Node *m_root;
+};
+
+template <typename T>
+LpmTrie<T>::LpmTrie ()
+  : m_root (0)
+{
+}
+
+template <typename T>
+LpmTrie<T>::~LpmTrie ()
+{
+  Clear ();
+}
+
+template <typename T>
+typename LpmTrie<T>::Node *
+LpmTrie<T>::CreateNode (uint8_t const *key, uint32_t length)
+{
+  Node *node = new Node ();
+  std::memset (node->key, 0, sizeof (node->key));
+  std::memcpy (node->key, key, (length + 7) / 8);
+  if (length % 8 != 0)
+    {
+      node->key[length / 8] &= 0xff << (8 - length % 8);
+    }
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+template <typename T>
+void
+LpmTrie<T>::DeleteNode (Node *node)
+{
+  if (node != 0)
+    {
+      DeleteNode (node->child[0]);
+      DeleteNode (node->child[1]);
+      delete node;
+    }
+}
+
+template <typename T>
+uint32_t
+LpmTrie<T>::GetBit (uint8_t const *key, uint32_t bit)
+{
+  return (key[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+template <typename T>
+uint32_t
+LpmTrie<T>::GetCommonLength (uint8_t const *a, uint8_t const *b, uint32_t length)
+{
+  uint32_t i = 0;
+  while (i + 8 <= length && a[i / 8] == b[i / 8])
+    {
+      i += 8;
+    }
+  while (i < length && GetBit (a, i) == GetBit (b, i))
+    {
+      i++;
+    }
+  return i;
+}
+
+template <typename T>
+void
+LpmTrie<T>::Insert (uint8_t const *key, uint32_t length, T const &value)
+{
+  NS_ASSERT (length <= MAX_LENGTH);
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0)
+        {
+          node = CreateNode (key, length);
+          node->values.push_back (value);
+          *link = node;
+          return;
+        }
+      uint32_t common = GetCommonLength (node->key, key, std::min (node->length, length));
+      if (common < node->length)
+        {
+          // the prefix diverges from the node, or is a prefix of it:
+          // insert a node at the branching point.
+          Node *branch = CreateNode (key, common);
+          branch->child[GetBit (node->key, common)] = node;
+          *link = branch;
+          if (common == length)
+            {
+              branch->values.push_back (value);
+            }
+          else
+            {
+              Node *leaf = CreateNode (key, length);
+              leaf->values.push_back (value);
+              branch->child[GetBit (key, common)] = leaf;
+            }
+          return;
+        }
+      if (node->length == length)
+        {
+          node->values.push_back (value);
+          return;
+        }
+      link = &node->child[GetBit (key, node->length)];
+    }
+}
+
+template <typename T>
+bool
+LpmTrie<T>::Remove (uint8_t const *key, uint32_t length, T const &value)
+{
+  NS_ASSERT (length <= MAX_LENGTH);
+  Node **parentLink = 0;
+  Node **link = &m_root;
+  while (*link != 0)
+    {
+      Node *node = *link;
+      if (node->length > length
+          || GetCommonLength (node->key, key, node->length) < node->length)
+        {
+          return false;
+        }
+      if (node->length < length)
+        {
+          parentLink = link;
+          link = &node->child[GetBit (key, node->length)];
+          continue;
+        }
+
+      typename Values::iterator i = std::find (node->values.begin (), node->values.end (), value);
+      if (i == node->values.end ())
+        {
+          return false;
+        }
+      node->values.erase (i);
+      // remove the nodes which neither hold values nor branch anymore.
+      while (node->values.empty () && (node->child[0] == 0 || node->child[1] == 0))
+        {
+          *link = node->child[0] != 0 ? node->child[0] : node->child[1];
+          delete node;
+          if (parentLink == 0 || *link != 0)
+            {
+              break;
+            }
+          // the parent has now a single child.
+          link = parentLink;
+          parentLink = 0;
+          node = *link;
+        }
+      return true;
+    }
+  return false;
+}
+
+template <typename T>
+void
+LpmTrie<T>::Clear (void)
+{
+  DeleteNode (m_root);
+  m_root = 0;
+}
+
+template <typename T>
+uint32_t
+LpmTrie<T>::Match (uint8_t const *key, uint32_t length, Values const *matches[]) const
+{
+  uint32_t n = 0;
+  Node const *node = m_root;
+  while (node != 0 && node->length <= length
+         && GetCommonLength (node->key, key, node->length) == node->length)
+    {
+      if (!node->values.empty ())
+        {
+          matches[n++] = &node->values;
+        }
+      if (node->length == length)
+        {
+          break;
+        }
+      node = node->child[GetBit (key, node->length)];
+    }
+  return n;
+}
+
+} // namespace ns3
+
+#endif /* LPM_TRIE_H */
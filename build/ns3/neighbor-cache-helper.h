@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NEIGHBOR_CACHE_HELPER_H
+#define NEIGHBOR_CACHE_HELPER_H
+
+#include "ns3/ptr.h"
+#include "ns3/channel.h"
+
+namespace ns3 {
+
+/**
+ * \brief Helper class that fills the ARP and NDISC caches with permanent
+ * entries.
+ *
+ * On a large LAN, every node resolves the addresses of its neighbors when
+ * the traffic starts, which floods the LAN with ARP requests and Neighbor
+ * Solicitations. This helper gives every interface attached to a channel
+ * the layer 2 address of all the IPv4 and IPv6 addresses of the other
+ * interfaces attached to the channel, in permanent entries of its ARP and
+ * NDISC caches. The permanent entries never expire, need no timer, are
+ * not updated by the ARP and Neighbor Discovery messages, and are kept
+ * when the caches are flushed upon a link change.
+ *
+ * The caches are filled with the addresses assigned at the time of the
+ * call: the helper must be called once the addresses are assigned.
+ */
+class NeighborCacheHelper
+{
+public:
+  /**
+   * \brief Fill the neighbor caches of the interfaces attached to every
+   * channel of the simulation.
+   */
+  static void PopulateNeighborCaches (void);
+
+  /**
+   * \brief Fill the neighbor caches of the interfaces attached to a
+   * channel.
+   * \param channel the channel
+   */
+  static void PopulateNeighborCaches (Ptr<Channel> channel);
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_CACHE_HELPER_H */
@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PCAP_REPLAY_HELPER_H
+#define PCAP_REPLAY_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/application-container.h"
+#include "ns3/object-factory.h"
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief create PcapReplay applications which inject a pcap file
+ *        into net devices.
+ */
+class PcapReplayHelper
+{
+public:
+  /**
+   * \param filename the pcap file to replay.
+   */
+  PcapReplayHelper (std::string filename);
+
+  /**
+   * Install a PcapReplay application on the node of each device of
+   * the container, replaying the file into that device.
+   *
+   * \param devices the devices to inject the packets into.
+   * \returns the applications created, one for each device.
+   */
+  ApplicationContainer Install (NetDeviceContainer devices) const;
+
+  /**
+   * Install a PcapReplay application on the node of the device,
+   * replaying the file into that device.
+   *
+   * \param device the device to inject the packets into.
+   * \returns an ApplicationContainer holding the application created.
+   */
+  ApplicationContainer Install (Ptr<NetDevice> device) const;
+
+  /**
+   * \brief Configure the attributes of the applications.
+   * \param name   attribute's name
+   * \param value  attribute's value
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+private:
+  /**
+   * \internal
+   */
+  Ptr<Application> InstallPriv (Ptr<NetDevice> device) const;
+  ObjectFactory m_factory;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_HELPER_H */
@@ -0,0 +1,13 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_POINT_TO_POINT_LAYOUT
+    
+
+// Module headers:
+#include "point-to-point-dumbbell.h"
+#include "point-to-point-grid.h"
+#include "point-to-point-star.h"
+#endif
@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENT_OFFLOAD_TAG_H
+#define SEGMENT_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Marks a packet which stands for several packets of a flow.
+ *
+ * With segment offload, a transport protocol sends in one packet the
+ * payload of several packets with identical headers: the segments of a
+ * super-segment, or a batch of ACKs without payload. The packet goes
+ * through the stack as one unit, and the devices which support the
+ * offload (see NetDevice::SupportsSegmentOffload), such as
+ * PointToPointNetDevice and CsmaNetDevice, take the time to transmit all
+ * the packets it stands for, each with its own copy of the headers.  IPv4
+ * and IPv6 fragment the packets larger than the MTU of the other devices,
+ * and remove the tag from them.
+ */
+class SegmentOffloadTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  SegmentOffloadTag ();
+  /**
+   * \param nPackets the number of packets the packet stands for.
+   * \param payloadSize the size of the payload of all these packets.
+   */
+  SegmentOffloadTag (uint32_t nPackets, uint32_t payloadSize);
+  void SetNPackets (uint32_t nPackets);
+  uint32_t GetNPackets (void) const;
+  void SetPayloadSize (uint32_t payloadSize);
+  uint32_t GetPayloadSize (void) const;
+  /**
+   * \param size the size of the packet with its headers, as it is
+   *        being transmitted.
+   * \returns the number of bytes of all the packets the packet stands
+   *          for, with their headers.
+   */
+  uint32_t GetWireSize (uint32_t size) const;
+private:
+  uint32_t m_nPackets;
+  uint32_t m_payloadSize;
+};
+
+} // namespace ns3
+
+#endif /* SEGMENT_OFFLOAD_TAG_H */
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_CUBIC_H
+#define TCP_CUBIC_H
+
+#include "tcp-socket-base.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief An implementation of a stream socket using TCP.
+ *
+ * This class contains the CUBIC implementation of TCP, as of \RFC{8312},
+ * with the HyStart slow start of Ha and Rhee. The fast retransmit and
+ * fast recovery are those of TcpNewReno.
+ *
+ * In congestion avoidance, the window grows as a cubic function of the
+ * time since the last congestion event, whose plateau is the window
+ * before the event: its growth is independent of the RTT and of the
+ * size of the window, so that paths of large bandwidth-delay products
+ * are filled quickly. The window grows by the acknowledged bytes rather
+ * than by the ACKs, and keeps the fractions of bytes between the ACKs,
+ * so that it scales to very large windows. Such windows also need the
+ * WindowScaling attribute of TcpSocketBase and large buffers, and a
+ * large initial SSThresh for the slow start to find the path capacity.
+ *
+ * HyStart ends the slow start before it overflows the bottleneck queue,
+ * once the ACKs of a round arrive in a train as long as half the minimum
+ * RTT, or once the RTT grows by a fraction of the minimum RTT.
+ */
+class TcpCubic : public TcpSocketBase
+{
+public:
+  static TypeId GetTypeId (void);
+  /**
+   * Create an unbound tcp socket.
+   */
+  TcpCubic (void);
+  TcpCubic (const TcpCubic& sock);
+  virtual ~TcpCubic (void);
+
+  // From TcpSocketBase
+  virtual int Connect (const Address &address);
+  virtual int Listen (void);
+
+protected:
+  virtual uint32_t Window (void); // Return the max possible number of unacked bytes
+  virtual Ptr<TcpSocketBase> Fork (void); // Call CopyObject<TcpCubic> to clone me
+  virtual void NewAck (SequenceNumber32 const& seq); // Inc cwnd and call NewAck() of parent
+  virtual void DupAck (const TcpHeader& t, uint32_t count);  // Reduce cwnd and enter fast recovery
+  virtual void Retransmit (void); // Exit fast recovery upon retransmit timeout
+  virtual bool InFastRecovery (void) const; // Return m_inFastRec
+
+  // Implementing ns3::TcpSocket -- Attribute get/set
+  virtual void     SetSegSize (uint32_t size);
+  virtual void     SetSSThresh (uint32_t threshold);
+  virtual uint32_t GetSSThresh (void) const;
+  virtual void     SetInitialCwnd (uint32_t cwnd);
+  virtual uint32_t GetInitialCwnd (void) const;
+private:
+  void InitializeCwnd (void);            // set m_cWnd when connection starts
+  /**
+   * Record the window at a congestion event, and set ssthresh to the
+   * reduced window.
+   */
+  void ReduceWindow (void);
+  /**
+   * Grow the window along the cubic function in congestion avoidance.
+   *
+   * \param acked the number of bytes acknowledged
+   */
+  void CubicUpdate (uint32_t acked);
+  /**
+   * Look for the end of the slow start, in the slow start.
+   *
+   * \param seq the sequence number acknowledged
+   */
+  void HystartUpdate (SequenceNumber32 const& seq);
+
+protected:
+  TracedValue<uint32_t>  m_cWnd;         //< Congestion window
+  uint32_t               m_ssThresh;     //< Slow Start Threshold
+  uint32_t               m_initialCWnd;  //< Initial cWnd value
+  SequenceNumber32       m_recover;      //< Previous highest Tx seqnum for fast recovery
+  uint32_t               m_retxThresh;   //< Fast Retransmit threshold
+  bool                   m_inFastRec;    //< currently in fast recovery
+
+  // CUBIC
+  double                 m_c;               //< Scaling constant C, in segments per cubed second
+  double                 m_beta;            //< Multiplicative decrease factor
+  bool                   m_fastConvergence; //< Lower the plateau upon consecutive reductions
+  double                 m_wMax;            //< Window before the last reduction, in bytes
+  double                 m_wLastMax;        //< Plateau of the last epoch, in bytes
+  Time                   m_epochStart;      //< Start of the congestion avoidance epoch, zero if none
+  double                 m_k;               //< Time to reach the origin point in the epoch, in seconds
+  double                 m_originPoint;     //< Plateau of the cubic function of the epoch, in bytes
+  double                 m_wEst;            //< Window of standard TCP in the epoch, in bytes
+  double                 m_cWndFraction;    //< Fraction of a byte of window growth not applied yet
+
+  // HyStart
+  bool                   m_hystart;           //< Use HyStart to end the slow start
+  uint32_t               m_hystartLowWindow;  //< Window below which HyStart is not used, in segments
+  uint32_t               m_hystartMinSamples; //< Number of RTT samples of a round for the delay increase
+  Time                   m_hystartAckDelta;   //< Maximum spacing of the ACKs of a train
+  Time                   m_hystartDelayMin;   //< Minimum RTT increase to end the slow start
+  Time                   m_hystartDelayMax;   //< Maximum RTT increase to end the slow start
+  Time                   m_delayMin;          //< Minimum RTT sample, zero if none
+  SequenceNumber32       m_endSeq;            //< Sequence number ending the round
+  Time                   m_roundStart;        //< Start of the round
+  Time                   m_lastAck;           //< Time of the last ACK of the train
+  Time                   m_currRoundMinRtt;   //< Minimum RTT sample of the round
+  uint32_t               m_sampleCount;       //< Number of RTT samples of the round
+};
+
+} // namespace ns3
+
+#endif /* TCP_CUBIC_H */
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_SACK_SCOREBOARD_H
+#define TCP_SACK_SCOREBOARD_H
+
+#include <map>
+#include <vector>
+#include "ns3/sequence-number.h"
+#include "ns3/tcp-header.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The data selectively acknowledged by the receiver of a TCP
+ *        connection, as seen by the sender (RFC 6675).
+ *
+ * The blocks reported in the SACK options are merged into a list of
+ * disjoint blocks above the cumulative ACK. A sequence number is lost
+ * when DupThresh discontiguous blocks, or more than (DupThresh - 1)
+ * segments of data, were SACKed above it (the IsLost() of RFC 6675):
+ * the scoreboard keeps the boundary below which the holes are lost,
+ * located from the highest blocks when they change, so that the lost
+ * holes and the pipe are found without testing each segment.
+ */
+class TcpSackScoreboard
+{
+public:
+  TcpSackScoreboard ();
+
+  /**
+   * \param dupThresh the number of duplicate ACKs, or SACKed segments,
+   *        above a hole for it to be lost
+   */
+  void SetDupThresh (uint32_t dupThresh);
+  /**
+   * \param segmentSize the sender maximum segment size
+   */
+  void SetSegmentSize (uint32_t segmentSize);
+
+  /**
+   * Forget all the blocks, e.g. after a retransmission timeout (RFC 2018,
+   * sec. 8).
+   */
+  void Clear (void);
+
+  /**
+   * Update the scoreboard with an ACK.
+   *
+   * \param head the cumulative ACK, the first sequence number not acknowledged
+   * \param highData the sequence number after the highest one sent
+   * \param blocks the blocks of the SACK option of the ACK
+   * \returns the number of bytes SACKed by the ACK for the first time
+   */
+  uint32_t Update (SequenceNumber32 head, SequenceNumber32 highData,
+                   std::vector<TcpHeader::SackBlock> const &blocks);
+
+  /**
+   * \returns the number of bytes SACKed above the cumulative ACK
+   */
+  uint32_t GetSackedBytes (void) const;
+  /**
+   * \returns the number of blocks SACKed above the cumulative ACK
+   */
+  uint32_t GetNBlocks (void) const;
+  /**
+   * \param seq a sequence number
+   * \returns true if the byte of sequence number seq was SACKed
+   */
+  bool IsSacked (SequenceNumber32 seq) const;
+  /**
+   * \param seq a sequence number
+   * \returns true if the byte of sequence number seq is lost, that is,
+   *          not SACKed and below the loss boundary
+   */
+  bool IsLost (SequenceNumber32 seq) const;
+
+  /**
+   * Find the first hole that is lost at or after a sequence number, the
+   * rule (1) of the NextSeg() of RFC 6675.
+   *
+   * \param seq the first sequence number to consider, usually HighRxt
+   * \param start the first sequence number of the lost data found
+   * \param length the length of the lost data found, up to the next
+   *        SACKed block
+   * \returns true if lost data was found
+   */
+  bool GetNextLost (SequenceNumber32 seq, SequenceNumber32 &start, uint32_t &length) const;
+
+  /**
+   * \param seq a sequence number
+   * \returns the sequence number after the SACKed block holding seq, or
+   *          seq if it is not SACKed
+   */
+  SequenceNumber32 SkipSacked (SequenceNumber32 seq) const;
+
+  /**
+   * The estimate of the data in flight of the SetPipe() of RFC 6675,
+   * counting the data which is neither SACKed nor lost, and the lost
+   * data which was retransmitted.
+   *
+   * \param head the cumulative ACK
+   * \param highData the sequence number after the highest one sent
+   * \param highRxt the sequence number after the highest one retransmitted
+   * \returns the number of bytes in flight
+   */
+  uint32_t GetPipe (SequenceNumber32 head, SequenceNumber32 highData, SequenceNumber32 highRxt) const;
+
+private:
+  typedef std::map<SequenceNumber32, SequenceNumber32> Blocks;
+
+  /**
+   * Add a block, merging it with the blocks it overlaps or touches.
+   *
+   * \param first the first sequence number of the block
+   * \param last the sequence number after the last one of the block
+   * \returns the number of bytes added
+   */
+  uint32_t AddBlock (SequenceNumber32 first, SequenceNumber32 last);
+  /**
+   * Locate the loss boundary from the highest blocks.
+   */
+  void UpdateLossBoundary (void);
+
+  Blocks m_blocks;                 //!< Disjoint SACKed blocks, from their first sequence number to the one after their last one
+  SequenceNumber32 m_head;         //!< The cumulative ACK
+  uint32_t m_sackedBytes;          //!< Number of bytes in the blocks
+  SequenceNumber32 m_lossBoundary; //!< Sequence number below which the holes are lost
+  uint32_t m_dupThresh;            //!< DupThresh of RFC 6675
+  uint32_t m_segmentSize;          //!< SMSS of RFC 6675
+};
+
+} // namespace ns3
+
+#endif /* TCP_SACK_SCOREBOARD_H */
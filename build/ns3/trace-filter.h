@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_FILTER_H
+#define TRACE_FILTER_H
+
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief Select the packets written to a pcap or ascii trace file.
+ *
+ * A packet is traced if the current time is within the time window,
+ * its size is within the size range and it belongs to the flow, if
+ * any. One packet out of every SetSampling packets which pass these
+ * tests is then written to the file. The tests are evaluated from the
+ * cheapest to the most expensive, before the packet is serialized.
+ *
+ * The flow is an IPv4 5-tuple. To find the IPv4 header, the link-layer
+ * header is skipped according to the data link type of the pcap file
+ * (Ethernet, PPP or raw IP). When the data link type is unknown, as for
+ * ascii traces or 802.11 captures, the IPv4 header is looked for at the
+ * start of the packet, after a PPP or Ethernet header, or after an
+ * LLC/SNAP header in the first bytes of the packet. Packets without an
+ * IPv4 header never match a flow.
+ *
+ * Each trace file owns its own copy of the filter (see Copy), so that
+ * the sampling is done independently for each file.
+ */
+class TraceFilter : public SimpleRefCount<TraceFilter>
+{
+public:
+  TraceFilter ();
+
+  /**
+   * \param n trace one packet out of n, starting with the first one.
+   */
+  void SetSampling (uint32_t n);
+  /**
+   * \param min the smallest packet size traced.
+   * \param max the largest packet size traced.
+   */
+  void SetSizeRange (uint32_t min, uint32_t max);
+  /**
+   * \param start the time at which tracing starts.
+   * \param stop the time at which tracing stops.
+   */
+  void SetTimeWindow (Time start, Time stop);
+  /**
+   * Trace only the packets of an IPv4 flow. The any address
+   * (Ipv4Address::GetAny) and a zero protocol or port match any value.
+   *
+   * \param source the source address.
+   * \param destination the destination address.
+   * \param protocol the IP protocol number.
+   * \param sourcePort the source port, for TCP and UDP.
+   * \param destinationPort the destination port, for TCP and UDP.
+   */
+  void SetFlow (Ipv4Address source, Ipv4Address destination, uint8_t protocol,
+                uint16_t sourcePort = 0, uint16_t destinationPort = 0);
+  /**
+   * \param snapLen the maximum number of bytes of each packet written
+   *        to pcap files, zero to keep the snap length of the file.
+   *        Only the bytes written are copied out of the packet.
+   */
+  void SetSnapLen (uint32_t snapLen);
+  uint32_t GetSnapLen (void) const;
+
+  /**
+   * \returns a copy of this filter, with its own sampling counter.
+   */
+  Ptr<TraceFilter> Copy (void) const;
+
+  /**
+   * \param p the packet about to be traced.
+   * \param dataLinkType the data link type of the packet, zero if
+   *        unknown.
+   * \returns true if the packet must be traced.
+   */
+  bool Match (Ptr<const Packet> p, uint32_t dataLinkType = 0);
+  /**
+   * \param header the link-layer header about to be traced in front
+   *        of the packet.
+   * \param p the packet about to be traced.
+   * \param dataLinkType the data link type of the packet, zero if
+   *        unknown.
+   * \returns true if the packet must be traced.
+   *
+   * Only the first bytes of the header and of the packet are peeked
+   * at when a flow is set: the packet is not copied.
+   */
+  bool Match (Header const &header, Ptr<const Packet> p, uint32_t dataLinkType = 0);
+  /**
+   * \param buffer the bytes of the packet about to be traced. It may
+   *        be zero if NeedsData returns false.
+   * \param size the size of the packet.
+   * \param dataLinkType the data link type of the packet, zero if
+   *        unknown.
+   * \returns true if the packet must be traced.
+   */
+  bool Match (uint8_t const *buffer, uint32_t size, uint32_t dataLinkType = 0);
+  /**
+   * \returns true if Match needs the bytes of the packet, that is, if
+   *          a flow is set.
+   */
+  bool NeedsData (void) const;
+
+private:
+  bool MatchSizeAndTime (uint32_t size) const;
+  bool MatchFlow (uint8_t const *buffer, uint32_t size, uint32_t dataLinkType) const;
+  bool MatchSampling (void);
+
+  uint32_t m_sampling;
+  uint32_t m_count;
+  uint32_t m_minSize;
+  uint32_t m_maxSize;
+  Time m_start;
+  Time m_stop;
+  bool m_hasFlow;
+  Ipv4Address m_source;
+  Ipv4Address m_destination;
+  uint8_t m_protocol;
+  uint16_t m_sourcePort;
+  uint16_t m_destinationPort;
+  uint32_t m_snapLen;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_FILTER_H */
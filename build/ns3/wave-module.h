@@ -0,0 +1,25 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_WAVE
+    
+
+// Module headers:
+#include "channel-coordinator.h"
+#include "channel-manager.h"
+#include "channel-scheduler.h"
+#include "expire-time-tag.h"
+#include "higher-tx-tag.h"
+#include "ocb-wifi-mac.h"
+#include "vendor-specific-action.h"
+#include "vsa-repeater.h"
+#include "wave-edca-txop-n.h"
+#include "wave-helper.h"
+#include "wave-mac-helper.h"
+#include "wave-mac-low.h"
+#include "wave-mac-queue.h"
+#include "wave-net-device.h"
+#include "wifi-80211p-helper.h"
+#endif
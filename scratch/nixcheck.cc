@@ -0,0 +1,148 @@
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv4-nix-vector-routing.h"
+
+using namespace ns3;
+
+static std::map<std::string, uint32_t> g_rx;
+
+static void
+Rx (std::string context, Ipv4Header const &h, Ptr<const Packet> p, uint32_t i)
+{
+  std::ostringstream oss;
+  oss << context << " " << h.GetSource () << " " << h.GetDestination ();
+  g_rx[oss.str ()]++;
+}
+
+static void
+SetDown (Ptr<Node> n, uint32_t i)
+{
+  n->GetObject<Ipv4> ()->SetDown (i);
+}
+
+static void
+SetUp (Ptr<Node> n, uint32_t i)
+{
+  n->GetObject<Ipv4> ()->SetUp (i);
+}
+
+int
+main (int argc, char *argv[])
+{
+  bool precompute = false;
+  uint32_t seed = 1;
+  uint32_t n = 40;
+  bool events = true;
+  bool lanOn = true;
+  CommandLine cmd;
+  cmd.AddValue ("precompute", "", precompute);
+  cmd.AddValue ("seed", "", seed);
+  cmd.AddValue ("n", "", n);
+  cmd.AddValue ("events", "", events);
+  cmd.AddValue ("lan", "", lanOn);
+  cmd.Parse (argc, argv);
+  srand (seed);
+
+  NodeContainer nodes;
+  nodes.Create (n);
+  InternetStackHelper stack;
+  Ipv4NixVectorHelper nix;
+  Ipv4StaticRoutingHelper staticRouting;
+  Ipv4ListRoutingHelper list;
+  list.Add (staticRouting, 0);
+  list.Add (nix, 10);
+  stack.SetRoutingHelper (list);
+  stack.Install (nodes);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  for (uint32_t i = 1; i < n; i++)
+    {
+      uint32_t j = rand () % i;
+      NetDeviceContainer d = p2p.Install (nodes.Get (i), nodes.Get (j));
+      address.Assign (d);
+      address.NewNetwork ();
+    }
+  for (uint32_t k = 0; k < n / 2; k++)
+    {
+      uint32_t i = rand () % n;
+      uint32_t j = rand () % n;
+      if (i == j)
+        {
+          continue;
+        }
+      NetDeviceContainer d = p2p.Install (nodes.Get (i), nodes.Get (j));
+      address.Assign (d);
+      address.NewNetwork ();
+    }
+  CsmaHelper csma;
+  NodeContainer lan;
+  for (uint32_t k = 0; k < (lanOn ? 4 : 0); k++)
+    {
+      lan.Add (nodes.Get (rand () % n));
+    }
+  Ipv4AddressHelper lanAddress;
+  lanAddress.SetBase ("172.16.0.0", "255.255.255.0");
+  if (lanOn)
+    {
+      lanAddress.Assign (csma.Install (lan));
+    }
+
+  std::vector<std::pair<Ptr<Node>, Ipv4Address> > flows;
+  for (uint32_t k = 0; k < 40; k++)
+    {
+      uint32_t s = rand () % n;
+      uint32_t d = rand () % n;
+      Ptr<Ipv4> ipv4 = nodes.Get (d)->GetObject<Ipv4> ();
+      Ipv4Address dest = ipv4->GetAddress (1 + rand () % (ipv4->GetNInterfaces () - 1), 0).GetLocal ();
+      uint16_t port = 9 + k;
+      UdpEchoServerHelper server (port);
+      ApplicationContainer sa = server.Install (nodes.Get (d));
+      sa.Start (Seconds (0.5));
+      UdpEchoClientHelper client (dest, port);
+      client.SetAttribute ("MaxPackets", UintegerValue (8));
+      client.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+      ApplicationContainer ca = client.Install (nodes.Get (s));
+      ca.Start (Seconds (1.0 + 0.01 * k));
+      std::ostringstream oss;
+      oss << "/NodeList/" << s << "/ApplicationList/" << ca.Get (0)->GetNode ()->GetNApplications () - 1 << "/$ns3::UdpEchoClient/Tx";
+      flows.push_back (std::make_pair (nodes.Get (s), dest));
+      Ptr<Ipv4> sipv4 = nodes.Get (s)->GetObject<Ipv4> ();
+      flows.push_back (std::make_pair (nodes.Get (d), sipv4->GetAddress (1, 0).GetLocal ()));
+    }
+  Config::Connect ("/NodeList/*/$ns3::Ipv4L3Protocol/LocalDeliver", MakeCallback (&Rx));
+  for (uint32_t k = 0; k < 3; k++)
+    {
+      Ptr<Node> node = nodes.Get (rand () % n);
+      uint32_t i = 1 + rand () % (node->GetObject<Ipv4> ()->GetNInterfaces () - 1);
+      if (events)
+        {
+          Simulator::Schedule (Seconds (3.5 + k), &SetDown, node, i);
+          Simulator::Schedule (Seconds (7.5), &SetUp, node, i);
+        }
+    }
+  if (false)
+    {
+      ;
+    }
+
+  Ptr<OutputStreamWrapper> out = Create<OutputStreamWrapper> (&std::cout);
+  nix.PrintRoutingTableAllAt (Seconds (3.2), out);
+  nix.PrintRoutingTableAllAt (Seconds (7.2), out);
+  nix.PrintRoutingTableAllAt (Seconds (12.0), out);
+  Simulator::Stop (Seconds (12.5));
+  Simulator::Run ();
+  for (std::map<std::string, uint32_t>::const_iterator i = g_rx.begin (); i != g_rx.end (); i++)
+    {
+      std::cout << i->first << " " << i->second << std::endl;
+    }
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "pcap-replay-helper.h"
+#include "ns3/pcap-replay.h"
+#include "ns3/string.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+
+namespace ns3 {
+
+PcapReplayHelper::PcapReplayHelper (std::string filename)
+{
+  m_factory.SetTypeId ("ns3::PcapReplay");
+  m_factory.Set ("Filename", StringValue (filename));
+}
+
+void
+PcapReplayHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+PcapReplayHelper::Install (Ptr<NetDevice> device) const
+{
+  return ApplicationContainer (InstallPriv (device));
+}
+
+ApplicationContainer
+PcapReplayHelper::Install (NetDeviceContainer c) const
+{
+  ApplicationContainer apps;
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      apps.Add (InstallPriv (*i));
+    }
+
+  return apps;
+}
+
+Ptr<Application>
+PcapReplayHelper::InstallPriv (Ptr<NetDevice> device) const
+{
+  Ptr<PcapReplay> app = m_factory.Create<PcapReplay> ();
+  app->SetDevice (device);
+  device->GetNode ()->AddApplication (app);
+
+  return app;
+}
+
+} // namespace ns3
@@ -0,0 +1,259 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "pcap-replay.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/trace-helper.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapReplay");
+NS_OBJECT_ENSURE_REGISTERED (PcapReplay);
+
+TypeId
+PcapReplay::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapReplay")
+    .SetParent<Application> ()
+    .AddConstructor<PcapReplay> ()
+    .AddAttribute ("Filename",
+                   "The name of the pcap file to replay.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapReplay::m_filename),
+                   MakeStringChecker ())
+    .AddAttribute ("EthernetFcs",
+                   "Whether the records of an Ethernet capture end with a frame check sequence.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PcapReplay::m_ethernetFcs),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Tx", "A packet is injected into the device, without its link-layer header.",
+                     MakeTraceSourceAccessor (&PcapReplay::m_txTrace))
+  ;
+  return tid;
+}
+
+PcapReplay::PcapReplay ()
+  : m_ethernetFcs (true),
+    m_device (0),
+    m_firstTimestamp (0),
+    m_sent (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapReplay::~PcapReplay ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PcapReplay::SetDevice (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  m_device = device;
+}
+
+uint32_t
+PcapReplay::GetSent (void) const
+{
+  return m_sent;
+}
+
+void
+PcapReplay::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Close ();
+  m_device = 0;
+  Application::DoDispose ();
+}
+
+void
+PcapReplay::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_device == 0)
+    {
+      NS_FATAL_ERROR ("PcapReplay: no device to replay " << m_filename << " into");
+    }
+  if (!m_file.Open (m_filename))
+    {
+      NS_FATAL_ERROR ("PcapReplay: unable to open " << m_filename);
+    }
+  uint32_t type = m_file.GetDataLinkType ();
+  if (type != PcapHelper::DLT_EN10MB && type != PcapHelper::DLT_PPP
+      && type != PcapHelper::DLT_RAW)
+    {
+      NS_FATAL_ERROR ("PcapReplay: unsupported data link type " << type << " in " << m_filename);
+    }
+  m_current = m_file.Begin ();
+  if (m_current == m_file.End ())
+    {
+      return;
+    }
+  m_firstTimestamp = GetTimestamp (*m_current);
+  m_started = Simulator::Now ();
+  m_sendEvent = Simulator::ScheduleNow (&PcapReplay::Send, this);
+}
+
+void
+PcapReplay::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sendEvent);
+  m_file.Close ();
+}
+
+int64_t
+PcapReplay::GetTimestamp (PcapMappedFile::Record const &record) const
+{
+  int64_t subsecond = record.GetTsUsec ();
+  if (!m_file.IsNanosecond ())
+    {
+      subsecond *= 1000;
+    }
+  return record.GetTsSec () * (int64_t)1000000000 + subsecond;
+}
+
+void
+PcapReplay::ScheduleNext (void)
+{
+  if (m_current == m_file.End ())
+    {
+      if (m_current.IsTruncated ())
+        {
+          NS_LOG_WARN ("Truncated record at the end of " << m_filename);
+        }
+      return;
+    }
+  Time at = m_started + NanoSeconds (GetTimestamp (*m_current) - m_firstTimestamp);
+  // records out of order in the capture are sent immediately.
+  Time delay = Max (at - Simulator::Now (), Seconds (0));
+  m_sendEvent = Simulator::Schedule (delay, &PcapReplay::Send, this);
+}
+
+void
+PcapReplay::Send (void)
+{
+  NS_LOG_FUNCTION (this);
+  PcapMappedFile::Record const &record = *m_current;
+  Ptr<Packet> p = Create<Packet> (record.GetData (), record.GetInclLen ());
+  uint16_t protocol = 0;
+  Address source = m_device->GetAddress ();
+  Address destination = m_device->GetBroadcast ();
+  bool valid = true;
+
+  switch (m_file.GetDataLinkType ())
+    {
+    case PcapHelper::DLT_EN10MB:
+      {
+        EthernetHeader header (false);
+        EthernetTrailer trailer;
+        uint32_t overhead = header.GetSerializedSize ();
+        if (m_ethernetFcs)
+          {
+            overhead += trailer.GetSerializedSize ();
+          }
+        if (p->GetSize () < overhead)
+          {
+            valid = false;
+            break;
+          }
+        p->RemoveHeader (header);
+        if (m_ethernetFcs)
+          {
+            p->RemoveTrailer (trailer);
+          }
+        source = header.GetSource ();
+        destination = header.GetDestination ();
+        protocol = header.GetLengthType ();
+        if (protocol <= 1500)
+          {
+            // 802.3 frame: the protocol is in the LLC/SNAP header.
+            LlcSnapHeader llc;
+            if (p->GetSize () < llc.GetSerializedSize ())
+              {
+                valid = false;
+                break;
+              }
+            p->RemoveHeader (llc);
+            protocol = llc.GetType ();
+          }
+        break;
+      }
+    case PcapHelper::DLT_PPP:
+      {
+        uint8_t buffer[2];
+        if (p->CopyData (buffer, 2) != 2)
+          {
+            valid = false;
+            break;
+          }
+        p->RemoveAtStart (2);
+        uint16_t ppp = (buffer[0] << 8) | buffer[1];
+        protocol = ppp == 0x0021 ? 0x0800 : ppp == 0x0057 ? 0x86DD : 0;
+        valid = protocol != 0;
+        break;
+      }
+    case PcapHelper::DLT_RAW:
+      {
+        uint8_t version;
+        if (p->CopyData (&version, 1) != 1)
+          {
+            valid = false;
+            break;
+          }
+        version >>= 4;
+        protocol = version == 4 ? 0x0800 : version == 6 ? 0x86DD : 0;
+        valid = protocol != 0;
+        break;
+      }
+    default:
+      NS_ASSERT (false);
+      break;
+    }
+
+  if (valid)
+    {
+      m_txTrace (p);
+      if (m_device->SupportsSendFrom ())
+        {
+          m_device->SendFrom (p, source, destination, protocol);
+        }
+      else
+        {
+          m_device->Send (p, destination, protocol);
+        }
+      m_sent++;
+    }
+  else
+    {
+      NS_LOG_WARN ("Skipping invalid record at " << record.GetTsSec () << "." << record.GetTsUsec ());
+    }
+  ++m_current;
+  ScheduleNext ();
+}
+
+} // namespace ns3
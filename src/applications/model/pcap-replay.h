@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PCAP_REPLAY_H
+#define PCAP_REPLAY_H
+
+#include "ns3/application.h"
+#include "ns3/traced-callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/pcap-mapped-file.h"
+#include <string>
+
+namespace ns3 {
+
+class NetDevice;
+class Packet;
+
+/**
+ * \ingroup applications
+ * \brief an application which injects the packets recorded in a pcap
+ *        file into a NetDevice.
+ *
+ * The first record of the file is sent when the application starts
+ * and each following record is sent at the same offset from the first
+ * one as in the capture. The file is mapped in memory and read one
+ * record at a time, so that captures of any size can be replayed.
+ *
+ * The link-layer header of each record is removed and the payload is
+ * handed to NetDevice::SendFrom (or NetDevice::Send when the device
+ * does not support SendFrom). The supported data link types are
+ * Ethernet (DLT_EN10MB), PPP (DLT_PPP) and raw IP (DLT_RAW): the
+ * records of the last two are sent to the broadcast address of the
+ * device. The Ethernet records are expected to end with the frame
+ * check sequence, as in the captures of CsmaNetDevice: it is removed
+ * too, unless the EthernetFcs attribute is false.
+ */
+class PcapReplay : public Application
+{
+public:
+  static TypeId GetTypeId (void);
+
+  PcapReplay ();
+  virtual ~PcapReplay ();
+
+  /**
+   * \param device the device to inject the packets into. It must
+   *        belong to the node of this application.
+   */
+  void SetDevice (Ptr<NetDevice> device);
+  /**
+   * \returns the number of records sent so far.
+   */
+  uint32_t GetSent (void) const;
+
+private:
+  // inherited from Application base class.
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+  virtual void DoDispose (void);
+
+  void ScheduleNext (void);
+  void Send (void);
+  int64_t GetTimestamp (PcapMappedFile::Record const &record) const;
+
+  /// Name of the pcap file to replay
+  std::string m_filename;
+  /// True if the Ethernet records end with a frame check sequence
+  bool m_ethernetFcs;
+  Ptr<NetDevice> m_device;
+  PcapMappedFile m_file;
+  /// The next record to send
+  PcapMappedFile::Iterator m_current;
+  /// Timestamp of the first record, in nanoseconds
+  int64_t m_firstTimestamp;
+  /// Time at which the first record was sent
+  Time m_started;
+  EventId m_sendEvent;
+  uint32_t m_sent;
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_H */
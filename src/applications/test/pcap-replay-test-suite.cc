@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <vector>
+#include "ns3/pcap-replay-helper.h"
+#include "ns3/pcap-replay.h"
+#include "ns3/pcap-file.h"
+#include "ns3/trace-helper.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/boolean.h"
+#include "ns3/mac48-address.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * Test that the records of an Ethernet pcap file are received by the
+ * peer of the device they are injected into, at the recorded times,
+ * without their frame check sequence when the capture has one.
+ */
+class PcapReplayTestCase : public TestCase
+{
+public:
+  PcapReplayTestCase (bool fcs);
+
+private:
+  virtual void DoRun (void);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  std::vector<Time> m_times;
+  std::vector<uint32_t> m_sizes;
+  std::vector<uint16_t> m_protocols;
+  bool m_fcs;
+};
+
+PcapReplayTestCase::PcapReplayTestCase (bool fcs)
+  : TestCase (fcs ? "Test that the packets of a pcap file with FCS are injected at the recorded times"
+              : "Test that the packets of a pcap file are injected at the recorded times"),
+    m_fcs (fcs)
+{
+}
+
+bool
+PcapReplayTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_times.push_back (Simulator::Now ());
+  m_sizes.push_back (p->GetSize ());
+  m_protocols.push_back (protocol);
+  return true;
+}
+
+void
+PcapReplayTestCase::DoRun (void)
+{
+  const uint32_t nRecords = 3;
+  uint32_t tsSec[nRecords] = { 100, 100, 101 };
+  uint32_t tsUsec[nRecords] = { 0, 500000, 250000 };
+  uint16_t protocols[nRecords] = { 0x0800, 0x0806, 0x86DD };
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  txDev->SetAddress (Mac48Address::Allocate ());
+  rxDev->SetAddress (Mac48Address::Allocate ());
+
+  std::string filename = CreateTempDirFilename ("replay.pcap");
+  PcapFile file;
+  file.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (file.Fail (), false, "Open (" << filename << ") returns error");
+  file.Init (PcapHelper::DLT_EN10MB);
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      EthernetHeader header (false);
+      header.SetSource (Mac48Address::ConvertFrom (txDev->GetAddress ()));
+      header.SetDestination (Mac48Address::ConvertFrom (rxDev->GetAddress ()));
+      header.SetLengthType (protocols[i]);
+      Ptr<Packet> p = Create<Packet> (100 + i);
+      if (m_fcs)
+        {
+          EthernetTrailer trailer;
+          p->AddTrailer (trailer);
+        }
+      file.Write (tsSec[i], tsUsec[i], header, p);
+    }
+  file.Close ();
+
+  NodeContainer n;
+  n.Create (2);
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  txDev->SetChannel (channel);
+  rxDev->SetChannel (channel);
+  rxDev->SetReceiveCallback (MakeCallback (&PcapReplayTestCase::Receive, this));
+
+  PcapReplayHelper helper (filename);
+  helper.SetAttribute ("EthernetFcs", BooleanValue (m_fcs));
+  ApplicationContainer apps = helper.Install (txDev);
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<PcapReplay> (apps.Get (0))->GetSent (), nRecords, "Not all the records were sent");
+  NS_TEST_ASSERT_MSG_EQ (m_times.size (), nRecords, "Not all the records were received");
+  for (uint32_t i = 0; i < nRecords; ++i)
+    {
+      Time expected = Seconds (1.0 + tsSec[i] - tsSec[0]) + MicroSeconds (tsUsec[i]);
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], expected, "Record " << i << " received at the wrong time");
+      NS_TEST_EXPECT_MSG_EQ (m_sizes[i], 100 + i, "Record " << i << " received with the wrong size");
+      NS_TEST_EXPECT_MSG_EQ (m_protocols[i], protocols[i], "Record " << i << " received with the wrong protocol");
+    }
+
+  Simulator::Destroy ();
+  remove (filename.c_str ());
+}
+
+class PcapReplayTestSuite : public TestSuite
+{
+public:
+  PcapReplayTestSuite ();
+};
+
+PcapReplayTestSuite::PcapReplayTestSuite ()
+  : TestSuite ("pcap-replay", UNIT)
+{
+  AddTestCase (new PcapReplayTestCase (false), TestCase::QUICK);
+  AddTestCase (new PcapReplayTestCase (true), TestCase::QUICK);
+}
+
+static PcapReplayTestSuite pcapReplayTestSuite;
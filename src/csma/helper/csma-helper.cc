@@ -87,6 +87,7 @@ CsmaHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool prom
     }
 
   PcapHelper pcapHelper;
+  pcapHelper.SetTraceFilter (m_pcapFilter);
 
   std::string filename;
   if (explicitFilename)
@@ -149,6 +150,7 @@ CsmaHelper::EnableAsciiInternal (
       // name of the file given the prefix.
       //
       AsciiTraceHelper asciiTraceHelper;
+      asciiTraceHelper.SetTraceFilter (m_asciiFilter);
 
       std::string filename;
       if (explicitFilename)
@@ -25,6 +25,7 @@
 #include "ns3/ethernet-trailer.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/error-model.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/enum.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
@@ -491,6 +492,12 @@ CsmaNetDevice::TransmitStart (void)
           m_phyTxBeginTrace (m_currentPkt);
 
           Time tEvent = Seconds (m_bps.CalculateTxTime (m_currentPkt->GetSize ()));
+          SegmentOffloadTag offload;
+          if (m_currentPkt->PeekPacketTag (offload))
+            { // Transmit all the frames the offloaded packet stands for
+              tEvent = Seconds (m_bps.CalculateTxTime (offload.GetWireSize (m_currentPkt->GetSize ())))
+                + TimeStep (m_tInterframeGap.GetTimeStep () * (offload.GetNPackets () - 1));
+            }
           NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.GetSeconds () << "sec");
           Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
@@ -1014,6 +1021,13 @@ CsmaNetDevice::SupportsSendFrom () const
   return true;
 }
 
+bool
+CsmaNetDevice::SupportsSegmentOffload () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return true;
+}
+
 int64_t
 CsmaNetDevice::AssignStreams (int64_t stream)
 {
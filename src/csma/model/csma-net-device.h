@@ -320,6 +320,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentOffload (void) const;
 
  /**
   * Assign a fixed random variable stream number to the random variables
@@ -80,6 +80,7 @@ EmuHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promi
     }
 
   PcapHelper pcapHelper;
+  pcapHelper.SetTraceFilter (m_pcapFilter);
 
   std::string filename;
   if (explicitFilename)
@@ -141,6 +142,7 @@ EmuHelper::EnableAsciiInternal (
       // name of the file given the prefix.
       //
       AsciiTraceHelper asciiTraceHelper;
+      asciiTraceHelper.SetTraceFilter (m_asciiFilter);
 
       std::string filename;
       if (explicitFilename)
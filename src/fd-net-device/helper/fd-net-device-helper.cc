@@ -65,6 +65,7 @@ FdNetDeviceHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
     }
 
   PcapHelper pcapHelper;
+  pcapHelper.SetTraceFilter (m_pcapFilter);
 
   std::string filename;
   if (explicitFilename)
@@ -126,6 +127,7 @@ FdNetDeviceHelper::EnableAsciiInternal (
       // name of the file given the prefix.
       //
       AsciiTraceHelper asciiTraceHelper;
+      asciiTraceHelper.SetTraceFilter (m_asciiFilter);
 
       std::string filename;
       if (explicitFilename)
@@ -0,0 +1,432 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fluid-traffic-model.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include <limits>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("FluidTrafficModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (FluidTrafficModel);
+
+/// The maximum number of hops of the route of a flow.
+static const uint32_t FLUID_MAX_HOPS = 255;
+
+TypeId
+FluidTrafficModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FluidTrafficModel")
+    .SetParent<Object> ()
+    .AddConstructor<FluidTrafficModel> ()
+    .AddAttribute ("Sharing",
+                   "How the flows share the capacity of the links.",
+                   EnumValue (MAX_MIN),
+                   MakeEnumAccessor (&FluidTrafficModel::m_sharing),
+                   MakeEnumChecker (MAX_MIN, "MaxMin",
+                                    TCP, "Tcp"))
+    .AddAttribute ("MaxUtilization",
+                   "The fraction of the data rate of a link the flows can use, lower than 1 "
+                   "so that the packets of the link are transmitted.",
+                   DoubleValue (0.95),
+                   MakeDoubleAccessor (&FluidTrafficModel::m_maxUtilization),
+                   MakeDoubleChecker<double> (0.0, 1.0 - std::numeric_limits<double>::epsilon ()))
+    .AddTraceSource ("FlowCompleted",
+                     "A flow has transferred all its bytes.",
+                     MakeTraceSourceAccessor (&FluidTrafficModel::m_flowCompletedTrace))
+  ;
+  return tid;
+}
+
+FluidTrafficModel::FluidTrafficModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FluidTrafficModel::~FluidTrafficModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FluidTrafficModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_completionEvent.Cancel ();
+  // the devices may outlive the model: they get their whole data rate back
+  for (std::vector<Link>::iterator l = m_links.begin (); l != m_links.end (); l++)
+    {
+      l->device->SetBackgroundDataRate (DataRate (0));
+    }
+  m_flows.clear ();
+  m_links.clear ();
+  m_linkIndexes.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+FluidTrafficModel::AddFlow (Ptr<Node> source, Ipv4Address destination, uint64_t size,
+                            DataRate maxRate, Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << source << destination << size << maxRate << start << stop);
+  NS_ABORT_MSG_IF (start < Simulator::Now (), "A flow cannot start in the past");
+  NS_ABORT_MSG_IF (!stop.IsZero () && stop <= start, "A flow must stop after it starts");
+
+  Flow flow;
+  flow.source = source;
+  flow.destination = destination;
+  flow.size = size;
+  flow.maxRate = maxRate.GetBitRate ();
+  flow.active = false;
+  flow.finished = false;
+  flow.rate = 0;
+  flow.bits = 0;
+  uint32_t flowId = m_flows.size ();
+  m_flows.push_back (flow);
+
+  Simulator::Schedule (start - Simulator::Now (), &FluidTrafficModel::StartFlow, this, flowId);
+  if (!stop.IsZero ())
+    {
+      Simulator::Schedule (stop - Simulator::Now (), &FluidTrafficModel::StopFlow, this, flowId);
+    }
+  return flowId;
+}
+
+DataRate
+FluidTrafficModel::GetFlowRate (uint32_t flowId) const
+{
+  NS_ASSERT (flowId < m_flows.size ());
+  return DataRate (static_cast<uint64_t> (m_flows[flowId].rate));
+}
+
+uint64_t
+FluidTrafficModel::GetFlowBytes (uint32_t flowId) const
+{
+  NS_ASSERT (flowId < m_flows.size ());
+  Flow const &flow = m_flows[flowId];
+  double bits = flow.bits;
+  if (flow.active)
+    {
+      bits += flow.rate * (Simulator::Now () - m_lastUpdate).GetSeconds ();
+    }
+  uint64_t bytes = static_cast<uint64_t> (bits / 8);
+  if (flow.size != 0)
+    {
+      bytes = std::min (bytes, flow.size);
+    }
+  return bytes;
+}
+
+bool
+FluidTrafficModel::IsFlowActive (uint32_t flowId) const
+{
+  NS_ASSERT (flowId < m_flows.size ());
+  return m_flows[flowId].active;
+}
+
+DataRate
+FluidTrafficModel::GetLinkLoad (Ptr<PointToPointNetDevice> device) const
+{
+  std::map<Ptr<PointToPointNetDevice>, uint32_t>::const_iterator it = m_linkIndexes.find (device);
+  if (it == m_linkIndexes.end ())
+    {
+      return DataRate (0);
+    }
+  return DataRate (static_cast<uint64_t> (m_links[it->second].load));
+}
+
+void
+FluidTrafficModel::StartFlow (uint32_t flowId)
+{
+  NS_LOG_FUNCTION (this << flowId);
+  Advance ();
+  Flow &flow = m_flows[flowId];
+  ComputeRoute (flow);
+  if (flow.links.empty () && flow.maxRate == 0)
+    {
+      NS_FATAL_ERROR ("The flow from node " << flow.source->GetId () << " to " << flow.destination <<
+                      " crosses no point-to-point link and has no maximum rate");
+    }
+  flow.active = true;
+  Update ();
+}
+
+void
+FluidTrafficModel::StopFlow (uint32_t flowId)
+{
+  NS_LOG_FUNCTION (this << flowId);
+  if (!m_flows[flowId].active)
+    {
+      return;
+    }
+  Advance ();
+  m_flows[flowId].active = false;
+  m_flows[flowId].finished = true;
+  Update ();
+}
+
+void
+FluidTrafficModel::CompleteFlows (void)
+{
+  NS_LOG_FUNCTION (this);
+  Advance ();
+  std::vector<uint32_t> completed;
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      Flow &flow = m_flows[i];
+      // the completion event is scheduled one time step late, which
+      // rounds the bits up.
+      if (flow.active && flow.size != 0 && flow.bits + 1e-3 >= flow.size * 8.0)
+        {
+          NS_LOG_LOGIC ("Flow " << i << " completed");
+          flow.bits = flow.size * 8.0;
+          flow.active = false;
+          flow.finished = true;
+          completed.push_back (i);
+        }
+    }
+  Update ();
+  for (std::vector<uint32_t>::const_iterator i = completed.begin (); i != completed.end (); i++)
+    {
+      m_flowCompletedTrace (*i);
+    }
+}
+
+void
+FluidTrafficModel::ComputeRoute (Flow &flow)
+{
+  NS_LOG_FUNCTION (this << flow.source << flow.destination);
+  flow.links.clear ();
+  Time delay = Seconds (0);
+  Ptr<Node> node = flow.source;
+  for (uint32_t hops = 0; ; hops++)
+    {
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      NS_ABORT_MSG_IF (ipv4 == 0, "Node " << node->GetId () << " has no IPv4 stack");
+      if (ipv4->GetInterfaceForAddress (flow.destination) != -1)
+        {
+          break;
+        }
+      NS_ABORT_MSG_IF (hops == FLUID_MAX_HOPS, "The route from node " << flow.source->GetId () <<
+                       " to " << flow.destination << " loops");
+
+      Ipv4Header header;
+      header.SetDestination (flow.destination);
+      Socket::SocketErrno sockerr;
+      Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, sockerr);
+      NS_ABORT_MSG_IF (route == 0, "Node " << node->GetId () << " has no route to " << flow.destination);
+      Ptr<NetDevice> device = route->GetOutputDevice ();
+      Ipv4Address nextHop = route->GetGateway ();
+      if (nextHop == Ipv4Address::GetZero ())
+        {
+          nextHop = flow.destination;
+        }
+
+      Ptr<PointToPointNetDevice> p2pDevice = DynamicCast<PointToPointNetDevice> (device);
+      if (p2pDevice != 0)
+        {
+          flow.links.push_back (GetLinkIndex (p2pDevice));
+          TimeValue channelDelay;
+          p2pDevice->GetChannel ()->GetAttribute ("Delay", channelDelay);
+          delay += channelDelay.Get ();
+        }
+
+      Ptr<Channel> channel = device->GetChannel ();
+      Ptr<Node> next = 0;
+      for (uint32_t i = 0; channel != 0 && i < channel->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> peer = channel->GetDevice (i);
+          Ptr<Ipv4> peerIpv4 = peer->GetNode ()->GetObject<Ipv4> ();
+          if (peer != device && peerIpv4 != 0 && peerIpv4->GetInterfaceForAddress (nextHop) != -1)
+            {
+              next = peer->GetNode ();
+              break;
+            }
+        }
+      NS_ABORT_MSG_IF (next == 0, "No node of the channel of node " << node->GetId () << " has the address " << nextHop);
+      node = next;
+    }
+  flow.rtt = delay + delay;
+  NS_LOG_LOGIC ("Route of " << flow.links.size () << " point-to-point links, rtt " << flow.rtt);
+}
+
+uint32_t
+FluidTrafficModel::GetLinkIndex (Ptr<PointToPointNetDevice> device)
+{
+  std::map<Ptr<PointToPointNetDevice>, uint32_t>::const_iterator it = m_linkIndexes.find (device);
+  if (it != m_linkIndexes.end ())
+    {
+      return it->second;
+    }
+  Link link;
+  link.device = device;
+  link.load = 0;
+  m_links.push_back (link);
+  m_linkIndexes[device] = m_links.size () - 1;
+  return m_links.size () - 1;
+}
+
+void
+FluidTrafficModel::Advance (void)
+{
+  double elapsed = (Simulator::Now () - m_lastUpdate).GetSeconds ();
+  for (std::vector<Flow>::iterator i = m_flows.begin (); i != m_flows.end (); i++)
+    {
+      if (i->active)
+        {
+          i->bits += i->rate * elapsed;
+        }
+    }
+  m_lastUpdate = Simulator::Now ();
+}
+
+void
+FluidTrafficModel::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Progressive filling: the rates of all the flows which are not
+  // limited yet grow together, in proportion of their weights, until a
+  // flow reaches its maximum rate or a link is full, which limits the
+  // flows which cross it.
+  std::vector<double> capacity (m_links.size ());
+  std::vector<double> linkWeight (m_links.size (), 0);
+  std::vector<uint32_t> linkFlows (m_links.size (), 0);
+  for (uint32_t l = 0; l < m_links.size (); l++)
+    {
+      capacity[l] = m_links[l].device->GetDataRate ().GetBitRate () * m_maxUtilization;
+    }
+  std::vector<double> weight (m_flows.size (), 0);
+  std::vector<uint32_t> growing;
+  for (uint32_t i = 0; i < m_flows.size (); i++)
+    {
+      Flow &flow = m_flows[i];
+      flow.rate = 0;
+      if (!flow.active)
+        {
+          continue;
+        }
+      weight[i] = 1;
+      if (m_sharing == TCP)
+        {
+          weight[i] = 1 / std::max (flow.rtt.GetSeconds (), 1e-6);
+        }
+      growing.push_back (i);
+      for (std::vector<uint32_t>::const_iterator l = flow.links.begin (); l != flow.links.end (); l++)
+        {
+          linkWeight[*l] += weight[i];
+          linkFlows[*l]++;
+        }
+    }
+
+  while (!growing.empty ())
+    {
+      double increment = std::numeric_limits<double>::max ();
+      for (uint32_t l = 0; l < m_links.size (); l++)
+        {
+          if (linkFlows[l] != 0)
+            {
+              increment = std::min (increment, capacity[l] / linkWeight[l]);
+            }
+        }
+      for (std::vector<uint32_t>::const_iterator i = growing.begin (); i != growing.end (); i++)
+        {
+          Flow const &flow = m_flows[*i];
+          if (flow.maxRate != 0)
+            {
+              increment = std::min (increment, (flow.maxRate - flow.rate) / weight[*i]);
+            }
+        }
+      increment = std::max (increment, 0.0);
+
+      for (std::vector<uint32_t>::const_iterator i = growing.begin (); i != growing.end (); i++)
+        {
+          m_flows[*i].rate += increment * weight[*i];
+        }
+      for (uint32_t l = 0; l < m_links.size (); l++)
+        {
+          capacity[l] -= increment * linkWeight[l];
+        }
+
+      std::vector<uint32_t> stillGrowing;
+      for (std::vector<uint32_t>::const_iterator i = growing.begin (); i != growing.end (); i++)
+        {
+          Flow &flow = m_flows[*i];
+          bool limited = flow.maxRate != 0 && flow.rate >= flow.maxRate * (1 - 1e-9);
+          for (std::vector<uint32_t>::const_iterator l = flow.links.begin (); l != flow.links.end (); l++)
+            {
+              limited = limited || capacity[*l] <= m_links[*l].device->GetDataRate ().GetBitRate () * 1e-9;
+            }
+          if (!limited)
+            {
+              stillGrowing.push_back (*i);
+              continue;
+            }
+          for (std::vector<uint32_t>::const_iterator l = flow.links.begin (); l != flow.links.end (); l++)
+            {
+              linkWeight[*l] -= weight[*i];
+              linkFlows[*l]--;
+            }
+        }
+      growing.swap (stillGrowing);
+    }
+
+  for (std::vector<Link>::iterator l = m_links.begin (); l != m_links.end (); l++)
+    {
+      l->load = 0;
+    }
+  for (std::vector<Flow>::const_iterator i = m_flows.begin (); i != m_flows.end (); i++)
+    {
+      for (std::vector<uint32_t>::const_iterator l = i->links.begin (); i->active && l != i->links.end (); l++)
+        {
+          m_links[*l].load += i->rate;
+        }
+    }
+  for (std::vector<Link>::iterator l = m_links.begin (); l != m_links.end (); l++)
+    {
+      l->device->SetBackgroundDataRate (DataRate (static_cast<uint64_t> (l->load)));
+    }
+
+  m_completionEvent.Cancel ();
+  double next = std::numeric_limits<double>::max ();
+  for (std::vector<Flow>::const_iterator i = m_flows.begin (); i != m_flows.end (); i++)
+    {
+      if (i->active && i->size != 0 && i->rate > 0)
+        {
+          next = std::min (next, (i->size * 8.0 - i->bits) / i->rate);
+        }
+    }
+  if (next != std::numeric_limits<double>::max ())
+    {
+      m_completionEvent = Simulator::Schedule (Seconds (std::max (next, 0.0)) + TimeStep (1),
+                                               &FluidTrafficModel::CompleteFlows, this);
+    }
+}
+
+} // namespace ns3
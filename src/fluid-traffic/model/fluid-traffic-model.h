@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLUID_TRAFFIC_MODEL_H
+#define FLUID_TRAFFIC_MODEL_H
+
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/node.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class PointToPointNetDevice;
+
+/**
+ * \defgroup fluid-traffic Fluid traffic
+ *
+ * Flow-level background traffic, whose flows are rates instead of packets.
+ */
+
+/**
+ * \ingroup fluid-traffic
+ *
+ * \brief A flow-level (fluid) model of background traffic.
+ *
+ * The flows of the model are not made of packets: each flow has a rate,
+ * which the model computes from the rates of all the flows sharing the
+ * point-to-point links of its route, and updates only when a flow starts,
+ * stops or completes. The route of a flow is the route of the IPv4
+ * routing protocols of the nodes (e.g. the global routing) when the flow
+ * starts; the links of other types do not limit the flows.
+ *
+ * The model gives the load of the background flows on every
+ * point-to-point link to the transmitting PointToPointNetDevice, which
+ * transmits its packets at the residual rate: the packet-level traffic
+ * sees the queueing delay of a loaded link without any per-packet
+ * background event. The packet-level traffic does not slow the
+ * background flows down.
+ *
+ * The flows share a link either with max-min fairness, or as TCP flows
+ * whose rate is inversely proportional to their round trip time, which is
+ * computed from the propagation delays of the links of the route.
+ */
+class FluidTrafficModel : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * How the flows share the capacity of the links.
+   */
+  enum Sharing
+  {
+    MAX_MIN, /**< max-min fair sharing */
+    TCP      /**< weighted max-min sharing, with weights inversely proportional to the round trip time */
+  };
+
+  FluidTrafficModel ();
+  virtual ~FluidTrafficModel ();
+
+  /**
+   * \brief Add a flow to the model.
+   *
+   * \param source the node the flow starts from
+   * \param destination the IPv4 address of the destination of the flow
+   * \param size the number of bytes the flow transfers before it
+   *        completes, or 0 for a flow which transfers until it stops
+   * \param maxRate the maximum rate of the flow, or 0 for a flow limited
+   *        only by the links
+   * \param start the time the flow starts at
+   * \param stop the time the flow stops at if it has not completed
+   *        before, or 0 for a flow which does not stop
+   * \returns the identifier of the flow
+   */
+  uint32_t AddFlow (Ptr<Node> source, Ipv4Address destination, uint64_t size,
+                    DataRate maxRate, Time start, Time stop);
+
+  /**
+   * \param flowId the identifier of the flow
+   * \returns the current rate of the flow, 0 if it is not active
+   */
+  DataRate GetFlowRate (uint32_t flowId) const;
+
+  /**
+   * \param flowId the identifier of the flow
+   * \returns the number of bytes the flow has transferred so far
+   */
+  uint64_t GetFlowBytes (uint32_t flowId) const;
+
+  /**
+   * \param flowId the identifier of the flow
+   * \returns true if the flow has started and neither stopped nor
+   *          completed
+   */
+  bool IsFlowActive (uint32_t flowId) const;
+
+  /**
+   * \param device the transmitting device of a point-to-point link
+   * \returns the rate of the background flows on the link
+   */
+  DataRate GetLinkLoad (Ptr<PointToPointNetDevice> device) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * A flow of the model.
+   */
+  struct Flow
+  {
+    Ptr<Node> source;
+    Ipv4Address destination;
+    uint64_t size;
+    double maxRate;                 //!< the maximum rate, in bit/s, 0 if none
+    bool active;
+    bool finished;
+    std::vector<uint32_t> links;    //!< the indexes of the links of the route
+    Time rtt;
+    double rate;                    //!< the current rate, in bit/s
+    double bits;                    //!< the number of bits transferred
+  };
+
+  /**
+   * A point-to-point link, in the direction of its transmitting device.
+   */
+  struct Link
+  {
+    Ptr<PointToPointNetDevice> device;
+    double load;                    //!< the rate of the flows, in bit/s
+  };
+
+  void StartFlow (uint32_t flowId);
+  void StopFlow (uint32_t flowId);
+  void CompleteFlows (void);
+  /**
+   * Compute the route of a flow and its round trip time.
+   */
+  void ComputeRoute (Flow &flow);
+  /**
+   * \returns the index of the link of the device, added if it is new.
+   */
+  uint32_t GetLinkIndex (Ptr<PointToPointNetDevice> device);
+  /**
+   * Account the bits the active flows have transferred since the last
+   * update.
+   */
+  void Advance (void);
+  /**
+   * Compute the rates of the active flows, give the loads to the devices
+   * and schedule the next completion of a flow.
+   */
+  void Update (void);
+
+  std::vector<Flow> m_flows;
+  std::vector<Link> m_links;
+  std::map<Ptr<PointToPointNetDevice>, uint32_t> m_linkIndexes;
+  Time m_lastUpdate;
+  EventId m_completionEvent;
+  enum Sharing m_sharing;
+  double m_maxUtilization;
+  TracedCallback<uint32_t> m_flowCompletedTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLUID_TRAFFIC_MODEL_H */
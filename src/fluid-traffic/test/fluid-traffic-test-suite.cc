@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/fluid-traffic-model.h"
+
+using namespace ns3;
+
+/**
+ * Connect two nodes with a point-to-point link, and give them addresses.
+ */
+static NetDeviceContainer
+Connect (Ptr<Node> a, Ptr<Node> b, std::string dataRate, std::string delay, Ipv4AddressHelper &address)
+{
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  p2p.SetChannelAttribute ("Delay", StringValue (delay));
+  NetDeviceContainer devices = p2p.Install (a, b);
+  address.Assign (devices);
+  address.NewNetwork ();
+  return devices;
+}
+
+static double
+GetLinkBitRate (NetDeviceContainer devices, uint32_t i)
+{
+  return DynamicCast<PointToPointNetDevice> (devices.Get (i))->GetBackgroundDataRate ().GetBitRate ();
+}
+
+// ===========================================================================
+// Max-min sharing of a line A - B - C, where the flows A -> C and B -> C
+// share the link B -> C, and the flow A -> B takes what A -> C leaves of
+// the link A -> B.
+// ===========================================================================
+class FluidTrafficMaxMinTestCase : public TestCase
+{
+public:
+  FluidTrafficMaxMinTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Check (Ptr<FluidTrafficModel> model, double ac, double bc, double ab);
+
+  NetDeviceContainer m_ab;
+  NetDeviceContainer m_bc;
+};
+
+FluidTrafficMaxMinTestCase::FluidTrafficMaxMinTestCase ()
+  : TestCase ("Check the max-min sharing of the links, and the load of the devices")
+{
+}
+
+void
+FluidTrafficMaxMinTestCase::Check (Ptr<FluidTrafficModel> model, double ac, double bc, double ab)
+{
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowRate (0).GetBitRate (), ac, 1, "Wrong rate of the flow A -> C");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowRate (1).GetBitRate (), bc, 1, "Wrong rate of the flow B -> C");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowRate (2).GetBitRate (), ab, 1, "Wrong rate of the flow A -> B");
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetLinkBitRate (m_ab, 0), ac + ab, 1, "Wrong load of the link A -> B");
+  NS_TEST_ASSERT_MSG_EQ_TOL (GetLinkBitRate (m_bc, 0), ac + bc, 1, "Wrong load of the link B -> C");
+  NS_TEST_ASSERT_MSG_EQ (GetLinkBitRate (m_ab, 1), 0, "The link B -> A is loaded");
+}
+
+void
+FluidTrafficMaxMinTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  m_ab = Connect (nodes.Get (0), nodes.Get (1), "10Mbps", "1ms", address);
+  m_bc = Connect (nodes.Get (1), nodes.Get (2), "4Mbps", "1ms", address);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // half the data rates: 5 Mbps from A to B, 2 Mbps from B to C
+  Ptr<FluidTrafficModel> model = CreateObject<FluidTrafficModel> ();
+  model->SetAttribute ("MaxUtilization", DoubleValue (0.5));
+  model->AddFlow (nodes.Get (0), Ipv4Address ("10.1.2.2"), 0, DataRate (0), Seconds (1), Seconds (0));
+  model->AddFlow (nodes.Get (1), Ipv4Address ("10.1.2.2"), 0, DataRate (0), Seconds (1), Seconds (2));
+  model->AddFlow (nodes.Get (0), Ipv4Address ("10.1.1.2"), 0, DataRate (0), Seconds (1), Seconds (0));
+
+  Simulator::Schedule (Seconds (1.5), &FluidTrafficMaxMinTestCase::Check, this, model, 1e6, 1e6, 4e6);
+  // once B -> C stops, A -> C takes the whole link B -> C
+  Simulator::Schedule (Seconds (2.5), &FluidTrafficMaxMinTestCase::Check, this, model, 2e6, 0, 3e6);
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (model->IsFlowActive (0), true, "The flow A -> C is not active");
+  NS_TEST_ASSERT_MSG_EQ (model->IsFlowActive (1), false, "The flow B -> C did not stop");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowBytes (0), 375000, 1, "Wrong number of bytes of the flow A -> C");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowBytes (1), 125000, 1, "Wrong number of bytes of the flow B -> C");
+
+  model->Dispose ();
+  NS_TEST_ASSERT_MSG_EQ (GetLinkBitRate (m_ab, 0), 0, "The link A -> B is still loaded once the model is disposed of");
+  NS_TEST_ASSERT_MSG_EQ (GetLinkBitRate (m_bc, 0), 0, "The link B -> C is still loaded once the model is disposed of");
+
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// Completion of a flow of a given size, whose rate changes while another
+// flow shares its link.
+// ===========================================================================
+class FluidTrafficCompletionTestCase : public TestCase
+{
+public:
+  FluidTrafficCompletionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void FlowCompleted (uint32_t flowId);
+
+  uint32_t m_completedFlow;
+  Time m_completed;
+};
+
+FluidTrafficCompletionTestCase::FluidTrafficCompletionTestCase ()
+  : TestCase ("Check the completion time of a flow"),
+    m_completedFlow (1)
+{
+}
+
+void
+FluidTrafficCompletionTestCase::FlowCompleted (uint32_t flowId)
+{
+  m_completedFlow = flowId;
+  m_completed = Simulator::Now ();
+}
+
+void
+FluidTrafficCompletionTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  NetDeviceContainer devices = Connect (nodes.Get (0), nodes.Get (1), "8Mbps", "1ms", address);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<FluidTrafficModel> model = CreateObject<FluidTrafficModel> ();
+  model->SetAttribute ("MaxUtilization", DoubleValue (0.5));
+  model->TraceConnectWithoutContext ("FlowCompleted", MakeCallback (&FluidTrafficCompletionTestCase::FlowCompleted, this));
+  // 500000 bytes at 4 Mbps from 1 s to 2 s, 250000 bytes at 2 Mbps from
+  // 2 s to 3 s, and the last 250000 bytes at 4 Mbps in 0.5 s.
+  model->AddFlow (nodes.Get (0), Ipv4Address ("10.1.1.2"), 1000000, DataRate (0), Seconds (1), Seconds (0));
+  model->AddFlow (nodes.Get (0), Ipv4Address ("10.1.1.2"), 0, DataRate (0), Seconds (2), Seconds (3));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_completedFlow, 0, "Wrong flow completed");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_completed, Seconds (3.5), MicroSeconds (1), "Wrong completion time");
+  NS_TEST_ASSERT_MSG_EQ (model->GetFlowBytes (0), 1000000, "Wrong number of bytes");
+  NS_TEST_ASSERT_MSG_EQ (GetLinkBitRate (devices, 0), 0, "The link is still loaded");
+
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// TCP-approximate sharing of the bottleneck C -> D by the flows A -> D and
+// B -> D, whose round trip times are 20 ms and 60 ms.
+// ===========================================================================
+class FluidTrafficTcpTestCase : public TestCase
+{
+public:
+  FluidTrafficTcpTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FluidTrafficTcpTestCase::FluidTrafficTcpTestCase ()
+  : TestCase ("Check the TCP-approximate sharing of a link")
+{
+}
+
+void
+FluidTrafficTcpTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Connect (nodes.Get (0), nodes.Get (2), "100Mbps", "10ms", address);
+  Connect (nodes.Get (1), nodes.Get (2), "100Mbps", "30ms", address);
+  Connect (nodes.Get (2), nodes.Get (3), "8Mbps", "0ms", address);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<FluidTrafficModel> model = CreateObject<FluidTrafficModel> ();
+  model->SetAttribute ("MaxUtilization", DoubleValue (0.5));
+  model->SetAttribute ("Sharing", EnumValue (FluidTrafficModel::TCP));
+  model->AddFlow (nodes.Get (0), Ipv4Address ("10.1.3.2"), 0, DataRate (0), Seconds (1), Seconds (0));
+  model->AddFlow (nodes.Get (1), Ipv4Address ("10.1.3.2"), 0, DataRate (0), Seconds (1), Seconds (0));
+  // a flow limited by its maximum rate leaves the rest of the link
+  model->AddFlow (nodes.Get (2), Ipv4Address ("10.1.3.2"), 0, DataRate ("1Mbps"), Seconds (1), Seconds (0));
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowRate (0).GetBitRate (), 2.25e6, 1, "Wrong rate of the flow with the shorter rtt");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowRate (1).GetBitRate (), 0.75e6, 1, "Wrong rate of the flow with the longer rtt");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetFlowRate (2).GetBitRate (), 1e6, 1, "Wrong rate of the flow with a maximum rate");
+
+  Simulator::Destroy ();
+}
+
+class FluidTrafficTestSuite : public TestSuite
+{
+public:
+  FluidTrafficTestSuite ();
+};
+
+FluidTrafficTestSuite::FluidTrafficTestSuite ()
+  : TestSuite ("fluid-traffic", UNIT)
+{
+  AddTestCase (new FluidTrafficMaxMinTestCase, TestCase::QUICK);
+  AddTestCase (new FluidTrafficCompletionTestCase, TestCase::QUICK);
+  AddTestCase (new FluidTrafficTcpTestCase, TestCase::QUICK);
+}
+
+static FluidTrafficTestSuite g_fluidTrafficTestSuite;
@@ -81,6 +81,10 @@ public:
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * If the "GlobalRoutingIncremental" global value is set, only the
+   * routers whose shortest path tree may have changed since the previous
+   * call recompute it.
+   *
    */
   static void RecomputeRoutingTables (void);
 private:
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "neighbor-cache-helper.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ndisc-cache.h"
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("NeighborCacheHelper");
+
+namespace ns3 {
+
+void
+NeighborCacheHelper::PopulateNeighborCaches (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); i++)
+    {
+      PopulateNeighborCaches (*i);
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCaches (Ptr<Channel> channel)
+{
+  NS_LOG_FUNCTION (channel);
+
+  std::vector<Ptr<Ipv4Interface> > ipv4Interfaces;
+  std::vector<Ptr<Ipv6Interface> > ipv6Interfaces;
+  for (uint32_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> device = channel->GetDevice (i);
+      Ptr<Ipv4L3Protocol> ipv4 = device->GetNode ()->GetObject<Ipv4L3Protocol> ();
+      if (ipv4 != 0 && ipv4->GetInterfaceForDevice (device) != -1)
+        {
+          ipv4Interfaces.push_back (ipv4->GetInterface (ipv4->GetInterfaceForDevice (device)));
+        }
+      Ptr<Ipv6L3Protocol> ipv6 = device->GetNode ()->GetObject<Ipv6L3Protocol> ();
+      if (ipv6 != 0 && ipv6->GetInterfaceForDevice (device) != -1)
+        {
+          ipv6Interfaces.push_back (ipv6->GetInterface (ipv6->GetInterfaceForDevice (device)));
+        }
+    }
+
+  for (std::vector<Ptr<Ipv4Interface> >::const_iterator i = ipv4Interfaces.begin (); i != ipv4Interfaces.end (); i++)
+    {
+      Ptr<ArpCache> cache = (*i)->GetArpCache ();
+      if (cache == 0)
+        {
+          continue;
+        }
+      for (std::vector<Ptr<Ipv4Interface> >::const_iterator j = ipv4Interfaces.begin (); j != ipv4Interfaces.end (); j++)
+        {
+          if (*j == *i)
+            {
+              continue;
+            }
+          for (uint32_t k = 0; k < (*j)->GetNAddresses (); k++)
+            {
+              Ipv4Address address = (*j)->GetAddress (k).GetLocal ();
+              ArpCache::Entry *entry = cache->Lookup (address);
+              if (entry == 0)
+                {
+                  entry = cache->Add (address);
+                }
+              entry->MarkPermanent ((*j)->GetDevice ()->GetAddress ());
+            }
+        }
+    }
+
+  for (std::vector<Ptr<Ipv6Interface> >::const_iterator i = ipv6Interfaces.begin (); i != ipv6Interfaces.end (); i++)
+    {
+      Ptr<NdiscCache> cache = (*i)->GetNdiscCache ();
+      if (cache == 0)
+        {
+          continue;
+        }
+      for (std::vector<Ptr<Ipv6Interface> >::const_iterator j = ipv6Interfaces.begin (); j != ipv6Interfaces.end (); j++)
+        {
+          if (*j == *i)
+            {
+              continue;
+            }
+          for (uint32_t k = 0; k < (*j)->GetNAddresses (); k++)
+            {
+              Ipv6Address address = (*j)->GetAddress (k).GetAddress ();
+              NdiscCache::Entry *entry = cache->Lookup (address);
+              if (entry == 0)
+                {
+                  entry = cache->Add (address);
+                }
+              entry->MarkPermanent ((*j)->GetDevice ()->GetAddress ());
+            }
+        }
+    }
+}
+
+} // namespace ns3
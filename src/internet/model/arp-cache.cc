@@ -88,7 +88,11 @@ void
 ArpCache::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  Flush ();
+  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+    {
+      delete (*i).second;
+    }
+  m_arpCache.clear ();
   m_device = 0;
   m_interface = 0;
   if (!m_waitReplyTimer.IsRunning ())
@@ -230,11 +234,16 @@ void
 ArpCache::Flush (void)
 {
   NS_LOG_FUNCTION (this);
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); ) 
     {
+      if ((*i).second->IsPermanent ())
+        {
+          i++;
+          continue;
+        }
       delete (*i).second;
+      m_arpCache.erase (i++);
     }
-  m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
   if (m_waitReplyTimer.IsRunning ())
     {
       NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
@@ -246,10 +255,10 @@ ArpCache::Entry *
 ArpCache::Lookup (Ipv4Address to)
 {
   NS_LOG_FUNCTION (this << to);
-  if (m_arpCache.find (to) != m_arpCache.end ()) 
+  CacheI it = m_arpCache.find (to);
+  if (it != m_arpCache.end ()) 
     {
-      ArpCache::Entry *entry = m_arpCache[to];
-      return entry;
+      return it->second;
     }
   return 0;
 }
@@ -293,6 +302,12 @@ ArpCache::Entry::IsWaitReply (void)
   NS_LOG_FUNCTION (this);
   return (m_state == WAIT_REPLY) ? true : false;
 }
+bool
+ArpCache::Entry::IsPermanent (void)
+{
+  NS_LOG_FUNCTION (this);
+  return (m_state == PERMANENT) ? true : false;
+}
 
 
 void 
@@ -314,6 +329,16 @@ ArpCache::Entry::MarkAlive (Address macAddress)
   UpdateSeen ();
 }
 
+void
+ArpCache::Entry::MarkPermanent (Address macAddress)
+{
+  NS_LOG_FUNCTION (this << macAddress);
+  m_macAddress = macAddress;
+  m_state = PERMANENT;
+  ClearRetries ();
+  UpdateSeen ();
+}
+
 bool
 ArpCache::Entry::UpdateWaitReply (Ptr<Packet> waiting)
 {
@@ -346,7 +371,7 @@ Address
 ArpCache::Entry::GetMacAddress (void) const
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_state == ALIVE);
+  NS_ASSERT (m_state == ALIVE || m_state == PERMANENT);
   return m_macAddress;
 }
 Ipv4Address 
@@ -382,6 +407,10 @@ bool
 ArpCache::Entry::IsExpired (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_state == PERMANENT)
+    {
+      return false;
+    }
   Time timeout = GetTimeout ();
   Time delta = Simulator::Now () - m_lastSeen;
   NS_LOG_DEBUG ("delta=" << delta.GetSeconds () << "s");
@@ -106,7 +106,7 @@ public:
    */
   ArpCache::Entry *Add (Ipv4Address to);
   /**
-   * \brief Clear the ArpCache of all entries
+   * \brief Clear the ArpCache of all entries but the permanent ones
    */
   void Flush (void);
 
@@ -129,6 +129,13 @@ public:
      * \param macAddress
      */
     void MarkAlive (Address macAddress);
+    /**
+     * \brief Changes the state of this entry to permanent: the entry
+     * never expires, and is not updated by the ARP replies.
+     *
+     * \param macAddress
+     */
+    void MarkPermanent (Address macAddress);
     /**
      * \param waiting
      */
@@ -150,6 +157,10 @@ public:
      * \return True if the state of this entry is wait_reply; false otherwise.
      */
     bool IsWaitReply (void);
+    /**
+     * \return True if the state of this entry is permanent; false otherwise.
+     */
+    bool IsPermanent (void);
 
     /**
      * \return The MacAddress of this entry
@@ -193,7 +204,8 @@ private:
     enum ArpCacheEntryState_e {
       ALIVE,
       WAIT_REPLY,
-      DEAD
+      DEAD,
+      PERMANENT
     };
 
     void UpdateSeen (void);
@@ -262,6 +262,13 @@ ArpL3Protocol::Lookup (Ptr<Packet> packet, Ipv4Address destination,
 {
   NS_LOG_FUNCTION (this << packet << destination << device << cache << hardwareDestination);
   ArpCache::Entry *entry = cache->Lookup (destination);
+  if (entry != 0 && entry->IsPermanent ())
+    {
+      NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
+                    ", permanent entry for " << destination << " -- send");
+      *hardwareDestination = entry->GetMacAddress ();
+      return true;
+    }
   if (entry != 0)
     {
       if (entry->IsExpired ()) 
@@ -42,24 +42,26 @@ operator<< (std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream& 
 operator<< (std::ostream& os, const CandidateQueue& q)
 {
-  typedef CandidateQueue::CandidateList_t List_t;
-  typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  CandidateQueue::CandidateHeap_t heap = q.m_candidates;
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
-  for (CIter_t iter = list.begin (); iter != list.end (); iter++)
+  while (!heap.empty ())
     {
+      std::pop_heap (heap.begin (), heap.end (), &CandidateQueue::IsAfter);
+      SPFVertex *v = heap.back ().vertex;
+      heap.pop_back ();
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << v->GetVertexId () << ", "
+      << v->GetDistanceFromRoot () << ", "
+      << v->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_candidates (),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -80,6 +82,7 @@ CandidateQueue::Clear (void)
       delete p;
       p = 0;
     }
+  m_sequence = 0;
 }
 
 void
@@ -87,11 +90,12 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  Candidate c;
+  c.vertex = vNew;
+  c.sequence = m_sequence++;
+  c.distance = vNew->GetDistanceFromRoot ();
+  m_candidates.push_back (c);
+  std::push_heap (m_candidates.begin (), m_candidates.end (), &CandidateQueue::IsAfter);
 }
 
 SPFVertex *
@@ -103,8 +107,9 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  std::pop_heap (m_candidates.begin (), m_candidates.end (), &CandidateQueue::IsAfter);
+  SPFVertex *v = m_candidates.back ().vertex;
+  m_candidates.pop_back ();
   return v;
 }
 
@@ -117,7 +122,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_candidates.front ().vertex;
 }
 
 bool
@@ -138,11 +143,11 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
+  CandidateHeap_t::const_iterator i = m_candidates.begin ();
 
   for (; i != m_candidates.end (); i++)
     {
-      SPFVertex *v = *i;
+      SPFVertex *v = i->vertex;
       if (v->GetVertexId () == addr)
         {
           return v;
@@ -157,7 +162,24 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  // The sorted list used to be sorted again, stably: a vertex whose
+  // distance changed stayed behind the vertices already queued at its new
+  // distance. Give such vertices a new sequence, in their previous order.
+  std::vector<Candidate *> changed;
+  for (CandidateHeap_t::iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+    {
+      if (i->distance != i->vertex->GetDistanceFromRoot ())
+        {
+          changed.push_back (&(*i));
+        }
+    }
+  std::sort (changed.begin (), changed.end (), &CandidateQueue::WasBefore);
+  for (std::vector<Candidate *>::iterator i = changed.begin (); i != changed.end (); i++)
+    {
+      (*i)->sequence = m_sequence++;
+      (*i)->distance = (*i)->vertex->GetDistanceFromRoot ();
+    }
+  std::make_heap (m_candidates.begin (), m_candidates.end (), &CandidateQueue::IsAfter);
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
@@ -190,4 +212,34 @@ CandidateQueue::CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2)
   return result;
 }
 
+bool
+CandidateQueue::IsAfter (Candidate const &c1, Candidate const &c2)
+{
+  if (CompareSPFVertex (c2.vertex, c1.vertex))
+    {
+      return true;
+    }
+  if (CompareSPFVertex (c1.vertex, c2.vertex))
+    {
+      return false;
+    }
+  return c1.sequence > c2.sequence;
+}
+
+bool
+CandidateQueue::WasBefore (Candidate const *c1, Candidate const *c2)
+{
+  if (c1->distance != c2->distance)
+    {
+      return c1->distance < c2->distance;
+    }
+  SPFVertex::VertexType t1 = c1->vertex->GetVertexType ();
+  SPFVertex::VertexType t2 = c2->vertex->GetVertexType ();
+  if (t1 != t2)
+    {
+      return t1 == SPFVertex::VertexNetwork && t2 == SPFVertex::VertexRouter;
+    }
+  return c1->sequence < c2->sequence;
+}
+
 } // namespace ns3
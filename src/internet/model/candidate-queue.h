@@ -22,7 +22,7 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -44,7 +44,9 @@ class SPFVertex;
  * Although a STL priority_queue almost does what we want, the requirement
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
- * enhanced priority queue.
+ * enhanced priority queue.  It is a binary heap in a vector, so that Push
+ * and Pop take a logarithmic time.  The vertices at the same distance and of
+ * the same type are popped in the order in which they were pushed.
  */
 class CandidateQueue
 {
@@ -189,8 +191,32 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t;
-  CandidateList_t m_candidates;
+  struct Candidate
+  {
+    SPFVertex *vertex;
+    /// The number of vertices pushed or reordered before this one
+    uint32_t sequence;
+    /// The distance of the vertex when it was pushed or reordered
+    uint32_t distance;
+  };
+
+/**
+ * \brief The ordering of the heap.
+ *
+ * \return True if c1 should be popped after c2; false otherwise
+ */
+  static bool IsAfter (Candidate const &c1, Candidate const &c2);
+/**
+ * \brief The ordering of the heap with the distances recorded in the
+ * candidates, before Reorder updates them.
+ *
+ * \return True if c1 was popped before c2; false otherwise
+ */
+  static bool WasBefore (Candidate const *c1, Candidate const *c2);
+
+  typedef std::vector<Candidate> CandidateHeap_t;
+  CandidateHeap_t m_candidates;
+  uint32_t m_sequence;
 
   friend std::ostream& operator<< (std::ostream& os, const CandidateQueue& q);
 };
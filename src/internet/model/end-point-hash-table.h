@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef END_POINT_HASH_TABLE_H
+#define END_POINT_HASH_TABLE_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A chained hash table of end points, used by the end point
+ *        demultiplexers and to index the reassembly buffers of the IP
+ *        layers.
+ *
+ * The end points are stored with a 32-bit hash of the fields of their
+ * four-tuple chosen by the owner of the table. The table compares only
+ * the hashes: the owner checks the fields of the end points it finds.
+ * Several end points may have the same hash, and an end point must be
+ * removed with the hash it was inserted with, that is, before any of
+ * its hashed fields changes.
+ *
+ * \tparam T the type of the end points.
+ */
+template <typename T>
+class EndPointHashTable
+{
+public:
+  EndPointHashTable ();
+  ~EndPointHashTable ();
+
+  /**
+   * \param hash the hash of the end point.
+   * \param endPoint the end point to add.
+   */
+  void Insert (uint32_t hash, T *endPoint);
+  /**
+   * \param hash the hash the end point was inserted with.
+   * \param endPoint the end point to remove.
+   * \returns true if the end point was found.
+   */
+  bool Remove (uint32_t hash, T *endPoint);
+  /**
+   * \param hash a hash.
+   * \param endPoints the vector to which the end points inserted with
+   *        the hash are appended, in no particular order.
+   */
+  void Find (uint32_t hash, std::vector<T *> &endPoints) const;
+  /**
+   * Remove all the end points.
+   */
+  void Clear (void);
+  /**
+   * \returns the number of end points in the table.
+   */
+  uint32_t GetN (void) const;
+
+private:
+  struct Entry
+  {
+    uint32_t hash;
+    T *endPoint;
+    Entry *next;
+  };
+
+  EndPointHashTable (EndPointHashTable const &);
+  EndPointHashTable &operator = (EndPointHashTable const &);
+
+  /**
+   * \param nBuckets the new number of buckets, a power of two.
+   */
+  void Resize (uint32_t nBuckets);
+
+  std::vector<Entry *> m_buckets;
+  uint32_t m_n;
+};
+
+template <typename T>
+EndPointHashTable<T>::EndPointHashTable ()
+  : m_buckets (16, (Entry *)0),
+    m_n (0)
+{
+}
+
+template <typename T>
+EndPointHashTable<T>::~EndPointHashTable ()
+{
+  Clear ();
+}
+
+template <typename T>
+void
+EndPointHashTable<T>::Insert (uint32_t hash, T *endPoint)
+{
+  if (m_n >= m_buckets.size ())
+    {
+      Resize (m_buckets.size () * 2);
+    }
+  Entry *entry = new Entry ();
+  entry->hash = hash;
+  entry->endPoint = endPoint;
+  Entry *&bucket = m_buckets[hash & (m_buckets.size () - 1)];
+  entry->next = bucket;
+  bucket = entry;
+  m_n++;
+}
+
+template <typename T>
+bool
+EndPointHashTable<T>::Remove (uint32_t hash, T *endPoint)
+{
+  for (Entry **link = &m_buckets[hash & (m_buckets.size () - 1)]; *link != 0; link = &(*link)->next)
+    {
+      Entry *entry = *link;
+      if (entry->endPoint == endPoint)
+        {
+          *link = entry->next;
+          delete entry;
+          m_n--;
+          return true;
+        }
+    }
+  return false;
+}
+
+template <typename T>
+void
+EndPointHashTable<T>::Find (uint32_t hash, std::vector<T *> &endPoints) const
+{
+  for (Entry const *entry = m_buckets[hash & (m_buckets.size () - 1)]; entry != 0; entry = entry->next)
+    {
+      if (entry->hash == hash)
+        {
+          endPoints.push_back (entry->endPoint);
+        }
+    }
+}
+
+template <typename T>
+void
+EndPointHashTable<T>::Clear (void)
+{
+  for (uint32_t i = 0; i < m_buckets.size (); ++i)
+    {
+      while (m_buckets[i] != 0)
+        {
+          Entry *entry = m_buckets[i];
+          m_buckets[i] = entry->next;
+          delete entry;
+        }
+    }
+  m_n = 0;
+}
+
+template <typename T>
+uint32_t
+EndPointHashTable<T>::GetN (void) const
+{
+  return m_n;
+}
+
+template <typename T>
+void
+EndPointHashTable<T>::Resize (uint32_t nBuckets)
+{
+  std::vector<Entry *> buckets (nBuckets, (Entry *)0);
+  for (uint32_t i = 0; i < m_buckets.size (); ++i)
+    {
+      while (m_buckets[i] != 0)
+        {
+          Entry *entry = m_buckets[i];
+          m_buckets[i] = entry->next;
+          Entry *&bucket = buckets[entry->hash & (nBuckets - 1)];
+          entry->next = bucket;
+          bucket = entry;
+        }
+    }
+  m_buckets.swap (buckets);
+}
+
+} // namespace ns3
+
+#endif /* END_POINT_HASH_TABLE_H */
@@ -35,6 +35,13 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#ifdef HAVE_PTHREAD_H
+#include <unistd.h>
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -44,6 +51,246 @@ NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
 namespace ns3 {
 
+GlobalValue g_globalRoutingThreads = GlobalValue ("GlobalRoutingThreads",
+                                                  "The number of threads which run the SPF calculations "
+                                                  "of the global routing, zero for one per processor.",
+                                                  UintegerValue (1),
+                                                  MakeUintegerChecker<uint32_t> ());
+GlobalValue g_globalRoutingIncremental = GlobalValue ("GlobalRoutingIncremental",
+                                                      "Whether the global routing recomputes only the routes "
+                                                      "of the routers whose shortest path tree may have changed.",
+                                                      BooleanValue (false),
+                                                      MakeBooleanChecker ());
+
+namespace {
+
+uint32_t
+GetNThreads (void)
+{
+  UintegerValue threads;
+  g_globalRoutingThreads.GetValue (threads);
+#ifdef HAVE_PTHREAD_H
+  if (threads.Get () == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      return processors > 0 ? processors : 1;
+    }
+  return threads.Get ();
+#else
+  return 1;
+#endif /* HAVE_PTHREAD_H */
+}
+
+/// The link records compared by SameLinkRecords
+enum RecordFilter
+{
+  ALL_RECORDS,
+  TRANSIT_RECORDS,    //!< The records which are neither point-to-point nor stub links
+  ROUTE_RECORDS       //!< The fields of the records from which the routes are derived
+};
+
+struct RecordKey
+{
+  uint32_t type;
+  Ipv4Address linkId;
+  Ipv4Address linkData;
+  uint16_t metric;
+};
+
+bool
+GetRecordKey (GlobalRoutingLinkRecord const *l, RecordFilter filter, RecordKey &key)
+{
+  key.type = l->GetLinkType ();
+  key.linkId = l->GetLinkId ();
+  key.linkData = l->GetLinkData ();
+  key.metric = l->GetMetric ();
+  bool transit = l->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint
+    && l->GetLinkType () != GlobalRoutingLinkRecord::StubNetwork;
+  switch (filter)
+    {
+    case TRANSIT_RECORDS:
+      return transit;
+    case ROUTE_RECORDS:
+      // the host routes to the local addresses of the point-to-point links,
+      // and the network routes to the stub networks.
+      key.metric = 0;
+      if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+        {
+          key.linkId = Ipv4Address ();
+        }
+      return !transit;
+    default:
+      return true;
+    }
+}
+
+bool
+SameLinkRecords (GlobalRoutingLSA const *a, GlobalRoutingLSA const *b, RecordFilter filter)
+{
+  uint32_t i = 0;
+  uint32_t j = 0;
+  RecordKey ka, kb;
+  for (;;)
+    {
+      while (i < a->GetNLinkRecords () && !GetRecordKey (a->GetLinkRecord (i), filter, ka))
+        {
+          i++;
+        }
+      while (j < b->GetNLinkRecords () && !GetRecordKey (b->GetLinkRecord (j), filter, kb))
+        {
+          j++;
+        }
+      if (i == a->GetNLinkRecords () || j == b->GetNLinkRecords ())
+        {
+          return i == a->GetNLinkRecords () && j == b->GetNLinkRecords ();
+        }
+      if (ka.type != kb.type || ka.linkId != kb.linkId
+          || ka.linkData != kb.linkData || ka.metric != kb.metric)
+        {
+          return false;
+        }
+      i++;
+      j++;
+    }
+}
+
+bool
+SameLSA (GlobalRoutingLSA const *a, GlobalRoutingLSA const *b)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetLinkStateId () != b->GetLinkStateId ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a->GetNAttachedRouters (); i++)
+    {
+      if (a->GetAttachedRouter (i) != b->GetAttachedRouter (i))
+        {
+          return false;
+        }
+    }
+  return a->GetNLinkRecords () == b->GetNLinkRecords ()
+         && SameLinkRecords (a, b, ALL_RECORDS);
+}
+
+/**
+ * A binary heap of the candidate vertices of an SPF calculation, indexed by
+ * the vertices of the SPFGraph so that the distance of a candidate can be
+ * decreased in place.  The candidates are ordered by distance from the root,
+ * the networks before the routers at equal distance, and then in the order
+ * in which they were pushed or last decreased, which is the order in which
+ * the sorted list of the CandidateQueue kept them.
+ */
+class SPFCandidateHeap
+{
+public:
+  SPFCandidateHeap ()
+    : m_sequence (0)
+  {
+  }
+  void Reset (uint32_t nVertices)
+  {
+    m_heap.clear ();
+    m_position.resize (nVertices);
+    m_key.resize (nVertices);
+    m_sequence = 0;
+  }
+  bool Empty (void) const
+  {
+    return m_heap.empty ();
+  }
+  void Push (uint32_t v, uint32_t distance, bool router)
+  {
+    SetKey (v, distance, router);
+    m_heap.push_back (v);
+    SiftUp (m_heap.size () - 1);
+  }
+  /// The distance of the candidate v must be smaller than its current one
+  void Decrease (uint32_t v, uint32_t distance, bool router)
+  {
+    SetKey (v, distance, router);
+    SiftUp (m_position[v]);
+  }
+  uint32_t Pop (void)
+  {
+    NS_ASSERT (!m_heap.empty ());
+    uint32_t top = m_heap.front ();
+    uint32_t last = m_heap.back ();
+    m_heap.pop_back ();
+    if (!m_heap.empty ())
+      {
+        Place (0, last);
+        SiftDown (0);
+      }
+    return top;
+  }
+
+private:
+  /// The distance, then the router flag in the high bit and the sequence
+  typedef std::pair<uint32_t, uint32_t> Key;
+
+  void SetKey (uint32_t v, uint32_t distance, bool router)
+  {
+    NS_ASSERT (m_sequence < 0x80000000);
+    m_key[v] = Key (distance, (router ? 0x80000000 : 0) | m_sequence++);
+  }
+  void Place (uint32_t i, uint32_t v)
+  {
+    m_heap[i] = v;
+    m_position[v] = i;
+  }
+  void SiftUp (uint32_t i)
+  {
+    uint32_t v = m_heap[i];
+    while (i > 0)
+      {
+        uint32_t parent = (i - 1) / 2;
+        if (!(m_key[v] < m_key[m_heap[parent]]))
+          {
+            break;
+          }
+        Place (i, m_heap[parent]);
+        i = parent;
+      }
+    Place (i, v);
+  }
+  void SiftDown (uint32_t i)
+  {
+    uint32_t v = m_heap[i];
+    uint32_t n = m_heap.size ();
+    for (;;)
+      {
+        uint32_t child = 2 * i + 1;
+        if (child >= n)
+          {
+            break;
+          }
+        if (child + 1 < n && m_key[m_heap[child + 1]] < m_key[m_heap[child]])
+          {
+            child++;
+          }
+        if (!(m_key[m_heap[child]] < m_key[v]))
+          {
+            break;
+          }
+        Place (i, m_heap[child]);
+        i = child;
+      }
+    Place (i, v);
+  }
+
+  std::vector<uint32_t> m_heap;
+  /// The index in m_heap of each candidate
+  std::vector<uint32_t> m_position;
+  std::vector<Key> m_key;
+  uint32_t m_sequence;
+};
+
+} // anonymous namespace
+
 std::ostream& 
 operator<< (std::ostream& os, const SPFVertex::NodeExit_t& exit)
 {
@@ -488,13 +735,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -524,15 +768,263 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
   return 0;
 }
 
+bool
+GlobalRouteManagerLSDB::Diff (GlobalRouteManagerLSDB const &old, std::vector<GlobalRoutingLSA *> &changed) const
+{
+  NS_LOG_FUNCTION (this << &old);
+  changed.clear ();
+  if (m_database.size () != old.m_database.size ()
+      || m_extdatabase.size () != old.m_extdatabase.size ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_extdatabase.size (); i++)
+    {
+      if (!SameLSA (m_extdatabase[i], old.m_extdatabase[i]))
+        {
+          return false;
+        }
+    }
+//
+// Both maps are sorted by address, so that the LSAs of the same address are
+// met at the same time.
+//
+  LSDBMap_t::const_iterator j = old.m_database.begin ();
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++, j++)
+    {
+      if (i->first != j->first)
+        {
+          return false;
+        }
+      if (SameLSA (i->second, j->second))
+        {
+          continue;
+        }
+      if (i->second->GetLSType () != GlobalRoutingLSA::RouterLSA
+          || j->second->GetLSType () != GlobalRoutingLSA::RouterLSA
+          || !SameLinkRecords (i->second, j->second, TRANSIT_RECORDS))
+        {
+          return false;
+        }
+      changed.push_back (i->second);
+    }
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+//
+// SPFGraph Implementation
+//
+// ---------------------------------------------------------------------------
+
+const uint32_t SPFGraph::NO_VERTEX;
+
+SPFGraph::SPFGraph ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SPFGraph::Build (GlobalRouteManagerLSDB const &lsdb)
+{
+  NS_LOG_FUNCTION (this << &lsdb);
+  m_vertices.clear ();
+  m_edges.clear ();
+  GlobalRouteManagerLSDB::LSDBMap_t::const_iterator i;
+  for (i = lsdb.m_database.begin (); i != lsdb.m_database.end (); i++)
+    {
+      Vertex vertex;
+      vertex.id = i->first;
+      vertex.lsa = i->second;
+      vertex.edges = 0;
+      switch (vertex.lsa->GetLSType ())
+        {
+        case GlobalRoutingLSA::RouterLSA:
+          vertex.type = SPFVertex::VertexRouter;
+          break;
+        case GlobalRoutingLSA::NetworkLSA:
+          vertex.type = SPFVertex::VertexNetwork;
+          break;
+        default:
+          vertex.type = SPFVertex::VertexUnknown;
+          break;
+        }
+      m_vertices.push_back (vertex);
+    }
+  uint32_t n = m_vertices.size ();
+  Vertex end;
+  end.type = SPFVertex::VertexUnknown;
+  end.lsa = 0;
+  end.edges = 0;
+  m_vertices.push_back (end);
+//
+// The attached routers of a network are found by the address of their
+// interface on the network, which is the link data of their transit network
+// record.  As in GetLSAByLinkData, the first LSA in the database wins.
+//
+  std::map<Ipv4Address, uint32_t> byLinkData;
+  for (uint32_t v = 0; v < n; v++)
+    {
+      GlobalRoutingLSA *lsa = m_vertices[v].lsa;
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+          if (l->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              byLinkData.insert (std::make_pair (l->GetLinkData (), v));
+            }
+        }
+    }
+
+  for (uint32_t v = 0; v < n; v++)
+    {
+      Vertex &vertex = m_vertices[v];
+      GlobalRoutingLSA *lsa = vertex.lsa;
+      vertex.edges = m_edges.size ();
+      if (vertex.type == SPFVertex::VertexRouter)
+        {
+          for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+            {
+              GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+              if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+                {
+                  continue;
+                }
+              NS_ASSERT_MSG (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint
+                             || l->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork,
+                             "illegal Link Type");
+              Edge e;
+              e.target = Find (l->GetLinkId ());
+              e.metric = l->GetMetric ();
+              e.link = l;
+              e.back = 0;
+              if (e.target != NO_VERTEX)
+                {
+                  GlobalRoutingLSA *w = m_vertices[e.target].lsa;
+                  for (uint32_t k = 0; k < w->GetNLinkRecords () && e.back == 0; k++)
+                    {
+                      if (w->GetLinkRecord (k)->GetLinkId () == vertex.id)
+                        {
+                          e.back = w->GetLinkRecord (k);
+                        }
+                    }
+                }
+              m_edges.push_back (e);
+            }
+        }
+      else if (vertex.type == SPFVertex::VertexNetwork)
+        {
+          for (uint32_t j = 0; j < lsa->GetNAttachedRouters (); j++)
+            {
+              std::map<Ipv4Address, uint32_t>::const_iterator w = byLinkData.find (lsa->GetAttachedRouter (j));
+              if (w == byLinkData.end ())
+                {
+                  continue;
+                }
+              Edge e;
+              e.target = w->second;
+              e.metric = 0;
+              e.link = 0;
+              e.back = 0;
+              GlobalRoutingLSA *wlsa = m_vertices[e.target].lsa;
+              for (uint32_t k = 0; k < wlsa->GetNLinkRecords (); k++)
+                {
+                  if (wlsa->GetLinkRecord (k)->GetLinkId () == vertex.id)
+                    {
+                      e.back = wlsa->GetLinkRecord (k);
+                    }
+                }
+              m_edges.push_back (e);
+            }
+        }
+    }
+  m_vertices[n].edges = m_edges.size ();
+  NS_LOG_LOGIC ("Built a graph of " << n << " vertices and " << m_edges.size () << " edges");
+}
+
+uint32_t
+SPFGraph::GetNVertices (void) const
+{
+  return m_vertices.empty () ? 0 : m_vertices.size () - 1;
+}
+
+SPFGraph::Vertex const &
+SPFGraph::GetVertex (uint32_t i) const
+{
+  return m_vertices[i];
+}
+
+uint32_t
+SPFGraph::Find (Ipv4Address id) const
+{
+  // the vertices are sorted by link state ID, as the database.
+  uint32_t begin = 0;
+  uint32_t end = GetNVertices ();
+  while (begin < end)
+    {
+      uint32_t middle = begin + (end - begin) / 2;
+      if (m_vertices[middle].id < id)
+        {
+          begin = middle + 1;
+        }
+      else
+        {
+          end = middle;
+        }
+    }
+  if (begin < GetNVertices () && m_vertices[begin].id == id)
+    {
+      return begin;
+    }
+  return NO_VERTEX;
+}
+
+SPFGraph::Edge const *
+SPFGraph::GetEdgesBegin (uint32_t i) const
+{
+  return m_edges.empty () ? 0 : &m_edges[0] + m_vertices[i].edges;
+}
+
+SPFGraph::Edge const *
+SPFGraph::GetEdgesEnd (uint32_t i) const
+{
+  return m_edges.empty () ? 0 : &m_edges[0] + m_vertices[i + 1].edges;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
 //
 // ---------------------------------------------------------------------------
 
+struct GlobalRouteManagerImpl::SPFState
+{
+  /// The graph vertex of the root
+  uint32_t root;
+  std::vector<GlobalRoutingLSA::SPFStatus> status;
+  std::vector<uint32_t> distance;
+  std::vector<std::vector<SPFVertex::NodeExit_t> > exits;
+  /// The parents of each vertex, the first one being that of its last next
+  /// hop calculation
+  std::vector<std::vector<uint32_t> > parents;
+  /// The exit directions of an equal-cost path, before they are merged
+  std::vector<SPFVertex::NodeExit_t> ecmpExits;
+  SPFCandidateHeap candidates;
+  /// The index in SPFTree::vertices of each graph vertex in the tree
+  std::vector<uint32_t> treeIndex;
+  /// The graph vertex of each tree vertex
+  std::vector<uint32_t> order;
+  /// The children of each tree vertex, in compressed sparse row form
+  std::vector<uint32_t> firstChild;
+  std::vector<uint32_t> nextChild;
+  std::vector<uint32_t> children;
+  std::vector<bool> processed;
+};
+
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_calculations (0),
+    m_nextCalculation (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -556,10 +1048,26 @@ GlobalRouteManagerImpl::DebugUseLsdb (GlobalRouteManagerLSDB* lsdb)
       delete m_lsdb;
     }
   m_lsdb = lsdb;
+  m_graph.Build (*m_lsdb);
+  m_trees.clear ();
 }
 
 void
 GlobalRouteManagerImpl::DeleteGlobalRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  DeleteRoutes ();
+  if (m_lsdb)
+    {
+      NS_LOG_LOGIC ("Deleting LSDB, creating new one");
+      delete m_lsdb;
+      m_lsdb = new GlobalRouteManagerLSDB ();
+    }
+  m_trees.clear ();
+}
+
+void
+GlobalRouteManagerImpl::DeleteRoutes ()
 {
   NS_LOG_FUNCTION (this);
   NodeList::Iterator listEnd = NodeList::End ();
@@ -572,24 +1080,23 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
           continue;
         }
       Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-      uint32_t j = 0;
-      uint32_t nRoutes = gr->GetNRoutes ();
       NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
-      // Each time we delete route 0, the route index shifts downward
-      // We can delete all routes if we delete the route numbered 0
-      // nRoutes times
-      for (j = 0; j < nRoutes; j++)
-        {
-          NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
-          gr->RemoveRoute (0);
-        }
-      NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
+      DeleteRoutes (gr);
     }
-  if (m_lsdb)
+}
+
+void
+GlobalRouteManagerImpl::DeleteRoutes (Ptr<Ipv4GlobalRouting> gr)
+{
+  NS_LOG_FUNCTION (this << gr);
+  uint32_t j = 0;
+  uint32_t nRoutes = gr->GetNRoutes ();
+  // Each time we delete route 0, the route index shifts downward
+  // We can delete all routes if we delete the route numbered 0
+  // nRoutes times
+  for (j = 0; j < nRoutes; j++)
     {
-      NS_LOG_LOGIC ("Deleting LSDB, creating new one");
-      delete m_lsdb;
-      m_lsdb = new GlobalRouteManagerLSDB ();
+      gr->RemoveRoute (0);
     }
 }
 
@@ -650,6 +1157,7 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase ()
           m_lsdb->Insert (lsa->GetLinkStateId (), lsa); 
         }
     }
+  m_graph.Build (*m_lsdb);
 }
 
 //
@@ -689,10 +1197,14 @@ void
 GlobalRouteManagerImpl::InitializeRoutes ()
 {
   NS_LOG_FUNCTION (this);
+  BooleanValue incremental;
+  g_globalRoutingIncremental.GetValue (incremental);
+  m_trees.clear ();
 //
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  std::vector<SPFCalculation *> calculations;
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -716,280 +1228,454 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          SPFCalculation *calc = new SPFCalculation;
+          PrepareCalculation (*calc, rtr->GetRouterId (), node);
+          calculations.push_back (calc);
         }
     }
+  RunCalculations (calculations, incremental.Get ());
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
-//
-// This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
-// 16.1 (2) for further details.
-//
-// We're passed a parameter <v> that is a vertex which is already in the SPF
-// tree.  A vertex represents a router node.  We also get a reference to the
-// SPF candidate queue, which is a priority queue containing the shortest paths
-// to the networks we know about.
-//
-// We examine the links in v's LSA and update the list of candidates with any
-// vertices not already on the list.  If a lower-cost path is found to a
-// vertex already on the candidate list, store the new (lower) cost.
-//
 void
-GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
+GlobalRouteManagerImpl::RecomputeRoutes ()
 {
-  NS_LOG_FUNCTION (this << v << &candidate);
+  NS_LOG_FUNCTION (this);
+  BooleanValue incremental;
+  g_globalRoutingIncremental.GetValue (incremental);
+  if (!incremental.Get () || m_trees.empty ())
+    {
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
 
-  SPFVertex* w = 0;
-  GlobalRoutingLSA* w_lsa = 0;
-  GlobalRoutingLinkRecord *l = 0;
-  uint32_t distance = 0;
-  uint32_t numRecordsInVertex = 0;
-//
-// V points to a Router-LSA or Network-LSA
-// Loop over the links in router LSA or attached routers in Network LSA
-//
-  if (v->GetVertexType () == SPFVertex::VertexRouter)
+  GlobalRouteManagerLSDB *old = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  std::vector<GlobalRoutingLSA *> changed;
+  if (!m_lsdb->Diff (*old, changed))
     {
-      numRecordsInVertex = v->GetLSA ()->GetNLinkRecords (); 
+      NS_LOG_INFO ("Not only router LSAs changed; recomputing all the routes");
+      delete old;
+      DeleteRoutes ();
+      InitializeRoutes ();
+      return;
     }
-  if (v->GetVertexType () == SPFVertex::VertexNetwork)
+  NS_LOG_INFO (changed.size () << " router LSAs changed");
+//
+// The routers whose tree is unaffected by the changes keep their routes,
+// unless the changed LSAs advertise other addresses or stub networks.
+//
+  bool sameRoutes = true;
+  for (uint32_t i = 0; i < changed.size (); i++)
     {
-      numRecordsInVertex = v->GetLSA ()->GetNAttachedRouters (); 
+      if (!SameLinkRecords (changed[i], old->GetLSA (changed[i]->GetLinkStateId ()), ROUTE_RECORDS))
+        {
+          sameRoutes = false;
+        }
     }
 
-  for (uint32_t i = 0; i < numRecordsInVertex; i++)
+  SPFTreeMap_t trees;
+  std::vector<SPFCalculation *> calculations;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
-// Get w_lsa:  In case of V is Router-LSA
-      if (v->GetVertexType () == SPFVertex::VertexRouter) 
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr == 0 || node->GetSystemId () != MpiInterface::GetSystemId ())
         {
-          NS_LOG_LOGIC ("Examining link " << i << " of " << 
-                        v->GetVertexId () << "'s " <<
-                        v->GetLSA ()->GetNLinkRecords () << " link records");
-//
-// (a) If this is a link to a stub network, examine the next link in V's LSA.
-// Links to stub networks will be considered in the second stage of the
-// shortest path calculation.
-//
-          l = v->GetLSA ()->GetLinkRecord (i);
-          NS_ASSERT (l != 0);
-          if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
-            {
-              NS_LOG_LOGIC ("Found a Stub record to " << l->GetLinkId ());
-              continue;
-            }
-//
-// (b) Otherwise, W is a transit vertex (router or transit network).  Look up
-// the vertex W's LSA (router-LSA or network-LSA) in Area A's link state
-// database. 
-//
-          if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
-            {
-//
-// Lookup the link state advertisement of the new link -- we call it <w> in
-// the link state database.
-//
-              w_lsa = m_lsdb->GetLSA (l->GetLinkId ());
-              NS_ASSERT (w_lsa);
-              NS_LOG_LOGIC ("Found a P2P record from " << 
-                            v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
-            }
-          else if (l->GetLinkType () == 
-                   GlobalRoutingLinkRecord::TransitNetwork)
-            {
-              w_lsa = m_lsdb->GetLSA (l->GetLinkId ());
-              NS_ASSERT (w_lsa);
-              NS_LOG_LOGIC ("Found a Transit record from " << 
-                            v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
-            }
-          else 
-            {
-              NS_ASSERT_MSG (0, "illegal Link Type");
-            }
+          continue;
         }
-// Get w_lsa:  In case of V is Network-LSA
-      if (v->GetVertexType () == SPFVertex::VertexNetwork) 
+      Ipv4Address root = rtr->GetRouterId ();
+      SPFTreeMap_t::iterator tree = m_trees.find (root);
+      bool reuse = rtr->GetNumLSAs () && tree != m_trees.end () && !tree->second.stub
+        && !IsAffected (tree->second, root, *old, changed);
+      if (reuse && sameRoutes)
         {
-          w_lsa = m_lsdb->GetLSAByLinkData 
-              (v->GetLSA ()->GetAttachedRouter (i));
-          if (!w_lsa)
-            {
-              continue;
-            }
-          NS_LOG_LOGIC ("Found a Network LSA from " << 
-                        v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
+          NS_LOG_LOGIC ("Keeping the routes of " << root);
+          trees[root].stub = false;
+          trees[root].vertices.swap (tree->second.vertices);
+          trees[root].routers.swap (tree->second.routers);
+          trees[root].exits.swap (tree->second.exits);
+          continue;
+        }
+      DeleteRoutes (rtr->GetRoutingProtocol ());
+      if (!rtr->GetNumLSAs ())
+        {
+          continue;
+        }
+      SPFCalculation *calc = new SPFCalculation;
+      PrepareCalculation (*calc, root, node);
+      if (reuse)
+        {
+          NS_LOG_LOGIC ("Deriving the routes of " << root << " from its previous tree");
+          calc->reuse = true;
+          calc->tree.vertices.swap (tree->second.vertices);
+          calc->tree.routers.swap (tree->second.routers);
+          calc->tree.exits.swap (tree->second.exits);
         }
+      calculations.push_back (calc);
+    }
+  delete old;
+  m_trees.swap (trees);
+  RunCalculations (calculations, true);
+}
 
-// Note:  w_lsa at this point may be either RouterLSA or NetworkLSA
 //
-// (c) If vertex W is already on the shortest-path tree, examine the next
-// link in the LSA.
+// A router A whose LSA changed may change the tree of the root R only if A is
+// in the tree: a router out of the tree can join it only through a change to
+// the LSA of a router of the tree.  If A is in the tree, at distance d (A),
+// a point-to-point link record l from A to a router B which was added or
+// removed changes the tree only if d (A) + metric (l) <= d (B), that is, if
+// the link is or would be on a shortest path to B, or if B is R, since the
+// record is then used to find the next hop from R to A.  Otherwise, the
+// distances and the exit directions of all the vertices are the same.
 //
-// If the link is to a router that is already in the shortest path first tree
-// then we have it covered -- ignore it.
+// The transit network records are not considered, since any change to them
+// makes Diff fail.
 //
-      if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE) 
+bool
+GlobalRouteManagerImpl::IsAffected (SPFTree const &tree, Ipv4Address root,
+                                    GlobalRouteManagerLSDB const &old,
+                                    std::vector<GlobalRoutingLSA *> const &changed) const
+{
+  NS_LOG_FUNCTION (this << root);
+  std::map<Ipv4Address, uint32_t> distance;
+  for (uint32_t i = 0; i < tree.vertices.size (); i++)
+    {
+      if (tree.vertices[i].type == SPFVertex::VertexRouter)
         {
-          NS_LOG_LOGIC ("Skipping ->  LSA "<< 
-                        w_lsa->GetLinkStateId () << " already in SPF tree");
-          continue;
+          distance[tree.vertices[i].id] = tree.vertices[i].distance;
         }
-//
-// (d) Calculate the link state cost D of the resulting path from the root to 
-// vertex W.  D is equal to the sum of the link state cost of the (already 
-// calculated) shortest path to vertex V and the advertised cost of the link
-// between vertices V and W.
-//
-      if (v->GetLSA ()->GetLSType () == GlobalRoutingLSA::RouterLSA)
+    }
+  for (uint32_t i = 0; i < changed.size (); i++)
+    {
+      Ipv4Address id = changed[i]->GetLinkStateId ();
+      if (id == root)
         {
-          NS_ASSERT (l != 0);
-          distance = v->GetDistanceFromRoot () + l->GetMetric ();
+          return true;
         }
-      else
+      std::map<Ipv4Address, uint32_t>::const_iterator a = distance.find (id);
+      if (a == distance.end ())
         {
-          distance = v->GetDistanceFromRoot ();
+          continue;
         }
-
-      NS_LOG_LOGIC ("Considering w_lsa " << w_lsa->GetLinkStateId ());
-
-// Is there already vertex w in candidate list?
-      if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+      GlobalRoutingLSA *lsas[2] = { changed[i], old.GetLSA (id) };
+      for (uint32_t k = 0; k < 2; k++)
         {
-// Calculate nexthop to w
-// We need to figure out how to actually get to the new router represented
-// by <w>.  This will (among other things) find the next hop address to send
-// packets destined for this network to, and also find the outbound interface
-// used to forward the packets.
-
-// prepare vertex w
-          w = new SPFVertex (w_lsa);
-          if (SPFNexthopCalculation (v, w, l, distance))
+          GlobalRoutingLSA *lsa = lsas[k];
+          GlobalRoutingLSA *other = lsas[1 - k];
+          for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
             {
-              w_lsa->SetStatus (GlobalRoutingLSA::LSA_SPF_CANDIDATE);
-//
-// Push this new vertex onto the priority queue (ordered by distance from the
-// root node).
-//
-              candidate.Push (w);
-              NS_LOG_LOGIC ("Pushing " << 
-                            w->GetVertexId () << ", parent vertexId: " <<
-                            v->GetVertexId () << ", distance: " <<
-                            w->GetDistanceFromRoot ());
-            }
-          else
-            NS_ASSERT_MSG (0, "SPFNexthopCalculation never " 
-                           << "return false, but it does now!");
+              GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+              if (l->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  continue;
+                }
+              bool found = false;
+              for (uint32_t m = 0; m < other->GetNLinkRecords () && !found; m++)
+                {
+                  GlobalRoutingLinkRecord *o = other->GetLinkRecord (m);
+                  found = o->GetLinkType () == l->GetLinkType ()
+                    && o->GetLinkId () == l->GetLinkId ()
+                    && o->GetLinkData () == l->GetLinkData ()
+                    && o->GetMetric () == l->GetMetric ();
+                }
+              if (found)
+                {
+                  continue;
+                }
+              if (l->GetLinkId () == root)
+                {
+                  return true;
+                }
+              std::map<Ipv4Address, uint32_t>::const_iterator b = distance.find (l->GetLinkId ());
+              if (b == distance.end ()
+                  || (uint64_t)a->second + l->GetMetric () <= b->second)
+                {
+                  return true;
+                }
+            }
         }
-      else if (w_lsa->GetStatus () == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
-        {
+    }
+  return false;
+}
+
+void
+GlobalRouteManagerImpl::PrepareCalculation (SPFCalculation &calc, Ipv4Address root, Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << root << node);
+  calc.root = root;
+  calc.reuse = false;
+  calc.tree.stub = false;
 //
-// We have already considered the link represented by <w>.  What wse have to
-// do now is to decide if this new router represents a route with a shorter
-// distance metric.
+// We do not need to calculate SPF for a node which has only one interface
+// through which another router can be reached, but the unit tests run the
+// calculation without nodes.
 //
-// So, locate the vertex in the candidate queue and take a look at the 
-// distance.
+  calc.checkStub = NodeList::GetNNodes () > 0;
+  if (node == 0)
+    {
+      NS_LOG_LOGIC ("Can't find root node " << root);
+      return;
+    }
+  Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
+  NS_ASSERT (router);
+  calc.routing = router->GetRoutingProtocol ();
+  NS_ASSERT (calc.routing);
+//
+// The addresses of the root are copied, since the Ipv4 interface cannot be
+// used by the threads which run the calculations.
+//
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::PrepareCalculation (): "
+                 "GetObject for <Ipv4> interface failed");
+  for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+    {
+      for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+        {
+          calc.addresses.push_back (std::make_pair (i, ipv4->GetAddress (i, j).GetLocal ()));
+        }
+    }
+}
 
-/* (quagga-0.98.6) W is already on the candidate list; call it cw.
-* Compare the previously calculated cost (cw->distance)
-* with the cost we just determined (w->distance) to see
-* if we've found a shorter path.
-*/
-          SPFVertex* cw;
-          cw = candidate.Find (w_lsa->GetLinkStateId ());
-          if (cw->GetDistanceFromRoot () < distance)
-            {
+void
+GlobalRouteManagerImpl::RunCalculations (std::vector<SPFCalculation *> &calculations, bool keepTrees)
+{
+  NS_LOG_FUNCTION (this << calculations.size () << keepTrees);
+  uint32_t nThreads = GetNThreads ();
 //
-// This is not a shorter path, so don't do anything.
+// The calculations are run by batches, to bound the memory taken by the
+// routes before they are installed.  The routes are installed in the order of
+// the roots, as if the calculations had been run one after the other.
 //
-              continue;
+  uint32_t batchSize = nThreads * 64;
+  for (uint32_t start = 0; start < calculations.size (); start += batchSize)
+    {
+      uint32_t end = std::min<uint32_t> (start + batchSize, calculations.size ());
+      std::vector<SPFCalculation *> batch (calculations.begin () + start, calculations.begin () + end);
+      m_calculations = &batch;
+      m_nextCalculation = 0;
+#ifdef HAVE_PTHREAD_H
+      uint32_t n = std::min<uint32_t> (nThreads, batch.size ());
+      // the log messages of concurrent calculations would be interleaved.
+      if (n > 1 && g_log.IsNoneEnabled ())
+        {
+          std::vector<Ptr<SystemThread> > threads;
+          for (uint32_t i = 0; i < n; i++)
+            {
+              threads.push_back (Create<SystemThread> (MakeCallback (&GlobalRouteManagerImpl::SPFWorker, this)));
+              threads.back ()->Start ();
+            }
+          for (uint32_t i = 0; i < n; i++)
+            {
+              threads[i]->Join ();
             }
-          else if (cw->GetDistanceFromRoot () == distance)
+        }
+      else
+#endif /* HAVE_PTHREAD_H */
+        {
+          SPFWorker ();
+        }
+      for (uint32_t i = 0; i < batch.size (); i++)
+        {
+          SPFCalculation *calc = batch[i];
+          InstallRoutes (*calc);
+          if (keepTrees)
+            {
+              SPFTree &tree = m_trees[calc->root];
+              tree.stub = calc->tree.stub;
+              tree.vertices.swap (calc->tree.vertices);
+              tree.routers.swap (calc->tree.routers);
+              tree.exits.swap (calc->tree.exits);
+            }
+          delete calc;
+        }
+    }
+  m_calculations = 0;
+}
+
+void
+GlobalRouteManagerImpl::SPFWorker (void)
+{
+  NS_LOG_FUNCTION (this);
+  SPFState state;
+  for (;;)
+    {
+      SPFCalculation *calc;
+      {
+#ifdef HAVE_PTHREAD_H
+        CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+        if (m_nextCalculation == m_calculations->size ())
+          {
+            return;
+          }
+        calc = (*m_calculations)[m_nextCalculation++];
+      }
+      if (calc->reuse)
+        {
+          // The tree is kept, but the LSAs are those of the new database.
+          for (uint32_t i = 0; i < calc->tree.vertices.size (); i++)
             {
+              calc->tree.vertices[i].lsa = m_lsdb->GetLSA (calc->tree.vertices[i].id);
+              NS_ASSERT (calc->tree.vertices[i].lsa);
+            }
+        }
+      else
+        {
+          SPFCalculate (*calc, state);
+        }
+      SPFAddRoutes (*calc);
+    }
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes (SPFCalculation const &calc)
+{
+  NS_LOG_FUNCTION (this << calc.root);
+  if (calc.routing == 0)
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < calc.routes.size (); i++)
+    {
+      SPFRoute const &route = calc.routes[i];
+      switch (route.type)
+        {
+        case SPFRoute::HOST:
+          calc.routing->AddHostRouteTo (route.dest, route.nextHop, route.interface);
+          break;
+        case SPFRoute::NETWORK:
+          calc.routing->AddNetworkRouteTo (route.dest, route.mask, route.nextHop, route.interface);
+          break;
+        case SPFRoute::EXTERNAL:
+          calc.routing->AddASExternalRouteTo (route.dest, route.mask, route.nextHop, route.interface);
+          break;
+        }
+    }
+}
+
+//
+// This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
+// 16.1 (2) for further details.
+//
+// We're passed a parameter <v> that is a vertex which is already in the SPF
+// tree.  A vertex represents a router node.  The state holds the SPF
+// candidate heap, which is a priority queue containing the shortest paths
+// to the networks we know about.
+//
+// We examine the edges of v in the graph and update the candidates with any
+// vertices not already on the heap.  If a lower-cost path is found to a
+// vertex already on the heap, store the new (lower) cost.
+//
+void
+GlobalRouteManagerImpl::SPFNext (SPFCalculation &calc, SPFState &state, uint32_t v)
+{
+  NS_LOG_FUNCTION (this << v);
+//
+// V is a Router-LSA or a Network-LSA.  Its edges are the link records to
+// routers and transit networks in the router LSA (the links to stub networks
+// are considered in the second stage of the shortest path calculation), or
+// the attached routers in the network LSA.
+//
+  SPFGraph::Edge const *end = m_graph.GetEdgesEnd (v);
+  for (SPFGraph::Edge const *e = m_graph.GetEdgesBegin (v); e != end; e++)
+    {
+      uint32_t w = e->target;
+      NS_ASSERT_MSG (w != SPFGraph::NO_VERTEX, "No LSA for link " << e->link->GetLinkId ());
+      if (w == SPFGraph::NO_VERTEX)
+        {
+          continue;
+        }
 //
-// This path is one with an equal cost.
+// (c) If vertex W is already on the shortest-path tree, examine the next
+// link in the LSA.
 //
-              NS_LOG_LOGIC ("Equal cost multiple paths found.");
+      if (state.status[w] == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        {
+          NS_LOG_LOGIC ("Skipping ->  LSA " << m_graph.GetVertex (w).id << " already in SPF tree");
+          continue;
+        }
+//
+// (d) Calculate the link state cost D of the resulting path from the root to 
+// vertex W.  D is equal to the sum of the link state cost of the (already 
+// calculated) shortest path to vertex V and the advertised cost of the link
+// between vertices V and W, which is zero from a network.
+//
+      uint32_t distance = state.distance[v] + e->metric;
+      bool router = m_graph.GetVertex (w).type == SPFVertex::VertexRouter;
+      NS_LOG_LOGIC ("Considering w_lsa " << m_graph.GetVertex (w).id);
 
-// At this point, there are two instances 'w' and 'cw' of the
-// same vertex, the vertex that is currently being considered
-// for adding into the shortest path tree. 'w' is the instance
-// as seen from the root via vertex 'v', and 'cw' is the instance 
-// as seen from the root via some other vertices other than 'v'.
-// These two instances are being merged in the following code.
-// In particular, the parent nodes, the next hops, and the root's
-// output interfaces of the two instances are being merged.
-// 
-// Note that this is functionally equivalent to calling
-// ospf_nexthop_merge (cw->nexthop, w->nexthop) in quagga-0.98.6
-// (ospf_spf.c::859), although the detail implementation
-// is very different from quagga (blame ns3::GlobalRouteManagerImpl)
-
-// prepare vertex w
-              w = new SPFVertex (w_lsa);
-              SPFNexthopCalculation (v, w, l, distance);
-              cw->MergeRootExitDirections (w);
-              cw->MergeParent (w);
-// SPFVertexAddParent (w) is necessary as the destructor of 
-// SPFVertex checks if the vertex and its parent is linked
-// bidirectionally
-              SPFVertexAddParent (w);
-              delete w;
-            }
-          else // cw->GetDistanceFromRoot () > w->GetDistanceFromRoot ()
-            {
-// 
-// this path represents a new, lower-cost path to <w> (the vertex we found in
-// the current link record of the link state advertisement of the current root
-// (vertex <v>)
+      if (state.status[w] == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+        {
 //
-// N.B. the nexthop_calculation is conditional, if it finds a valid nexthop
-// it will call spf_add_parents, which will flush the old parents
+// We need to figure out how to actually get to the new vertex <w>: the next
+// hop address and the outbound interface used to forward the packets.  Then
+// push it onto the priority queue (ordered by distance from the root node).
+//
+          state.exits[w].clear ();
+          SPFNexthopCalculation (calc, state, v, *e, state.exits[w]);
+          state.distance[w] = distance;
+          state.parents[w].assign (1, v);
+          state.status[w] = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
+          state.candidates.Push (w, distance, router);
+          NS_LOG_LOGIC ("Pushing " << m_graph.GetVertex (w).id << ", parent vertexId: " <<
+                        m_graph.GetVertex (v).id << ", distance: " << distance);
+        }
+      else if (state.distance[w] == distance)
+        {
 //
-              if (SPFNexthopCalculation (v, cw, l, distance))
-                {
+// This path is one with an equal cost.  The parents, the next hops and the
+// root's output interfaces of the path through <v> are merged into those of
+// <w>, which is functionally equivalent to calling ospf_nexthop_merge
+// (cw->nexthop, w->nexthop) in quagga-0.98.6 (ospf_spf.c::859).
+//
+          NS_LOG_LOGIC ("Equal cost multiple paths found.");
+          std::vector<SPFVertex::NodeExit_t> &exits = state.exits[w];
+          state.ecmpExits.clear ();
+          SPFNexthopCalculation (calc, state, v, *e, state.ecmpExits);
+          exits.insert (exits.end (), state.ecmpExits.begin (), state.ecmpExits.end ());
+          std::sort (exits.begin (), exits.end ());
+          exits.erase (std::unique (exits.begin (), exits.end ()), exits.end ());
+          std::vector<uint32_t> &parents = state.parents[w];
+          if (std::find (parents.begin (), parents.end (), v) == parents.end ())
+            {
+              parents.push_back (v);
+            }
+        }
+      else if (state.distance[w] > distance)
+        {
 //
-// If we've changed the cost to get to the vertex represented by <w>, we 
-// must reorder the priority queue keyed to that cost.
+// This path represents a new, lower-cost path to <w>, which replaces its
+// parents and next hops.  The heap is keyed to the cost, so <w> moves up.
 //
-                  candidate.Reorder ();
-                }
-            } // new lower cost path found
-        } // end W is already on the candidate list
-    } // end loop over the links in V's LSA
+          SPFNexthopCalculation (calc, state, v, *e, state.exits[w]);
+          state.distance[w] = distance;
+          state.parents[w].assign (1, v);
+          state.candidates.Decrease (w, distance, router);
+        }
+    } // end loop over the edges of V
 }
 
 //
 // This method is derived from quagga ospf_nexthop_calculation() 16.1.1.
 //
-// Calculate nexthop from root through V (parent) to vertex W (destination)
-// with given distance from root->W.
-//
-// As appropriate, set w's parent, distance, and nexthop information
+// Calculate the exit directions (next hop and outgoing interface of the
+// root) from root through V (parent) to the target W of the edge <e>.
 //
 // For now, this is greatly simplified from the quagga code
 //
-int
-GlobalRouteManagerImpl::SPFNexthopCalculation (
-  SPFVertex* v, 
-  SPFVertex* w,
-  GlobalRoutingLinkRecord* l,
-  uint32_t distance)
+void
+GlobalRouteManagerImpl::SPFNexthopCalculation (SPFCalculation &calc, SPFState const &state, uint32_t v,
+                                               SPFGraph::Edge const &e,
+                                               std::vector<SPFVertex::NodeExit_t> &exits)
 {
-  NS_LOG_FUNCTION (this << v << w << l << distance);
-//
-// If w is a NetworkVertex, l should be null
-/*
-  if (w->GetVertexType () == SPFVertex::VertexNetwork && l)
-    {
-        NS_ASSERT_MSG (0, "Error:  SPFNexthopCalculation parameter problem");
-    }
-*/
-
-//
-// The vertex m_spfroot is a distinguished vertex representing the node at
-// the root of the calculations.  That is, it is the node for which we are
-// calculating the routes.
+  NS_LOG_FUNCTION (this << v << e.target);
+  SPFGraph::Vertex const &w = m_graph.GetVertex (e.target);
 //
 // There are two distinct cases for calculating the next hop information.
 // First, if we're considering a hop from the root to an "adjacent" network
@@ -1006,117 +1692,66 @@ GlobalRouteManagerImpl::SPFNexthopCalculation (
 // We call the propagation of next hop information down vertices of a path
 // "inheriting" the next hop information.
 //
-// The point-to-point link information is only useful in this calculation when
-// we are examining the root node. 
-//
-  if (v == m_spfroot)
+  if (v == state.root)
     {
-//
-// In this case <v> is the root node, which means it is the starting point
-// for the packets forwarded by that node.  This also means that the next hop
-// address of packets headed for some arbitrary off-network destination must
-// be the destination at the other end of one of the links off of the root
-// node if this root node is a router.  We then need to see if this node <w>
-// is a router.
-//
-      if (w->GetVertexType () == SPFVertex::VertexRouter) 
+      if (w.type == SPFVertex::VertexRouter) 
         {
 //
-// In the case of point-to-point links, the link data field (m_linkData) of a
-// Global Router Link Record contains the local IP address.  If we look at the
-// link record describing the link from the perspecive of <w> (the remote
-// node from the viewpoint of <v>) back to the root node, we can discover the
-// IP address of the router to which <v> is adjacent.  This is a distinguished
-// address -- the next hop address to get from <v> to <w> and all networks 
-// accessed through that path.
-//
-// SPFGetNextLink () is a little odd.  used in this way it is just going to
-// return the link record describing the link from <w> to <v>.  Think of it as
-// SPFGetLink.
-//
-          NS_ASSERT (l);
-          GlobalRoutingLinkRecord *linkRemote = 0;
-          linkRemote = SPFGetNextLink (w, v, linkRemote);
-// 
-// At this point, <l> is the Global Router Link Record describing the point-
-// to point link from <v> to <w> from the perspective of <v>; and <linkRemote>
-// is the Global Router Link Record describing that same link from the 
-// perspective of <w> (back to <v>).  Now we can just copy the next hop 
-// address from the m_linkData member variable.
-// 
-// The next hop member variable we put in <w> has the sense "in order to get
-// from the root node to the host represented by vertex <w>, you have to send
-// the packet to the next hop address specified in w->m_nextHop.
-//
-          Ipv4Address nextHop = linkRemote->GetLinkData ();
-// 
-// Now find the outgoing interface corresponding to the point to point link
-// from the perspective of <v> -- remember that <l> is the link "from"
-// <v> "to" <w>.
-//
-          uint32_t outIf = FindOutgoingInterfaceId (l->GetLinkData ());
-
-          w->SetRootExitDirection (nextHop, outIf);
-          w->SetDistanceFromRoot (distance);
-          w->SetParent (v);
-          NS_LOG_LOGIC ("Next hop from " << 
-                        v->GetVertexId () << " to " << w->GetVertexId () <<
+// In the case of point-to-point links, the link data field of the link
+// record describing the link from <w> back to the root node is the IP
+// address of the router to which the root is adjacent: the next hop address
+// to get from <v> to <w> and all networks accessed through that path.  The
+// link data of <l>, the record from <v> to <w>, gives the outgoing interface.
+//
+          NS_ASSERT (e.link);
+          NS_ASSERT_MSG (e.back, "No link from " << w.id << " back to the root");
+          Ipv4Address nextHop = e.back->GetLinkData ();
+          uint32_t outIf = FindOutgoingInterfaceId (calc, e.link->GetLinkData ());
+          exits.assign (1, SPFVertex::NodeExit_t (nextHop, outIf));
+          NS_LOG_LOGIC ("Next hop from " << m_graph.GetVertex (v).id << " to " << w.id <<
                         " goes through next hop " << nextHop <<
-                        " via outgoing interface " << outIf <<
-                        " with distance " << distance);
-        }  // end W is a router vertes
+                        " via outgoing interface " << outIf);
+        }
       else 
         {
-          NS_ASSERT (w->GetVertexType () == SPFVertex::VertexNetwork);
-// W is a directly connected network; no next hop is required
-          GlobalRoutingLSA* w_lsa = w->GetLSA ();
-          NS_ASSERT (w_lsa->GetLSType () == GlobalRoutingLSA::NetworkLSA);
-// Find outgoing interface ID for this network
-          uint32_t outIf = FindOutgoingInterfaceId (w_lsa->GetLinkStateId (), 
-                                                    w_lsa->GetNetworkLSANetworkMask () );
-// Set the next hop to 0.0.0.0 meaning "not exist"
-          Ipv4Address nextHop = Ipv4Address::GetZero ();
-          w->SetRootExitDirection (nextHop, outIf);
-          w->SetDistanceFromRoot (distance);
-          w->SetParent (v);
-          NS_LOG_LOGIC ("Next hop from " << 
-                        v->GetVertexId () << " to network " << w->GetVertexId () <<
-                        " via outgoing interface " << outIf <<
-                        " with distance " << distance);
-          return 1;
-        }
-    } // end v is the root
-  else if (v->GetVertexType () == SPFVertex::VertexNetwork) 
-    {
-// See if any of v's parents are the root
-      if (v->GetParent () == m_spfroot)
+          NS_ASSERT (w.type == SPFVertex::VertexNetwork);
+//
+// W is a directly connected network; no next hop is required, which is
+// written 0.0.0.0.
+//
+          uint32_t outIf = FindOutgoingInterfaceId (calc, w.lsa->GetLinkStateId (), 
+                                                    w.lsa->GetNetworkLSANetworkMask ());
+          exits.assign (1, SPFVertex::NodeExit_t (Ipv4Address::GetZero (), outIf));
+          NS_LOG_LOGIC ("Next hop from " << m_graph.GetVertex (v).id << " to network " << w.id <<
+                        " via outgoing interface " << outIf);
+        }
+    }
+  else if (m_graph.GetVertex (v).type == SPFVertex::VertexNetwork) 
+    {
+      std::vector<SPFVertex::NodeExit_t> const &vExits = state.exits[v];
+      if (state.parents[v].front () == state.root)
         {
 // 16.1.1 para 5. ...the parent vertex is a network that
 // directly connects the calculating router to the destination
 // router.  The list of next hops is then determined by
-// examining the destination's router-LSA...
-          NS_ASSERT (w->GetVertexType () == SPFVertex::VertexRouter);
-          GlobalRoutingLinkRecord *linkRemote = 0;
-          while ((linkRemote = SPFGetNextLink (w, v, linkRemote)))
+// examining the destination's router-LSA: the link data of the
+// link pointing back to the parent network is the IP address of
+// a next hop router.  The outgoing interface is inherited from
+// the parent network.
+          NS_ASSERT (w.type == SPFVertex::VertexRouter);
+          if (e.back != 0)
             {
-/* ...For each link in the router-LSA that points back to the
- * parent network, the link's Link Data field provides the IP
- * address of a next hop router.  The outgoing interface to
- * use can then be derived from the next hop IP address (or 
- * it can be inherited from the parent network).
- */
-              Ipv4Address nextHop = linkRemote->GetLinkData ();
-              uint32_t outIf = v->GetRootExitDirection ().second;
-              w->SetRootExitDirection (nextHop, outIf);
-              NS_LOG_LOGIC ("Next hop from " <<
-                            v->GetVertexId () << " to " << w->GetVertexId () <<
-                            " goes through next hop " << nextHop <<
-                            " via outgoing interface " << outIf);
+              NS_ASSERT_MSG (vExits.size () == 1, "Assumed there is one exit from the root to this vertex");
+              exits.assign (1, SPFVertex::NodeExit_t (e.back->GetLinkData (), vExits.front ().second));
+              NS_LOG_LOGIC ("Next hop from " << m_graph.GetVertex (v).id << " to " << w.id <<
+                            " goes through next hop " << e.back->GetLinkData () <<
+                            " via outgoing interface " << vExits.front ().second);
             }
         }
       else 
         {
-          w->SetRootExitDirection (v->GetRootExitDirection ());
+          NS_ASSERT_MSG (vExits.size () == 1, "Assumed there is one exit from the root to this vertex");
+          exits.assign (1, vExits.front ());
         }
     }
   else 
@@ -1124,112 +1759,10 @@ GlobalRouteManagerImpl::SPFNexthopCalculation (
 //
 // If we're calculating the next hop information from a node (v) that is 
 // *not* the root, then we need to "inherit" the information needed to
-// forward the packet from the vertex closer to the root.  That is, we'll
-// still send packets to the next hop address of the router adjacent to the
-// root on the path toward <w>.
-//
-// Above, when we were considering the root node, we calculated the next hop
-// address and outgoing interface required to get off of the root network.
-// At this point, we are further away from the root network along one of the
-// (shortest) paths.  So the next hop and outoing interface remain the same
-// (are inherited).
-//
-      w->InheritAllRootExitDirections (v);
-    }
-//
-// In all cases, we need valid values for the distance metric and a parent.
-//
-  w->SetDistanceFromRoot (distance);
-  w->SetParent (v);
-
-  return 1;
-}
-
-//
-// This method is derived from quagga ospf_get_next_link ()
-//
-// First search the Global Router Link Records of vertex <v> for one
-// representing a point-to point link to vertex <w>.
-//
-// What is done depends on prev_link.  Contrary to appearances, prev_link just
-// acts as a flag here.  If prev_link is NULL, we return the first Global
-// Router Link Record we find that describes a point-to-point link from <v> 
-// to <w>.  If prev_link is not NULL, we return a Global Router Link Record
-// representing a possible *second* link from <v> to <w>.
-//
-GlobalRoutingLinkRecord*
-GlobalRouteManagerImpl::SPFGetNextLink (
-  SPFVertex* v,
-  SPFVertex* w,
-  GlobalRoutingLinkRecord* prev_link) 
-{
-  NS_LOG_FUNCTION (this << v << w << prev_link);
-
-  bool skip = true;
-  bool found_prev_link = false;
-  GlobalRoutingLinkRecord* l;
-//
-// If prev_link is 0, we are really looking for the first link, not the next 
-// link.
-//
-  if (prev_link == 0)
-    {
-      skip = false;
-      found_prev_link = true;
-    }
-//
-// Iterate through the Global Router Link Records advertised by the vertex
-// <v> looking for records representing the point-to-point links off of this
-// vertex.
-//
-  for (uint32_t i = 0; i < v->GetLSA ()->GetNLinkRecords (); ++i)
-    {
-      l = v->GetLSA ()->GetLinkRecord (i);
+// forward the packet from the vertex closer to the root.
 //
-// The link ID of a link record representing a point-to-point link is set to
-// the router ID of the neighboring router -- the router to which the link
-// connects from the perspective of <v> in this case.  The vertex ID is also
-// set to the router ID (using the link state advertisement of a router node).
-// We're just checking to see if the link <l> is actually the link from <v> to
-// <w>.
-//
-      if (l->GetLinkId () == w->GetVertexId ()) 
-        {
-          if (!found_prev_link)
-            {
-              NS_LOG_LOGIC ("Skipping links before prev_link found");
-              found_prev_link = true;
-              continue;
-            }
-
-          NS_LOG_LOGIC ("Found matching link l:  linkId = " <<
-                        l->GetLinkId () << " linkData = " << l->GetLinkData ());
-//
-// If skip is false, don't (not too surprisingly) skip the link found -- it's 
-// the one we're interested in.  That's either because we didn't pass in a 
-// previous link, and we're interested in the first one, or because we've 
-// skipped a previous link and moved forward to the next (which is then the
-// one we want).
-//
-          if (skip == false)
-            {
-              NS_LOG_LOGIC ("Returning the found link");
-              return l;
-            }
-          else
-            {
-//
-// Skip is true and we've found a link from <v> to <w>.  We want the next one.
-// Setting skip to false gets us the next point-to-point global router link
-// record in the LSA from <v>.
-//
-              NS_LOG_LOGIC ("Skipping the found link");
-              skip = false;
-              continue;
-            }
-        }
+      exits = state.exits[v];
     }
-  return 0;
 }
 
 //
@@ -1239,7 +1772,22 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
-  SPFCalculate (root);
+  Ptr<Node> node = 0;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd && node == 0; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr != 0 && rtr->GetRouterId () == root)
+        {
+          node = *i;
+        }
+    }
+  SPFCalculation calc;
+  SPFState state;
+  PrepareCalculation (calc, root, node);
+  SPFCalculate (calc, state);
+  SPFAddRoutes (calc);
+  InstallRoutes (calc);
 }
 
 //
@@ -1249,8 +1797,9 @@ GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
 // to be run
 //
 bool
-GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
+GlobalRouteManagerImpl::CheckForStubNode (SPFCalculation &calc)
 {
+  Ipv4Address root = calc.root;
   NS_LOG_FUNCTION (this << root);
   GlobalRoutingLSA *rlsa = m_lsdb->GetLSA (root);
   Ipv4Address myRouterId = rlsa->GetLinkStateId ();
@@ -1312,15 +1861,15 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-                  NS_ASSERT (gr);
-                  gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
-                                         FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                  SPFRoute route;
+                  route.type = SPFRoute::NETWORK;
+                  route.dest = Ipv4Address ("0.0.0.0");
+                  route.mask = Ipv4Mask ("0.0.0.0");
+                  route.nextHop = lr->GetLinkData ();
+                  route.interface = FindOutgoingInterfaceId (calc, transitLink->GetLinkData ());
+                  calc.routes.push_back (route);
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
-                                lr->GetLinkData () << " via interface " << 
-                                FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                                lr->GetLinkData () << " via interface " << route.interface);
                   return true;
                 }
             }
@@ -1331,35 +1880,42 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate (SPFCalculation &calc, SPFState &state)
 {
+  Ipv4Address root = calc.root;
   NS_LOG_FUNCTION (this << root);
-
-  SPFVertex *v;
-//
-// Initialize the Link State Database.
-//
-  m_lsdb->Initialize ();
 //
-// The candidate queue is a priority queue of SPFVertex objects, with the top
-// of the queue being the closest vertex in terms of distance from the root
-// of the tree.  Initially, this queue is empty.
-//
-  CandidateQueue candidate;
-  NS_ASSERT (candidate.Size () == 0);
+// The state of the vertices is private to the calculation, so that the Link
+// State Database and its graph are left untouched.  The arrays are only
+// resized, so that they keep their memory from one calculation to the next.
+//
+  uint32_t n = m_graph.GetNVertices ();
+  state.status.assign (n, GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
+  state.distance.resize (n);
+  state.exits.resize (n);
+  state.parents.resize (n);
+  state.treeIndex.resize (n);
+  state.order.clear ();
+  state.candidates.Reset (n);
+  calc.routes.clear ();
+  calc.tree.stub = false;
+  calc.tree.vertices.clear ();
+  calc.tree.routers.clear ();
+  calc.tree.exits.clear ();
 //
 // Initialize the shortest-path tree to only contain the router doing the 
 // calculation.  Each router (and corresponding network) is a vertex in the
-// shortest path first (SPF) tree.
-//
-  v = new SPFVertex (m_lsdb->GetLSA (root));
-// 
-// This vertex is the root of the SPF tree and it is distance 0 from the root.
-// We also mark this vertex as being in the SPF tree.
-//
-  m_spfroot= v;
-  v->SetDistanceFromRoot (0);
-  v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+// shortest path first (SPF) tree.  This vertex is the root of the SPF tree
+// and it is distance 0 from the root.
+//
+  uint32_t v = m_graph.Find (root);
+  NS_ASSERT_MSG (v != SPFGraph::NO_VERTEX, "No LSA for the root " << root);
+  state.root = v;
+  state.distance[v] = 0;
+  state.exits[v].clear ();
+  state.parents[v].clear ();
+  state.status[v] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+  AddTreeVertex (calc.tree, state, v);
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
 
 //
@@ -1369,106 +1925,52 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+  if (calc.checkStub && CheckForStubNode (calc))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
-      delete m_spfroot;
+      calc.tree.stub = true;
       return;
     }
 
   for (;;)
     {
 //
-// The operations we need to do are given in the OSPF RFC which we reference
-// as we go along.
-//
 // RFC2328 16.1. (2). 
 //
-// We examine the Global Router Link Records in the Link State 
-// Advertisements of the current vertex.  If there are any point-to-point
-// links to unexplored adjacent vertices we add them to the tree and update
-// the distance and next hop information on how to get there.  We also add
-// the new vertices to the candidate queue (the priority queue ordered by
-// shortest path).  If the new vertices represent shorter paths, we use them
-// and update the path cost.
+// We examine the edges of the current vertex.  If there are any links to
+// unexplored adjacent vertices we add them to the candidates and compute
+// the distance and next hop information on how to get there.  If the new
+// vertices represent shorter paths, we use them and update the path cost.
 //
-      SPFNext (v, candidate);
+      SPFNext (calc, state, v);
 //
 // RFC2328 16.1. (3). 
 //
-// If at this step the candidate list is empty, the shortest-path tree (of
+// If at this step the candidate heap is empty, the shortest-path tree (of
 // transit vertices) has been completely built and this stage of the
 // procedure terminates. 
 //
-      if (candidate.Size () == 0)
+      if (state.candidates.Empty ())
         {
           break;
         }
 //
-// Choose the vertex belonging to the candidate list that is closest to the
-// root, and add it to the shortest-path tree (removing it from the candidate
-// list in the process).
-//
-// Recall that in the previous step, we created SPFVertex structures for each
-// of the routers found in the Global Router Link Records and added tehm to 
-// the candidate list.
-//
-      NS_LOG_LOGIC (candidate);
-      v = candidate.Pop ();
-      NS_LOG_LOGIC ("Popped vertex " << v->GetVertexId ());
+// Choose the vertex belonging to the candidate heap that is closest to the
+// root, and add it to the shortest-path tree.  Note that when there is a
+// choice of vertices closest to the root, network vertices must be chosen
+// before router vertices in order to necessarily find all equal-cost paths. 
 //
-// Update the status field of the vertex to indicate that it is in the SPF
-// tree.
-//
-      v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
-//
-// The current vertex has a parent pointer.  By calling this rather oddly 
-// named method (blame quagga) we add the current vertex to the list of 
-// children of that parent vertex.  In the next hop calculation called during
-// SPFNext, the parent pointer was set but the vertex has been orphaned up
-// to now.
-//
-      SPFVertexAddParent (v);
-//
-// Note that when there is a choice of vertices closest to the root, network
-// vertices must be chosen before router vertices in order to necessarily
-// find all equal-cost paths. 
+      v = state.candidates.Pop ();
+      NS_LOG_LOGIC ("Popped vertex " << m_graph.GetVertex (v).id);
+      state.status[v] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
 //
 // RFC2328 16.1. (4). 
 //
-// This is the method that actually adds the routes.  It'll walk the list
-// of nodes in the system, looking for the node corresponding to the router
-// ID of the root of the tree -- that is the router we're building the routes
-// for.  It looks for the Ipv4 interface of that node and remembers it.  So
-// we are only actually adding routes to that one node at the root of the SPF 
-// tree.
+// The vertex is now in the tree, with its final distance and exit
+// directions.  Record it; SPFAddRoutes adds the routes to the vertices in
+// the order in which they joined the tree.
 //
-// We're going to pop of a pointer to every vertex in the tree except the 
-// root in order of distance from the root.  For each of the vertices, we call
-// SPFIntraAddRouter ().  Down in SPFIntraAddRouter, we look at all of the 
-// point-to-point Global Router Link Records (the links to nodes adjacent to
-// the node represented by the vertex).  We add a route to the IP address 
-// specified by the m_linkData field of each of those link records.  This will
-// be the *local* IP address associated with the interface attached to the 
-// link.  We use the outbound interface and next hop information present in 
-// the vertex <v> which have possibly been inherited from the root.
-//
-// To summarize, we're going to look at the node represented by <v> and loop
-// through its point-to-point links, adding a *host* route to the local IP
-// address (at the <v> side) for each of those links.
-//
-      if (v->GetVertexType () == SPFVertex::VertexRouter)
-        {
-          SPFIntraAddRouter (v);
-        }
-      else if (v->GetVertexType () == SPFVertex::VertexNetwork)
-        {
-          SPFIntraAddTransit (v);
-        }
-      else
-        {
-          NS_ASSERT_MSG (0, "illegal SPFVertex type");
-        }
+      AddTreeVertex (calc.tree, state, v);
 //
 // RFC2328 16.1. (5). 
 //
@@ -1477,438 +1979,277 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 
     }  // end for loop
 
-// Second stage of SPF calculation procedure
-  SPFProcessStubs (m_spfroot);
-  for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs (); i++)
+//
+// The children of a vertex are the vertices of which it is a parent, in the
+// order in which they joined the tree.
+//
+  uint32_t nTree = state.order.size ();
+  state.firstChild.assign (nTree + 1, 0);
+  for (uint32_t i = 1; i < nTree; i++)
     {
-      m_spfroot->ClearVertexProcessed ();
-      GlobalRoutingLSA *extlsa = m_lsdb->GetExtLSA (i);
-      NS_LOG_LOGIC ("Processing External LSA with id " << extlsa->GetLinkStateId ());
-      ProcessASExternals (m_spfroot, extlsa);
+      std::vector<uint32_t> const &parents = state.parents[state.order[i]];
+      for (uint32_t j = 0; j < parents.size (); j++)
+        {
+          state.firstChild[state.treeIndex[parents[j]] + 1]++;
+        }
+    }
+  for (uint32_t i = 0; i < nTree; i++)
+    {
+      state.firstChild[i + 1] += state.firstChild[i];
     }
+  state.nextChild.assign (state.firstChild.begin (), state.firstChild.end () - 1);
+  state.children.resize (state.firstChild[nTree]);
+  for (uint32_t i = 1; i < nTree; i++)
+    {
+      std::vector<uint32_t> const &parents = state.parents[state.order[i]];
+      for (uint32_t j = 0; j < parents.size (); j++)
+        {
+          state.children[state.nextChild[state.treeIndex[parents[j]]]++] = i;
+        }
+    }
+  state.processed.assign (nTree, false);
 
-//
-// We're all done setting the routing information for the node at the root of
-// the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-// possibly do it again for the next router.
-//
-  delete m_spfroot;
-  m_spfroot = 0;
+// Second stage of SPF calculation procedure: the stub networks and the AS
+// external routes are added by walking the tree in depth-first order.
+  SPFListRouters (calc, state, 0);
+}
+
+void
+GlobalRouteManagerImpl::AddTreeVertex (SPFTree &tree, SPFState &state, uint32_t v)
+{
+  SPFGraph::Vertex const &graphVertex = m_graph.GetVertex (v);
+  std::vector<SPFVertex::NodeExit_t> const &exits = state.exits[v];
+  SPFTreeVertex vertex;
+  vertex.id = graphVertex.id;
+  vertex.type = graphVertex.type;
+  vertex.distance = state.distance[v];
+  vertex.lsa = graphVertex.lsa;
+  vertex.exit = tree.exits.size ();
+  vertex.nExits = exits.size ();
+  tree.exits.insert (tree.exits.end (), exits.begin (), exits.end ());
+  state.treeIndex[v] = tree.vertices.size ();
+  state.order.push_back (v);
+  tree.vertices.push_back (vertex);
 }
 
+// Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
+// The router vertices are listed in the order in which the stub networks
+// and the AS external LSAs of their routers are processed.
 void
-GlobalRouteManagerImpl::ProcessASExternals (SPFVertex* v, GlobalRoutingLSA* extlsa)
+GlobalRouteManagerImpl::SPFListRouters (SPFCalculation &calc, SPFState &state, uint32_t v)
 {
-  NS_LOG_FUNCTION (this << v << extlsa);
-  NS_LOG_LOGIC ("Processing external for destination " << 
-                extlsa->GetLinkStateId () <<
-                ", for router "  << v->GetVertexId () <<
-                ", advertised by " << extlsa->GetAdvertisingRouter ());
-  if (v->GetVertexType () == SPFVertex::VertexRouter)
+  NS_LOG_FUNCTION (this << v);
+  if (calc.tree.vertices[v].type == SPFVertex::VertexRouter)
     {
-      GlobalRoutingLSA *rlsa = v->GetLSA ();
-      NS_LOG_LOGIC ("Processing router LSA with id " << rlsa->GetLinkStateId ());
-      if ((rlsa->GetLinkStateId ()) == (extlsa->GetAdvertisingRouter ()))
-        {
-          NS_LOG_LOGIC ("Found advertising router to destination");
-          SPFAddASExternal (extlsa,v);
-        }
+      calc.tree.routers.push_back (v);
     }
-  for (uint32_t i = 0; i < v->GetNChildren (); i++)
+  for (uint32_t i = state.firstChild[v]; i < state.firstChild[v + 1]; i++)
     {
-      if (!v->GetChild (i)->IsVertexProcessed ())
+      uint32_t child = state.children[i];
+      if (!state.processed[child])
         {
-          NS_LOG_LOGIC ("Vertex's child " << i << " not yet processed, processing...");
-          ProcessASExternals (v->GetChild (i), extlsa);
-          v->GetChild (i)->SetVertexProcessed (true);
+          SPFListRouters (calc, state, child);
+          state.processed[child] = true;
         }
     }
 }
 
-//
-// Adding external routes to routing table - modeled after
-// SPFAddIntraAddStub()
-//
-
 void
-GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v)
+GlobalRouteManagerImpl::SPFAddRoutes (SPFCalculation &calc)
 {
-  NS_LOG_FUNCTION (this << extlsa << v);
-
-  NS_ASSERT_MSG (m_spfroot, "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
-// Two cases to consider: We are advertising the external ourselves
-// => No need to add anything
-// OR find best path to the advertising router
-  if (v->GetVertexId () == m_spfroot->GetVertexId ())
+  NS_LOG_FUNCTION (this << calc.root);
+  if (calc.tree.stub)
     {
-      NS_LOG_LOGIC ("External is on local host: " 
-                    << v->GetVertexId () << "; returning");
+      // CheckForStubNode added the default route.
       return;
     }
-  NS_LOG_LOGIC ("External is on remote host: " 
-                << extlsa->GetAdvertisingRouter () << "; installing");
-
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
+  calc.routes.clear ();
+  std::vector<SPFTreeVertex> const &vertices = calc.tree.vertices;
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// For each of the vertices but the root, in the order in which they joined
+// the tree, we look at the node represented by the vertex and add a host
+// route to the local IP address of each of its point-to-point links, or a
+// network route to the transit network.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  for (uint32_t i = 1; i < vertices.size (); i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
+      if (vertices[i].type == SPFVertex::VertexRouter)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
+          SPFIntraAddRouter (calc, vertices[i]);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else if (vertices[i].type == SPFVertex::VertexNetwork)
         {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-
+          SPFIntraAddTransit (calc, vertices[i]);
+        }
+      else
+        {
+          NS_ASSERT_MSG (0, "illegal SPFVertex type");
+        }
+    }
 //
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
-}
-
-
-// Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
 // stub link records will exist for point-to-point interfaces and for
 // broadcast interfaces for which no neighboring router can be found
-void
-GlobalRouteManagerImpl::SPFProcessStubs (SPFVertex* v)
-{
-  NS_LOG_FUNCTION (this << v);
-  NS_LOG_LOGIC ("Processing stubs for " << v->GetVertexId ());
-  if (v->GetVertexType () == SPFVertex::VertexRouter)
+//
+  for (uint32_t i = 0; i < calc.tree.routers.size (); i++)
     {
-      GlobalRoutingLSA *rlsa = v->GetLSA ();
+      SPFTreeVertex const &v = vertices[calc.tree.routers[i]];
+      GlobalRoutingLSA *rlsa = v.lsa;
       NS_LOG_LOGIC ("Processing router LSA with id " << rlsa->GetLinkStateId ());
-      for (uint32_t i = 0; i < rlsa->GetNLinkRecords (); i++)
+      for (uint32_t j = 0; j < rlsa->GetNLinkRecords (); j++)
         {
-          NS_LOG_LOGIC ("Examining link " << i << " of " << 
-                        v->GetVertexId () << "'s " <<
-                        v->GetLSA ()->GetNLinkRecords () << " link records");
-          GlobalRoutingLinkRecord *l = v->GetLSA ()->GetLinkRecord (i);
+          GlobalRoutingLinkRecord *l = rlsa->GetLinkRecord (j);
           if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
             {
               NS_LOG_LOGIC ("Found a Stub record to " << l->GetLinkId ());
-              SPFIntraAddStub (l, v);
-              continue;
+              SPFIntraAddStub (calc, l, v);
             }
         }
     }
-  for (uint32_t i = 0; i < v->GetNChildren (); i++)
+  for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs (); i++)
     {
-      if (!v->GetChild (i)->IsVertexProcessed ())
+      GlobalRoutingLSA *extlsa = m_lsdb->GetExtLSA (i);
+      NS_LOG_LOGIC ("Processing External LSA with id " << extlsa->GetLinkStateId ());
+      for (uint32_t j = 0; j < calc.tree.routers.size (); j++)
         {
-          SPFProcessStubs (v->GetChild (i));
-          v->GetChild (i)->SetVertexProcessed (true);
+          SPFTreeVertex const &v = vertices[calc.tree.routers[j]];
+          if (v.lsa->GetLinkStateId () == extlsa->GetAdvertisingRouter ())
+            {
+              NS_LOG_LOGIC ("Found advertising router to destination");
+              SPFAddASExternal (calc, extlsa, v);
+            }
         }
     }
 }
 
-// RFC2328 16.1. second stage. 
+//
+// Adding external routes to routing table - modeled after
+// SPFAddIntraAddStub()
+//
+
 void
-GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex* v)
+GlobalRouteManagerImpl::SPFAddASExternal (SPFCalculation &calc, GlobalRoutingLSA *extlsa,
+                                          SPFTreeVertex const &v)
 {
-  NS_LOG_FUNCTION (this << l << v);
+  NS_LOG_FUNCTION (this << extlsa << v.id);
+
+// Two cases to consider: We are advertising the external ourselves
+// => No need to add anything
+// OR find best path to the advertising router
+  if (v.id == calc.root)
+    {
+      NS_LOG_LOGIC ("External is on local host: " 
+                    << v.id << "; returning");
+      return;
+    }
+  NS_LOG_LOGIC ("External is on remote host: " 
+                << extlsa->GetAdvertisingRouter () << "; installing");
+
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  SPFAddRoute (calc, SPFRoute::EXTERNAL, tempip, tempmask, v);
+}
 
-  NS_ASSERT_MSG (m_spfroot, 
-                 "GlobalRouteManagerImpl::SPFIntraAddStub (): Root pointer not set");
+// RFC2328 16.1. second stage. 
+void
+GlobalRouteManagerImpl::SPFIntraAddStub (SPFCalculation &calc, GlobalRoutingLinkRecord *l,
+                                         SPFTreeVertex const &v)
+{
+  NS_LOG_FUNCTION (this << l << v.id);
 
   // XXX simplifed logic for the moment.  There are two cases to consider:
   // 1) the stub network is on this router; do nothing for now
   //    (already handled above)
   // 2) the stub network is on a remote router, so I should use the
   // same next hop that I use to get to vertex v
-  if (v->GetVertexId () == m_spfroot->GetVertexId ())
+  if (v.id == calc.root)
     {
-      NS_LOG_LOGIC ("Stub is on local host: " << v->GetVertexId () << "; returning");
+      NS_LOG_LOGIC ("Stub is on local host: " << v.id << "; returning");
       return;
     }
-  NS_LOG_LOGIC ("Stub is on remote host: " << v->GetVertexId () << "; installing");
-//
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
+  NS_LOG_LOGIC ("Stub is on remote host: " << v.id << "; installing");
+
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  SPFAddRoute (calc, SPFRoute::NETWORK, tempip, tempmask, v);
+}
 
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// Add a route to the destination through each of the exit directions of the
+// vertex <v>.  The vertex <v> has the next hop addresses precalculated for us
+// that are the addresses to which the root node should send packets to be
+// forwarded to the destination, and the outbound interface indices through
+// which the packets should be sent.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+void
+GlobalRouteManagerImpl::SPFAddRoute (SPFCalculation &calc, SPFRoute::Type type,
+                                     Ipv4Address dest, Ipv4Mask mask, SPFTreeVertex const &v)
+{
+  for (uint32_t i = 0; i < v.nExits; i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
+      SPFVertex::NodeExit_t const &exit = calc.tree.exits[v.exit + i];
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
+          SPFRoute route;
+          route.type = type;
+          route.dest = dest;
+          route.mask = mask;
+          route.nextHop = nextHop;
+          route.interface = outIf;
+          calc.routes.push_back (route);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << calc.root <<
+                        " add route to " << dest <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << calc.root <<
+                        " NOT able to add route to " << dest <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
+        }
+    }
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This does what GetInterfaceForPrefix() does, on the addresses of the root
+// copied by PrepareCalculation.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
 int32_t
-GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
+GlobalRouteManagerImpl::FindOutgoingInterfaceId (SPFCalculation const &calc, Ipv4Address a, Ipv4Mask amask)
 {
   NS_LOG_FUNCTION (this << a << amask);
-//
-// We have an IP address <a> and a vertex ID of the root of the SPF tree.
-// The question is what interface index does this address correspond to.
-// The answer is a little complicated since we have to find a pointer to
-// the node corresponding to the vertex ID, find the Ipv4 interface on that
-// node in order to iterate the interfaces and find the one corresponding to
-// the address in question.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-//
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  for (uint32_t i = 0; i < calc.addresses.size (); i++)
     {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
-        {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
+      if (calc.addresses[i].second.CombineMask (amask) == a.CombineMask (amask))
         {
-//
-// This is the node we're building the routing table for.  We're going to need
-// the Ipv4 interface to look for the ipv4 interface index.  Since this node
-// is participating in routing IP version 4 packets, it certainly must have 
-// an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Look through the interfaces on this node for one that has the IP address
-// we're looking for.  If we find one, return the corresponding interface
-// index, or -1 if not found.
-//
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif 
-          return interface;
+          return calc.addresses[i].first;
         }
     }
 //
 // Couldn't find it.
 //
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
+  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find an interface of " << calc.root << " for " << a);
   return -1;
 }
 
 //
 // This method is derived from quagga ospf_intra_add_router ()
 //
-// This is where we are actually going to add the host routes to the routing
-// tables of the individual nodes.
+// This is where we are actually going to find the host routes of the root.
 //
-// The vertex passed as a parameter has just been added to the SPF tree.
+// The vertex passed as a parameter is in the SPF tree.
 // This vertex must have a valid m_root_oid, corresponding to the outgoing
 // interface on the root router of the tree that is the first hop on the path
 // to the vertex.  The vertex must also have a next hop address, corresponding
@@ -1919,77 +2260,21 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 // route.
 //
 void
-GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddRouter (SPFCalculation &calc, SPFTreeVertex const &v)
 {
-  NS_LOG_FUNCTION (this << v);
-
-  NS_ASSERT_MSG (m_spfroot, 
-                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
-//
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
+  NS_LOG_FUNCTION (this << v.id);
 //
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = v.lsa;
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -1998,201 +2283,52 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Node " << calc.root <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
+        }
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
 // record.  In the case of a point-to-point link, this is the local IP address
 // of the node connected to the link.  Each of these point-to-point links
 // will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
-            }
-//
-// Done adding the routes for the selected node.
+// the node at the root of the SPF tree can send packets.
 //
-          return;
-        }
+      // walk through all available exit directions due to ECMP,
+      // and add host route for each of the exit direction toward
+      // the vertex 'v'
+      SPFAddRoute (calc, SPFRoute::HOST, lr->GetLinkData (), Ipv4Mask::GetOnes (), v);
     }
 }
+
 void
-GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddTransit (SPFCalculation &calc, SPFTreeVertex const &v)
 {
-  NS_LOG_FUNCTION (this << v);
-
-  NS_ASSERT_MSG (m_spfroot, 
-                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
-//
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
+  NS_LOG_FUNCTION (this << v.id);
 //
 // Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
-        }
-    } 
-}
-
-// Derived from quagga ospf_vertex_add_parents ()
-//
-// This is a somewhat oddly named method (blame quagga).  Although you might
-// expect it to add a parent *to* something, it actually adds a vertex
-// to the list of children *in* each of its parents. 
-//
-// Given a pointer to a vertex, it links back to the vertex's parent that it
-// already has set and adds itself to that vertex's list of children.
-//
-void
-GlobalRouteManagerImpl::SPFVertexAddParent (SPFVertex* v)
-{
-  NS_LOG_FUNCTION (this << v);
-
-  for (uint32_t i=0;;)
-    {
-      SPFVertex* parent;
-      // check if all parents of vertex v
-      if ((parent = v->GetParent (i++)) == 0) break;
-      parent->AddChild (v);
-    }
+// adding the routes to.  This is the network LSA of the transit network.
+//
+  GlobalRoutingLSA *lsa = v.lsa;
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all available exit directions due to ECMP,
+  // and add network route for each of the exit direction toward
+  // the vertex 'v'
+  SPFAddRoute (calc, SPFRoute::NETWORK, tempip, tempmask, v);
 }
 
 } // namespace ns3
@@ -30,6 +30,10 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#endif /* HAVE_PTHREAD_H */
 #include "global-router-interface.h"
 
 namespace ns3 {
@@ -38,6 +42,7 @@ const uint32_t SPF_INFINITY = 0xffffffff;
 
 class CandidateQueue;
 class Ipv4GlobalRouting;
+class Node;
 
 /**
  * @brief Vertex used in shortest path first (SPF) computations. See \RFC{2328},
@@ -665,6 +670,17 @@ public:
   GlobalRoutingLSA* GetExtLSA (uint32_t index) const;
   uint32_t GetNumExtLSAs () const;
 
+/**
+ * @brief Compare the database with an older one, for incremental SPF.
+ * @internal
+ *
+ * @param old The older database.
+ * @param changed Set to the router LSAs of this database which differ from
+ * the LSA of the same router in the older database.
+ * @returns False if the databases differ in anything else than the link
+ * records of some router LSAs, in which case changed is meaningless.
+ */
+  bool Diff (GlobalRouteManagerLSDB const &old, std::vector<GlobalRoutingLSA *> &changed) const;
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t;
@@ -684,6 +700,76 @@ private:
  * need for it and a compiler provided shallow copy would be wrong.
  */
   GlobalRouteManagerLSDB& operator= (GlobalRouteManagerLSDB& lsdb);
+
+  friend class SPFGraph;
+};
+
+/**
+ * @brief The router and network LSAs of a Link State Database, compiled into
+ * a graph in compressed sparse row form for the SPF calculations.
+ *
+ * The vertices are numbered in the order of the link state IDs, and the
+ * edges leaving a vertex are stored contiguously, in the order of the link
+ * records (router LSA) or of the attached routers (network LSA) they are
+ * derived from.  The lookups which the SPF calculation used to make in the
+ * database for each edge, such as finding the router LSA of an attached
+ * router or the link record pointing back to a vertex, are done once when
+ * the graph is built.  The graph points into the LSAs of the database, so
+ * that it must be built again whenever the database is.
+ */
+class SPFGraph
+{
+public:
+  /// The index of a vertex which is not in the graph
+  static const uint32_t NO_VERTEX = 0xffffffff;
+
+  struct Vertex
+  {
+    Ipv4Address id;
+    SPFVertex::VertexType type;
+    GlobalRoutingLSA *lsa;
+    /// The index of the first edge of the vertex
+    uint32_t edges;
+  };
+
+  struct Edge
+  {
+    /// NO_VERTEX if the link record points to an LSA not in the database
+    uint32_t target;
+    /// The metric of the link record, zero for the edges of a network
+    uint32_t metric;
+    /// The link record of a router vertex, zero for a network vertex
+    GlobalRoutingLinkRecord *link;
+    /**
+     * The link record of the target pointing back to the source: the first
+     * one if the source is a router, the last one if it is a network, zero if
+     * there is none.
+     */
+    GlobalRoutingLinkRecord *back;
+  };
+
+  SPFGraph ();
+  /**
+   * @brief Compile the router and network LSAs of the database.
+   * @param lsdb The database, which must be complete.
+   */
+  void Build (GlobalRouteManagerLSDB const &lsdb);
+  uint32_t GetNVertices (void) const;
+  Vertex const &GetVertex (uint32_t i) const;
+  /**
+   * @param id A link state ID.
+   * @returns The index of the vertex of the LSA, or NO_VERTEX.
+   */
+  uint32_t Find (Ipv4Address id) const;
+  /// @returns The first edge leaving the vertex i
+  Edge const *GetEdgesBegin (uint32_t i) const;
+  /// @returns Past the last edge leaving the vertex i
+  Edge const *GetEdgesEnd (uint32_t i) const;
+
+private:
+  /// One more vertex than in the graph, whose first edge is the end of m_edges
+  std::vector<Vertex> m_vertices;
+  std::vector<Edge> m_edges;
 };
 
 /**
@@ -696,6 +782,12 @@ private:
  * and finally configure each of the node's forwarding tables.
  *
  * The design is guided by OSPFv2 \RFC{2328} section 16.1.1 and quagga ospfd.
+ *
+ * The SPF calculations of the roots are independent of each other, and are
+ * run by the number of threads given by the "GlobalRoutingThreads" global
+ * value.  The routes are installed by the main thread once the calculations
+ * are done, so that the routing tables are the same whatever the number of
+ * threads.
  */
 class GlobalRouteManagerImpl
 {
@@ -727,6 +819,21 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes after a
+ * topology change.
+ * @internal
+ *
+ * When the "GlobalRoutingIncremental" global value is set, the shortest path
+ * trees of the previous calculation are kept, and only the roots whose tree
+ * may be changed by the router LSAs which differ from the previous database
+ * run the SPF calculation again.  The routes of the other roots are derived
+ * from their previous tree.  Otherwise, or if anything else than router LSAs
+ * changed, this is DeleteGlobalRoutes, BuildGlobalRoutingDatabase and
+ * InitializeRoutes.
+ */
+  virtual void RecomputeRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  * @internal
@@ -754,23 +861,117 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
-  SPFVertex* m_spfroot;
+  /**
+   * @brief A route found by an SPF calculation, to be installed in the
+   * routing table of the root.
+   */
+  struct SPFRoute
+  {
+    enum Type
+    {
+      HOST,
+      NETWORK,
+      EXTERNAL
+    } type;
+    Ipv4Address dest;
+    Ipv4Mask mask;
+    Ipv4Address nextHop;
+    uint32_t interface;
+  };
+
+  /**
+   * @brief A vertex of a shortest path tree.
+   */
+  struct SPFTreeVertex
+  {
+    Ipv4Address id;
+    SPFVertex::VertexType type;
+    uint32_t distance;
+    GlobalRoutingLSA *lsa;
+    uint32_t exit;      //!< The index of the first exit direction in SPFTree::exits
+    uint32_t nExits;
+  };
+
+  /**
+   * @brief The shortest path tree of a root, from which its routes are
+   * derived.  Kept from one calculation to the next in incremental mode.
+   */
+  struct SPFTree
+  {
+    /// True if CheckForStubNode short-circuited the calculation
+    bool stub;
+    /// The root first, then the vertices in the order they joined the tree
+    std::vector<SPFTreeVertex> vertices;
+    /// The indices of the router vertices, in depth-first order
+    std::vector<uint32_t> routers;
+    std::vector<SPFVertex::NodeExit_t> exits;
+  };
+
+  /**
+   * @brief The state of the SPF calculation of one root.  Each calculation
+   * is run by a single thread and shares nothing but the LSDB, which is
+   * read-only while the calculations run.
+   */
+  struct SPFCalculation
+  {
+    Ipv4Address root;
+    /// The Ipv4GlobalRouting of the root, zero if the root is not a node
+    Ptr<Ipv4GlobalRouting> routing;
+    /// The interfaces and local addresses of the root, in interface order
+    std::vector<std::pair<uint32_t, Ipv4Address> > addresses;
+    /// Whether stub routers get a default route instead of an SPF calculation
+    bool checkStub;
+    /// True if the tree is kept from the previous calculation
+    bool reuse;
+    SPFTree tree;
+    std::vector<SPFRoute> routes;
+  };
+
+  typedef std::map<Ipv4Address, SPFTree> SPFTreeMap_t;
+
+  /**
+   * @brief The per-vertex arrays and the candidate heap of the SPF
+   * calculation, kept by each thread from one calculation to the next so
+   * that the calculations do not allocate memory once they are warmed up.
+   */
+  struct SPFState;
+
   GlobalRouteManagerLSDB* m_lsdb;
-  bool CheckForStubNode (Ipv4Address root);
-  void SPFCalculate (Ipv4Address root);
-  void SPFProcessStubs (SPFVertex* v);
-  void ProcessASExternals (SPFVertex* v, GlobalRoutingLSA* extlsa);
-  void SPFNext (SPFVertex*, CandidateQueue&);
-  int SPFNexthopCalculation (SPFVertex* v, SPFVertex* w, 
-                             GlobalRoutingLinkRecord* l, uint32_t distance);
-  void SPFVertexAddParent (SPFVertex* v);
-  GlobalRoutingLinkRecord* SPFGetNextLink (SPFVertex* v, SPFVertex* w, 
-                                           GlobalRoutingLinkRecord* prev_link);
-  void SPFIntraAddRouter (SPFVertex* v);
-  void SPFIntraAddTransit (SPFVertex* v);
-  void SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex* v);
-  void SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v);
-  int32_t FindOutgoingInterfaceId (Ipv4Address a, 
+  /// The graph of m_lsdb
+  SPFGraph m_graph;
+  /// The trees of the last calculation, in incremental mode
+  SPFTreeMap_t m_trees;
+  /// The calculations run by the worker threads, and the next one to run
+  std::vector<SPFCalculation *> *m_calculations;
+  uint32_t m_nextCalculation;
+#ifdef HAVE_PTHREAD_H
+  SystemMutex m_mutex;
+#endif /* HAVE_PTHREAD_H */
+
+  void DeleteRoutes (void);
+  void DeleteRoutes (Ptr<Ipv4GlobalRouting> gr);
+  void PrepareCalculation (SPFCalculation &calc, Ipv4Address root, Ptr<Node> node);
+  void RunCalculations (std::vector<SPFCalculation *> &calculations, bool keepTrees);
+  void SPFWorker (void);
+  void InstallRoutes (SPFCalculation const &calc);
+  bool IsAffected (SPFTree const &tree, Ipv4Address root,
+                   GlobalRouteManagerLSDB const &oldLsdb,
+                   std::vector<GlobalRoutingLSA *> const &changed) const;
+  bool CheckForStubNode (SPFCalculation &calc);
+  void SPFCalculate (SPFCalculation &calc, SPFState &state);
+  void AddTreeVertex (SPFTree &tree, SPFState &state, uint32_t v);
+  void SPFListRouters (SPFCalculation &calc, SPFState &state, uint32_t v);
+  void SPFAddRoutes (SPFCalculation &calc);
+  void SPFNext (SPFCalculation &calc, SPFState &state, uint32_t v);
+  void SPFNexthopCalculation (SPFCalculation &calc, SPFState const &state, uint32_t v,
+                              SPFGraph::Edge const &e, std::vector<SPFVertex::NodeExit_t> &exits);
+  void SPFIntraAddRouter (SPFCalculation &calc, SPFTreeVertex const &v);
+  void SPFIntraAddTransit (SPFCalculation &calc, SPFTreeVertex const &v);
+  void SPFIntraAddStub (SPFCalculation &calc, GlobalRoutingLinkRecord *l, SPFTreeVertex const &v);
+  void SPFAddASExternal (SPFCalculation &calc, GlobalRoutingLSA *extlsa, SPFTreeVertex const &v);
+  void SPFAddRoute (SPFCalculation &calc, SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                    SPFTreeVertex const &v);
+  int32_t FindOutgoingInterfaceId (SPFCalculation const &calc, Ipv4Address a, 
                                    Ipv4Mask amask = Ipv4Mask ("255.255.255.255"));
 };
 
@@ -67,6 +67,15 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes of all the
+ * nodes after a topology change.  In incremental mode (see the
+ * "GlobalRoutingIncremental" global value), only the routers whose shortest
+ * path tree may have changed run the SPF calculation again.
+ * @internal
+ */
+  static void RecomputeRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
@@ -371,7 +371,7 @@ void Icmpv6L4Protocol::ReceiveLLA (Icmpv6OptionLinkLayerAddress lla, Ipv6Address
       entry->MarkReachable ();
       entry->StartReachableTimer ();
     }
-  else
+  else if (!entry->IsPermanent ())
     {
       std::list<Ptr<Packet> > waiting;
       if (entry->IsIncomplete ())
@@ -450,7 +450,7 @@ void Icmpv6L4Protocol::HandleRS (Ptr<Packet> packet, Ipv6Address const &src, Ipv
           entry->SetRouter (false);
           entry->MarkStale (lla.GetAddress ());
         }
-      else if (entry->GetMacAddress () != lla.GetAddress ())
+      else if (!entry->IsPermanent () && entry->GetMacAddress () != lla.GetAddress ())
         {
           entry->MarkStale (lla.GetAddress ());
         }
@@ -522,7 +522,7 @@ void Icmpv6L4Protocol::HandleNS (Ptr<Packet> packet, Ipv6Address const &src, Ipv
           entry->SetRouter (false);
           entry->MarkStale (lla.GetAddress ());
         }
-      else if (entry->GetMacAddress () != lla.GetAddress ())
+      else if (!entry->IsPermanent () && entry->GetMacAddress () != lla.GetAddress ())
         {
           entry->MarkStale (lla.GetAddress ());
         }
@@ -649,6 +649,11 @@ void Icmpv6L4Protocol::HandleNA (Ptr<Packet> packet, Ipv6Address const &src, Ipv
     }
   packet->RemoveHeader (lla);
 
+  if (entry->IsPermanent ())
+    {
+      return;
+    }
+
   if (entry->IsIncomplete ())
     {
       /* we receive a NA so stop the retransmission timer */
@@ -769,7 +774,7 @@ void Icmpv6L4Protocol::HandleRedirection (Ptr<Packet> packet, Ipv6Address const
           entry->SetMacAddress (llOptionHeader.GetAddress ());
           entry->MarkStale ();
         }
-      else
+      else if (!entry->IsPermanent ())
         {
           if (entry->IsIncomplete () || entry->GetMacAddress () != llOptionHeader.GetAddress ())
             {
@@ -1288,7 +1293,7 @@ bool Icmpv6L4Protocol::Lookup (Ipv6Address dst, Ptr<NetDevice> device, Ptr<Ndisc
       NdiscCache::Entry* entry = cache->Lookup (dst);
       if (entry)
         {
-          if (entry->IsReachable () || entry->IsDelay ())
+          if (entry->IsReachable () || entry->IsDelay () || entry->IsPermanent ())
             {
               *hardwareDestination = entry->GetMacAddress ();
               return true;
@@ -1322,7 +1327,7 @@ bool Icmpv6L4Protocol::Lookup (Ptr<Packet> p, Ipv6Address dst, Ptr<NetDevice> de
   NdiscCache::Entry* entry = cache->Lookup (dst);
   if (entry)
     {
-      if (entry->IsReachable () || entry->IsDelay ())
+      if (entry->IsReachable () || entry->IsDelay () || entry->IsPermanent ())
         {
           /* XXX check reachability time */
           /* send packet */
@@ -18,6 +18,8 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+
+#include <algorithm>
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ns3/log.h"
@@ -27,7 +29,8 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152),
+    m_nAllocated (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -35,9 +38,12 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  m_connections.Clear ();
+  m_listeners.Clear ();
+  for (std::map<uint64_t, Ipv4EndPoint *>::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
-      Ipv4EndPoint *endPoint = *i;
+      Ipv4EndPoint *endPoint = i->second;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
@@ -47,29 +53,14 @@ bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_nPortEndPoints.find (port) != m_nPortEndPoints.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_nLocalEndPoints.find (std::make_pair (addr, port)) != m_nLocalEndPoints.end ();
 }
 
 Ipv4EndPoint *
@@ -83,7 +74,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -99,7 +90,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -122,7 +113,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -132,7 +123,8 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::vector<Ipv4EndPoint *> const &candidates = GetCandidates (localAddress, localPort, peerAddress, peerPort);
+  for (std::vector<Ipv4EndPoint *>::const_iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
       if ((*i)->GetLocalPort () == localPort &&
           (*i)->GetLocalAddress () == localAddress &&
@@ -146,7 +138,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
 
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
 
@@ -157,15 +149,14 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  m_endPoints.erase (endPoint->m_sequence);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -177,9 +168,9 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   NS_LOG_FUNCTION (this);
   EndPoints ret;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (std::map<uint64_t, Ipv4EndPoint *>::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4EndPoint* endP = i->second;
       ret.push_back (endP);
     }
   return ret;
@@ -203,8 +194,28 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval3; // Matches all but local address
   EndPoints retval4; // Exact match on all 4
 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  // the connections can only match the local address of the interface
+  // for a broadcast, and the destination address otherwise.
+  std::vector<Ipv4EndPoint *> const &candidates =
+    GetCandidates (isBroadcast ? incomingInterfaceAddr : daddr, dport, saddr, sport);
+
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (std::vector<Ipv4EndPoint *>::const_iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
@@ -230,20 +241,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -315,35 +312,42 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  std::vector<Ipv4EndPoint *> const &candidates = GetCandidates (daddr, dport, saddr, sport);
+  for (std::vector<Ipv4EndPoint *>::const_iterator i = candidates.begin (); i != candidates.end (); i++) 
+    {
+      if ((*i)->GetLocalPort () == dport &&
+          (*i)->GetLocalAddress () == daddr &&
+          (*i)->GetPeerPort () == sport &&
+          (*i)->GetPeerAddress () == saddr) 
+        {
+          /* this is an exact match. */
+          return *i;
+        }
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (std::map<uint64_t, Ipv4EndPoint *>::iterator j = m_endPoints.begin (); j != m_endPoints.end (); j++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
+      Ipv4EndPoint *endPoint = j->second;
+      if (endPoint->GetLocalPort () != dport) 
         {
           continue;
         }
-      if ((*i)->GetLocalAddress () == daddr &&
-          (*i)->GetPeerPort () == sport &&
-          (*i)->GetPeerAddress () == saddr) 
-        {
-          /* this is an exact match. */
-          return *i;
-        }
       uint32_t tmp = 0;
-      if ((*i)->GetLocalAddress () == Ipv4Address::GetAny ()) 
+      if (endPoint->GetLocalAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
-      if ((*i)->GetPeerAddress () == Ipv4Address::GetAny ()) 
+      if (endPoint->GetPeerAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
       if (tmp < genericity) 
         {
-          generic = (*i);
+          generic = endPoint;
           genericity = tmp;
         }
     }
@@ -372,5 +376,108 @@ Ipv4EndPointDemux::AllocateEphemeralPort (void)
   return port;
 }
 
-} // namespace ns3
+void
+Ipv4EndPointDemux::Add (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  endPoint->m_sequence = m_nAllocated++;
+  m_endPoints[endPoint->m_sequence] = endPoint;
+  Index (endPoint);
+}
 
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t port = endPoint->m_localPort;
+  if (IsConnection (endPoint))
+    {
+      m_connections.Insert (GetHash (endPoint->m_localAddr, port, endPoint->m_peerAddr, endPoint->m_peerPort),
+                            endPoint);
+    }
+  else
+    {
+      m_listeners.Insert (GetHash (port), endPoint);
+    }
+  m_nPortEndPoints[port]++;
+  m_nLocalEndPoints[std::make_pair (endPoint->m_localAddr, port)]++;
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t port = endPoint->m_localPort;
+  if (IsConnection (endPoint))
+    {
+      m_connections.Remove (GetHash (endPoint->m_localAddr, port, endPoint->m_peerAddr, endPoint->m_peerPort),
+                            endPoint);
+    }
+  else
+    {
+      m_listeners.Remove (GetHash (port), endPoint);
+    }
+  std::map<uint16_t, uint32_t>::iterator i = m_nPortEndPoints.find (port);
+  if (--i->second == 0)
+    {
+      m_nPortEndPoints.erase (i);
+    }
+  std::map<std::pair<Ipv4Address, uint16_t>, uint32_t>::iterator j =
+    m_nLocalEndPoints.find (std::make_pair (endPoint->m_localAddr, port));
+  if (--j->second == 0)
+    {
+      m_nLocalEndPoints.erase (j);
+    }
+}
+
+std::vector<Ipv4EndPoint *> const &
+Ipv4EndPointDemux::GetCandidates (Ipv4Address localAddress, uint16_t localPort,
+                                  Ipv4Address peerAddress, uint16_t peerPort)
+{
+  m_candidates.clear ();
+  m_listeners.Find (GetHash (localPort), m_candidates);
+  m_connections.Find (GetHash (localAddress, localPort, peerAddress, peerPort), m_candidates);
+  if (m_candidates.size () > 1)
+    {
+      std::sort (m_candidates.begin (), m_candidates.end (), &Ipv4EndPointDemux::IsAllocatedBefore);
+    }
+  return m_candidates;
+}
+
+bool
+Ipv4EndPointDemux::IsConnection (Ipv4EndPoint *endPoint)
+{
+  return endPoint->m_localAddr != Ipv4Address::GetAny ()
+         && endPoint->m_peerAddr != Ipv4Address::GetAny ()
+         && endPoint->m_peerPort != 0;
+}
+
+bool
+Ipv4EndPointDemux::IsAllocatedBefore (Ipv4EndPoint *a, Ipv4EndPoint *b)
+{
+  return a->m_sequence < b->m_sequence;
+}
+
+uint32_t
+Ipv4EndPointDemux::GetHash (Ipv4Address localAddress, uint16_t localPort,
+                            Ipv4Address peerAddress, uint16_t peerPort)
+{
+  uint8_t buffer[12];
+  localAddress.Serialize (buffer);
+  peerAddress.Serialize (buffer + 4);
+  buffer[8] = localPort >> 8;
+  buffer[9] = localPort & 0xff;
+  buffer[10] = peerPort >> 8;
+  buffer[11] = peerPort & 0xff;
+  return m_hasher.clear ().GetHash32 ((char const *)buffer, sizeof (buffer));
+}
+
+uint32_t
+Ipv4EndPointDemux::GetHash (uint16_t localPort)
+{
+  // the listeners are few: the port is a good enough hash.
+  return localPort;
+}
+
+} // namespace ns3
@@ -23,8 +23,12 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <vector>
 #include "ns3/ipv4-address.h"
+#include "ns3/hash.h"
 #include "ipv4-interface.h"
+#include "end-point-hash-table.h"
 
 namespace ns3 {
 
@@ -38,6 +42,14 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints whose four-tuple is fully specified (connections) are
+ * indexed by a hash table of their four-tuple, and the other endpoints
+ * (listeners and wildcard bindings) by a hash table of their local
+ * port, so that a lookup only examines the endpoints which may match.
+ * The endpoints tell their demux when their addresses or ports change,
+ * to be indexed again. Among several matching endpoints of the same
+ * precedence, the lookups return them in the order of their allocation.
  */
 
 class Ipv4EndPointDemux {
@@ -74,12 +86,62 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
   uint16_t AllocateEphemeralPort (void);
+  /**
+   * Add a new endpoint to the demux.
+   */
+  void Add (Ipv4EndPoint *endPoint);
+  /**
+   * Add an endpoint to the hash tables, according to its current
+   * four-tuple.
+   */
+  void Index (Ipv4EndPoint *endPoint);
+  /**
+   * Remove an endpoint from the hash tables, before its four-tuple
+   * changes or it is deallocated.
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
+  /**
+   * \param localAddress the local address.
+   * \param localPort the local port.
+   * \param peerAddress the peer address.
+   * \param peerPort the peer port.
+   * eturns the endpoints which may have this four-tuple, in the
+   *          order of their allocation. They are the connections with
+   *          the same hash and all the other endpoints of the local port.
+   */
+  std::vector<Ipv4EndPoint *> const &GetCandidates (Ipv4Address localAddress, uint16_t localPort,
+                                                    Ipv4Address peerAddress, uint16_t peerPort);
+  /**
+   * eturns true if the four-tuple of the endpoint is fully specified.
+   */
+  static bool IsConnection (Ipv4EndPoint *endPoint);
+  /**
+   * eturns true if a was allocated before b.
+   */
+  static bool IsAllocatedBefore (Ipv4EndPoint *a, Ipv4EndPoint *b);
+  uint32_t GetHash (Ipv4Address localAddress, uint16_t localPort,
+                    Ipv4Address peerAddress, uint16_t peerPort);
+  uint32_t GetHash (uint16_t localPort);
 
   uint16_t m_ephemeral;
   uint16_t m_portLast;
   uint16_t m_portFirst;
-  EndPoints m_endPoints;
+  /// All the endpoints, by order of allocation.
+  std::map<uint64_t, Ipv4EndPoint *> m_endPoints;
+  uint64_t m_nAllocated;
+  /// The connections, by hash of their four-tuple.
+  EndPointHashTable<Ipv4EndPoint> m_connections;
+  /// The other endpoints, by hash of their local port.
+  EndPointHashTable<Ipv4EndPoint> m_listeners;
+  /// The number of endpoints bound to each local port.
+  std::map<uint16_t, uint32_t> m_nPortEndPoints;
+  /// The number of endpoints bound to each local address and port.
+  std::map<std::pair<Ipv4Address, uint16_t>, uint32_t> m_nLocalEndPoints;
+  std::vector<Ipv4EndPoint *> m_candidates;
+  Hasher m_hasher;
 };
 
 } // namespace ns3
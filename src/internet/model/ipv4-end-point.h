@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \brief A representation of an internet endpoint/connection
@@ -76,6 +77,8 @@ public:
                     uint32_t icmpInfo);
 
 private:
+  friend class Ipv4EndPointDemux;
+
   void DoForwardUp (Ptr<Packet> p, const Ipv4Header& header, uint16_t sport,
                     Ptr<Ipv4Interface> incomingInterface);
   void DoForwardIcmp (Ipv4Address icmpSource, uint8_t icmpTtl, 
@@ -89,6 +92,10 @@ private:
   Callback<void,Ptr<Packet>, Ipv4Header, uint16_t, Ptr<Ipv4Interface> > m_rxCallback;
   Callback<void,Ipv4Address,uint8_t,uint8_t,uint8_t,uint32_t> m_icmpCallback;
   Callback<void> m_destroyCallback;
+  /// The demux which indexes this endpoint, if any.
+  Ipv4EndPointDemux *m_demux;
+  /// The rank of allocation of this endpoint in its demux.
+  uint64_t m_sequence;
 };
 
 } // namespace ns3
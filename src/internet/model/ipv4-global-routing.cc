@@ -17,7 +17,10 @@
 //
 
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <iomanip>
+#include <cstring>
 #include "ns3/names.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -27,6 +30,8 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/boolean.h"
+#include "ns3/node.h"
+#include "ns3/hash.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
 
@@ -36,6 +41,90 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4GlobalRouting);
 
+namespace {
+
+struct NextHop
+{
+  Ipv4Address gateway;
+  uint32_t interface;
+};
+
+/// The next hops of the routes of all the instances, never shrunk.
+std::vector<NextHop> &
+GetNextHops (void)
+{
+  static std::vector<NextHop> nextHops;
+  return nextHops;
+}
+
+/// \returns the index of the next hop in the pool, added if needed.
+uint32_t
+InternNextHop (Ipv4Address gateway, uint32_t interface)
+{
+  static std::map<std::pair<uint32_t, uint32_t>, uint32_t> indices;
+  std::pair<uint32_t, uint32_t> key (gateway.Get (), interface);
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t>::const_iterator i = indices.find (key);
+  if (i != indices.end ())
+    {
+      return i->second;
+    }
+  NextHop nextHop;
+  nextHop.gateway = gateway;
+  nextHop.interface = interface;
+  GetNextHops ().push_back (nextHop);
+  uint32_t index = GetNextHops ().size () - 1;
+  indices[key] = index;
+  return index;
+}
+
+/// The groups of next hops of the routes of all the instances, never shrunk.
+std::vector<std::vector<uint32_t> > &
+GetGroups (void)
+{
+  static std::vector<std::vector<uint32_t> > groups;
+  return groups;
+}
+
+/// \returns the index of the group in the pool, added if needed.
+uint32_t
+InternGroup (std::vector<uint32_t> const &group)
+{
+  static std::map<std::vector<uint32_t>, uint32_t> indices;
+  std::map<std::vector<uint32_t>, uint32_t>::const_iterator i = indices.find (group);
+  if (i != indices.end ())
+    {
+      return i->second;
+    }
+  GetGroups ().push_back (group);
+  uint32_t index = GetGroups ().size () - 1;
+  indices[group] = index;
+  return index;
+}
+
+/// \returns the index of the group made of the group and the next hop.
+uint32_t
+ExtendGroup (uint32_t group, uint32_t nextHop)
+{
+  static std::map<std::pair<uint32_t, uint32_t>, uint32_t> extensions;
+  std::pair<uint32_t, uint32_t> key (group, nextHop);
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t>::const_iterator i = extensions.find (key);
+  if (i != extensions.end ())
+    {
+      return i->second;
+    }
+  // copy the group: interning it may reallocate the pool.
+  std::vector<uint32_t> extended = GetGroups ()[group];
+  extended.push_back (nextHop);
+  uint32_t index = InternGroup (extended);
+  extensions[key] = index;
+  return index;
+}
+
+/// The salt of the flow hashes before it is known.
+const uint32_t NO_SALT = 0xffffffff;
+
+} // anonymous namespace
+
 TypeId 
 Ipv4GlobalRouting::GetTypeId (void)
 { 
@@ -46,6 +135,11 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_randomEcmpRouting),
                    MakeBooleanChecker ())
+    .AddAttribute ("FlowEcmpRouting",
+                   "Set to true if packets are routed among ECMP by a hash of their flow, so that the packets of a flow follow the same path; takes precedence over RandomEcmpRouting",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::m_flowEcmpRouting),
+                   MakeBooleanChecker ())
     .AddAttribute ("RespondToInterfaceEvents",
                    "Set to true if you want to dynamically recompute the global routes upon Interface notification events (up/down, or add/remove address)",
                    BooleanValue (false),
@@ -57,6 +151,8 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
+    m_flowEcmpRouting (false),
+    m_flowHashSalt (NO_SALT),
     m_respondToInterfaceEvents (false)
 {
   NS_LOG_FUNCTION (this);
@@ -75,9 +171,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
                                    uint32_t interface)
 {
   NS_LOG_FUNCTION (this << dest << nextHop << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
-  m_hostRoutes.push_back (route);
+  m_hostRoutes.Add (dest, Ipv4Mask::GetOnes (), nextHop, interface);
 }
 
 void 
@@ -85,9 +179,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
                                    uint32_t interface)
 {
   NS_LOG_FUNCTION (this << dest << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
-  m_hostRoutes.push_back (route);
+  m_hostRoutes.Add (dest, Ipv4Mask::GetOnes (), Ipv4Address::GetZero (), interface);
 }
 
 void 
@@ -97,12 +189,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                       uint32_t interface)
 {
   NS_LOG_FUNCTION (this << network << networkMask << nextHop << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
-                                                        networkMask,
-                                                        nextHop,
-                                                        interface);
-  m_networkRoutes.push_back (route);
+  m_networkRoutes.Add (network, networkMask, nextHop, interface);
 }
 
 void 
@@ -111,11 +198,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                       uint32_t interface)
 {
   NS_LOG_FUNCTION (this << network << networkMask << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
-                                                        networkMask,
-                                                        interface);
-  m_networkRoutes.push_back (route);
+  m_networkRoutes.Add (network, networkMask, Ipv4Address::GetZero (), interface);
 }
 
 void 
@@ -125,122 +208,112 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                          uint32_t interface)
 {
   NS_LOG_FUNCTION (this << network << networkMask << nextHop << interface);
-  Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
-  *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
-                                                        networkMask,
-                                                        nextHop,
-                                                        interface);
-  m_ASexternalRoutes.push_back (route);
+  m_ASexternalRoutes.Add (network, networkMask, nextHop, interface);
 }
 
 
-Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
+void
+Ipv4GlobalRouting::AddCandidates (RouteTable const &table, std::vector<uint32_t> const &runs,
+                                  Ptr<NetDevice> oif, bool first)
 {
-  NS_LOG_FUNCTION (this << dest << oif);
-  NS_LOG_LOGIC ("Looking for route for destination " << dest);
-  Ptr<Ipv4Route> rtentry = 0;
-  // store all available routes that bring packets to their destination
-  typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-  RouteVec_t allRoutes;
-
-  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  std::vector<NextHop> const &nextHops = GetNextHops ();
+  for (std::vector<uint32_t>::const_iterator i = runs.begin (); i != runs.end (); i++)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      std::vector<uint32_t> const &group = table.GetGroup (*i);
+      for (std::vector<uint32_t>::const_iterator j = group.begin (); j != group.end (); j++)
         {
-          if (oif != 0)
+          if (oif != 0 && oif != m_ipv4->GetNetDevice (nextHops[*j].interface))
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
-        }
-    }
-  if (allRoutes.size () == 0) // if no host route is found
-    {
-      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
-        {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          m_candidates.push_back (std::make_pair (table.GetNetwork (*i), *j));
+          NS_LOG_LOGIC (m_candidates.size () << " Found global route to " << table.GetNetwork (*i)
+                                             << " through " << nextHops[*j].gateway);
+          if (first)
             {
-              if (oif != 0)
-                {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
-                }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+              return;
             }
         }
     }
-  if (allRoutes.size () == 0)  // consider external if no host/network found
+}
+
+uint32_t
+Ipv4GlobalRouting::GetFlowHash (Ipv4Header const &header, Ptr<const Packet> p)
+{
+  if (m_flowHashSalt == NO_SALT)
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
-        {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
-            {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
-                {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
-                }
-              allRoutes.push_back (*k);
-              break;
-            }
-        }
+      Ptr<Node> node = m_ipv4->GetObject<Node> ();
+      m_flowHashSalt = node != 0 ? node->GetId () : 0;
     }
-  if (allRoutes.size () > 0 ) // if route(s) is found
+  uint8_t buffer[17];
+  header.GetSource ().Serialize (buffer);
+  header.GetDestination ().Serialize (buffer + 4);
+  buffer[8] = header.GetProtocol ();
+  std::memset (buffer + 9, 0, 4);
+  // only the unfragmented packets carry their ports: the fragments of a
+  // packet must follow the same path.
+  if (p != 0 && (header.GetProtocol () == 6 || header.GetProtocol () == 17)
+      && header.IsLastFragment () && header.GetFragmentOffset () == 0 && p->GetSize () >= 4)
     {
-      // pick up one of the routes uniformly at random if random
-      // ECMP routing is enabled, or always select the first route
-      // consistently if random ECMP routing is disabled
-      uint32_t selectIndex;
-      if (m_randomEcmpRouting)
-        {
-          selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
-        }
-      else 
+      p->CopyData (buffer + 9, 4);
+    }
+  std::memcpy (buffer + 13, &m_flowHashSalt, 4);
+  return Hash32 ((char const *)buffer, sizeof (buffer));
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::LookupGlobal (Ipv4Header const &header, Ptr<const Packet> p, Ptr<NetDevice> oif)
+{
+  Ipv4Address dest = header.GetDestination ();
+  NS_LOG_FUNCTION (this << dest << p << oif);
+  NS_LOG_LOGIC ("Looking for route for destination " << dest);
+  // store all available routes that bring packets to their destination
+  m_candidates.clear ();
+
+  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.GetN ());
+  m_hostRoutes.Match (dest, m_matches);
+  AddCandidates (m_hostRoutes, m_matches, oif, false);
+  if (m_candidates.empty ()) // if no host route is found
+    {
+      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.GetN ());
+      m_networkRoutes.Match (dest, m_matches);
+      AddCandidates (m_networkRoutes, m_matches, oif, false);
+    }
+  if (m_candidates.empty ())  // consider external if no host/network found
+    {
+      m_ASexternalRoutes.Match (dest, m_matches);
+      AddCandidates (m_ASexternalRoutes, m_matches, oif, true);
+    }
+  if (m_candidates.empty ())
+    {
+      return 0;
+    }
+
+  // pick up one of the routes by the hash of the flow of the packet if
+  // flow ECMP routing is enabled, uniformly at random if random ECMP
+  // routing is enabled, or always select the first route consistently
+  uint32_t selectIndex = 0;
+  if (m_flowEcmpRouting)
+    {
+      if (m_candidates.size () > 1)
         {
-          selectIndex = 0;
+          selectIndex = GetFlowHash (header, p) % m_candidates.size ();
         }
-      Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
-      // create a Ipv4Route object from the selected routing table entry
-      rtentry = Create<Ipv4Route> ();
-      rtentry->SetDestination (route->GetDest ());
-      /// \todo handle multi-address case
-      rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
-      rtentry->SetGateway (route->GetGateway ());
-      uint32_t interfaceIdx = route->GetInterface ();
-      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-      return rtentry;
-    }
-  else 
+    }
+  else if (m_randomEcmpRouting)
     {
-      return 0;
+      selectIndex = m_rand->GetInteger (0, m_candidates.size () - 1);
     }
+  NextHop const &nextHop = GetNextHops ()[m_candidates[selectIndex].second];
+  // create a Ipv4Route object from the selected routing table entry
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (m_candidates[selectIndex].first);
+  /// \todo handle multi-address case
+  rtentry->SetSource (m_ipv4->GetAddress (nextHop.interface, 0).GetLocal ());
+  rtentry->SetGateway (nextHop.gateway);
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (nextHop.interface));
+  return rtentry;
 }
 
 uint32_t 
@@ -248,9 +321,9 @@ Ipv4GlobalRouting::GetNRoutes (void) const
 {
   NS_LOG_FUNCTION (this);
   uint32_t n = 0;
-  n += m_hostRoutes.size ();
-  n += m_networkRoutes.size ();
-  n += m_ASexternalRoutes.size ();
+  n += m_hostRoutes.GetN ();
+  n += m_networkRoutes.GetN ();
+  n += m_ASexternalRoutes.GetN ();
   return n;
 }
 
@@ -258,104 +331,67 @@ Ipv4RoutingTableEntry *
 Ipv4GlobalRouting::GetRoute (uint32_t index) const
 {
   NS_LOG_FUNCTION (this << index);
-  if (index < m_hostRoutes.size ())
+  if (index < m_hostRoutes.GetN ())
     {
-      uint32_t tmp = 0;
-      for (HostRoutesCI i = m_hostRoutes.begin (); 
-           i != m_hostRoutes.end (); 
-           i++) 
-        {
-          if (tmp  == index)
-            {
-              return *i;
-            }
-          tmp++;
-        }
+      return m_hostRoutes.GetEntry (index);
     }
-  index -= m_hostRoutes.size ();
-  uint32_t tmp = 0;
-  if (index < m_networkRoutes.size ())
+  index -= m_hostRoutes.GetN ();
+  if (index < m_networkRoutes.GetN ())
     {
-      for (NetworkRoutesCI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end ();
-           j++)
-        {
-          if (tmp == index)
-            {
-              return *j;
-            }
-          tmp++;
-        }
+      return m_networkRoutes.GetEntry (index);
     }
-  index -= m_networkRoutes.size ();
-  tmp = 0;
-  for (ASExternalRoutesCI k = m_ASexternalRoutes.begin (); 
-       k != m_ASexternalRoutes.end (); 
-       k++) 
+  index -= m_networkRoutes.GetN ();
+  if (index < m_ASexternalRoutes.GetN ())
     {
-      if (tmp == index)
-        {
-          return *k;
-        }
-      tmp++;
+      return m_ASexternalRoutes.GetEntry (index);
     }
   NS_ASSERT (false);
   // quiet compiler.
   return 0;
 }
+Ipv4RoutingTableEntry
+Ipv4GlobalRouting::CopyRoute (uint32_t index) const
+{
+  if (index < m_hostRoutes.GetN ())
+    {
+      return m_hostRoutes.Get (index);
+    }
+  index -= m_hostRoutes.GetN ();
+  if (index < m_networkRoutes.GetN ())
+    {
+      return m_networkRoutes.Get (index);
+    }
+  index -= m_networkRoutes.GetN ();
+  NS_ASSERT (index < m_ASexternalRoutes.GetN ());
+  return m_ASexternalRoutes.Get (index);
+}
+
 void 
 Ipv4GlobalRouting::RemoveRoute (uint32_t index)
 {
   NS_LOG_FUNCTION (this << index);
-  if (index < m_hostRoutes.size ())
+  if (index < m_hostRoutes.GetN ())
     {
-      uint32_t tmp = 0;
-      for (HostRoutesI i = m_hostRoutes.begin (); 
-           i != m_hostRoutes.end (); 
-           i++) 
-        {
-          if (tmp  == index)
-            {
-              NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
-              delete *i;
-              m_hostRoutes.erase (i);
-              NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
-              return;
-            }
-          tmp++;
-        }
+      NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.GetN ());
+      m_hostRoutes.Remove (index);
+      NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.GetN ());
+      return;
     }
-  index -= m_hostRoutes.size ();
-  uint32_t tmp = 0;
-  for (NetworkRoutesI j = m_networkRoutes.begin (); 
-       j != m_networkRoutes.end (); 
-       j++) 
+  index -= m_hostRoutes.GetN ();
+  if (index < m_networkRoutes.GetN ())
     {
-      if (tmp == index)
-        {
-          NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
-          delete *j;
-          m_networkRoutes.erase (j);
-          NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
-          return;
-        }
-      tmp++;
+      NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.GetN ());
+      m_networkRoutes.Remove (index);
+      NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.GetN ());
+      return;
     }
-  index -= m_networkRoutes.size ();
-  tmp = 0;
-  for (ASExternalRoutesI k = m_ASexternalRoutes.begin (); 
-       k != m_ASexternalRoutes.end ();
-       k++)
+  index -= m_networkRoutes.GetN ();
+  if (index < m_ASexternalRoutes.GetN ())
     {
-      if (tmp == index)
-        {
-          NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
-          delete *k;
-          m_ASexternalRoutes.erase (k);
-          NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
-          return;
-        }
-      tmp++;
+      NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.GetN ());
+      m_ASexternalRoutes.Remove (index);
+      NS_LOG_LOGIC ("Done removing external route " << index << "; external route remaining size = " << m_ASexternalRoutes.GetN ());
+      return;
     }
   NS_ASSERT (false);
 }
@@ -372,24 +408,9 @@ void
 Ipv4GlobalRouting::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  for (HostRoutesI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i = m_hostRoutes.erase (i)) 
-    {
-      delete (*i);
-    }
-  for (NetworkRoutesI j = m_networkRoutes.begin (); 
-       j != m_networkRoutes.end (); 
-       j = m_networkRoutes.erase (j)) 
-    {
-      delete (*j);
-    }
-  for (ASExternalRoutesI l = m_ASexternalRoutes.begin (); 
-       l != m_ASexternalRoutes.end ();
-       l = m_ASexternalRoutes.erase (l))
-    {
-      delete (*l);
-    }
+  m_hostRoutes.Clear ();
+  m_networkRoutes.Clear ();
+  m_ASexternalRoutes.Clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -406,7 +427,7 @@ Ipv4GlobalRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
       for (uint32_t j = 0; j < GetNRoutes (); j++)
         {
           std::ostringstream dest, gw, mask, flags;
-          Ipv4RoutingTableEntry route = GetRoute (j);
+          Ipv4RoutingTableEntry route = CopyRoute (j);
           dest << route.GetDest ();
           *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ();
           gw << route.GetGateway ();
@@ -459,7 +480,7 @@ Ipv4GlobalRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<Net
 // See if this is a unicast packet we have a route for.
 //
   NS_LOG_LOGIC ("Unicast destination- looking up");
-  Ptr<Ipv4Route> rtentry = LookupGlobal (header.GetDestination (), oif);
+  Ptr<Ipv4Route> rtentry = LookupGlobal (header, 0, oif);
   if (rtentry)
     {
       sockerr = Socket::ERROR_NOTERROR;
@@ -536,7 +557,7 @@ Ipv4GlobalRouting::RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, P
     }
   // Next, try to find a route
   NS_LOG_LOGIC ("Unicast destination- looking up global route");
-  Ptr<Ipv4Route> rtentry = LookupGlobal (header.GetDestination ());
+  Ptr<Ipv4Route> rtentry = LookupGlobal (header, p);
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Found unicast destination- calling unicast callback");
@@ -556,9 +577,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -568,9 +587,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -580,9 +597,7 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -592,9 +607,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::RecomputeRoutes ();
     }
 }
 
@@ -607,4 +620,325 @@ Ipv4GlobalRouting::SetIpv4 (Ptr<Ipv4> ipv4)
 }
 
 
+const uint32_t Ipv4GlobalRouting::RouteTable::NONE;
+
+Ipv4GlobalRouting::RouteTable::RouteTable ()
+  : m_nRoutes (0),
+    m_nNetworks (0),
+    m_valid (true),
+    m_firstsValid (true)
+{
+}
+
+Ipv4GlobalRouting::RouteTable::~RouteTable ()
+{
+  Clear ();
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Add (Ipv4Address network, Ipv4Mask mask, Ipv4Address nextHop, uint32_t interface)
+{
+  uint32_t index = InternNextHop (nextHop, interface);
+  m_nRoutes++;
+  if (!m_entries.empty ())
+    {
+      m_entries.push_back (0);
+    }
+  if (!m_runs.empty () && m_runs.back ().network == network.Get () && m_runs.back ().mask == mask.Get ())
+    {
+      m_runs.back ().group = ExtendGroup (m_runs.back ().group, index);
+      return;
+    }
+  Run run;
+  run.network = network.Get ();
+  run.mask = mask.Get ();
+  run.group = InternGroup (std::vector<uint32_t> (1, index));
+  run.next = NONE;
+  m_runs.push_back (run);
+  if (m_firstsValid)
+    {
+      m_firsts.push_back (m_nRoutes - 1);
+    }
+  if (m_valid)
+    {
+      Index (m_runs.size () - 1);
+    }
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Remove (uint32_t i)
+{
+  NS_ASSERT (i < m_nRoutes);
+  if (!m_entries.empty ())
+    {
+      delete m_entries[i];
+      m_entries.erase (m_entries.begin () + i);
+      std::vector<uint32_t>::iterator j = std::lower_bound (m_entryRoutes.begin (), m_entryRoutes.end (), i);
+      if (j != m_entryRoutes.end () && *j == i)
+        {
+          j = m_entryRoutes.erase (j);
+        }
+      for (; j != m_entryRoutes.end (); j++)
+        {
+          (*j)--;
+        }
+    }
+  uint32_t r = Locate (i);
+  m_nRoutes--;
+  if (m_nRoutes == 0)
+    {
+      Clear ();
+      return;
+    }
+  m_firstsValid = false;
+  std::vector<uint32_t> group = GetGroups ()[m_runs[r].group];
+  if (group.size () > 1)
+    {
+      group.erase (group.begin () + i);
+      m_runs[r].group = InternGroup (group);
+      return;
+    }
+  m_runs.erase (m_runs.begin () + r);
+  m_valid = false;
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Clear (void)
+{
+  for (std::deque<Ipv4RoutingTableEntry *>::iterator i = m_entries.begin (); i != m_entries.end (); i++)
+    {
+      delete *i;
+    }
+  std::deque<Ipv4RoutingTableEntry *> ().swap (m_entries);
+  std::vector<uint32_t> ().swap (m_entryRoutes);
+  ClearRoutes ();
+}
+
+void
+Ipv4GlobalRouting::RouteTable::ClearRoutes (void)
+{
+  std::deque<Run> ().swap (m_runs);
+  std::vector<uint32_t> ().swap (m_slots);
+  std::vector<uint32_t> ().swap (m_masks);
+  std::vector<uint32_t> ().swap (m_firsts);
+  m_nRoutes = 0;
+  m_nNetworks = 0;
+  m_valid = true;
+  m_firstsValid = true;
+}
+
+uint32_t
+Ipv4GlobalRouting::RouteTable::GetN (void) const
+{
+  return m_nRoutes;
+}
+
+uint32_t
+Ipv4GlobalRouting::RouteTable::Locate (uint32_t &i) const
+{
+  // removing all the routes removes the first one repeatedly.
+  if (i < GetGroups ()[m_runs.front ().group].size ())
+    {
+      return 0;
+    }
+  if (!m_firstsValid)
+    {
+      m_firsts.clear ();
+      uint32_t first = 0;
+      for (std::deque<Run>::const_iterator j = m_runs.begin (); j != m_runs.end (); j++)
+        {
+          m_firsts.push_back (first);
+          first += GetGroups ()[j->group].size ();
+        }
+      m_firstsValid = true;
+    }
+  uint32_t r = std::upper_bound (m_firsts.begin (), m_firsts.end (), i) - m_firsts.begin () - 1;
+  i -= m_firsts[r];
+  return r;
+}
+
+Ipv4RoutingTableEntry
+Ipv4GlobalRouting::RouteTable::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_nRoutes);
+  if (!m_entries.empty () && m_entries[i] != 0)
+    {
+      return *m_entries[i];
+    }
+  return Decode (i);
+}
+
+Ipv4RoutingTableEntry
+Ipv4GlobalRouting::RouteTable::Decode (uint32_t i) const
+{
+  uint32_t r = Locate (i);
+  Run const &run = m_runs[r];
+  NextHop const &nextHop = GetNextHops ()[GetGroups ()[run.group][i]];
+  return Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address (run.network), Ipv4Mask (run.mask),
+                                                      nextHop.gateway, nextHop.interface);
+}
+
+Ipv4RoutingTableEntry *
+Ipv4GlobalRouting::RouteTable::GetEntry (uint32_t i) const
+{
+  NS_ASSERT (i < m_nRoutes);
+  if (m_entries.empty ())
+    {
+      m_entries.resize (m_nRoutes, 0);
+    }
+  if (m_entries[i] == 0)
+    {
+      m_entries[i] = new Ipv4RoutingTableEntry (Decode (i));
+      m_entryRoutes.insert (std::lower_bound (m_entryRoutes.begin (), m_entryRoutes.end (), i), i);
+    }
+  return m_entries[i];
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Sync (void)
+{
+  bool changed = false;
+  for (std::vector<uint32_t>::const_iterator i = m_entryRoutes.begin (); i != m_entryRoutes.end () && !changed; i++)
+    {
+      Ipv4RoutingTableEntry const *entry = m_entries[*i];
+      Ipv4RoutingTableEntry route = Decode (*i);
+      changed = entry->GetDest () != route.GetDest ()
+        || entry->GetDestNetworkMask () != route.GetDestNetworkMask ()
+        || entry->GetGateway () != route.GetGateway ()
+        || entry->GetInterface () != route.GetInterface ();
+    }
+  if (!changed)
+    {
+      return;
+    }
+  // rebuild the routes in the same order, as their entries are now.
+  std::vector<Ipv4RoutingTableEntry> routes;
+  for (uint32_t i = 0; i < m_nRoutes; i++)
+    {
+      routes.push_back (Get (i));
+    }
+  std::deque<Ipv4RoutingTableEntry *> entries;
+  entries.swap (m_entries);
+  ClearRoutes ();
+  for (std::vector<Ipv4RoutingTableEntry>::const_iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      Add (i->GetDest (), i->GetDestNetworkMask (), i->GetGateway (), i->GetInterface ());
+    }
+  entries.swap (m_entries);
+}
+
+Ipv4Address
+Ipv4GlobalRouting::RouteTable::GetNetwork (uint32_t run) const
+{
+  return Ipv4Address (m_runs[run].network);
+}
+
+std::vector<uint32_t> const &
+Ipv4GlobalRouting::RouteTable::GetGroup (uint32_t run) const
+{
+  return GetGroups ()[m_runs[run].group];
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Match (Ipv4Address dest, std::vector<uint32_t> &runs)
+{
+  runs.clear ();
+  Sync ();
+  if (!m_valid)
+    {
+      Rebuild ();
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_masks.begin (); i != m_masks.end (); i++)
+    {
+      uint32_t slot = FindSlot (dest.Get () & *i, *i);
+      for (uint32_t j = m_slots[slot]; j != NONE; j = m_runs[j].next)
+        {
+          runs.push_back (j);
+        }
+    }
+  if (m_masks.size () > 1)
+    {
+      std::sort (runs.begin (), runs.end ());
+    }
+}
+
+uint32_t
+Ipv4GlobalRouting::RouteTable::Hash (uint32_t network, uint32_t mask)
+{
+  uint32_t h = (network ^ (mask * 0x85ebca6b)) * 0x9e3779b1;
+  return h ^ (h >> 16);
+}
+
+uint32_t
+Ipv4GlobalRouting::RouteTable::FindSlot (uint32_t network, uint32_t mask) const
+{
+  uint32_t slotMask = m_slots.size () - 1;
+  uint32_t slot = Hash (network, mask) & slotMask;
+  while (m_slots[slot] != NONE)
+    {
+      Run const &run = m_runs[m_slots[slot]];
+      if (run.mask == mask && (run.network & mask) == network)
+        {
+          break;
+        }
+      slot = (slot + 1) & slotMask;
+    }
+  return slot;
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Index (uint32_t i)
+{
+  // keep the load factor of the hash table below one half.
+  if ((m_nNetworks + 1) * 2 > m_slots.size ())
+    {
+      std::vector<uint32_t> slots (std::max<uint32_t> (8, m_slots.size () * 2), NONE);
+      slots.swap (m_slots);
+      for (std::vector<uint32_t>::const_iterator j = slots.begin (); j != slots.end (); j++)
+        {
+          if (*j != NONE)
+            {
+              Run const &run = m_runs[*j];
+              m_slots[FindSlot (run.network & run.mask, run.mask)] = *j;
+            }
+        }
+    }
+
+  Run const &run = m_runs[i];
+  uint32_t slot = FindSlot (run.network & run.mask, run.mask);
+  if (m_slots[slot] != NONE)
+    {
+      uint32_t j = m_slots[slot];
+      while (m_runs[j].next != NONE)
+        {
+          j = m_runs[j].next;
+        }
+      m_runs[j].next = i;
+      return;
+    }
+  m_slots[slot] = i;
+  m_nNetworks++;
+  if (std::find (m_masks.begin (), m_masks.end (), run.mask) == m_masks.end ())
+    {
+      m_masks.push_back (run.mask);
+    }
+}
+
+void
+Ipv4GlobalRouting::RouteTable::Rebuild (void)
+{
+  std::vector<uint32_t> ().swap (m_slots);
+  m_masks.clear ();
+  m_nNetworks = 0;
+  for (std::deque<Run>::iterator i = m_runs.begin (); i != m_runs.end (); i++)
+    {
+      i->next = NONE;
+    }
+  for (uint32_t i = 0; i < m_runs.size (); i++)
+    {
+      Index (i);
+    }
+  m_valid = true;
+}
+
 } // namespace ns3
@@ -20,7 +20,8 @@
 #ifndef IPV4_GLOBAL_ROUTING_H
 #define IPV4_GLOBAL_ROUTING_H
 
-#include <list>
+#include <deque>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +29,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-routing-table-entry.h"
 
 namespace ns3 {
 
@@ -36,7 +38,6 @@ class NetDevice;
 class Ipv4Interface;
 class Ipv4Address;
 class Ipv4Header;
-class Ipv4RoutingTableEntry;
 class Ipv4MulticastRoutingTableEntry;
 class Node;
 
@@ -63,6 +64,26 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * The consecutive routes to the same destination, such as the equal-cost
+ * routes added by the GlobalRouteManager, are stored as a 16-byte record
+ * which refers to their next hops by an index into a pool of next hop
+ * groups shared by all the instances of this class: the nodes of a large
+ * topology, a fat tree for instance, have many routes but few distinct
+ * groups of next hops, each the pair of a gateway and an interface. The host,
+ * network and external routes are each indexed by a hash table keyed by
+ * destination network and mask, which a lookup probes once per distinct
+ * mask of the table, so that the cost of a lookup does not depend on the
+ * number of routes.
+ *
+ * When several routes match a destination, the first one is selected, or
+ * one at random if the RandomEcmpRouting attribute is set, or one chosen by
+ * a hash of the flow of the packet if the FlowEcmpRouting attribute is set,
+ * so that the packets of a flow follow the same path and are not
+ * reordered. The flow is the source and destination addresses and the
+ * protocol of the packet, and the ports of the TCP and UDP packets which
+ * are forwarded unfragmented: the packets sent by the node are routed
+ * before their ports are known.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -186,7 +207,8 @@ public:
  * \param i The index (into the routing table) of the route to retrieve.  If
  * the default route has been set, it will occupy index zero.
  * \return If route is set, a pointer to that Ipv4RoutingTableEntry is returned, otherwise
- * a zero pointer is returned.
+ * a zero pointer is returned.  The entry stays valid until the route is
+ * removed, and the changes made to it apply to the route.
  *
  * \see Ipv4RoutingTableEntry
  * \see Ipv4GlobalRouting::RemoveRoute
@@ -227,26 +249,128 @@ protected:
 private:
   /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
   bool m_randomEcmpRouting;
+  /// Set to true if packets are routed among ECMP by a hash of their flow
+  bool m_flowEcmpRouting;
+  /// Mixed into the flow hashes, so that the nodes do not all select the same paths
+  uint32_t m_flowHashSalt;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
   bool m_respondToInterfaceEvents;
   /// A uniform random number generator for randomly routing packets among ECMP 
   Ptr<UniformRandomVariable> m_rand;
 
-  typedef std::list<Ipv4RoutingTableEntry *> HostRoutes;
-  typedef std::list<Ipv4RoutingTableEntry *>::const_iterator HostRoutesCI;
-  typedef std::list<Ipv4RoutingTableEntry *>::iterator HostRoutesI;
-  typedef std::list<Ipv4RoutingTableEntry *> NetworkRoutes;
-  typedef std::list<Ipv4RoutingTableEntry *>::const_iterator NetworkRoutesCI;
-  typedef std::list<Ipv4RoutingTableEntry *>::iterator NetworkRoutesI;
-  typedef std::list<Ipv4RoutingTableEntry *> ASExternalRoutes;
-  typedef std::list<Ipv4RoutingTableEntry *>::const_iterator ASExternalRoutesCI;
-  typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
+  /**
+   * \brief A table of routes, indexed by destination network.
+   *
+   * The routes are kept in insertion order. The consecutive routes to the
+   * same network and mask form a run, which refers to the group of their
+   * next hops in the shared pool. The index is an open addressing hash
+   * table of the first run to each (network, mask) pair, the runs to the
+   * same pair being chained in insertion order. Removing a run invalidates
+   * the index, which is rebuilt by the next lookup, so that removing all
+   * the routes costs linear time. The entries handed out by GetRoute ()
+   * are kept with their routes; the changes made to them are applied by
+   * the next lookup.
+   */
+  class RouteTable
+  {
+public:
+    RouteTable ();
+    ~RouteTable ();
+    void Add (Ipv4Address network, Ipv4Mask mask, Ipv4Address nextHop, uint32_t interface);
+    void Remove (uint32_t i);
+    void Clear (void);
+    uint32_t GetN (void) const;
+    Ipv4RoutingTableEntry Get (uint32_t i) const;
+    /**
+     * \returns the entry of the route i, created when first asked for,
+     *          and deleted with the route. The changes made to it are
+     *          applied to the route by the next Match ().
+     */
+    Ipv4RoutingTableEntry *GetEntry (uint32_t i) const;
+    /**
+     * \param dest the destination to look up.
+     * \param runs set to the runs whose network contains dest, in
+     *        increasing order.
+     */
+    void Match (Ipv4Address dest, std::vector<uint32_t> &runs);
+    Ipv4Address GetNetwork (uint32_t run) const;
+    /// \returns the indices in the shared pool of the next hops of the run.
+    std::vector<uint32_t> const &GetGroup (uint32_t run) const;
+
+private:
+    RouteTable (RouteTable const &);
+    RouteTable &operator = (RouteTable const &);
+
+    static const uint32_t NONE = 0xffffffff;
+    struct Run
+    {
+      uint32_t network;
+      uint32_t mask;
+      uint32_t group;   ///< the index of the next hop group in the shared pool
+      uint32_t next;    ///< the next run to the same network, or NONE
+    };
+
+    static uint32_t Hash (uint32_t network, uint32_t mask);
+    /// \returns the slot of the network, or of the empty slot where it belongs.
+    uint32_t FindSlot (uint32_t network, uint32_t mask) const;
+    void Index (uint32_t i);
+    void Rebuild (void);
+    /**
+     * \param i the index of a route, set to its index in its run.
+     * \returns the index of the run of the route.
+     */
+    uint32_t Locate (uint32_t &i) const;
+    /// \returns the route i as it is stored, whatever its entry.
+    Ipv4RoutingTableEntry Decode (uint32_t i) const;
+    /// Apply the changes made to the entries returned by GetEntry.
+    void Sync (void);
+    /// Clear the routes, but not the entries.
+    void ClearRoutes (void);
+
+    std::deque<Run> m_runs;
+    uint32_t m_nRoutes;
+    std::vector<uint32_t> m_slots;
+    uint32_t m_nNetworks;
+    std::vector<uint32_t> m_masks; ///< the distinct masks of the runs
+    bool m_valid;
+    /// The index of the first route of each run, rebuilt when needed.
+    mutable std::vector<uint32_t> m_firsts;
+    mutable bool m_firstsValid;
+    /// The entry of each route, or zero, or no entry at all if none was asked for.
+    mutable std::deque<Ipv4RoutingTableEntry *> m_entries;
+    /// The routes which have an entry, in increasing order.
+    mutable std::vector<uint32_t> m_entryRoutes;
+  };
+
+  /**
+   * \param index the index of a route, as in GetRoute ().
+   * \returns a copy of the route, without creating its entry.
+   */
+  Ipv4RoutingTableEntry CopyRoute (uint32_t index) const;
 
-  Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
+  /**
+   * \param header the header of the packet to route.
+   * \param p the packet being forwarded, whose payload starts with the
+   *        transport header, or zero.
+   * \param oif the output device, or zero for any device.
+   * \returns the route, or zero.
+   */
+  Ptr<Ipv4Route> LookupGlobal (Ipv4Header const &header, Ptr<const Packet> p, Ptr<NetDevice> oif = 0);
+  /**
+   * \param runs the runs of the table which match the destination.
+   * \param first true to add only the first route on the output device.
+   */
+  void AddCandidates (RouteTable const &table, std::vector<uint32_t> const &runs,
+                      Ptr<NetDevice> oif, bool first);
+  uint32_t GetFlowHash (Ipv4Header const &header, Ptr<const Packet> p);
 
-  HostRoutes m_hostRoutes;
-  NetworkRoutes m_networkRoutes;
-  ASExternalRoutes m_ASexternalRoutes; // External routes imported
+  RouteTable m_hostRoutes;
+  RouteTable m_networkRoutes;
+  RouteTable m_ASexternalRoutes; // External routes imported
+  /// The runs matched by the last lookup
+  std::vector<uint32_t> m_matches;
+  /// The destinations and next hops of the routes of the last lookup
+  std::vector<std::pair<Ipv4Address, uint32_t> > m_candidates;
 
   Ptr<Ipv4> m_ipv4;
 };
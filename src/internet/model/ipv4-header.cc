@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/header.h"
 #include "ipv4-header.h"
+#include "ns3/packet.h"
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4Header");
 
@@ -41,6 +42,7 @@ Ipv4Header::Ipv4Header ()
     m_fragmentOffset (0),
     m_checksum (0),
     m_goodChecksum (true),
+    m_checksumValid (false),
     m_headerSize(5*4)
 {
 }
@@ -57,6 +59,7 @@ Ipv4Header::SetPayloadSize (uint16_t size)
 {
   NS_LOG_FUNCTION (this << size);
   m_payloadSize = size;
+  m_checksumValid = false;
 }
 uint16_t
 Ipv4Header::GetPayloadSize (void) const
@@ -76,6 +79,7 @@ Ipv4Header::SetIdentification (uint16_t identification)
 {
   NS_LOG_FUNCTION (this << identification);
   m_identification = identification;
+  m_checksumValid = false;
 }
 
 void 
@@ -83,6 +87,7 @@ Ipv4Header::SetTos (uint8_t tos)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (tos));
   m_tos = tos;
+  m_checksumValid = false;
 }
 
 void
@@ -91,6 +96,7 @@ Ipv4Header::SetDscp (DscpType dscp)
   NS_LOG_FUNCTION (this << dscp);
   m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
   m_tos |= dscp;
+  m_checksumValid = false;
 }
 
 void
@@ -99,6 +105,7 @@ Ipv4Header::SetEcn (EcnType ecn)
   NS_LOG_FUNCTION (this << ecn);
   m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
   m_tos |= ecn;
+  m_checksumValid = false;
 }
 
 Ipv4Header::DscpType 
@@ -201,12 +208,14 @@ Ipv4Header::SetMoreFragments (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags |= MORE_FRAGMENTS;
+  m_checksumValid = false;
 }
 void
 Ipv4Header::SetLastFragment (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags &= ~MORE_FRAGMENTS;
+  m_checksumValid = false;
 }
 bool 
 Ipv4Header::IsLastFragment (void) const
@@ -220,12 +229,14 @@ Ipv4Header::SetDontFragment (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags |= DONT_FRAGMENT;
+  m_checksumValid = false;
 }
 void 
 Ipv4Header::SetMayFragment (void)
 {
   NS_LOG_FUNCTION (this);
   m_flags &= ~DONT_FRAGMENT;
+  m_checksumValid = false;
 }
 bool 
 Ipv4Header::IsDontFragment (void) const
@@ -241,6 +252,7 @@ Ipv4Header::SetFragmentOffset (uint16_t offsetBytes)
   // check if the user is trying to set an invalid offset
   NS_ABORT_MSG_IF ((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
   m_fragmentOffset = offsetBytes;
+  m_checksumValid = false;
 }
 uint16_t 
 Ipv4Header::GetFragmentOffset (void) const
@@ -259,6 +271,26 @@ Ipv4Header::SetTtl (uint8_t ttl)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (ttl));
   m_ttl = ttl;
+  m_checksumValid = false;
+}
+void
+Ipv4Header::DecrementTtl (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the TTL and protocol word, as summed by CalculateIpChecksum.
+  uint16_t oldWord = m_ttl | (m_protocol << 8);
+  m_ttl--;
+  if (m_checksumValid)
+    {
+      // RFC 1624, equation 3: HC' = ~(~HC + ~m + m')
+      uint16_t newWord = m_ttl | (m_protocol << 8);
+      uint32_t sum = (uint16_t)~m_checksum + (uint16_t)~oldWord + newWord;
+      while (sum >> 16)
+        {
+          sum = (sum & 0xffff) + (sum >> 16);
+        }
+      m_checksum = ~sum;
+    }
 }
 uint8_t 
 Ipv4Header::GetTtl (void) const
@@ -278,6 +310,7 @@ Ipv4Header::SetProtocol (uint8_t protocol)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (protocol));
   m_protocol = protocol;
+  m_checksumValid = false;
 }
 
 void 
@@ -285,6 +318,7 @@ Ipv4Header::SetSource (Ipv4Address source)
 {
   NS_LOG_FUNCTION (this << source);
   m_source = source;
+  m_checksumValid = false;
 }
 Ipv4Address
 Ipv4Header::GetSource (void) const
@@ -298,6 +332,7 @@ Ipv4Header::SetDestination (Ipv4Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
   m_destination = dst;
+  m_checksumValid = false;
 }
 Ipv4Address
 Ipv4Header::GetDestination (void) const
@@ -407,7 +442,14 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
   i.WriteHtonU32 (m_source.Get ());
   i.WriteHtonU32 (m_destination.Get ());
 
-  if (m_calcChecksum) 
+  if (m_calcChecksum && m_checksumValid)
+    {
+      // the header was received and then only modified by DecrementTtl.
+      i = start;
+      i.Next (10);
+      i.WriteU16 (m_checksum);
+    }
+  else if (m_calcChecksum) 
     {
       i = start;
       uint16_t checksum = i.CalculateIpChecksum (20);
@@ -461,7 +503,83 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
 
       m_goodChecksum = (checksum == 0);
     }
+  // Serialize writes the same bytes, and can thus reuse the checksum, if
+  // the header has no options and the reserved flag is not set.
+  m_checksumValid = m_calcChecksum && m_goodChecksum && headerSize == 20 && !(flags & (1<<7));
   return GetSerializedSize ();
 }
 
+Ipv4HeaderView::Ipv4HeaderView (Ptr<const Packet> packet)
+  : m_data (packet->PeekContiguousData (20))
+{
+  NS_LOG_FUNCTION (this << packet);
+  if (m_data == 0 && packet->CopyData (m_storage, 20) == 20)
+    {
+      m_data = m_storage;
+    }
+}
+
+bool
+Ipv4HeaderView::IsValid (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_data != 0;
+}
+
+uint16_t
+Ipv4HeaderView::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return (m_data[0] & 0x0f) * 4;
+}
+
+uint16_t
+Ipv4HeaderView::GetPayloadSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return ((m_data[2] << 8) | m_data[3]) - GetSerializedSize ();
+}
+
+uint16_t
+Ipv4HeaderView::GetIdentification (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return (m_data[4] << 8) | m_data[5];
+}
+
+uint8_t
+Ipv4HeaderView::GetTtl (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return m_data[8];
+}
+
+uint8_t
+Ipv4HeaderView::GetProtocol (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return m_data[9];
+}
+
+Ipv4Address
+Ipv4HeaderView::GetSource (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return Ipv4Address::Deserialize (m_data + 12);
+}
+
+Ipv4Address
+Ipv4HeaderView::GetDestination (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (IsValid ());
+  return Ipv4Address::Deserialize (m_data + 16);
+}
+
 } // namespace ns3
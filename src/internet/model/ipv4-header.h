@@ -23,8 +23,12 @@
 
 #include "ns3/header.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/ptr.h"
 
 namespace ns3 {
+
+class Packet;
+
 /**
  * \brief Packet header for IPv4
  */
@@ -143,6 +147,14 @@ public:
    * \param ttl the ipv4 TTL
    */
   void SetTtl (uint8_t ttl);
+  /**
+   * \brief Decrement the TTL, as routers do when forwarding.
+   *
+   * If this header was deserialized with the checksum enabled and not
+   * modified since, its checksum is updated incrementally (RFC 1624)
+   * rather than recomputed when the header is serialized again.
+   */
+  void DecrementTtl (void);
   /**
    * \param num the ipv4 protocol field
    */
@@ -246,9 +258,67 @@ private:
   Ipv4Address m_destination;
   uint16_t m_checksum;
   bool m_goodChecksum;
+  bool m_checksumValid; //!< m_checksum matches the fields, see DecrementTtl
   uint16_t m_headerSize;
 };
 
+/**
+ * \ingroup ipv4
+ * \brief Read-only view of the Ipv4 header located at the start of a packet
+ *
+ * The fields are read on demand from the bytes of the packet instead
+ * of deserializing a complete Ipv4Header. The bytes are not copied
+ * when they are stored contiguously in the packet buffer, which is
+ * the common case for headers. A view must not outlive, nor be used
+ * after a modification of, the packet it was created from.
+ */
+class Ipv4HeaderView
+{
+public:
+  /**
+   * \param packet the packet which starts with an Ipv4 header.
+   */
+  Ipv4HeaderView (Ptr<const Packet> packet);
+  /**
+   * \returns true if the packet is large enough to hold an Ipv4 header.
+   */
+  bool IsValid (void) const;
+  /**
+   * \returns the size of the header, including options.
+   */
+  uint16_t GetSerializedSize (void) const;
+  /**
+   * \returns the size of the payload in bytes
+   */
+  uint16_t GetPayloadSize (void) const;
+  /**
+   * \returns the identification field of this packet.
+   */
+  uint16_t GetIdentification (void) const;
+  /**
+   * \returns the TTL field of this packet
+   */
+  uint8_t GetTtl (void) const;
+  /**
+   * \returns the protocol field of this packet
+   */
+  uint8_t GetProtocol (void) const;
+  /**
+   * \returns the source address of this packet
+   */
+  Ipv4Address GetSource (void) const;
+  /**
+   * \returns the destination address of this packet
+   */
+  Ipv4Address GetDestination (void) const;
+private:
+  Ipv4HeaderView (const Ipv4HeaderView &o);
+  Ipv4HeaderView &operator = (const Ipv4HeaderView &o);
+
+  const uint8_t *m_data;
+  uint8_t m_storage[20];
+};
+
 } // namespace ns3
 
 
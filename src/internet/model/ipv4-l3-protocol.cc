@@ -32,6 +32,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/segment-offload-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -46,6 +47,13 @@ namespace ns3 {
 
 const uint16_t Ipv4L3Protocol::PROT_NUMBER = 0x0800;
 
+/// The number of ticks of the reassembly timer wheel in FragmentExpirationTimeout.
+static const uint32_t FRAGMENTS_TIMER_TICKS = 8;
+
+/// The number of fragments the reassembly buffer of a packet has room for
+/// upon its creation, enough for a 9000 bytes datagram over a 1500 bytes MTU.
+static const uint32_t FRAGMENTS_SLOTS = 8;
+
 NS_OBJECT_ENSURE_REGISTERED (Ipv4L3Protocol);
 
 TypeId 
@@ -90,8 +98,8 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
-  : m_identification (0)
-
+  : m_identification (0),
+    m_fragmentsTimers (FRAGMENTS_TIMER_TICKS)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -215,21 +223,14 @@ Ipv4L3Protocol::DoDispose (void)
   m_node = 0;
   m_routingProtocol = 0;
 
-  for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      it->second = 0;
-    }
-
-  for (MapFragmentsTimers_t::iterator it = m_fragmentsTimers.begin (); it != m_fragmentsTimers.end (); it++)
+  std::list<Fragments *> fragments;
+  m_fragmentsTimers.Clear (fragments);
+  for (std::list<Fragments *>::iterator it = fragments.begin (); it != fragments.end (); it++)
     {
-      if (it->second.IsRunning ())
-        {
-          it->second.Cancel ();
-        }
+      delete *it;
     }
-
-  m_fragments.clear ();
-  m_fragmentsTimers.clear ();
+  m_fragments.Clear ();
+  m_fragmentsTimerEvent.Cancel ();
 
   Object::DoDispose ();
 }
@@ -746,14 +747,19 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   NS_ASSERT (interface >= 0);
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
+  // Offloaded packets are sent as one unit by the devices which support
+  // it, and fragmented without their tag through the other devices.
+  SegmentOffloadTag offload;
+  bool offloaded = outDev->SupportsSegmentOffload () && packet->PeekPacketTag (offload);
 
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () && !offloaded )
             {
+              packet->RemovePacketTag (offload);
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
               for ( std::list<Ptr<Packet> >::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
@@ -781,8 +787,9 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () && !offloaded )
             {
+              packet->RemovePacketTag (offload);
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
               for ( std::list<Ptr<Packet> >::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
@@ -825,7 +832,7 @@ Ipv4L3Protocol::IpMulticastForward (Ptr<Ipv4MulticastRoute> mrtentry, Ptr<const
 
       Ptr<Packet> packet = p->Copy ();
       Ipv4Header h = header;
-      h.SetTtl (header.GetTtl () - 1);
+      h.DecrementTtl ();
       if (h.GetTtl () == 0)
         {
           NS_LOG_WARN ("TTL exceeded.  Drop.");
@@ -853,7 +860,7 @@ Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ip
   Ipv4Header ipHeader = header;
   Ptr<Packet> packet = p->Copy ();
   int32_t interface = GetInterfaceForDevice (rtentry->GetOutputDevice ());
-  ipHeader.SetTtl (ipHeader.GetTtl () - 1);
+  ipHeader.DecrementTtl ();
   if (ipHeader.GetTtl () == 0)
     {
       // Do not reply to ICMP or to multicast/broadcast IP address 
@@ -1275,29 +1282,33 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 {
   NS_LOG_FUNCTION (this << packet << ipHeader << iif);
 
-  uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 & uint64_t (ipHeader.GetDestination ().Get ());
-  uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 & uint32_t (ipHeader.GetProtocol ());
-  std::pair<uint64_t, uint32_t> key;
   bool ret = false;
   Ptr<Packet> p = packet->Copy ();
 
-  key.first = addressCombination;
-  key.second = idProto;
-
-  Ptr<Fragments> fragments;
+  uint32_t hash = GetFragmentsHash (ipHeader);
+  Fragments *fragments = 0;
 
-  MapFragments_t::iterator it = m_fragments.find (key);
-  if (it == m_fragments.end ())
+  m_fragmentsCandidates.clear ();
+  m_fragments.Find (hash, m_fragmentsCandidates);
+  for (std::vector<Fragments *>::const_iterator it = m_fragmentsCandidates.begin (); it != m_fragmentsCandidates.end (); it++)
     {
-      fragments = Create<Fragments> ();
-      m_fragments.insert (std::make_pair (key, fragments));
-      m_fragmentsTimers[key] = Simulator::Schedule (m_fragmentExpirationTimeout,
-                                                    &Ipv4L3Protocol::HandleFragmentsTimeout, this,
-                                                    key, ipHeader, iif);
+      if ((*it)->IsMatching (ipHeader))
+        {
+          fragments = *it;
+          break;
+        }
     }
-  else
+
+  if (fragments == 0)
     {
-      fragments = it->second;
+      fragments = new Fragments (ipHeader, iif);
+      m_fragments.Insert (hash, fragments);
+      fragments->SetTimeout (m_fragmentsTimers.Insert (fragments));
+      if (!m_fragmentsTimerEvent.IsRunning ())
+        {
+          m_fragmentsTimerEvent = Simulator::Schedule (TimeStep (m_fragmentExpirationTimeout.GetTimeStep () / FRAGMENTS_TIMER_TICKS),
+                                                       &Ipv4L3Protocol::HandleFragmentsTimeout, this);
+        }
     }
 
   NS_LOG_LOGIC ("Adding fragment - Size: " << packet->GetSize ( ) << " - Offset: " << (ipHeader.GetFragmentOffset ()) );
@@ -1307,24 +1318,43 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   if ( fragments->IsEntire () )
     {
       packet = fragments->GetPacket ();
-      fragments = 0;
-      m_fragments.erase (key);
-      if (m_fragmentsTimers[key].IsRunning ())
-        {
-          NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
-          m_fragmentsTimers[key].Cancel ();
-        }
-      m_fragmentsTimers.erase (key);
+      m_fragmentsTimers.Remove (fragments->GetTimeout ());
+      RemoveFragments (fragments);
       ret = true;
     }
 
   return ret;
 }
 
-Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+uint32_t
+Ipv4L3Protocol::GetFragmentsHash (Ipv4Header const &ipHeader)
 {
-  NS_LOG_FUNCTION (this);
+  uint8_t buffer[11];
+  ipHeader.GetSource ().Serialize (buffer);
+  ipHeader.GetDestination ().Serialize (buffer + 4);
+  buffer[8] = ipHeader.GetIdentification () >> 8;
+  buffer[9] = ipHeader.GetIdentification () & 0xff;
+  buffer[10] = ipHeader.GetProtocol ();
+  return m_hasher.clear ().GetHash32 ((char const *)buffer, sizeof (buffer));
+}
+
+void
+Ipv4L3Protocol::RemoveFragments (Fragments *fragments)
+{
+  NS_LOG_FUNCTION (this << fragments);
+
+  bool found = m_fragments.Remove (GetFragmentsHash (fragments->GetIpHeader ()), fragments);
+  NS_ASSERT (found);
+  delete fragments;
+}
+
+Ipv4L3Protocol::Fragments::Fragments (Ipv4Header const &ipHeader, uint32_t iif)
+  : m_moreFragment (0),
+    m_ipHeader (ipHeader),
+    m_iif (iif)
+{
+  NS_LOG_FUNCTION (this << ipHeader << iif);
+  m_fragments.reserve (FRAGMENTS_SLOTS);
 }
 
 Ipv4L3Protocol::Fragments::~Fragments ()
@@ -1337,14 +1367,12 @@ Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentO
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  // the fragments mostly arrive in order: look for the slot from the end.
+  std::vector<std::pair<Ptr<Packet>, uint16_t> >::iterator it = m_fragments.end ();
 
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
+  while (it != m_fragments.begin () && (it - 1)->second > fragmentOffset)
     {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
+      it--;
     }
 
   if (it == m_fragments.end ())
@@ -1366,7 +1394,7 @@ Ipv4L3Protocol::Fragments::IsEntire () const
     {
       uint16_t lastEndOffset = 0;
 
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
+      for (std::vector<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
         {
           // overlapping fragments do exist
           NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
@@ -1390,7 +1418,7 @@ Ipv4L3Protocol::Fragments::GetPacket () const
 {
   NS_LOG_FUNCTION (this);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
+  std::vector<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
 
   Ptr<Packet> p = Create<Packet> ();
   uint16_t lastEndOffset = 0;
@@ -1427,7 +1455,7 @@ Ipv4L3Protocol::Fragments::GetPartialPacket () const
 {
   NS_LOG_FUNCTION (this);
   
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
+  std::vector<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
 
   Ptr<Packet> p = Create<Packet> ();
   uint16_t lastEndOffset = 0;
@@ -1457,27 +1485,69 @@ Ipv4L3Protocol::Fragments::GetPartialPacket () const
   return p;
 }
 
+bool
+Ipv4L3Protocol::Fragments::IsMatching (Ipv4Header const &ipHeader) const
+{
+  return m_ipHeader.GetSource () == ipHeader.GetSource ()
+         && m_ipHeader.GetDestination () == ipHeader.GetDestination ()
+         && m_ipHeader.GetIdentification () == ipHeader.GetIdentification ()
+         && m_ipHeader.GetProtocol () == ipHeader.GetProtocol ();
+}
+
+Ipv4Header const &
+Ipv4L3Protocol::Fragments::GetIpHeader () const
+{
+  return m_ipHeader;
+}
+
+uint32_t
+Ipv4L3Protocol::Fragments::GetInterface () const
+{
+  return m_iif;
+}
+
 void
-Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif)
+Ipv4L3Protocol::Fragments::SetTimeout (TimerWheel<Fragments>::Handle timeout)
 {
-  NS_LOG_FUNCTION (this << &key << &ipHeader << iif);
+  m_timeout = timeout;
+}
 
-  MapFragments_t::iterator it = m_fragments.find (key);
-  Ptr<Packet> packet = it->second->GetPartialPacket ();
+TimerWheel<Ipv4L3Protocol::Fragments>::Handle const &
+Ipv4L3Protocol::Fragments::GetTimeout () const
+{
+  return m_timeout;
+}
 
-  // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+void
+Ipv4L3Protocol::HandleFragmentsTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::list<Fragments *> expired;
+  m_fragmentsTimers.Tick (expired);
+
+  for (std::list<Fragments *>::iterator it = expired.begin (); it != expired.end (); it++)
     {
-      Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
-      icmp->SendTimeExceededTtl (ipHeader, packet);
-    }
-  m_dropTrace (ipHeader, packet, DROP_FRAGMENT_TIMEOUT, m_node->GetObject<Ipv4> (), iif);
+      Fragments *fragments = *it;
+      Ipv4Header ipHeader = fragments->GetIpHeader ();
+      uint32_t iif = fragments->GetInterface ();
+      Ptr<Packet> packet = fragments->GetPartialPacket ();
+      RemoveFragments (fragments);
 
-  // clear the buffers
-  it->second = 0;
+      // if we have at least 8 bytes, we can send an ICMP.
+      if ( packet->GetSize () > 8 )
+        {
+          Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
+          icmp->SendTimeExceededTtl (ipHeader, packet);
+        }
+      m_dropTrace (ipHeader, packet, DROP_FRAGMENT_TIMEOUT, m_node->GetObject<Ipv4> (), iif);
+    }
 
-  m_fragments.erase (key);
-  m_fragmentsTimers.erase (key);
+  if (m_fragmentsTimers.GetN () > 0)
+    {
+      m_fragmentsTimerEvent = Simulator::Schedule (TimeStep (m_fragmentExpirationTimeout.GetTimeStep () / FRAGMENTS_TIMER_TICKS),
+                                                   &Ipv4L3Protocol::HandleFragmentsTimeout, this);
+    }
 }
 
 } // namespace ns3
@@ -34,6 +34,9 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/hash.h"
+#include "end-point-hash-table.h"
+#include "timer-wheel.h"
 
 namespace ns3 {
 
@@ -284,12 +287,10 @@ private:
   bool ProcessFragment (Ptr<Packet>& packet, Ipv4Header & ipHeader, uint32_t iif);
 
   /**
-   * \brief Process the timeout for packet fragments
-   * \param key representing the packet fragments
-   * \param ipHeader the IP header of the original packet
-   * \param iif Input Interface
+   * \brief Process the timeouts of the packet fragments, once per tick
+   * of the reassembly timer wheel.
    */
-  void HandleFragmentsTimeout ( std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif);
+  void HandleFragmentsTimeout (void);
 
   typedef std::vector<Ptr<Ipv4Interface> > Ipv4InterfaceList;
   typedef std::list<Ptr<Ipv4RawSocketImpl> > SocketList;
@@ -321,14 +322,21 @@ private:
   /**
    * \class Fragments
    * \brief A Set of Fragment belonging to the same packet (src, dst, identification and proto)
+   *
+   * The fragments are kept sorted by offset in a vector, whose slots are
+   * reserved when the set is created: the fragments of a datagram of a
+   * few MTUs are added without any allocation, and in order in the
+   * common case.
    */
-  class Fragments : public SimpleRefCount<Fragments>
+  class Fragments
   {
 public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IP header of the first fragment received
+     * \param iif Input Interface
      */
-    Fragments ();
+    Fragments (Ipv4Header const &ipHeader, uint32_t iif);
 
     /**
      * \brief Destructor.
@@ -361,6 +369,37 @@ public:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \brief If a fragment belongs to this packet.
+     * \param ipHeader the IP header of the fragment
+     * \returns true if the fragment has the same src, dst, identification and proto
+     */
+    bool IsMatching (Ipv4Header const &ipHeader) const;
+
+    /**
+     * \brief Get the IP header of the first fragment received.
+     * \return the IP header
+     */
+    Ipv4Header const &GetIpHeader () const;
+
+    /**
+     * \brief Get the interface the first fragment was received on.
+     * \return the Input Interface
+     */
+    uint32_t GetInterface () const;
+
+    /**
+     * \brief Set the position of the packet in the reassembly timer wheel.
+     * \param timeout the handle of the packet in the timer wheel
+     */
+    void SetTimeout (TimerWheel<Fragments>::Handle timeout);
+
+    /**
+     * \brief Get the position of the packet in the reassembly timer wheel.
+     * \return the handle of the packet in the timer wheel
+     */
+    TimerWheel<Fragments>::Handle const &GetTimeout () const;
+
 private:
     /**
      * \brief True if other fragments will be sent.
@@ -370,19 +409,46 @@ private:
     /**
      * \brief The current fragments.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    std::vector<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+
+    /**
+     * \brief The IP header of the first fragment received.
+     */
+    Ipv4Header m_ipHeader;
+
+    /**
+     * \brief The interface the first fragment was received on.
+     */
+    uint32_t m_iif;
 
+    /**
+     * \brief The position of the packet in the reassembly timer wheel.
+     */
+    TimerWheel<Fragments>::Handle m_timeout;
   };
 
-  typedef std::map< std::pair<uint64_t, uint32_t>, Ptr<Fragments> > MapFragments_t;
-  typedef std::map< std::pair<uint64_t, uint32_t>, EventId > MapFragmentsTimers_t;
+  /**
+   * \brief Get the hash of the src, dst, identification and proto of a fragment.
+   * \param ipHeader the IP header of the fragment
+   * \return the hash
+   */
+  uint32_t GetFragmentsHash (Ipv4Header const &ipHeader);
+
+  /**
+   * \brief Remove a packet from the reassembly buffers and delete it.
+   * \param fragments the packet fragments
+   */
+  void RemoveFragments (Fragments *fragments);
 
   /**
    * \brief The hash of fragmented packets.
    */
-  MapFragments_t       m_fragments;
-  Time                 m_fragmentExpirationTimeout;
-  MapFragmentsTimers_t m_fragmentsTimers;
+  EndPointHashTable<Fragments> m_fragments;
+  std::vector<Fragments *>     m_fragmentsCandidates; //!< Scratch vector of the lookups in m_fragments
+  Hasher                       m_hasher;
+  Time                         m_fragmentExpirationTimeout;
+  TimerWheel<Fragments>        m_fragmentsTimers;     //!< The timeouts of the fragmented packets
+  EventId                      m_fragmentsTimerEvent; //!< The next tick of m_fragmentsTimers
 
 };
 
@@ -40,6 +40,21 @@ using std::make_pair;
 
 namespace ns3 {
 
+namespace {
+
+/**
+ * \returns true if the mask is made of leading ones only, so that the
+ *          routes using it can be indexed by prefix.
+ */
+bool
+IsContiguous (Ipv4Mask mask)
+{
+  uint32_t hostBits = ~mask.Get ();
+  return (hostBits & (hostBits + 1)) == 0;
+}
+
+} // anonymous namespace
+
 NS_OBJECT_ENSURE_REGISTERED (Ipv4StaticRouting);
 
 TypeId
@@ -53,7 +68,8 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_nNonContiguousRoutes (0),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -71,7 +87,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         nextHop,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddNetworkRoute (route, metric);
 }
 
 void 
@@ -85,7 +101,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddNetworkRoute (route, metric);
 }
 
 void 
@@ -142,7 +158,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  AddNetworkRoute (route, 0);
 }
 
 uint32_t 
@@ -223,8 +239,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -238,9 +252,53 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
       return rtentry;
     }
 
+  Ipv4RoutingTableEntry *route = 0;
+  if (m_nNonContiguousRoutes > 0)
+    {
+      route = SelectNetworkRoute (m_networkRoutes, dest, oif);
+    }
+  else
+    {
+      // all the routes of a prefix have the same mask length: the
+      // prefixes of the destination are searched from the longest.
+      uint8_t key[4];
+      dest.Serialize (key);
+      NetworkRouteTrie::Values const *matches[33];
+      uint32_t nMatches = m_networkRouteTrie.Match (key, 32, matches);
+      for (uint32_t k = nMatches; k > 0 && route == 0; k--)
+        {
+          route = SelectNetworkRoute (*matches[k - 1], dest, oif);
+        }
+    }
+  if (route != 0)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
+  if (rtentry != 0)
+    {
+      NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
+    }
+  else
+    {
+      NS_LOG_LOGIC ("No matching route to " << dest << " found");
+    }
+  return rtentry;
+}
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
+Ipv4RoutingTableEntry *
+Ipv4StaticRouting::SelectNetworkRoute (NetworkRoutes const &routes, Ipv4Address dest, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << dest << " " << oif);
+  Ipv4RoutingTableEntry *route = 0;
+  uint16_t longest_mask = 0;
+  uint32_t shortest_metric = 0xffffffff;
+  for (NetworkRoutesCI i = routes.begin (); 
+       i != routes.end (); 
        i++) 
     {
       Ipv4RoutingTableEntry *j=i->first;
@@ -276,24 +334,10 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
               continue;
             }
           shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+          route = j;
         }
     }
-  if (rtentry != 0)
-    {
-      NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
-    }
-  else
-    {
-      NS_LOG_LOGIC ("No matching route to " << dest << " found");
-    }
-  return rtentry;
+  return route;
 }
 
 Ptr<Ipv4MulticastRoute>
@@ -442,8 +486,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete j->first;
-          m_networkRoutes.erase (j);
+          RemoveNetworkRoute (j);
           return;
         }
       tmp++;
@@ -451,6 +494,44 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+void
+Ipv4StaticRouting::AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  Ipv4Mask mask = route->GetDestNetworkMask ();
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+  if (IsContiguous (mask))
+    {
+      uint8_t key[4];
+      route->GetDestNetwork ().CombineMask (mask).Serialize (key);
+      m_networkRouteTrie.Insert (key, mask.GetPrefixLength (), m_networkRoutes.back ());
+    }
+  else
+    {
+      m_nNonContiguousRoutes++;
+    }
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::RemoveNetworkRoute (NetworkRoutesI i)
+{
+  NS_LOG_FUNCTION (this << i->first);
+  Ipv4Mask mask = i->first->GetDestNetworkMask ();
+  if (IsContiguous (mask))
+    {
+      uint8_t key[4];
+      i->first->GetDestNetwork ().CombineMask (mask).Serialize (key);
+      bool found = m_networkRouteTrie.Remove (key, mask.GetPrefixLength (), *i);
+      NS_ASSERT (found);
+    }
+  else
+    {
+      m_nNonContiguousRoutes--;
+    }
+  delete i->first;
+  return m_networkRoutes.erase (i);
+}
+
 Ptr<Ipv4Route> 
 Ipv4StaticRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
@@ -592,6 +673,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkRouteTrie.Clear ();
+  m_nNonContiguousRoutes = 0;
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/lpm-trie.h"
 
 namespace ns3 {
 
@@ -383,6 +384,24 @@ private:
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::const_iterator MulticastRoutesCI;
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  typedef LpmTrie<std::pair <Ipv4RoutingTableEntry *, uint32_t> > NetworkRouteTrie;
+
+  /**
+   * \brief Append a route to m_networkRoutes and index it by prefix.
+   */
+  void AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+  /**
+   * \brief Remove a route from m_networkRoutes and from the prefix index,
+   * and delete it.
+   * \returns the route following the removed route.
+   */
+  NetworkRoutesI RemoveNetworkRoute (NetworkRoutesI i);
+  /**
+   * \brief Select the route to dest among routes: the longest mask
+   * which matches, then the lowest metric, then the last route added.
+   */
+  Ipv4RoutingTableEntry *SelectNetworkRoute (NetworkRoutes const &routes, Ipv4Address dest, Ptr<NetDevice> oif);
+
   Ptr<Ipv4Route> LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif = 0);
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
@@ -390,6 +409,10 @@ private:
   Ipv4Address SourceAddressSelection (uint32_t interface, Ipv4Address dest);
 
   NetworkRoutes m_networkRoutes;
+  // the routes of m_networkRoutes, indexed by destination prefix, but
+  // for the routes with non-contiguous masks, which disable the index.
+  NetworkRouteTrie m_networkRouteTrie;
+  uint32_t m_nNonContiguousRoutes;
   MulticastRoutes m_multicastRoutes;
 
   Ptr<Ipv4> m_ipv4;
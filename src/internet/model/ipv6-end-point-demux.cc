@@ -18,6 +18,7 @@
  * Author: Sebastien Vincent <vincent@clarinet.u-strasbg.fr>
  */
 
+#include <algorithm>
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
@@ -29,7 +30,8 @@ NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_nAllocated (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -37,9 +39,12 @@ Ipv6EndPointDemux::Ipv6EndPointDemux ()
 Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  m_connections.Clear ();
+  m_listeners.Clear ();
+  for (std::map<uint64_t, Ipv6EndPoint *>::iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv6EndPoint *endPoint = *i;
+      Ipv6EndPoint *endPoint = i->second;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
@@ -48,28 +53,13 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_nPortEndPoints.find (port) != m_nPortEndPoints.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_nLocalEndPoints.find (std::make_pair (addr, port)) != m_nLocalEndPoints.end ();
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
@@ -82,7 +72,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -97,7 +87,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -118,7 +108,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -127,7 +117,8 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::vector<Ipv6EndPoint *> const &candidates = GetCandidates (localAddress, localPort, peerAddress, peerPort);
+  for (std::vector<Ipv6EndPoint *>::const_iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       if ((*i)->GetLocalPort () == localPort
           && (*i)->GetLocalAddress () == localAddress
@@ -141,7 +132,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Add (endPoint);
 
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
 
@@ -151,15 +142,14 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (endPoint->m_demux != this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  Unindex (endPoint);
+  m_endPoints.erase (endPoint->m_sequence);
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -178,8 +168,10 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval3; /* Matches all but local address */
   EndPoints retval4; /* Exact match on all 4 */
 
+  std::vector<Ipv6EndPoint *> const &candidates = GetCandidates (daddr, dport, saddr, sport);
+
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (std::vector<Ipv6EndPoint *>::const_iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
@@ -280,38 +272,44 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  std::vector<Ipv6EndPoint *> const &candidates = GetCandidates (dst, dport, src, sport);
+  for (std::vector<Ipv6EndPoint *>::const_iterator i = candidates.begin (); i != candidates.end (); i++)
+    {
+      if ((*i)->GetLocalPort () == dport
+          && (*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
+          && (*i)->GetPeerAddress () == src)
+        {
+          /* this is an exact match. */
+          return *i;
+        }
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (std::map<uint64_t, Ipv6EndPoint *>::const_iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
+      Ipv6EndPoint *endPoint = i->second;
       uint32_t tmp = 0;
 
-      if ((*i)->GetLocalPort () != dport)
+      if (endPoint->GetLocalPort () != dport)
         {
           continue;
         }
 
-      if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
-          && (*i)->GetPeerAddress () == src)
-        {
-          /* this is an exact match. */
-          return *i;
-        }
-
-      if ((*i)->GetLocalAddress () == Ipv6Address::GetAny ())
+      if (endPoint->GetLocalAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
-      if ((*i)->GetPeerAddress () == Ipv6Address::GetAny ())
+      if (endPoint->GetPeerAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
       if (tmp < genericity)
         {
-          generic = (*i);
+          generic = endPoint;
           genericity = tmp;
         }
     }
@@ -342,7 +340,108 @@ uint16_t Ipv6EndPointDemux::AllocateEphemeralPort ()
 
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
 {
-  return m_endPoints;
+  EndPoints endPoints;
+  for (std::map<uint64_t, Ipv6EndPoint *>::const_iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+    {
+      endPoints.push_back (i->second);
+    }
+  return endPoints;
+}
+
+void Ipv6EndPointDemux::Add (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  endPoint->m_demux = this;
+  endPoint->m_sequence = m_nAllocated++;
+  m_endPoints[endPoint->m_sequence] = endPoint;
+  Index (endPoint);
+}
+
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t port = endPoint->m_localPort;
+  if (IsConnection (endPoint))
+    {
+      m_connections.Insert (GetHash (endPoint->m_localAddr, port, endPoint->m_peerAddr, endPoint->m_peerPort),
+                            endPoint);
+    }
+  else
+    {
+      m_listeners.Insert (GetHash (port), endPoint);
+    }
+  m_nPortEndPoints[port]++;
+  m_nLocalEndPoints[std::make_pair (endPoint->m_localAddr, port)]++;
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  uint16_t port = endPoint->m_localPort;
+  if (IsConnection (endPoint))
+    {
+      m_connections.Remove (GetHash (endPoint->m_localAddr, port, endPoint->m_peerAddr, endPoint->m_peerPort),
+                            endPoint);
+    }
+  else
+    {
+      m_listeners.Remove (GetHash (port), endPoint);
+    }
+  std::map<uint16_t, uint32_t>::iterator i = m_nPortEndPoints.find (port);
+  if (--i->second == 0)
+    {
+      m_nPortEndPoints.erase (i);
+    }
+  std::map<std::pair<Ipv6Address, uint16_t>, uint32_t>::iterator j =
+    m_nLocalEndPoints.find (std::make_pair (endPoint->m_localAddr, port));
+  if (--j->second == 0)
+    {
+      m_nLocalEndPoints.erase (j);
+    }
+}
+
+std::vector<Ipv6EndPoint *> const &Ipv6EndPointDemux::GetCandidates (Ipv6Address localAddress, uint16_t localPort,
+                                                                     Ipv6Address peerAddress, uint16_t peerPort)
+{
+  m_candidates.clear ();
+  m_listeners.Find (GetHash (localPort), m_candidates);
+  m_connections.Find (GetHash (localAddress, localPort, peerAddress, peerPort), m_candidates);
+  if (m_candidates.size () > 1)
+    {
+      std::sort (m_candidates.begin (), m_candidates.end (), &Ipv6EndPointDemux::IsAllocatedBefore);
+    }
+  return m_candidates;
+}
+
+bool Ipv6EndPointDemux::IsConnection (Ipv6EndPoint *endPoint)
+{
+  return endPoint->m_localAddr != Ipv6Address::GetAny ()
+         && endPoint->m_peerAddr != Ipv6Address::GetAny ()
+         && endPoint->m_peerPort != 0;
+}
+
+bool Ipv6EndPointDemux::IsAllocatedBefore (Ipv6EndPoint *a, Ipv6EndPoint *b)
+{
+  return a->m_sequence < b->m_sequence;
+}
+
+uint32_t Ipv6EndPointDemux::GetHash (Ipv6Address localAddress, uint16_t localPort,
+                                     Ipv6Address peerAddress, uint16_t peerPort)
+{
+  uint8_t buffer[36];
+  localAddress.GetBytes (buffer);
+  peerAddress.GetBytes (buffer + 16);
+  buffer[32] = localPort >> 8;
+  buffer[33] = localPort & 0xff;
+  buffer[34] = peerPort >> 8;
+  buffer[35] = peerPort & 0xff;
+  return m_hasher.clear ().GetHash32 ((char const *)buffer, sizeof (buffer));
+}
+
+uint32_t Ipv6EndPointDemux::GetHash (uint16_t localPort)
+{
+  /* the listeners are few: the port is a good enough hash. */
+  return localPort;
 }
 
 } /* namespace ns3 */
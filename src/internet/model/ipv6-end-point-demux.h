@@ -23,8 +23,12 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <vector>
 #include "ns3/ipv6-address.h"
+#include "ns3/hash.h"
 #include "ipv6-interface.h"
+#include "end-point-hash-table.h"
 
 namespace ns3 {
 
@@ -33,6 +37,12 @@ class Ipv6EndPoint;
 /**
  * \class Ipv6EndPointDemux
  * \brief Demultiplexor for end points.
+ *
+ * The end points whose four-tuple is fully specified are indexed by a
+ * hash table of their four-tuple, and the other end points by a hash
+ * table of their local port. Among several matching end points of the
+ * same precedence, the lookups return them in the order of their
+ * allocation.
  */
 class Ipv6EndPointDemux
 {
@@ -137,12 +147,71 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
    */
   uint16_t AllocateEphemeralPort ();
 
+  /**
+   * \brief Add a new end point to the demux.
+   * \param endPoint the end point
+   */
+  void Add (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the hash tables.
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the hash tables, before its
+   * four-tuple changes or it is deallocated.
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the end points which may have a four-tuple.
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \return the fully specified end points with the same hash and all
+   * the other end points of the local port, in the order of allocation
+   */
+  std::vector<Ipv6EndPoint *> const &GetCandidates (Ipv6Address localAddress, uint16_t localPort,
+                                                    Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Is the four-tuple of an end point fully specified ?
+   * \param endPoint the end point
+   * \return true if it is
+   */
+  static bool IsConnection (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Compare the allocation order of two end points.
+   * \param a an end point
+   * \param b another end point
+   * \return true if a was allocated before b
+   */
+  static bool IsAllocatedBefore (Ipv6EndPoint *a, Ipv6EndPoint *b);
+
+  /**
+   * \brief Hash a four-tuple.
+   */
+  uint32_t GetHash (Ipv6Address localAddress, uint16_t localPort,
+                    Ipv6Address peerAddress, uint16_t peerPort);
+
+  /**
+   * \brief Hash a local port.
+   */
+  uint32_t GetHash (uint16_t localPort);
+
   /**
    * \brief The ephemeral port.
    */
@@ -159,9 +228,44 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief The IPv6 end points, by order of allocation.
+   */
+  std::map<uint64_t, Ipv6EndPoint *> m_endPoints;
+
+  /**
+   * \brief The number of end points allocated.
+   */
+  uint64_t m_nAllocated;
+
+  /**
+   * \brief The fully specified end points, by hash of their four-tuple.
+   */
+  EndPointHashTable<Ipv6EndPoint> m_connections;
+
+  /**
+   * \brief The other end points, by hash of their local port.
+   */
+  EndPointHashTable<Ipv6EndPoint> m_listeners;
+
+  /**
+   * \brief The number of end points bound to each local port.
+   */
+  std::map<uint16_t, uint32_t> m_nPortEndPoints;
+
+  /**
+   * \brief The number of end points bound to each local address and port.
+   */
+  std::map<std::pair<Ipv6Address, uint16_t>, uint32_t> m_nLocalEndPoints;
+
+  /**
+   * \brief The result of GetCandidates.
+   */
+  std::vector<Ipv6EndPoint *> m_candidates;
+
+  /**
+   * \brief The hash function of the four-tuples.
    */
-  EndPoints m_endPoints;
+  Hasher m_hasher;
 };
 
 } /* namespace ns3 */
@@ -288,6 +288,16 @@ uint8_t Ipv6ExtensionDestination::Process (Ptr<Packet>& packet, uint8_t offset,
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv6ExtensionFragment);
 
+/// The timeout of the reassembly of a packet, in seconds.
+static const uint32_t FRAGMENTS_TIMEOUT = 60;
+
+/// The number of ticks of the reassembly timer wheel in FRAGMENTS_TIMEOUT.
+static const uint32_t FRAGMENTS_TIMER_TICKS = 8;
+
+/// The number of fragments the reassembly buffer of a packet has room for
+/// upon its creation, enough for a 9000 bytes datagram over a 1500 bytes MTU.
+static const uint32_t FRAGMENTS_SLOTS = 8;
+
 TypeId Ipv6ExtensionFragment::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::Ipv6ExtensionFragment")
@@ -298,6 +308,7 @@ TypeId Ipv6ExtensionFragment::GetTypeId ()
 }
 
 Ipv6ExtensionFragment::Ipv6ExtensionFragment ()
+  : m_fragmentsTimers (FRAGMENTS_TIMER_TICKS)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -311,12 +322,14 @@ void Ipv6ExtensionFragment::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
+  std::list<Fragments *> fragments;
+  m_fragmentsTimers.Clear (fragments);
+  for (std::list<Fragments *>::iterator it = fragments.begin (); it != fragments.end (); it++)
     {
-      it->second = 0;
+      delete *it;
     }
-
-  m_fragments.clear ();
+  m_fragments.Clear ();
+  m_fragmentsTimerEvent.Cancel ();
   Ipv6Extension::DoDispose ();
 }
 
@@ -345,27 +358,34 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
   bool moreFragment = fragmentHeader.GetMoreFragment ();
   uint16_t fragmentOffset = fragmentHeader.GetOffset ();
   uint32_t identification = fragmentHeader.GetIdentification ();
-  Ipv6Address src = ipv6Header.GetSourceAddress ();
-
-  std::pair<Ipv6Address, uint32_t> fragmentsId = std::pair<Ipv6Address, uint32_t> (src, identification);
-  Ptr<Fragments> fragments;
 
-  Ipv6Header ipHeader = ipv6Header;
-  ipHeader.SetNextHeader (fragmentHeader.GetNextHeader ());
+  uint32_t hash = GetFragmentsHash (ipv6Header, identification);
+  Fragments *fragments = 0;
 
-  MapFragments_t::iterator it = m_fragments.find (fragmentsId);
-  if (it == m_fragments.end ())
+  m_fragmentsCandidates.clear ();
+  m_fragments.Find (hash, m_fragmentsCandidates);
+  for (std::vector<Fragments *>::const_iterator it = m_fragmentsCandidates.begin (); it != m_fragmentsCandidates.end (); it++)
     {
-      fragments = Create<Fragments> ();
-      m_fragments.insert (std::make_pair (fragmentsId, fragments));
-      EventId timeout = Simulator::Schedule (Seconds (60),
-                                             &Ipv6ExtensionFragment::HandleFragmentsTimeout, this,
-                                             fragmentsId, ipHeader);
-      fragments->SetTimeoutEventId (timeout);
+      if ((*it)->IsMatching (ipv6Header, identification))
+        {
+          fragments = *it;
+          break;
+        }
     }
-  else
+
+  if (fragments == 0)
     {
-      fragments = it->second;
+      Ipv6Header ipHeader = ipv6Header;
+      ipHeader.SetNextHeader (fragmentHeader.GetNextHeader ());
+
+      fragments = new Fragments (ipHeader, identification);
+      m_fragments.Insert (hash, fragments);
+      fragments->SetTimeout (m_fragmentsTimers.Insert (fragments));
+      if (!m_fragmentsTimerEvent.IsRunning ())
+        {
+          m_fragmentsTimerEvent = Simulator::Schedule (Seconds (double (FRAGMENTS_TIMEOUT) / FRAGMENTS_TIMER_TICKS),
+                                                       &Ipv6ExtensionFragment::HandleFragmentsTimeout, this);
+        }
     }
 
   if (fragmentOffset == 0)
@@ -380,8 +400,8 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet, uint8_t offset, Ipv
   if (fragments->IsEntire ())
     {
       packet = fragments->GetPacket ();
-      fragments->CancelTimeout ();
-      m_fragments.erase (fragmentsId);
+      m_fragmentsTimers.Remove (fragments->GetTimeout ());
+      RemoveFragments (fragments);
       isDropped = false;
     }
   else
@@ -569,34 +589,71 @@ void Ipv6ExtensionFragment::GetFragments (Ptr<Packet> packet, uint32_t maxFragme
 }
 
 
-void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> fragmentsId,
-                                                    Ipv6Header & ipHeader)
+void Ipv6ExtensionFragment::HandleFragmentsTimeout ()
 {
-  Ptr<Fragments> fragments;
+  NS_LOG_FUNCTION_NOARGS ();
 
-  MapFragments_t::iterator it = m_fragments.find (fragmentsId);
-  NS_ASSERT_MSG(it != m_fragments.end (), "IPv6 Fragment timeout reached for non-existent fragment");
-  fragments = it->second;
+  std::list<Fragments *> expired;
+  m_fragmentsTimers.Tick (expired);
+
+  for (std::list<Fragments *>::iterator it = expired.begin (); it != expired.end (); it++)
+    {
+      Fragments *fragments = *it;
+      Ipv6Header ipHeader = fragments->GetIpHeader ();
+      Ptr<Packet> packet = fragments->GetPartialPacket ();
+      RemoveFragments (fragments);
 
-  Ptr<Packet> packet = fragments->GetPartialPacket ();
+      // an unfragmentable part is only known from the first fragment.
+      if (!packet)
+        {
+          continue;
+        }
 
-  packet->AddHeader (ipHeader);
+      packet->AddHeader (ipHeader);
 
-  // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+      // if we have at least 8 bytes, we can send an ICMP.
+      if ( packet->GetSize () > 8 )
+        {
+          Ptr<Icmpv6L4Protocol> icmp = GetNode ()->GetObject<Icmpv6L4Protocol> ();
+          icmp->SendErrorTimeExceeded (packet, ipHeader.GetSourceAddress (), Icmpv6Header::ICMPV6_FRAGTIME);
+        }
+      m_dropTrace (packet);
+    }
+
+  if (m_fragmentsTimers.GetN () > 0)
     {
-      Ptr<Icmpv6L4Protocol> icmp = GetNode ()->GetObject<Icmpv6L4Protocol> ();
-      icmp->SendErrorTimeExceeded (packet, ipHeader.GetSourceAddress (), Icmpv6Header::ICMPV6_FRAGTIME);
+      m_fragmentsTimerEvent = Simulator::Schedule (Seconds (double (FRAGMENTS_TIMEOUT) / FRAGMENTS_TIMER_TICKS),
+                                                   &Ipv6ExtensionFragment::HandleFragmentsTimeout, this);
     }
-  m_dropTrace (packet);
+}
+
+uint32_t Ipv6ExtensionFragment::GetFragmentsHash (Ipv6Header const &ipHeader, uint32_t identification)
+{
+  uint8_t buffer[36];
+  ipHeader.GetSourceAddress ().Serialize (buffer);
+  ipHeader.GetDestinationAddress ().Serialize (buffer + 16);
+  buffer[32] = identification >> 24;
+  buffer[33] = (identification >> 16) & 0xff;
+  buffer[34] = (identification >> 8) & 0xff;
+  buffer[35] = identification & 0xff;
+  return m_hasher.clear ().GetHash32 ((char const *)buffer, sizeof (buffer));
+}
+
+void Ipv6ExtensionFragment::RemoveFragments (Fragments *fragments)
+{
+  NS_LOG_FUNCTION (this << fragments);
 
-  // clear the buffers
-  m_fragments.erase (fragmentsId);
+  bool found = m_fragments.Remove (GetFragmentsHash (fragments->GetIpHeader (), fragments->GetIdentification ()), fragments);
+  NS_ASSERT (found);
+  delete fragments;
 }
 
-Ipv6ExtensionFragment::Fragments::Fragments ()
-  : m_moreFragment (0)
+Ipv6ExtensionFragment::Fragments::Fragments (Ipv6Header const &ipHeader, uint32_t identification)
+  : m_moreFragment (0),
+    m_ipHeader (ipHeader),
+    m_identification (identification)
 {
+  m_packetFragments.reserve (FRAGMENTS_SLOTS);
 }
 
 Ipv6ExtensionFragment::Fragments::~Fragments ()
@@ -605,14 +662,12 @@ Ipv6ExtensionFragment::Fragments::~Fragments ()
 
 void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  // the fragments mostly arrive in order: look for the slot from the end.
+  std::vector<std::pair<Ptr<Packet>, uint16_t> >::iterator it = m_packetFragments.end ();
 
-  for (it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  while (it != m_packetFragments.begin () && (it - 1)->second > fragmentOffset)
     {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
+      it--;
     }
 
   if (it == m_packetFragments.end ())
@@ -636,7 +691,7 @@ bool Ipv6ExtensionFragment::Fragments::IsEntire () const
     {
       uint16_t lastEndOffset = 0;
 
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+      for (std::vector<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
         {
           if (lastEndOffset != it->second)
             {
@@ -655,7 +710,7 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPacket () const
 {
   Ptr<Packet> p =  m_unfragmentable->Copy ();
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::vector<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
       p->AddAtEnd (it->first);
     }
@@ -678,7 +733,7 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
 
   uint16_t lastEndOffset = 0;
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::vector<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
       if (lastEndOffset != it->second)
         {
@@ -691,16 +746,31 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
   return p;
 }
 
-void Ipv6ExtensionFragment::Fragments::SetTimeoutEventId (EventId event)
+bool Ipv6ExtensionFragment::Fragments::IsMatching (Ipv6Header const &ipHeader, uint32_t identification) const
+{
+  return m_identification == identification
+         && m_ipHeader.GetSourceAddress () == ipHeader.GetSourceAddress ()
+         && m_ipHeader.GetDestinationAddress () == ipHeader.GetDestinationAddress ();
+}
+
+Ipv6Header const &Ipv6ExtensionFragment::Fragments::GetIpHeader () const
+{
+  return m_ipHeader;
+}
+
+uint32_t Ipv6ExtensionFragment::Fragments::GetIdentification () const
+{
+  return m_identification;
+}
+
+void Ipv6ExtensionFragment::Fragments::SetTimeout (TimerWheel<Fragments>::Handle timeout)
 {
-  m_timeoutEventId = event;
-  return;
+  m_timeout = timeout;
 }
 
-void Ipv6ExtensionFragment::Fragments::CancelTimeout ()
+TimerWheel<Ipv6ExtensionFragment::Fragments>::Handle const &Ipv6ExtensionFragment::Fragments::GetTimeout () const
 {
-  m_timeoutEventId.Cancel ();
-  return;
+  return m_timeout;
 }
 
 
@@ -23,10 +23,12 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 #include "ns3/object.h"
 #include "ns3/node.h"
 #include "ns3/ptr.h"
+#include "ns3/event-id.h"
 #include "ipv6-interface.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/buffer.h"
@@ -34,6 +36,9 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/traced-callback.h"
+#include "ns3/hash.h"
+#include "end-point-hash-table.h"
+#include "timer-wheel.h"
 
 
 namespace ns3 {
@@ -298,15 +303,20 @@ protected:
 private:
   /**
    * \class Fragments
-   * \brief A Set of Fragment
+   * \brief A Set of Fragment belonging to the same packet (src, dst and identification)
+   *
+   * The fragments are kept sorted by offset in a vector, whose slots are
+   * reserved when the set is created.
    */
-  class Fragments : public SimpleRefCount<Fragments>
+  class Fragments
   {
 public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IP header of the packet
+     * \param identification the identification of the packet
      */
-    Fragments ();
+    Fragments (Ipv6Header const &ipHeader, uint32_t identification);
 
     /**
      * \brief Destructor.
@@ -346,14 +356,36 @@ public:
     Ptr<Packet> GetPartialPacket () const;
 
     /**
-     * \brief Set the Timeout EventId.
+     * \brief If a fragment belongs to this packet.
+     * \param ipHeader the IP header of the fragment
+     * \param identification the identification of the fragment
+     * \returns true if the fragment has the same src, dst and identification
+     */
+    bool IsMatching (Ipv6Header const &ipHeader, uint32_t identification) const;
+
+    /**
+     * \brief Get the IP header of the packet.
+     * \return the IP header
+     */
+    Ipv6Header const &GetIpHeader () const;
+
+    /**
+     * \brief Get the identification of the packet.
+     * \return the identification
      */
-    void SetTimeoutEventId (EventId event);
+    uint32_t GetIdentification () const;
 
     /**
-     * \brief Cancel the timeout event
+     * \brief Set the position of the packet in the reassembly timer wheel.
+     * \param timeout the handle of the packet in the timer wheel
      */
-    void CancelTimeout ();
+    void SetTimeout (TimerWheel<Fragments>::Handle timeout);
+
+    /**
+     * \brief Get the position of the packet in the reassembly timer wheel.
+     * \return the handle of the packet in the timer wheel
+     */
+    TimerWheel<Fragments>::Handle const &GetTimeout () const;
 
 private:
     /**
@@ -364,7 +396,7 @@ private:
     /**
      * \brief The current fragments.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_packetFragments;
+    std::vector<std::pair<Ptr<Packet>, uint16_t> > m_packetFragments;
 
     /**
      * \brief The unfragmentable part.
@@ -372,41 +404,65 @@ private:
     Ptr<Packet> m_unfragmentable;
 
     /**
-     * \brief Timeout handler event
+     * \brief The IP header of the packet.
+     */
+    Ipv6Header m_ipHeader;
+
+    /**
+     * \brief The identification of the packet.
      */
-    EventId m_timeoutEventId;
+    uint32_t m_identification;
+
+    /**
+     * \brief The position of the packet in the reassembly timer wheel.
+     */
+    TimerWheel<Fragments>::Handle m_timeout;
   };
 
   /**
-   * \brief Process the timeout for packet fragments
-   * \param key representing the packet fragments
-   * \param ipHeader the IP header of the original packet
-   * \param iif Input Interface
+   * \brief Process the timeouts of the packet fragments, once per tick
+   * of the reassembly timer wheel.
    */
-  void HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> key, Ipv6Header & ipHeader);
+  void HandleFragmentsTimeout (void);
 
   /**
-   * \brief Get the packet parts so far received.
-   * \return the partial packet
+   * \brief Get the hash of the src, dst and identification of a fragment.
+   * \param ipHeader the IP header of the fragment
+   * \param identification the identification of the fragment
+   * \return the hash
    */
-  Ptr<Packet> GetPartialPacket () const;
+  uint32_t GetFragmentsHash (Ipv6Header const &ipHeader, uint32_t identification);
 
   /**
-   * \brief Set the Timeout EventId.
+   * \brief Remove a packet from the reassembly buffers and delete it.
+   * \param fragments the packet fragments
    */
-  void SetTimeoutEventId (EventId event);
+  void RemoveFragments (Fragments *fragments);
 
   /**
-   * \brief Cancel the timeout event
+   * \brief The hash of fragmented packets.
    */
-  void CancelTimeout ();
+  EndPointHashTable<Fragments> m_fragments;
 
-  typedef std::map<std::pair<Ipv6Address, uint32_t>, Ptr<Fragments> > MapFragments_t;
+  /**
+   * \brief Scratch vector of the lookups in m_fragments.
+   */
+  std::vector<Fragments *> m_fragmentsCandidates;
 
   /**
-   * \brief The hash of fragmented packets.
+   * \brief The hasher of the src, dst and identification of the fragments.
+   */
+  Hasher m_hasher;
+
+  /**
+   * \brief The timeouts of the fragmented packets.
+   */
+  TimerWheel<Fragments> m_fragmentsTimers;
+
+  /**
+   * \brief The next tick of m_fragmentsTimers.
    */
-  MapFragments_t m_fragments;
+  EventId m_fragmentsTimerEvent;
 };
 
 /**
@@ -141,6 +141,12 @@ Ptr<NetDevice> Ipv6Interface::GetDevice () const
   return m_device;
 }
 
+Ptr<NdiscCache> Ipv6Interface::GetNdiscCache () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return m_ndCache;
+}
+
 void Ipv6Interface::SetMetric (uint16_t metric)
 {
   NS_LOG_FUNCTION (this << metric);
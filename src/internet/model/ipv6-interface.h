@@ -83,6 +83,13 @@ public:
    */
   virtual Ptr<NetDevice> GetDevice () const;
 
+  /**
+   * \brief Get the NDISC cache.
+   * \return the NDISC cache used by this interface, 0 if the NetDevice
+   * does not need one
+   */
+  Ptr<NdiscCache> GetNdiscCache () const;
+
   /**
    * \brief Set the metric.
    * \param metric configured routing metric (cost) of this interface
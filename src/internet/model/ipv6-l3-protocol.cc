@@ -30,6 +30,7 @@
 #include "ns3/ipv6-route.h"
 #include "ns3/mac16-address.h"
 #include "ns3/mac64-address.h"
+#include "ns3/segment-offload-tag.h"
 
 #include "loopback-net-device.h"
 #include "ipv6-l3-protocol.h"
@@ -886,9 +887,14 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
       targetMtu = dev->GetMtu ();
     }
 
-  if (packet->GetSize () > targetMtu + 40) /* 40 => size of IPv6 header */
+  // Offloaded packets are sent as one unit by the devices which support
+  // it, and fragmented without their tag through the other devices.
+  SegmentOffloadTag offload;
+  bool tagged = packet->PeekPacketTag (offload);
+  if (packet->GetSize () > targetMtu + 40 && !(tagged && dev->SupportsSegmentOffload ())) /* 40 => size of IPv6 header */
     {
-      // Router => drop
+      // Router => drop, unless the packet stands for several packets
+      // which each fit in the MTU
 
       bool fromMe = false;
       for (uint32_t i=0; i<GetNInterfaces(); i++ )
@@ -902,7 +908,7 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
                 }
             }
         }
-      if (!fromMe)
+      if (!fromMe && !tagged)
         {
           Ptr<Icmpv6L4Protocol> icmpv6 = GetIcmpv6 ();
           if ( icmpv6 )
@@ -915,6 +921,7 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
 
       Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
 
+      packet->RemovePacketTag (offload);
       packet->AddHeader (ipHeader);
 
       // To get specific method GetFragments from Ipv6ExtensionFragmentation
@@ -34,6 +34,21 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Ipv6StaticRouting");
 NS_OBJECT_ENSURE_REGISTERED (Ipv6StaticRouting);
 
+namespace {
+
+/**
+ * \brief Check that a prefix is made of leading ones only, so that the
+ * routes using it can be indexed by prefix.
+ * \param prefix the prefix
+ * \return true if the prefix is contiguous
+ */
+bool IsContiguous (Ipv6Prefix prefix)
+{
+  return prefix == Ipv6Prefix (prefix.GetPrefixLength ());
+}
+
+} // anonymous namespace
+
 TypeId Ipv6StaticRouting::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::Ipv6StaticRouting")
@@ -44,7 +59,8 @@ TypeId Ipv6StaticRouting::GetTypeId ()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting ()
-  : m_ipv6 (0)
+  : m_nNonContiguousRoutes (0),
+    m_ipv6 (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -116,7 +132,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << nextHop << interface << metric);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  AddNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -129,7 +145,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
 
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface, prefixToUse);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  AddNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface, uint32_t metric)
@@ -137,7 +153,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   NS_LOG_FUNCTION (this << network << networkPrefix << interface);
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, interface);
-  m_networkRoutes.push_back (std::make_pair (route, metric));
+  AddNetworkRoute (route, metric);
 }
 
 void Ipv6StaticRouting::SetDefaultRoute (Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -161,7 +177,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Address network = Ipv6Address ("ff00::"); /* RFC 3513 */
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
-  m_networkRoutes.push_back (std::make_pair (route, 0));
+  AddNetworkRoute (route, 0);
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -250,8 +266,6 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
 {
   NS_LOG_FUNCTION (this << dst << interface);
   Ptr<Ipv6Route> rtentry = 0;
-  uint16_t longestMask = 0;
-  uint32_t shortestMetric = 0xffffffff;
 
   /* when sending on link-local multicast, there have to be interface specified */
   if (dst == Ipv6Address::GetAllNodesMulticast () || dst.IsSolicitedMulticast ()
@@ -266,7 +280,64 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  Ipv6RoutingTableEntry* route = 0;
+  if (m_nNonContiguousRoutes > 0)
+    {
+      route = SelectNetworkRoute (m_networkRoutes, dst, interface);
+    }
+  else
+    {
+      /* all the routes of a prefix have the same prefix length: the
+       * prefixes of the destination are searched from the longest.
+       */
+      uint8_t key[16];
+      dst.GetBytes (key);
+      NetworkRouteTrie::Values const *matches[129];
+      uint32_t nMatches = m_networkRouteTrie.Match (key, 128, matches);
+      for (uint32_t k = nMatches; k > 0 && route == 0; k--)
+        {
+          route = SelectNetworkRoute (*matches[k - 1], dst, interface);
+        }
+    }
+
+  if (route)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv6Route> ();
+
+      if (route->GetGateway ().IsAny ())
+        {
+          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+        }
+      else if (route->GetDest ().IsAny ()) /* default route */
+        {
+          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
+        }
+      else
+        {
+          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+        }
+
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+    }
+
+  if (rtentry)
+    {
+      NS_LOG_LOGIC ("Matching route via " << rtentry->GetDestination () << " (throught " << rtentry->GetGateway () << ") at the end");
+    }
+  return rtentry;
+}
+
+Ipv6RoutingTableEntry* Ipv6StaticRouting::SelectNetworkRoute (NetworkRoutes const &routes, Ipv6Address dst, Ptr<NetDevice> interface)
+{
+  NS_LOG_FUNCTION (this << dst << interface);
+  Ipv6RoutingTableEntry* route = 0;
+  uint16_t longestMask = 0;
+  uint32_t shortestMetric = 0xffffffff;
+
+  for (NetworkRoutesCI it = routes.begin (); it != routes.end (); it++)
     {
       Ipv6RoutingTableEntry* j = it->first;
       uint32_t metric = it->second;
@@ -302,35 +373,11 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
                 }
 
               shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
-
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
-                {
-                  rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
-
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+              route = j;
             }
         }
     }
-
-  if (rtentry)
-    {
-      NS_LOG_LOGIC ("Matching route via " << rtentry->GetDestination () << " (throught " << rtentry->GetGateway () << ") at the end");
-    }
-  return rtentry;
+  return route;
 }
 
 void Ipv6StaticRouting::DoDispose ()
@@ -342,6 +389,8 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_networkRouteTrie.Clear ();
+  m_nNonContiguousRoutes = 0;
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -402,6 +451,42 @@ Ptr<Ipv6MulticastRoute> Ipv6StaticRouting::LookupStatic (Ipv6Address origin, Ipv
   return mrtentry;
 }
 
+void Ipv6StaticRouting::AddNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << route << metric);
+  Ipv6Prefix prefix = route->GetDestNetworkPrefix ();
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+  if (IsContiguous (prefix))
+    {
+      uint8_t key[16];
+      route->GetDestNetwork ().CombinePrefix (prefix).GetBytes (key);
+      m_networkRouteTrie.Insert (key, prefix.GetPrefixLength (), m_networkRoutes.back ());
+    }
+  else
+    {
+      m_nNonContiguousRoutes++;
+    }
+}
+
+Ipv6StaticRouting::NetworkRoutesI Ipv6StaticRouting::RemoveNetworkRoute (NetworkRoutesI it)
+{
+  NS_LOG_FUNCTION (this << it->first);
+  Ipv6Prefix prefix = it->first->GetDestNetworkPrefix ();
+  if (IsContiguous (prefix))
+    {
+      uint8_t key[16];
+      it->first->GetDestNetwork ().CombinePrefix (prefix).GetBytes (key);
+      bool found = m_networkRouteTrie.Remove (key, prefix.GetPrefixLength (), *it);
+      NS_ASSERT (found);
+    }
+  else
+    {
+      m_nNonContiguousRoutes--;
+    }
+  delete it->first;
+  return m_networkRoutes.erase (it);
+}
+
 uint32_t Ipv6StaticRouting::GetNRoutes () const
 {
   return m_networkRoutes.size ();
@@ -490,8 +575,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          RemoveNetworkRoute (it);
           return;
         }
       tmp++;
@@ -509,8 +593,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
       if (network == rtentry->GetDest () && rtentry->GetInterface () == ifIndex
           && rtentry->GetPrefixToUse () == prefixToUse)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          RemoveNetworkRoute (it);
           return;
         }
     }
@@ -746,8 +829,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
 
           if (dst == entry && prefix == mask && rtentry->GetInterface () == interface)
             {
-              delete j->first;
-              j = m_networkRoutes.erase (j);
+              j = RemoveNetworkRoute (j);
             }
           else
             {
@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/lpm-trie.h"
 
 namespace ns3 {
 
@@ -258,6 +259,34 @@ private:
   typedef std::list<Ipv6MulticastRoutingTableEntry *>::const_iterator MulticastRoutesCI;
   typedef std::list<Ipv6MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  typedef LpmTrie<std::pair <Ipv6RoutingTableEntry *, uint32_t> > NetworkRouteTrie;
+
+  /**
+   * \brief Append a route to the forwarding table and index it by prefix.
+   * \param route the route
+   * \param metric metric of the route
+   */
+  void AddNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric);
+
+  /**
+   * \brief Remove a route from the forwarding table and from the prefix
+   * index, and delete it.
+   * \param it the route to remove
+   * \return the route following the removed route
+   */
+  NetworkRoutesI RemoveNetworkRoute (NetworkRoutesI it);
+
+  /**
+   * \brief Select the route to a destination among some routes: the
+   * longest prefix which matches, then the lowest metric, then the last
+   * route added.
+   * \param routes the routes to search
+   * \param dest destination address
+   * \param interface output interface if any (put 0 otherwise)
+   * \return the route selected, or 0 if none matches
+   */
+  Ipv6RoutingTableEntry* SelectNetworkRoute (NetworkRoutes const &routes, Ipv6Address dest, Ptr<NetDevice> interface);
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -288,6 +317,20 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the routes of the forwarding table for network, indexed by
+   * destination prefix.
+   *
+   * The routes with non-contiguous prefixes are not indexed: while there
+   * are some, the whole table is searched.
+   */
+  NetworkRouteTrie m_networkRouteTrie;
+
+  /**
+   * \brief the number of routes with non-contiguous prefixes.
+   */
+  uint32_t m_nNonContiguousRoutes;
+
   /**
    * \brief the forwarding table for multicast.
    */
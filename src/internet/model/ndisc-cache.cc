@@ -61,7 +61,11 @@ NdiscCache::~NdiscCache ()
 void NdiscCache::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  Flush ();
+  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+    {
+      delete (*i).second; /* delete the pointer NdiscCache::Entry */
+    }
+  m_ndCache.clear ();
   m_device = 0;
   m_interface = 0;
   Object::DoDispose ();
@@ -90,10 +94,10 @@ NdiscCache::Entry* NdiscCache::Lookup (Ipv6Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
 
-  if (m_ndCache.find (dst) != m_ndCache.end ())
+  CacheI it = m_ndCache.find (dst);
+  if (it != m_ndCache.end ())
     {
-      NdiscCache::Entry* entry = m_ndCache[dst];
-      return entry;
+      return it->second;
     }
   return 0;
 }
@@ -129,12 +133,16 @@ void NdiscCache::Flush ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); )
     {
+      if ((*i).second->IsPermanent ())
+        {
+          i++;
+          continue;
+        }
       delete (*i).second; /* delete the pointer NdiscCache::Entry */
+      m_ndCache.erase (i++);
     }
-
-  m_ndCache.erase (m_ndCache.begin (), m_ndCache.end ());
 }
 
 void NdiscCache::SetUnresQlen (uint32_t unresQlen)
@@ -475,6 +483,17 @@ void NdiscCache::Entry::MarkDelay ()
   m_state = DELAY;
 }
 
+void NdiscCache::Entry::MarkPermanent (Address mac)
+{
+  NS_LOG_FUNCTION (this << mac);
+  StopReachableTimer ();
+  StopRetransmitTimer ();
+  StopProbeTimer ();
+  StopDelayTimer ();
+  m_state = PERMANENT;
+  m_macAddress = mac;
+}
+
 bool NdiscCache::Entry::IsStale () const
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -505,6 +524,12 @@ bool NdiscCache::Entry::IsProbe () const
   return (m_state == PROBE);
 }
 
+bool NdiscCache::Entry::IsPermanent () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return (m_state == PERMANENT);
+}
+
 Address NdiscCache::Entry::GetMacAddress () const
 {
   NS_LOG_FUNCTION_NOARGS ();
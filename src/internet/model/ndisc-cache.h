@@ -101,7 +101,7 @@ public:
   void Remove (NdiscCache::Entry* entry);
 
   /**
-   * \brief Flush the cache.
+   * \brief Flush the cache of all entries but the permanent ones.
    */
   void Flush ();
 
@@ -177,6 +177,14 @@ public:
      */
     void MarkDelay ();
 
+    /**
+     * \brief Change the state to this entry to PERMANENT: the entry has
+     * no reachability timer, and is not updated by the Neighbor Discovery
+     * messages.
+     * \param mac L2 address
+     */
+    void MarkPermanent (Address mac);
+
     /**
      * \brief Add a packet (or replace old value) in the queue.
      * \param p packet to add
@@ -218,6 +226,12 @@ public:
      */
     bool IsProbe () const;
 
+    /**
+     * \brief Is the entry PERMANENT
+     * \return true if the entry is in PERMANENT state, false otherwise
+     */
+    bool IsPermanent () const;
+
     /**
      * \brief Get the MAC address of this entry.
      * \return the L2 address
@@ -352,7 +366,8 @@ private:
       REACHABLE, /**< Mapping exists between IPv6 and L2 addresses */
       STALE, /**< Mapping is stale */
       DELAY, /**< Try to wait contact from remote host */
-      PROBE /**< Try to contact IPv6 address to know again its L2 address */
+      PROBE, /**< Try to contact IPv6 address to know again its L2 address */
+      PERMANENT /**< Static mapping between IPv6 and L2 addresses */
     };
 
     /**
@@ -0,0 +1,454 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define NS_LOG_APPEND_CONTEXT \
+  if (m_node) { std::clog << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
+
+#include <cmath>
+#include "tcp-cubic.h"
+#include "ns3/log.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/simulator.h"
+#include "ns3/abort.h"
+#include "ns3/node.h"
+#include "ns3/double.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpCubic");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (TcpCubic);
+
+TypeId
+TcpCubic::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpCubic")
+    .SetParent<TcpSocketBase> ()
+    .AddConstructor<TcpCubic> ()
+    .AddAttribute ("ReTxThreshold", "Threshold for fast retransmit",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&TcpCubic::m_retxThresh),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("C", "Scaling constant of the cubic function, in segments per cubed second",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&TcpCubic::m_c),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Beta", "Multiplicative decrease factor of the window upon a congestion event",
+                   DoubleValue (0.7),
+                   MakeDoubleAccessor (&TcpCubic::m_beta),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("FastConvergence", "Lower the plateau of the window upon consecutive reductions",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_fastConvergence),
+                   MakeBooleanChecker ())
+    .AddAttribute ("HyStart", "End the slow start with HyStart",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_hystart),
+                   MakeBooleanChecker ())
+    .AddAttribute ("HyStartLowWindow", "Window below which HyStart is not used, in segments",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&TcpCubic::m_hystartLowWindow),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("HyStartMinSamples", "Number of RTT samples of a round to detect a delay increase",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&TcpCubic::m_hystartMinSamples),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("HyStartAckDelta", "Maximum spacing of the ACKs of a train",
+                   TimeValue (MilliSeconds (2)),
+                   MakeTimeAccessor (&TcpCubic::m_hystartAckDelta),
+                   MakeTimeChecker ())
+    .AddAttribute ("HyStartDelayMin", "Minimum RTT increase to end the slow start",
+                   TimeValue (MilliSeconds (4)),
+                   MakeTimeAccessor (&TcpCubic::m_hystartDelayMin),
+                   MakeTimeChecker ())
+    .AddAttribute ("HyStartDelayMax", "Maximum RTT increase to end the slow start",
+                   TimeValue (MilliSeconds (16)),
+                   MakeTimeAccessor (&TcpCubic::m_hystartDelayMax),
+                   MakeTimeChecker ())
+    .AddTraceSource ("CongestionWindow",
+                     "The TCP connection's congestion window",
+                     MakeTraceSourceAccessor (&TcpCubic::m_cWnd))
+  ;
+  return tid;
+}
+
+TcpCubic::TcpCubic (void)
+  : m_retxThresh (3), // mute valgrind, actual value set by the attribute system
+    m_inFastRec (false),
+    m_c (0.4),
+    m_beta (0.7),
+    m_fastConvergence (true),
+    m_wMax (0),
+    m_wLastMax (0),
+    m_k (0),
+    m_originPoint (0),
+    m_wEst (0),
+    m_cWndFraction (0),
+    m_hystart (true),
+    m_hystartLowWindow (16),
+    m_hystartMinSamples (8),
+    m_sampleCount (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpCubic::TcpCubic (const TcpCubic& sock)
+  : TcpSocketBase (sock),
+    m_cWnd (sock.m_cWnd),
+    m_ssThresh (sock.m_ssThresh),
+    m_initialCWnd (sock.m_initialCWnd),
+    m_retxThresh (sock.m_retxThresh),
+    m_inFastRec (false),
+    m_c (sock.m_c),
+    m_beta (sock.m_beta),
+    m_fastConvergence (sock.m_fastConvergence),
+    m_wMax (0),
+    m_wLastMax (0),
+    m_k (0),
+    m_originPoint (0),
+    m_wEst (0),
+    m_cWndFraction (0),
+    m_hystart (sock.m_hystart),
+    m_hystartLowWindow (sock.m_hystartLowWindow),
+    m_hystartMinSamples (sock.m_hystartMinSamples),
+    m_hystartAckDelta (sock.m_hystartAckDelta),
+    m_hystartDelayMin (sock.m_hystartDelayMin),
+    m_hystartDelayMax (sock.m_hystartDelayMax),
+    m_sampleCount (0)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Invoked the copy constructor");
+}
+
+TcpCubic::~TcpCubic (void)
+{
+}
+
+/** We initialize m_cWnd from this function, after attributes initialized */
+int
+TcpCubic::Listen (void)
+{
+  NS_LOG_FUNCTION (this);
+  InitializeCwnd ();
+  return TcpSocketBase::Listen ();
+}
+
+/** We initialize m_cWnd from this function, after attributes initialized */
+int
+TcpCubic::Connect (const Address & address)
+{
+  NS_LOG_FUNCTION (this << address);
+  InitializeCwnd ();
+  return TcpSocketBase::Connect (address);
+}
+
+/** Limit the size of in-flight data by cwnd and receiver's rxwin */
+uint32_t
+TcpCubic::Window (void)
+{
+  NS_LOG_FUNCTION (this);
+  return std::min (m_rWnd.Get (), m_cWnd.Get ());
+}
+
+Ptr<TcpSocketBase>
+TcpCubic::Fork (void)
+{
+  return CopyObject<TcpCubic> (this);
+}
+
+/** New ACK (up to seqnum seq) received. Increase cwnd and call TcpSocketBase::NewAck() */
+void
+TcpCubic::NewAck (const SequenceNumber32& seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  NS_LOG_LOGIC ("TcpCubic received ACK for seq " << seq <<
+                " cwnd " << m_cWnd <<
+                " ssthresh " << m_ssThresh);
+
+  uint32_t acked = seq - m_txBuffer.HeadSequence ();
+  if (m_lastRtt.Get ().IsStrictlyPositive () && (m_delayMin.IsZero () || m_lastRtt.Get () < m_delayMin))
+    {
+      m_delayMin = m_lastRtt.Get ();
+    }
+
+  // Fast recovery, as in TcpNewReno
+  if (m_inFastRec && seq < m_recover && m_sackPermitted)
+    { // Partial ACK with SACK: the window was not inflated, and the lost
+      // data is retransmitted as the pipe allows (RFC6675 sec.5)
+      TcpSocketBase::NewAck (seq);
+      return;
+    }
+  else if (m_inFastRec && seq < m_recover)
+    { // Partial ACK, partial window deflation (RFC2582 sec.3 bullet #5 paragraph 3)
+      m_cWnd -= acked;
+      m_cWnd += m_segmentSize;
+      NS_LOG_INFO ("Partial ACK in fast recovery: cwnd set to " << m_cWnd);
+      TcpSocketBase::NewAck (seq);
+      DoRetransmit ();
+      return;
+    }
+  else if (m_inFastRec && seq >= m_recover)
+    { // Full ACK (RFC2582 sec.3 bullet #5 paragraph 2, option 1)
+      m_cWnd = std::min (m_ssThresh, BytesInFlight () + m_segmentSize);
+      m_inFastRec = false;
+      NS_LOG_INFO ("Received full ACK. Leaving fast recovery with cwnd set to " << m_cWnd);
+    }
+
+  if (m_cWnd < m_ssThresh)
+    { // Slow start, counting the bytes acknowledged up to two segments (RFC3465, sec.2.2)
+      if (m_hystart)
+        {
+          HystartUpdate (seq);
+        }
+      m_cWnd += std::min (acked, 2 * m_segmentSize);
+      NS_LOG_INFO ("In SlowStart, updated to cwnd " << m_cWnd << " ssthresh " << m_ssThresh);
+    }
+  else
+    {
+      CubicUpdate (acked);
+      NS_LOG_INFO ("In CongAvoid, updated to cwnd " << m_cWnd << " ssthresh " << m_ssThresh);
+    }
+
+  // Complete newAck processing
+  TcpSocketBase::NewAck (seq);
+}
+
+/** Grow the window towards the cubic function one RTT ahead (RFC8312, sec.4.1 to 4.4) */
+void
+TcpCubic::CubicUpdate (uint32_t acked)
+{
+  NS_LOG_FUNCTION (this << acked);
+  double cWnd = m_cWnd.Get ();
+  double segment = m_segmentSize;
+  Time now = Simulator::Now ();
+  if (m_epochStart.IsZero ())
+    { // First ACK of the epoch
+      m_epochStart = now;
+      if (cWnd < m_wMax)
+        {
+          m_k = std::pow ((m_wMax - cWnd) / segment / m_c, 1.0 / 3);
+          m_originPoint = m_wMax;
+        }
+      else
+        {
+          m_k = 0;
+          m_originPoint = cWnd;
+        }
+      m_wEst = cWnd;
+      NS_LOG_LOGIC ("New epoch: K " << m_k << " s, origin point " << m_originPoint);
+    }
+
+  Time rtt = m_delayMin.IsZero () ? m_lastRtt.Get () : m_delayMin;
+  double t = (now - m_epochStart + rtt).GetSeconds () - m_k;
+  double target = m_originPoint + m_c * t * t * t * segment;
+
+  // The window of standard TCP grows by 3 (1 - beta) / (1 + beta) segments
+  // per RTT, that is, per cWnd bytes acknowledged (RFC8312, sec.4.2)
+  m_wEst += 3 * (1 - m_beta) / (1 + m_beta) * segment * acked / cWnd;
+  target = std::max (target, m_wEst);
+  target = std::min (std::max (target, cWnd), 1.5 * cWnd);
+
+  // Grow by (target - cWnd) / cWnd per byte acknowledged (RFC8312, sec.4.3)
+  m_cWndFraction += (target - cWnd) * acked / cWnd;
+  uint32_t increase = static_cast<uint32_t> (m_cWndFraction);
+  m_cWndFraction -= increase;
+  m_cWnd += increase;
+}
+
+/** Look for an ACK train or a delay increase in the round (HyStart) */
+void
+TcpCubic::HystartUpdate (SequenceNumber32 const& seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  Time now = Simulator::Now ();
+  if (seq > m_endSeq)
+    { // Start of a round: the data sent so far is acknowledged
+      m_endSeq = m_highTxMark;
+      m_roundStart = now;
+      m_lastAck = now;
+      m_currRoundMinRtt = Time::Max ();
+      m_sampleCount = 0;
+    }
+  if (m_cWnd < m_hystartLowWindow * m_segmentSize || m_delayMin.IsZero ())
+    {
+      return;
+    }
+
+  bool found = false;
+  if (now - m_lastAck <= m_hystartAckDelta)
+    { // The ACK train spans half the minimum RTT: the window fills the path
+      m_lastAck = now;
+      if ((now - m_roundStart).GetSeconds () > m_delayMin.GetSeconds () / 2)
+        {
+          NS_LOG_INFO ("HyStart: ACK train of " << (now - m_roundStart).GetSeconds () << " s");
+          found = true;
+        }
+    }
+  if (m_sampleCount < m_hystartMinSamples)
+    {
+      if (m_lastRtt.Get ().IsStrictlyPositive ())
+        {
+          m_currRoundMinRtt = std::min (m_currRoundMinRtt, m_lastRtt.Get ());
+          m_sampleCount++;
+        }
+    }
+  else
+    { // The queue builds up: the RTT of the round grew by an eighth of the minimum RTT
+      Time threshold = std::min (std::max (Seconds (m_delayMin.GetSeconds () / 8), m_hystartDelayMin),
+                                 m_hystartDelayMax);
+      if (m_currRoundMinRtt > m_delayMin + threshold)
+        {
+          NS_LOG_INFO ("HyStart: RTT increase to " << m_currRoundMinRtt.GetSeconds () << " s");
+          found = true;
+        }
+    }
+  if (found)
+    {
+      m_ssThresh = m_cWnd;
+      NS_LOG_INFO ("HyStart: leaving slow start with cwnd " << m_cWnd);
+    }
+}
+
+/** Record the window and reduce ssthresh upon a congestion event (RFC8312, sec.4.5 and 4.6) */
+void
+TcpCubic::ReduceWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  double cWnd = m_cWnd.Get ();
+  m_epochStart = Seconds (0);
+  m_cWndFraction = 0;
+  if (m_fastConvergence && cWnd < m_wLastMax)
+    { // Another flow took bandwidth: release some
+      m_wLastMax = cWnd;
+      m_wMax = cWnd * (1 + m_beta) / 2;
+    }
+  else
+    {
+      m_wLastMax = cWnd;
+      m_wMax = cWnd;
+    }
+  m_ssThresh = std::max (2 * m_segmentSize, static_cast<uint32_t> (cWnd * m_beta));
+}
+
+/** Cut cwnd and enter fast recovery mode upon triple dupack */
+void
+TcpCubic::DupAck (const TcpHeader& t, uint32_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+  if (count == m_retxThresh && !m_inFastRec && t.GetAckNumber () >= m_recover)
+    { // triple duplicate ack triggers fast retransmit, unless it is caused
+      // by the data sent again after a timeout (RFC6582 sec.3.2 step 1)
+      ReduceWindow ();
+      m_cWnd = m_ssThresh + 3 * m_segmentSize;
+      if (m_sackPermitted)
+        { // The pipe already discounts the SACKed data (RFC6675 sec.5)
+          m_cWnd = m_ssThresh;
+        }
+      m_recover = m_highTxMark;
+      m_inFastRec = true;
+      NS_LOG_INFO ("Triple dupack. Enter fast recovery mode. Reset cwnd to " << m_cWnd <<
+                   ", ssthresh to " << m_ssThresh << " at fast recovery seqnum " << m_recover);
+      DoRetransmit ();
+    }
+  else if (m_inFastRec)
+    { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
+      if (!m_sackPermitted)
+        {
+          m_cWnd += m_segmentSize;
+        }
+      NS_LOG_INFO ("Dupack in fast recovery mode. Increase cwnd to " << m_cWnd);
+      SendPendingData (m_connected);
+    }
+}
+
+bool
+TcpCubic::InFastRecovery (void) const
+{
+  return m_inFastRec;
+}
+
+/** Retransmit timeout */
+void
+TcpCubic::Retransmit (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC (this << " ReTxTimeout Expired at time " << Simulator::Now ().GetSeconds ());
+  m_inFastRec = false;
+
+  // If erroneous timeout in closed/timed-wait state, just return
+  if (m_state == CLOSED || m_state == TIME_WAIT) return;
+  // If all data are received (non-closing socket and nothing to send), just return
+  if (m_state <= ESTABLISHED && m_txBuffer.HeadSequence () >= m_highTxMark) return;
+
+  // Upon RTO, the window is reduced as upon any congestion event, then
+  // restarts from 1*MSS in slow start (RFC8312, sec.4.7). The path may
+  // have changed: HyStart measures the minimum RTT again.
+  ReduceWindow ();
+  m_cWnd = m_segmentSize;
+  m_delayMin = Seconds (0);
+  m_endSeq = m_highTxMark;
+  m_recover = m_highTxMark;
+  m_nextTxSequence = m_txBuffer.HeadSequence (); // Restart from highest Ack
+  NS_LOG_INFO ("RTO. Reset cwnd to " << m_cWnd <<
+               ", ssthresh to " << m_ssThresh << ", restart from seqnum " << m_nextTxSequence);
+  m_rtt->IncreaseMultiplier ();             // Double the next RTO
+  DoRetransmit ();                          // Retransmit the packet
+}
+
+void
+TcpCubic::SetSegSize (uint32_t size)
+{
+  NS_ABORT_MSG_UNLESS (m_state == CLOSED, "TcpCubic::SetSegSize() cannot change segment size after connection started.");
+  m_segmentSize = size;
+}
+
+void
+TcpCubic::SetSSThresh (uint32_t threshold)
+{
+  m_ssThresh = threshold;
+}
+
+uint32_t
+TcpCubic::GetSSThresh (void) const
+{
+  return m_ssThresh;
+}
+
+void
+TcpCubic::SetInitialCwnd (uint32_t cwnd)
+{
+  NS_ABORT_MSG_UNLESS (m_state == CLOSED, "TcpCubic::SetInitialCwnd() cannot change initial cwnd after connection started.");
+  m_initialCWnd = cwnd;
+}
+
+uint32_t
+TcpCubic::GetInitialCwnd (void) const
+{
+  return m_initialCWnd;
+}
+
+void
+TcpCubic::InitializeCwnd (void)
+{
+  /*
+   * Initialize congestion window, default to 1 MSS (RFC2001, sec.1) and must
+   * not be larger than 2 MSS (RFC2581, sec.3.1). Both m_initiaCWnd and
+   * m_segmentSize are set by the attribute system in ns3::TcpSocket.
+   */
+  m_cWnd = m_initialCWnd * m_segmentSize;
+}
+
+} // namespace ns3
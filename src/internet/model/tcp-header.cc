@@ -20,9 +20,11 @@
 
 #include <stdint.h>
 #include <iostream>
+#include <algorithm>
 #include "tcp-header.h"
 #include "ns3/buffer.h"
 #include "ns3/address-utils.h"
+#include "ns3/packet.h"
 
 namespace ns3 {
 
@@ -37,6 +39,9 @@ TcpHeader::TcpHeader ()
     m_flags (0),
     m_windowSize (0xffff),
     m_urgentPointer (0),
+    m_sackPermitted (false),
+    m_hasWindowScale (false),
+    m_windowScale (0),
     m_calcChecksum (false),
     m_goodChecksum (true)
 {
@@ -84,6 +89,25 @@ void TcpHeader::SetUrgentPointer (uint16_t urgentPointer)
 {
   m_urgentPointer = urgentPointer;
 }
+void TcpHeader::SetSackPermitted (bool permitted)
+{
+  m_sackPermitted = permitted;
+}
+void TcpHeader::SetWindowScale (uint8_t shift)
+{
+  NS_ASSERT (shift <= MAX_WINDOW_SCALE);
+  m_hasWindowScale = true;
+  m_windowScale = shift;
+}
+void TcpHeader::AddSackBlock (SackBlock const &block)
+{
+  NS_ASSERT (m_sackBlocks.size () < MAX_SACK_BLOCKS);
+  m_sackBlocks.push_back (block);
+}
+void TcpHeader::ClearSackBlocks (void)
+{
+  m_sackBlocks.clear ();
+}
 
 uint16_t TcpHeader::GetSourcePort () const
 {
@@ -103,7 +127,7 @@ SequenceNumber32 TcpHeader::GetAckNumber () const
 }
 uint8_t  TcpHeader::GetLength () const
 {
-  return m_length;
+  return GetSerializedSize () / 4;
 }
 uint8_t  TcpHeader::GetFlags () const
 {
@@ -117,6 +141,22 @@ uint16_t TcpHeader::GetUrgentPointer () const
 {
   return m_urgentPointer;
 }
+bool TcpHeader::IsSackPermitted (void) const
+{
+  return m_sackPermitted;
+}
+bool TcpHeader::HasWindowScale (void) const
+{
+  return m_hasWindowScale;
+}
+uint8_t TcpHeader::GetWindowScale (void) const
+{
+  return m_windowScale;
+}
+std::vector<TcpHeader::SackBlock> const &TcpHeader::GetSackBlocks (void) const
+{
+  return m_sackBlocks;
+}
 
 void 
 TcpHeader::InitializeChecksum (Ipv4Address source, 
@@ -252,10 +292,39 @@ void TcpHeader::Print (std::ostream &os)  const
       os<<"]";
     }
   os<<" Seq="<<m_sequenceNumber<<" Ack="<<m_ackNumber<<" Win="<<m_windowSize;
+  if (m_hasWindowScale)
+    {
+      os<<" WindowScale="<<static_cast<uint32_t> (m_windowScale);
+    }
+  if (m_sackPermitted)
+    {
+      os<<" SackPermitted";
+    }
+  for (std::vector<SackBlock>::const_iterator i = m_sackBlocks.begin (); i != m_sackBlocks.end (); ++i)
+    {
+      os<<" Sack="<<i->first<<"-"<<i->second;
+    }
+}
+uint32_t TcpHeader::GetOptionsSize (void) const
+{
+  uint32_t size = 0;
+  if (m_hasWindowScale)
+    {
+      size += 4; // NOP, kind, length, shift
+    }
+  if (m_sackPermitted)
+    {
+      size += 4; // NOP, NOP, kind, length
+    }
+  if (!m_sackBlocks.empty ())
+    {
+      size += 4 + 8 * m_sackBlocks.size (); // NOP, NOP, kind, length, blocks
+    }
+  return size;
 }
 uint32_t TcpHeader::GetSerializedSize (void)  const
 {
-  return 4*m_length;
+  return std::max<uint32_t> (4*m_length, 20 + GetOptionsSize ());
 }
 void TcpHeader::Serialize (Buffer::Iterator start)  const
 {
@@ -264,10 +333,41 @@ void TcpHeader::Serialize (Buffer::Iterator start)  const
   i.WriteHtonU16 (m_destinationPort);
   i.WriteHtonU32 (m_sequenceNumber.GetValue ());
   i.WriteHtonU32 (m_ackNumber.GetValue ());
-  i.WriteHtonU16 (m_length << 12 | m_flags); //reserved bits are all zero
+  i.WriteHtonU16 (GetLength () << 12 | m_flags); //reserved bits are all zero
   i.WriteHtonU16 (m_windowSize);
   i.WriteHtonU16 (0);
   i.WriteHtonU16 (m_urgentPointer);
+  if (m_hasWindowScale)
+    {
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_WINDOW_SCALE);
+      i.WriteU8 (3);
+      i.WriteU8 (m_windowScale);
+    }
+  if (m_sackPermitted)
+    {
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_SACK_PERMITTED);
+      i.WriteU8 (2);
+    }
+  if (!m_sackBlocks.empty ())
+    {
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_SACK);
+      i.WriteU8 (2 + 8 * m_sackBlocks.size ());
+      for (std::vector<SackBlock>::const_iterator j = m_sackBlocks.begin (); j != m_sackBlocks.end (); ++j)
+        {
+          i.WriteHtonU32 (j->first.GetValue ());
+          i.WriteHtonU32 (j->second.GetValue ());
+        }
+    }
+  // Pad the options up to the header length, END being zero
+  for (uint32_t n = 20 + GetOptionsSize (); n < GetSerializedSize (); ++n)
+    {
+      i.WriteU8 (OPTION_END);
+    }
 
   if(m_calcChecksum)
     {
@@ -294,6 +394,66 @@ uint32_t TcpHeader::Deserialize (Buffer::Iterator start)
   i.Next (2);
   m_urgentPointer = i.ReadNtohU16 ();
 
+  // Read the options, skipping the unknown ones
+  m_sackPermitted = false;
+  m_hasWindowScale = false;
+  m_windowScale = 0;
+  m_sackBlocks.clear ();
+  uint32_t optionsSize = m_length > 5 ? 4 * m_length - 20 : 0;
+  while (optionsSize > 0)
+    {
+      uint8_t kind = i.ReadU8 ();
+      optionsSize--;
+      if (kind == OPTION_END)
+        {
+          i.Next (optionsSize);
+          break;
+        }
+      if (kind == OPTION_NOP)
+        {
+          continue;
+        }
+      if (optionsSize == 0)
+        {
+          break; // Truncated option
+        }
+      uint8_t length = i.ReadU8 ();
+      optionsSize--;
+      if (length < 2 || length - 2u > optionsSize)
+        { // Malformed option: ignore the rest of the options
+          i.Next (optionsSize);
+          break;
+        }
+      uint32_t dataSize = length - 2;
+      if (kind == OPTION_WINDOW_SCALE && dataSize == 1)
+        { // A larger shift is taken as the largest one (RFC 7323, sec. 2.3)
+          uint8_t shift = i.ReadU8 ();
+          m_hasWindowScale = true;
+          m_windowScale = shift > MAX_WINDOW_SCALE ? MAX_WINDOW_SCALE : shift;
+        }
+      else if (kind == OPTION_SACK_PERMITTED && dataSize == 0)
+        {
+          m_sackPermitted = true;
+        }
+      else if (kind == OPTION_SACK && dataSize % 8 == 0)
+        {
+          for (uint32_t n = 0; n < dataSize / 8; ++n)
+            {
+              SequenceNumber32 left (i.ReadNtohU32 ());
+              SequenceNumber32 right (i.ReadNtohU32 ());
+              if (m_sackBlocks.size () < MAX_SACK_BLOCKS)
+                {
+                  m_sackBlocks.push_back (SackBlock (left, right));
+                }
+            }
+        }
+      else
+        {
+          i.Next (dataSize);
+        }
+      optionsSize -= dataSize;
+    }
+
   if(m_calcChecksum)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
@@ -302,7 +462,51 @@ uint32_t TcpHeader::Deserialize (Buffer::Iterator start)
       m_goodChecksum = (checksum == 0);
     }
 
-  return GetSerializedSize ();
+  return 4*m_length;
+}
+
+TcpHeaderView::TcpHeaderView (Ptr<const Packet> packet)
+  : m_data (packet->PeekContiguousData (20))
+{
+  if (m_data == 0 && packet->CopyData (m_storage, 20) == 20)
+    {
+      m_data = m_storage;
+    }
+}
+
+bool
+TcpHeaderView::IsValid (void) const
+{
+  return m_data != 0;
+}
+
+uint16_t
+TcpHeaderView::GetSourcePort (void) const
+{
+  NS_ASSERT (IsValid ());
+  return (m_data[0] << 8) | m_data[1];
+}
+
+uint16_t
+TcpHeaderView::GetDestinationPort (void) const
+{
+  NS_ASSERT (IsValid ());
+  return (m_data[2] << 8) | m_data[3];
+}
+
+SequenceNumber32
+TcpHeaderView::GetSequenceNumber (void) const
+{
+  NS_ASSERT (IsValid ());
+  return SequenceNumber32 ((static_cast<uint32_t> (m_data[4]) << 24) |
+                           (m_data[5] << 16) | (m_data[6] << 8) | m_data[7]);
+}
+
+uint8_t
+TcpHeaderView::GetFlags (void) const
+{
+  NS_ASSERT (IsValid ());
+  return m_data[13] & 0x3f;
 }
 
 
@@ -22,15 +22,19 @@
 #define TCP_HEADER_H
 
 #include <stdint.h>
+#include <vector>
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "ns3/tcp-socket-factory.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/sequence-number.h"
+#include "ns3/ptr.h"
 
 namespace ns3 {
 
+class Packet;
+
 /**
  * \ingroup tcp
  * \brief Header for the Transmission Control Protocol
@@ -38,6 +42,10 @@ namespace ns3 {
  * This class has fields corresponding to those in a network TCP header
  * (port numbers, sequence and acknowledgement numbers, flags, etc) as well
  * as methods for serialization to and deserialization from a byte buffer.
+ *
+ * The SACK-permitted and SACK options of RFC 2018 are supported; the
+ * other options are skipped on deserialization. The header length
+ * grows to hold the options set.
  */
 
 class TcpHeader : public Header 
@@ -85,6 +93,35 @@ public:
    * \param urgentPointer the urgent pointer for this TcpHeader
    */
   void SetUrgentPointer (uint16_t urgentPointer);
+  /**
+   * \param permitted whether this TcpHeader carries the SACK-permitted option
+   */
+  void SetSackPermitted (bool permitted);
+  /**
+   * Add the window scale option to this TcpHeader (RFC 7323, sec. 2).
+   *
+   * \param shift the number of bits the sender of this TcpHeader will shift
+   *        its receive window right, at most 14
+   */
+  void SetWindowScale (uint8_t shift);
+
+  /**
+   * A block of data acknowledged selectively, from its first sequence
+   * number to the one after its last one.
+   */
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /**
+   * Add a block to the SACK option of this TcpHeader. At most
+   * MAX_SACK_BLOCKS blocks are carried, the first block reporting the
+   * most recently received data (RFC 2018, sec. 4).
+   *
+   * \param block the block to add
+   */
+  void AddSackBlock (SackBlock const &block);
+  /**
+   * Remove the SACK option from this TcpHeader.
+   */
+  void ClearSackBlocks (void);
 
 
 //Getters
@@ -120,6 +157,24 @@ public:
    * \return the urgent pointer for this TcpHeader
    */
   uint16_t GetUrgentPointer () const;
+  /**
+   * \return true if this TcpHeader carries the SACK-permitted option
+   */
+  bool IsSackPermitted (void) const;
+  /**
+   * \return true if this TcpHeader carries the window scale option
+   */
+  bool HasWindowScale (void) const;
+  /**
+   * \return the shift of the window scale option of this TcpHeader, zero
+   *         if there is no window scale option
+   */
+  uint8_t GetWindowScale (void) const;
+  /**
+   * \return the blocks of the SACK option of this TcpHeader, empty if there
+   *         is no SACK option
+   */
+  std::vector<SackBlock> const &GetSackBlocks (void) const;
 
   /**
    * \param source the ip source to use in the underlying
@@ -145,6 +200,20 @@ public:
   typedef enum { NONE = 0, FIN = 1, SYN = 2, RST = 4, PSH = 8, ACK = 16, 
                  URG = 32, ECE = 64, CWR = 128} Flags_t;
 
+  /// Option kinds (RFC 793, RFC 7323, RFC 2018)
+  enum OptionKind
+  {
+    OPTION_END = 0,
+    OPTION_NOP = 1,
+    OPTION_WINDOW_SCALE = 3,
+    OPTION_SACK_PERMITTED = 4,
+    OPTION_SACK = 5
+  };
+  /// Maximum number of blocks of a SACK option, as limited by the 40 bytes of options
+  static const uint32_t MAX_SACK_BLOCKS = 4;
+  /// Maximum shift of the window scale option (RFC 7323, sec. 2.3)
+  static const uint8_t MAX_WINDOW_SCALE = 14;
+
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
   virtual void Print (std::ostream &os) const;
@@ -160,6 +229,10 @@ public:
 
 private:
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
+  /**
+   * \returns the size of the options set, padded to a multiple of 4 bytes
+   */
+  uint32_t GetOptionsSize (void) const;
   uint16_t m_sourcePort;
   uint16_t m_destinationPort;
   SequenceNumber32 m_sequenceNumber;
@@ -168,6 +241,10 @@ private:
   uint8_t m_flags;      // really a uint6_t
   uint16_t m_windowSize;
   uint16_t m_urgentPointer;
+  bool m_sackPermitted;
+  bool m_hasWindowScale;
+  uint8_t m_windowScale;
+  std::vector<SackBlock> m_sackBlocks;
 
   Address m_source;
   Address m_destination;
@@ -178,6 +255,49 @@ private:
   bool m_goodChecksum;
 };
 
+/**
+ * \ingroup tcp
+ * \brief Read-only view of the TCP header located at the start of a packet
+ *
+ * The fields are read directly from the bytes of the packet instead
+ * of deserializing a complete TcpHeader. A view must not outlive,
+ * nor be used after a modification of, the packet it was created from.
+ */
+class TcpHeaderView
+{
+public:
+  /**
+   * \param packet the packet which starts with a TCP header.
+   */
+  TcpHeaderView (Ptr<const Packet> packet);
+  /**
+   * \returns true if the packet is large enough to hold a TCP header.
+   */
+  bool IsValid (void) const;
+  /**
+   * \return The source port for this TcpHeader
+   */
+  uint16_t GetSourcePort (void) const;
+  /**
+   * \return the destination port for this TcpHeader
+   */
+  uint16_t GetDestinationPort (void) const;
+  /**
+   * \return the sequence number for this TcpHeader
+   */
+  SequenceNumber32 GetSequenceNumber (void) const;
+  /**
+   * \return the flags for this TcpHeader
+   */
+  uint8_t GetFlags (void) const;
+private:
+  TcpHeaderView (const TcpHeaderView &o);
+  TcpHeaderView &operator = (const TcpHeaderView &o);
+
+  const uint8_t *m_data;
+  uint8_t m_storage[20];
+};
+
 } // namespace ns3
 
 #endif /* TCP_HEADER */
@@ -122,7 +122,13 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
                 " ssthresh " << m_ssThresh);
 
   // Check for exit condition of fast recovery
-  if (m_inFastRec && seq < m_recover)
+  if (m_inFastRec && seq < m_recover && m_sackPermitted)
+    { // Partial ACK with SACK: the window was not inflated, and the lost
+      // data is retransmitted as the pipe allows (RFC6675 sec.5)
+      TcpSocketBase::NewAck (seq);
+      return;
+    }
+  else if (m_inFastRec && seq < m_recover)
     { // Partial ACK, partial window deflation (RFC2582 sec.3 bullet #5 paragraph 3)
       m_cWnd -= seq - m_txBuffer.HeadSequence ();
       m_cWnd += m_segmentSize;  // increase cwnd
@@ -166,6 +172,10 @@ TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
     { // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
       m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
       m_cWnd = m_ssThresh + 3 * m_segmentSize;
+      if (m_sackPermitted)
+        { // The pipe already discounts the SACKed data (RFC6675 sec.5)
+          m_cWnd = m_ssThresh;
+        }
       m_recover = m_highTxMark;
       m_inFastRec = true;
       NS_LOG_INFO ("Triple dupack. Enter fast recovery mode. Reset cwnd to " << m_cWnd <<
@@ -174,7 +184,10 @@ TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
     }
   else if (m_inFastRec)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
-      m_cWnd += m_segmentSize;
+      if (!m_sackPermitted)
+        {
+          m_cWnd += m_segmentSize;
+        }
       NS_LOG_INFO ("Dupack in fast recovery mode. Increase cwnd to " << m_cWnd);
       SendPendingData (m_connected);
     }
@@ -186,6 +199,12 @@ TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
     };
 }
 
+bool
+TcpNewReno::InFastRecovery (void) const
+{
+  return m_inFastRec;
+}
+
 /** Retransmit timeout */
 void
 TcpNewReno::Retransmit (void)
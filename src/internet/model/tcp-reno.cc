@@ -150,18 +150,31 @@ TcpReno::DupAck (const TcpHeader& t, uint32_t count)
     { // triple duplicate ack triggers fast retransmit (RFC2581, sec.3.2)
       m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
       m_cWnd = m_ssThresh + 3 * m_segmentSize;
+      if (m_sackPermitted)
+        { // The pipe already discounts the SACKed data (RFC6675 sec.5)
+          m_cWnd = m_ssThresh;
+        }
       m_inFastRec = true;
       NS_LOG_INFO ("Triple dupack. Reset cwnd to " << m_cWnd << ", ssthresh to " << m_ssThresh);
       DoRetransmit ();
     }
   else if (m_inFastRec)
     { // In fast recovery, inc cwnd for every additional dupack (RFC2581, sec.3.2)
-      m_cWnd += m_segmentSize;
+      if (!m_sackPermitted)
+        {
+          m_cWnd += m_segmentSize;
+        }
       NS_LOG_INFO ("Increased cwnd to " << m_cWnd);
       SendPendingData (m_connected);
     };
 }
 
+bool
+TcpReno::InFastRecovery (void) const
+{
+  return m_inFastRec;
+}
+
 // Retransmit timeout
 void TcpReno::Retransmit (void)
 {
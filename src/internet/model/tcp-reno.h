@@ -56,6 +56,7 @@ protected:
   virtual void NewAck (const SequenceNumber32& seq); // Inc cwnd and call NewAck() of parent
   virtual void DupAck (const TcpHeader& t, uint32_t count);  // Fast retransmit
   virtual void Retransmit (void); // Retransmit timeout
+  virtual bool InFastRecovery (void) const; // Return m_inFastRec
 
   // Implementing ns3::TcpSocket -- Attribute get/set
   virtual void     SetSegSize (uint32_t size);
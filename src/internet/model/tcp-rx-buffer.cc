@@ -152,61 +152,68 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end () && i->first <= tailSeq)
-    {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      if (lastByteSeq > headSeq)
-        {
-          if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
-              m_data.erase (i++);
-              continue;
-            }
-          if (i->first <= headSeq)
-            { // Incoming head is overlapped
-              headSeq = lastByteSeq;
-            }
-          if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-              tailSeq = i->first;
-            }
-        }
-      ++i;
-    }
-  // We now know how much we are going to store, trim the packet
   if (headSeq >= tailSeq)
     {
       NS_LOG_LOGIC ("Nothing to buffer");
       return false; // Nothing to buffer anyway
     }
-  else
+  // Find the first block that overlaps or touches the data
+  BlockIterator first = m_blocks.upper_bound (headSeq);
+  if (first != m_blocks.begin ())
     {
-      uint32_t start = headSeq - tcph.GetSequenceNumber ();
-      uint32_t length = tailSeq - headSeq;
-      p = p->CreateFragment (start, length);
-      NS_ASSERT (length == p->GetSize ());
+      BlockIterator previous = first;
+      --previous;
+      if (previous->second >= headSeq)
+        {
+          first = previous;
+        }
     }
-  // Insert packet into buffer
-  NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
-  m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  // Store the parts of the packet that fill the holes between the blocks
+  // it overlaps, and merge these blocks with it
+  SequenceNumber32 blockHead = headSeq;
+  SequenceNumber32 blockTail = tailSeq;
+  SequenceNumber32 seq = headSeq;
+  uint32_t stored = 0;
+  BlockIterator last = first;
+  for (; last != m_blocks.end () && last->first <= tailSeq; ++last)
     {
-      if (i->first < m_nextRxSeq)
+      if (seq < last->first)
+        {
+          stored += AddFragment (p, tcph.GetSequenceNumber (), seq, last->first);
+        }
+      if (last->first < blockHead)
+        {
+          blockHead = last->first;
+        }
+      if (last->second > blockTail)
         {
-          continue;
+          blockTail = last->second;
         }
-      else if (i->first > m_nextRxSeq)
+      if (last->second > seq)
         {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+          seq = last->second;
+        }
+    }
+  if (seq < tailSeq)
+    {
+      stored += AddFragment (p, tcph.GetSequenceNumber (), seq, tailSeq);
+    }
+  if (stored == 0)
+    {
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false; // The data was all there already
+    }
+  m_blocks.erase (first, last);
+  // Update variables
+  m_size += stored;      // Occupancy
+  if (blockHead == m_nextRxSeq)
+    { // The block is in sequence: it is available to the application
+      m_nextRxSeq = blockTail;
+      m_availBytes += blockTail - blockHead;
+    }
+  else
+    {
+      m_blocks[blockHead] = blockTail;
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -216,6 +223,42 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   return true;
 }
 
+uint32_t
+TcpRxBuffer::AddFragment (Ptr<Packet> p, SequenceNumber32 seq, SequenceNumber32 head, SequenceNumber32 tail)
+{
+  uint32_t length = tail - head;
+  NS_ASSERT (m_data.find (head) == m_data.end ()); // Shouldn't be there yet
+  m_data[head] = p->CreateFragment (head - seq, length);
+  NS_LOG_LOGIC ("Buffered packet of seqno=" << head << " len=" << length);
+  return length;
+}
+
+uint32_t
+TcpRxBuffer::GetNBlocks (void) const
+{
+  return m_blocks.size ();
+}
+
+std::vector<TcpRxBuffer::Block>
+TcpRxBuffer::GetBlocks (void) const
+{
+  return std::vector<Block> (m_blocks.begin (), m_blocks.end ());
+}
+
+std::vector<TcpRxBuffer::Block>
+TcpRxBuffer::GetHoles (void) const
+{
+  std::vector<Block> holes;
+  SequenceNumber32 seq = m_nextRxSeq;
+  for (std::map<SequenceNumber32, SequenceNumber32>::const_iterator i = m_blocks.begin ();
+       i != m_blocks.end (); ++i)
+    {
+      holes.push_back (Block (seq, i->first));
+      seq = i->second;
+    }
+  return holes;
+}
+
 Ptr<Packet>
 TcpRxBuffer::Extract (uint32_t maxSize)
 {
@@ -225,7 +268,7 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
-  Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
+  Ptr<Packet> outPkt; // The packet that contains all the data to return
   BufIterator i;
   while (extractSize)
     { // Check the buffered data for delivery
@@ -233,9 +276,9 @@ TcpRxBuffer::Extract (uint32_t maxSize)
       NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
       // Check if we send the whole pkt or just a partial
       uint32_t pktSize = i->second->GetSize ();
+      Ptr<Packet> fragment = i->second;
       if (pktSize <= extractSize)
         { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
           m_data.erase (i);
           m_size -= pktSize;
           m_availBytes -= pktSize;
@@ -243,13 +286,25 @@ TcpRxBuffer::Extract (uint32_t maxSize)
         }
       else
         { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
+          fragment = i->second->CreateFragment (0, extractSize);
           m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
           m_data.erase (i);
           m_size -= extractSize;
           m_availBytes -= extractSize;
           extractSize = 0;
         }
+      // The packets stored are fragments owned by the buffer: the first
+      // one is returned, without the tags of the lower layers, and the
+      // others appended to it
+      if (outPkt == 0)
+        {
+          outPkt = fragment;
+          outPkt->RemoveAllPacketTags ();
+        }
+      else
+        {
+          outPkt->AddAtEnd (fragment);
+        }
     }
   if (outPkt->GetSize () == 0)
     {
@@ -22,6 +22,7 @@
 #define TCP_RX_BUFFER_H
 
 #include <map>
+#include <vector>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
@@ -36,6 +37,12 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The data received out of order is tracked as a list of blocks, the
+ * maximal ranges of contiguous sequence numbers received beyond
+ * RCV.NXT. A packet is located among the blocks by a binary search, and
+ * only the parts of it that fill the holes between them are stored, as
+ * fragments referencing its buffer.
  */
 class TcpRxBuffer : public Object
 {
@@ -72,8 +79,43 @@ public:
    * The extracted data is going to be forwarded to the application.
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * A range of sequence numbers, from its first one to the one after
+   * its last one.
+   */
+  typedef std::pair<SequenceNumber32, SequenceNumber32> Block;
+
+  /**
+   * \returns the number of blocks of data received out of order
+   */
+  uint32_t GetNBlocks (void) const;
+
+  /**
+   * \returns the blocks of data received out of order, that is, beyond
+   *          RCV.NXT, in sequence order.
+   */
+  std::vector<Block> GetBlocks (void) const;
+
+  /**
+   * \returns the holes in the data received, from RCV.NXT to the start of
+   *          the last block received out of order, in sequence order.
+   */
+  std::vector<Block> GetHoles (void) const;
+private:
+  /**
+   * Store a part of a packet.
+   *
+   * \param p the packet
+   * \param seq the sequence number of the first byte of the packet
+   * \param head the sequence number of the first byte to store
+   * \param tail the sequence number after the last byte to store
+   * \returns the number of bytes stored
+   */
+  uint32_t AddFragment (Ptr<Packet> p, SequenceNumber32 seq, SequenceNumber32 head, SequenceNumber32 tail);
 public:
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  typedef std::map<SequenceNumber32, SequenceNumber32>::iterator BlockIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //< Seqnum of the FIN packet
   bool m_gotFin;                             //< Did I received FIN packet?
@@ -82,6 +124,8 @@ public:
   uint32_t m_availBytes;                     //< Number of bytes available to read, i.e. contiguous block at head
   std::map<SequenceNumber32, Ptr<Packet> > m_data;
   //< Corresponding data (may be null)
+  std::map<SequenceNumber32, SequenceNumber32> m_blocks;
+  //< Blocks of data received out of order, from their first sequence number to the one after their last one
 };
 
 } //namepsace ns3
@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "tcp-sack-scoreboard.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackScoreboard");
+
+namespace ns3 {
+
+TcpSackScoreboard::TcpSackScoreboard ()
+  : m_head (0),
+    m_sackedBytes (0),
+    m_lossBoundary (0),
+    m_dupThresh (3),
+    m_segmentSize (536)
+{
+}
+
+void
+TcpSackScoreboard::SetDupThresh (uint32_t dupThresh)
+{
+  m_dupThresh = dupThresh;
+}
+
+void
+TcpSackScoreboard::SetSegmentSize (uint32_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+void
+TcpSackScoreboard::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_blocks.clear ();
+  m_sackedBytes = 0;
+  m_lossBoundary = m_head;
+}
+
+uint32_t
+TcpSackScoreboard::Update (SequenceNumber32 head, SequenceNumber32 highData,
+                           std::vector<TcpHeader::SackBlock> const &blocks)
+{
+  NS_LOG_FUNCTION (this << head << highData << blocks.size ());
+  // Forget the data cumulatively acknowledged
+  if (head > m_head || m_blocks.empty ())
+    {
+      m_head = head;
+    }
+  while (!m_blocks.empty () && m_blocks.begin ()->first < m_head)
+    {
+      SequenceNumber32 first = m_blocks.begin ()->first;
+      SequenceNumber32 last = m_blocks.begin ()->second;
+      m_blocks.erase (m_blocks.begin ());
+      if (last > m_head)
+        {
+          m_sackedBytes -= m_head - first;
+          m_blocks[m_head] = last;
+          break;
+        }
+      m_sackedBytes -= last - first;
+    }
+  // Add the blocks, ignoring the parts outside of the data in flight
+  uint32_t added = 0;
+  for (std::vector<TcpHeader::SackBlock>::const_iterator i = blocks.begin (); i != blocks.end (); ++i)
+    {
+      SequenceNumber32 first = std::max (i->first, m_head);
+      SequenceNumber32 last = std::min (i->second, highData);
+      if (first < last)
+        {
+          added += AddBlock (first, last);
+        }
+    }
+  UpdateLossBoundary ();
+  return added;
+}
+
+uint32_t
+TcpSackScoreboard::AddBlock (SequenceNumber32 first, SequenceNumber32 last)
+{
+  // Find the first block that overlaps or touches the new one
+  Blocks::iterator begin = m_blocks.upper_bound (first);
+  if (begin != m_blocks.begin ())
+    {
+      Blocks::iterator previous = begin;
+      --previous;
+      if (previous->second >= first)
+        {
+          begin = previous;
+        }
+    }
+  // Merge the blocks with the new one
+  Blocks::iterator end = begin;
+  uint32_t overlapped = 0;
+  SequenceNumber32 mergedFirst = first;
+  SequenceNumber32 mergedLast = last;
+  for (; end != m_blocks.end () && end->first <= last; ++end)
+    {
+      overlapped += end->second - end->first;
+      mergedFirst = std::min (mergedFirst, end->first);
+      mergedLast = std::max (mergedLast, end->second);
+    }
+  m_blocks.erase (begin, end);
+  m_blocks[mergedFirst] = mergedLast;
+  uint32_t added = (mergedLast - mergedFirst) - overlapped;
+  m_sackedBytes += added;
+  return added;
+}
+
+void
+TcpSackScoreboard::UpdateLossBoundary (void)
+{
+  // Walk down the blocks until DupThresh of them, or more than
+  // (DupThresh - 1) segments of data, were SACKed: the holes below the
+  // last block met are lost
+  m_lossBoundary = m_head;
+  uint32_t nBlocks = 0;
+  uint32_t bytes = 0;
+  for (Blocks::reverse_iterator i = m_blocks.rbegin (); i != m_blocks.rend (); ++i)
+    {
+      nBlocks++;
+      bytes += i->second - i->first;
+      if (nBlocks >= m_dupThresh || bytes > (m_dupThresh - 1) * m_segmentSize)
+        {
+          m_lossBoundary = i->first;
+          break;
+        }
+    }
+  NS_LOG_LOGIC ("Sacked " << m_sackedBytes << " bytes in " << m_blocks.size ()
+                          << " blocks, lost below " << m_lossBoundary);
+}
+
+uint32_t
+TcpSackScoreboard::GetSackedBytes (void) const
+{
+  return m_sackedBytes;
+}
+
+uint32_t
+TcpSackScoreboard::GetNBlocks (void) const
+{
+  return m_blocks.size ();
+}
+
+bool
+TcpSackScoreboard::IsSacked (SequenceNumber32 seq) const
+{
+  Blocks::const_iterator i = m_blocks.upper_bound (seq);
+  if (i == m_blocks.begin ())
+    {
+      return false;
+    }
+  --i;
+  return seq < i->second;
+}
+
+bool
+TcpSackScoreboard::IsLost (SequenceNumber32 seq) const
+{
+  return seq >= m_head && seq < m_lossBoundary && !IsSacked (seq);
+}
+
+bool
+TcpSackScoreboard::GetNextLost (SequenceNumber32 seq, SequenceNumber32 &start, uint32_t &length) const
+{
+  seq = std::max (seq, m_head);
+  // Skip the block holding seq, if any
+  Blocks::const_iterator next = m_blocks.upper_bound (seq);
+  if (next != m_blocks.begin ())
+    {
+      Blocks::const_iterator previous = next;
+      --previous;
+      seq = std::max (seq, previous->second);
+    }
+  if (seq >= m_lossBoundary)
+    {
+      return false;
+    }
+  // The boundary is the start of a block, so there is one after seq
+  NS_ASSERT (next != m_blocks.end ());
+  start = seq;
+  length = next->first - seq;
+  return true;
+}
+
+SequenceNumber32
+TcpSackScoreboard::SkipSacked (SequenceNumber32 seq) const
+{
+  Blocks::const_iterator i = m_blocks.upper_bound (seq);
+  if (i != m_blocks.begin () && (--i)->second > seq)
+    {
+      return i->second;
+    }
+  return seq;
+}
+
+uint32_t
+TcpSackScoreboard::GetPipe (SequenceNumber32 head, SequenceNumber32 highData, SequenceNumber32 highRxt) const
+{
+  uint32_t pipe = highData - head;
+  // After a retransmission timeout, the data is sent again from the
+  // head: the blocks above highData are not part of the pipe
+  uint32_t sacked = m_sackedBytes;
+  for (Blocks::const_reverse_iterator i = m_blocks.rbegin (); i != m_blocks.rend () && i->second > highData; ++i)
+    {
+      sacked -= i->second - std::max (i->first, highData);
+    }
+  pipe -= std::min (pipe, sacked);
+  // Discount the lost data not retransmitted yet, the holes between
+  // HighRxt and the loss boundary
+  SequenceNumber32 seq = std::max (head, highRxt);
+  SequenceNumber32 boundary = std::min (m_lossBoundary, highData);
+  if (seq < boundary)
+    {
+      uint32_t lost = boundary - seq;
+      for (Blocks::const_iterator i = m_blocks.lower_bound (seq); i != m_blocks.end () && i->first < boundary; ++i)
+        {
+          lost -= std::min (i->second, boundary) - i->first;
+        }
+      // HighRxt may be inside a block
+      Blocks::const_iterator i = m_blocks.upper_bound (seq);
+      if (i != m_blocks.begin () && (--i)->first < seq && i->second > seq)
+        {
+          lost -= std::min (i->second, boundary) - seq;
+        }
+      pipe -= std::min (pipe, lost);
+    }
+  return pipe;
+}
+
+} // namespace ns3
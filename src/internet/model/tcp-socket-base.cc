@@ -39,6 +39,8 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -83,6 +85,32 @@ TcpSocketBase::GetTypeId (void)
                    CallbackValue (),
                    MakeCallbackAccessor (&TcpSocketBase::m_icmpCallback6),
                    MakeCallbackChecker ())                   
+    .AddAttribute ("LazyTimers",
+                   "Keep the events of the retransmission and delayed ACK timers pending when "
+                   "the timers are restarted or stopped, and reschedule them upon expiry if needed. "
+                   "The timeouts happen at the same times, but the events at the same timestamp "
+                   "may run in another order",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_lazyTimers),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SegmentOffload",
+                   "Maximum payload of the super-segments, each sent as one packet standing for "
+                   "several segments, or 0 to send one packet per segment",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpSocketBase::m_offloadSize),
+                   MakeUintegerChecker<uint32_t> (0, 65455))
+    .AddAttribute ("WindowScaling",
+                   "Enable the window scale option of RFC 7323, to advertise receive buffers "
+                   "larger than MaxWindowSize",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_winScalingEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Sack",
+                   "Enable the selective acknowledgements of RFC 2018 when the peer permits them, "
+                   "and the SACK-based loss recovery of RFC 6675",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RTO",
                      "Retransmission timeout",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_rto))
@@ -106,7 +134,10 @@ TcpSocketBase::GetTypeId (void)
 }
 
 TcpSocketBase::TcpSocketBase (void)
-  : m_dupAckCount (0),
+  : m_retxRunning (false),
+    m_retxFlags (0),
+    m_delAckRunning (false),
+    m_dupAckCount (0),
     m_delAckCount (0),
     m_endPoint (0),
     m_endPoint6 (0),
@@ -127,7 +158,14 @@ TcpSocketBase::TcpSocketBase (void)
     m_connected (false),
     m_segmentSize (0),
     // For attribute initialization consistency (quiet valgrind)
-    m_rWnd (0)
+    m_rWnd (0),
+    m_winScalingEnabled (false),
+    m_winScaling (false),
+    m_sndWindShift (0),
+    m_rcvWindShift (0),
+    m_sendDeferred (false),
+    m_sackEnabled (false),
+    m_sackPermitted (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -135,6 +173,10 @@ TcpSocketBase::TcpSocketBase (void)
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   : TcpSocket (sock),
     //copy object::m_tid and socket::callbacks
+    m_lazyTimers (sock.m_lazyTimers),
+    m_retxRunning (false),
+    m_retxFlags (0),
+    m_delAckRunning (false),
     m_dupAckCount (sock.m_dupAckCount),
     m_delAckCount (0),
     m_delAckMaxCount (sock.m_delAckMaxCount),
@@ -162,7 +204,18 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_msl (sock.m_msl),
     m_segmentSize (sock.m_segmentSize),
     m_maxWinSize (sock.m_maxWinSize),
-    m_rWnd (sock.m_rWnd)
+    m_rWnd (sock.m_rWnd),
+    m_winScalingEnabled (sock.m_winScalingEnabled),
+    m_winScaling (sock.m_winScaling),
+    m_sndWindShift (sock.m_sndWindShift),
+    m_rcvWindShift (sock.m_rcvWindShift),
+    m_offloadSize (sock.m_offloadSize),
+    m_sendDeferred (false),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_sackPermitted (sock.m_sackPermitted),
+    m_scoreboard (sock.m_scoreboard),
+    m_highRxt (sock.m_highRxt),
+    m_sackRxSeq (sock.m_sackRxSeq)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
@@ -871,7 +924,9 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port
       NS_LOG_LOGIC (this << " Leaving zerowindow persist state");
       m_persistEvent.Cancel ();
     }
-  m_rWnd = tcpHeader.GetWindowSize ();
+  // The window of a SYN is never scaled (RFC 7323, sec. 2.2)
+  m_rWnd = (tcpHeader.GetFlags () & TcpHeader::SYN) ? tcpHeader.GetWindowSize ()
+    : static_cast<uint32_t> (tcpHeader.GetWindowSize ()) << m_sndWindShift;
 
   // Discard fully out of range data packets
   if (packet->GetSize ()
@@ -966,7 +1021,9 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv6Header header, uint16_t port
       NS_LOG_LOGIC (this << " Leaving zerowindow persist state");
       m_persistEvent.Cancel ();
     }
-  m_rWnd = tcpHeader.GetWindowSize ();
+  // The window of a SYN is never scaled (RFC 7323, sec. 2.2)
+  m_rWnd = (tcpHeader.GetFlags () & TcpHeader::SYN) ? tcpHeader.GetWindowSize ()
+    : static_cast<uint32_t> (tcpHeader.GetWindowSize ()) << m_sndWindShift;
 
   // Discard fully out of range packets
   if (packet->GetSize ()
@@ -1087,6 +1144,21 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
+  // With segment offload, an empty packet may stand for several ACKs
+  uint32_t nAcks = 1;
+  SegmentOffloadTag offload;
+  if (packet->GetSize () == 0 && packet->PeekPacketTag (offload))
+    {
+      nAcks = offload.GetNPackets ();
+    }
+
+  // Record the data SACKed before the ACK is processed
+  if (m_sackPermitted && (tcpHeader.GetFlags () & TcpHeader::ACK)
+      && tcpHeader.GetAckNumber () >= m_txBuffer.HeadSequence ())
+    {
+      m_scoreboard.Update (tcpHeader.GetAckNumber (), m_highTxMark, tcpHeader.GetSackBlocks ());
+    }
+
   // Received ACK. Compare the ACK number against highest unacked seqno
   if (0 == (tcpHeader.GetFlags () & TcpHeader::ACK))
     { // Ignore if no ACK flag
@@ -1100,6 +1172,12 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       if (tcpHeader.GetAckNumber () < m_nextTxSequence && packet->GetSize() == 0)
         {
           NS_LOG_LOGIC ("Dupack of " << tcpHeader.GetAckNumber ());
+          for (uint32_t i = 1; i < nAcks; ++i)
+            { // Send data after the last duplicate ACK of a batch only
+              m_sendDeferred = true;
+              DupAck (tcpHeader, ++m_dupAckCount);
+            }
+          m_sendDeferred = false;
           DupAck (tcpHeader, ++m_dupAckCount);
         }
       // otherwise, the ACK is precisely equal to the nextTxSequence
@@ -1108,6 +1186,17 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
   else if (tcpHeader.GetAckNumber () > m_txBuffer.HeadSequence ())
     { // Case 3: New ACK, reset m_dupAckCount and update m_txBuffer
       NS_LOG_LOGIC ("New ack of " << tcpHeader.GetAckNumber ());
+      // Split a batch of ACKs evenly over the acknowledged data
+      SequenceNumber32 head = m_txBuffer.HeadSequence ();
+      uint32_t acked = tcpHeader.GetAckNumber () - head;
+      nAcks = std::min (nAcks, acked);
+      for (uint32_t i = 1; i < nAcks; ++i)
+        {
+          m_sendDeferred = true;
+          NewAck (head + SequenceNumber32 (acked / nAcks * i));
+          m_dupAckCount = 0;
+        }
+      m_sendDeferred = false;
       NewAck (tcpHeader.GetAckNumber ());
       m_dupAckCount = 0;
     }
@@ -1162,7 +1251,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      CancelReTx ();
       m_delAckCount = m_delAckMaxCount;
       ReceivedData (packet, tcpHeader);
       Simulator::ScheduleNow (&TcpSocketBase::ConnectionSucceeded, this);
@@ -1184,7 +1273,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      CancelReTx ();
       m_rxBuffer.SetNextRxSequence (tcpHeader.GetSequenceNumber () + SequenceNumber32 (1));
       m_highTxMark = ++m_nextTxSequence;
       m_txBuffer.SetHeadSequence (m_nextTxSequence);
@@ -1225,7 +1314,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       NS_LOG_INFO ("SYN_RCVD -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      CancelReTx ();
       m_highTxMark = ++m_nextTxSequence;
       m_txBuffer.SetHeadSequence (m_nextTxSequence);
       if (m_endPoint)
@@ -1259,7 +1348,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       if (tcpHeader.GetSequenceNumber () == m_rxBuffer.NextRxSequence ())
         { // In-sequence FIN before connection complete. Set up connection and close.
           m_connected = true;
-          m_retxEvent.Cancel ();
+          CancelReTx ();
           m_highTxMark = ++m_nextTxSequence;
           m_txBuffer.SetHeadSequence (m_nextTxSequence);
           if (m_endPoint)
@@ -1527,7 +1616,7 @@ TcpSocketBase::Destroy (void)
         }
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                GetReTxExpiry ().GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -1548,15 +1637,15 @@ TcpSocketBase::Destroy6 (void)
         }
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                GetReTxExpiry ().GetSeconds ());
   CancelAllTimers ();
 }
 
 /** Send an empty packet with specified TCP flags */
 void
-TcpSocketBase::SendEmptyPacket (uint8_t flags)
+TcpSocketBase::SendEmptyPacket (uint8_t flags, uint32_t nAcks)
 {
-  NS_LOG_FUNCTION (this << (uint32_t)flags);
+  NS_LOG_FUNCTION (this << (uint32_t)flags << nAcks);
   Ptr<Packet> p = Create<Packet> ();
   TcpHeader header;
   SequenceNumber32 s = m_nextTxSequence;
@@ -1624,6 +1713,14 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
     }
   header.SetWindowSize (AdvertisedWindowSize ());
   AddOptions (header);
+  if (m_sackPermitted && flags == TcpHeader::ACK)
+    {
+      AddSackBlocks (header);
+    }
+  if (nAcks > 1)
+    { // A batch of ACKs sent as one packet with segment offload
+      p->AddPacketTag (SegmentOffloadTag (nAcks, 0));
+    }
   m_rto = m_rtt->RetransmitTimeout ();
   bool hasSyn = flags & TcpHeader::SYN;
   bool hasFin = flags & TcpHeader::FIN;
@@ -1655,15 +1752,15 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
     }
   if (flags & TcpHeader::ACK)
     { // If sending an ACK, cancel the delay ACK as well
-      m_delAckEvent.Cancel ();
+      CancelDelAck ();
       m_delAckCount = 0;
     }
-  if (m_retxEvent.IsExpired () && (hasSyn || hasFin) && !isAck )
+  if (!IsReTxRunning () && (hasSyn || hasFin) && !isAck )
     { // Retransmit SYN / SYN+ACK / FIN / FIN+ACK to guard against lost
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      ScheduleReTx (m_rto, flags);
     }
 }
 
@@ -1866,6 +1963,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->AddPacketTag (ipHopLimitTag);
     }
 
+  if (sz > m_segmentSize)
+    { // A super-segment sent as one packet with segment offload
+      p->AddPacketTag (SegmentOffloadTag ((sz + m_segmentSize - 1) / m_segmentSize, sz));
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -1896,13 +1998,13 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
   header.SetWindowSize (AdvertisedWindowSize ());
   AddOptions (header);
-  if (m_retxEvent.IsExpired () )
+  if (!IsReTxRunning ())
     { // Schedule retransmit
       m_rto = m_rtt->RetransmitTimeout ();
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      ScheduleReTx (m_rto);
     }
   NS_LOG_LOGIC ("Send packet via TcpL4Protocol with flags 0x" << std::hex << static_cast<uint32_t> (flags) << std::dec);
   if (m_endPoint)
@@ -1943,7 +2045,34 @@ TcpSocketBase::SendPendingData (bool withAck)
       NS_LOG_INFO ("TcpSocketBase::SendPendingData: No endpoint; m_shutdownSend=" << m_shutdownSend);
       return false; // Is this the right way to handle this condition?
     }
+  if (m_sendDeferred)
+    {
+      return false; // Wait for the last ACK of the batch
+    }
   uint32_t nPacketsSent = 0;
+  if (m_sackPermitted)
+    {
+      if (InFastRecovery ())
+        { // Retransmit the lost data first, the rule (1) of NextSeg() in
+          // RFC 6675. Outside of the recovery, whose start reduces the
+          // window, the lost data waits for the dupacks or the timeout.
+          SequenceNumber32 seq;
+          uint32_t length;
+          while (m_scoreboard.GetNextLost (std::max (m_highRxt, m_txBuffer.HeadSequence ()), seq, length)
+                 && AvailableWindow () >= m_segmentSize)
+            {
+              NS_LOG_LOGIC ("TcpSocketBase " << this << " retxing lost seq " << seq);
+              uint32_t sz = SendDataPacket (seq, std::min (length, m_segmentSize), withAck);
+              m_highRxt = seq + SequenceNumber32 (sz);
+              nPacketsSent++;
+            }
+        }
+      if (m_nextTxSequence < m_highRxt)
+        { // After a timeout, the holes below HighRxt were sent again already
+          m_nextTxSequence = m_highRxt;
+        }
+      m_nextTxSequence = m_scoreboard.SkipSacked (m_nextTxSequence);
+    }
   while (m_txBuffer.SizeFromSequence (m_nextTxSequence))
     {
       uint32_t w = AvailableWindow (); // Get available window size
@@ -1969,9 +2098,20 @@ TcpSocketBase::SendPendingData (bool withAck)
           break;
         }
       uint32_t s = std::min (w, m_segmentSize);  // Send no more than window
+      if (m_offloadSize > m_segmentSize && w >= 2 * m_segmentSize)
+        { // Segment offload: send as many whole segments as allowed in one super-segment
+          s = std::min (std::min (w, m_offloadSize), std::max (m_segmentSize, Window () / 2)) / m_segmentSize * m_segmentSize;
+        }
+      bool resent = m_nextTxSequence < m_highTxMark;
       uint32_t sz = SendDataPacket (m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_nextTxSequence += sz;                     // Advance next tx sequence
+      if (m_sackPermitted && resent)
+        { // Sent again after a timeout: no longer counted as lost in the
+          // pipe, and the data the receiver holds is not sent again
+          m_highRxt = std::max (m_highRxt, m_nextTxSequence.Get ());
+          m_nextTxSequence = m_scoreboard.SkipSacked (m_nextTxSequence);
+        }
     }
   NS_LOG_LOGIC ("SendPendingData sent " << nPacketsSent << " packets");
   return (nPacketsSent > 0);
@@ -2003,6 +2143,10 @@ TcpSocketBase::AvailableWindow ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   uint32_t unack = UnAckDataCount (); // Number of outstanding bytes
+  if (m_sackPermitted)
+    { // Neither the SACKed data nor the lost data is in the network
+      unack = m_scoreboard.GetPipe (m_txBuffer.HeadSequence (), std::max (m_nextTxSequence.Get (), m_highRxt), m_highRxt);
+    }
   uint32_t win = Window (); // Number of bytes allowed to be outstanding
   NS_LOG_LOGIC ("UnAckCount=" << unack << ", Win=" << win);
   return (win < unack) ? 0 : (win - unack);
@@ -2011,7 +2155,8 @@ TcpSocketBase::AvailableWindow ()
 uint16_t
 TcpSocketBase::AdvertisedWindowSize ()
 {
-  return std::min (m_rxBuffer.MaxBufferSize () - m_rxBuffer.Size (), (uint32_t)m_maxWinSize);
+  uint32_t w = (m_rxBuffer.MaxBufferSize () - m_rxBuffer.Size ()) >> m_rcvWindShift;
+  return std::min (w, (uint32_t)m_maxWinSize);
 }
 
 // Receipt of new packet, put into Rx buffer
@@ -2023,6 +2168,14 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
                 " ack " << tcpHeader.GetAckNumber () <<
                 " pkt size " << p->GetSize () );
 
+  // A super-segment counts as the segments it stands for
+  uint32_t nSegments = 1;
+  SegmentOffloadTag offload;
+  if (p->RemovePacketTag (offload))
+    {
+      nSegments = offload.GetNPackets ();
+    }
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer.NextRxSequence ();
   if (!m_rxBuffer.Add (p, tcpHeader))
@@ -2030,24 +2183,34 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
       SendEmptyPacket (TcpHeader::ACK);
       return;
     }
+  if (tcpHeader.GetSequenceNumber () > m_rxBuffer.NextRxSequence ())
+    { // Out of order: the first SACK block reports this segment
+      m_sackRxSeq = tcpHeader.GetSequenceNumber ();
+    }
   // Now send a new ACK packet acknowledging all received and delivered data
   if (m_rxBuffer.Size () > m_rxBuffer.Available () || m_rxBuffer.NextRxSequence () > expectedSeq + p->GetSize ())
-    { // A gap exists in the buffer, or we filled a gap: Always ACK
-      SendEmptyPacket (TcpHeader::ACK);
+    { // A gap exists in the buffer, or we filled a gap: Always ACK, with a
+      // duplicate ACK for every segment received out of order
+      SendEmptyPacket (TcpHeader::ACK, m_rxBuffer.NextRxSequence () == expectedSeq ? nSegments : 1);
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      m_delAckCount += nSegments;
+      if (m_delAckCount >= m_delAckMaxCount)
         {
-          m_delAckEvent.Cancel ();
+          uint32_t nAcks = 1;
+          if (nSegments > 1)
+            { // The ACKs that the segments of the super-segment would have caused
+              nAcks = m_delAckMaxCount > 1 ? (m_delAckCount + m_delAckMaxCount - 1) / m_delAckMaxCount : nSegments;
+            }
+          CancelDelAck ();
           m_delAckCount = 0;
-          SendEmptyPacket (TcpHeader::ACK);
+          SendEmptyPacket (TcpHeader::ACK, nAcks);
         }
-      else if (m_delAckEvent.IsExpired ())
+      else if (!IsDelAckRunning ())
         {
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
-          NS_LOG_LOGIC (this << " scheduled delayed ACK at " << (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+          ScheduleDelAck (m_delAckTimeout);
+          NS_LOG_LOGIC (this << " scheduled delayed ACK at " << GetDelAckExpiry ().GetSeconds ());
         }
     }
   // Notify app to receive if necessary
@@ -2101,21 +2264,21 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   if (m_state != SYN_RCVD)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    GetReTxExpiry ().GetSeconds ());
+      CancelReTx ();
       // On recieving a "New" ack we restart retransmission timer .. RFC 2988
       m_rto = m_rtt->RetransmitTimeout ();
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      ScheduleReTx (m_rto);
     }
   if (m_rWnd.Get () == 0 && m_persistEvent.IsExpired ())
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << "Enter zerowindow persist state");
       NS_LOG_LOGIC (this << "Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    GetReTxExpiry ().GetSeconds ());
+      CancelReTx ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
@@ -2137,8 +2300,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   if (m_txBuffer.Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    GetReTxExpiry ().GetSeconds ());
+      CancelReTx ();
     }
   // Try to send more data
   SendPendingData (m_connected);
@@ -2160,6 +2323,9 @@ TcpSocketBase::ReTxTimeout ()
     {
       return;
     }
+  // The receiver may have discarded the data it SACKed (RFC 2018, sec. 8)
+  m_scoreboard.Clear ();
+  m_highRxt = m_txBuffer.HeadSequence ();
 
   Retransmit ();
 }
@@ -2228,6 +2394,12 @@ TcpSocketBase::PersistTimeout ()
   m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
 }
 
+bool
+TcpSocketBase::InFastRecovery (void) const
+{
+  return false;
+}
+
 void
 TcpSocketBase::Retransmit ()
 {
@@ -2268,19 +2440,150 @@ TcpSocketBase::DoRetransmit ()
   uint32_t sz = SendDataPacket (m_txBuffer.HeadSequence (), m_segmentSize, true);
   // In case of RTO, advance m_nextTxSequence
   m_nextTxSequence = std::max (m_nextTxSequence.Get (), m_txBuffer.HeadSequence () + sz);
+  m_highRxt = std::max (m_highRxt, m_txBuffer.HeadSequence () + SequenceNumber32 (sz));
 
 }
 
 void
 TcpSocketBase::CancelAllTimers ()
 {
+  m_retxRunning = false;
   m_retxEvent.Cancel ();
   m_persistEvent.Cancel ();
+  m_delAckRunning = false;
   m_delAckEvent.Cancel ();
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
 }
 
+/*
+ * The retransmission timer is restarted upon every new ACK, and the
+ * delayed ACK timer is stopped by most of the ACKs sent. With LazyTimers,
+ * m_retxEvent and m_delAckEvent stay scheduled at or before the
+ * deadline of their timer: restarting a timer later only moves its
+ * deadline, and stopping it only marks it stopped. When the event
+ * expires, it is scheduled again at the deadline if the deadline has
+ * moved, and it does nothing if the timer has been stopped. The timeouts
+ * thus happen at the same times as with the timers cancelled and
+ * rescheduled every time, with far fewer events inserted in and removed
+ * from the scheduler. Only the order of the events at the same timestamp
+ * may differ: an event scheduled again at the deadline gets a later uid
+ * than the events scheduled for that time in the meantime.
+ */
+void
+TcpSocketBase::ScheduleReTx (Time delay, uint8_t flags)
+{
+  m_retxRunning = true;
+  m_retxDeadline = Simulator::Now () + delay;
+  m_retxFlags = flags;
+  if (m_lazyTimers && !m_retxEvent.IsExpired ()
+      && TimeStep (m_retxEvent.GetTs ()) <= m_retxDeadline)
+    { // The pending event expires first and reschedules itself
+      return;
+    }
+  m_retxEvent.Cancel ();
+  m_retxEvent = Simulator::Schedule (delay, &TcpSocketBase::ReTxExpired, this);
+}
+
+void
+TcpSocketBase::CancelReTx (void)
+{
+  m_retxRunning = false;
+  if (!m_lazyTimers)
+    {
+      m_retxEvent.Cancel ();
+    }
+}
+
+bool
+TcpSocketBase::IsReTxRunning (void) const
+{
+  return m_retxRunning;
+}
+
+Time
+TcpSocketBase::GetReTxExpiry (void) const
+{
+  return m_retxRunning ? m_retxDeadline : Simulator::Now ();
+}
+
+void
+TcpSocketBase::ReTxExpired (void)
+{
+  if (!m_retxRunning)
+    {
+      return;
+    }
+  if (Simulator::Now () < m_retxDeadline)
+    {
+      m_retxEvent = Simulator::Schedule (m_retxDeadline - Simulator::Now (),
+                                         &TcpSocketBase::ReTxExpired, this);
+      return;
+    }
+  m_retxRunning = false;
+  if (m_retxFlags != 0)
+    {
+      SendEmptyPacket (m_retxFlags);
+    }
+  else
+    {
+      ReTxTimeout ();
+    }
+}
+
+void
+TcpSocketBase::ScheduleDelAck (Time delay)
+{
+  m_delAckRunning = true;
+  m_delAckDeadline = Simulator::Now () + delay;
+  if (m_lazyTimers && !m_delAckEvent.IsExpired ()
+      && TimeStep (m_delAckEvent.GetTs ()) <= m_delAckDeadline)
+    {
+      return;
+    }
+  m_delAckEvent.Cancel ();
+  m_delAckEvent = Simulator::Schedule (delay, &TcpSocketBase::DelAckExpired, this);
+}
+
+void
+TcpSocketBase::CancelDelAck (void)
+{
+  m_delAckRunning = false;
+  if (!m_lazyTimers)
+    {
+      m_delAckEvent.Cancel ();
+    }
+}
+
+bool
+TcpSocketBase::IsDelAckRunning (void) const
+{
+  return m_delAckRunning;
+}
+
+Time
+TcpSocketBase::GetDelAckExpiry (void) const
+{
+  return m_delAckRunning ? m_delAckDeadline : Simulator::Now ();
+}
+
+void
+TcpSocketBase::DelAckExpired (void)
+{
+  if (!m_delAckRunning)
+    {
+      return;
+    }
+  if (Simulator::Now () < m_delAckDeadline)
+    {
+      m_delAckEvent = Simulator::Schedule (m_delAckDeadline - Simulator::Now (),
+                                           &TcpSocketBase::DelAckExpired, this);
+      return;
+    }
+  m_delAckRunning = false;
+  DelAckTimeout ();
+}
+
 /** Move TCP to Time_Wait state and schedule a transition to Closed state */
 void
 TcpSocketBase::TimeWait ()
@@ -2418,16 +2721,80 @@ TcpSocketBase::GetAllowBroadcast (void) const
   return false;
 }
 
-/** Placeholder function for future extension that reads more from the TCP header */
+/** Read the options of the TCP header: SACK is negotiated in the SYN segments */
+void
+TcpSocketBase::ReadOptions (const TcpHeader& header)
+{
+  if (header.GetFlags () & TcpHeader::SYN)
+    { // Both windows are scaled, or none (RFC 7323, sec. 2.2)
+      m_winScaling = m_winScalingEnabled && header.HasWindowScale ();
+      m_sndWindShift = m_winScaling ? header.GetWindowScale () : 0;
+      m_rcvWindShift = m_winScaling ? CalculateWindowScale () : 0;
+      NS_LOG_LOGIC (this << " Window shifts " << static_cast<uint32_t> (m_sndWindShift) <<
+                    " sent, " << static_cast<uint32_t> (m_rcvWindShift) << " received");
+      m_sackPermitted = m_sackEnabled && header.IsSackPermitted ();
+      m_scoreboard.SetSegmentSize (m_segmentSize);
+      NS_LOG_LOGIC (this << " SACK " << (m_sackPermitted ? "permitted" : "not permitted"));
+    }
+}
+
+/** Add the options to the TCP header: window scaling and SACK are offered
+    in a SYN, and accepted in a SYN+ACK */
 void
-TcpSocketBase::ReadOptions (const TcpHeader&)
+TcpSocketBase::AddOptions (TcpHeader& header)
+{
+  if (header.GetFlags () & TcpHeader::SYN)
+    {
+      bool synAck = header.GetFlags () & TcpHeader::ACK;
+      if (synAck ? m_winScaling : m_winScalingEnabled)
+        {
+          header.SetWindowScale (CalculateWindowScale ());
+          // The window of a SYN is never scaled (RFC 7323, sec. 2.2)
+          header.SetWindowSize (std::min (m_rxBuffer.MaxBufferSize () - m_rxBuffer.Size (), (uint32_t)m_maxWinSize));
+        }
+      header.SetSackPermitted (synAck ? m_sackPermitted : m_sackEnabled);
+    }
+}
+
+/** The smallest shift for the whole Rx buffer to fit in the advertised window */
+uint8_t
+TcpSocketBase::CalculateWindowScale (void) const
 {
+  uint8_t shift = 0;
+  while (shift < TcpHeader::MAX_WINDOW_SCALE && (m_rxBuffer.MaxBufferSize () >> shift) > m_maxWinSize)
+    {
+      shift++;
+    }
+  return shift;
 }
 
-/** Placeholder function for future extension that changes the TCP header */
+/** Report the blocks received out of order, the first one holding the
+    last segment received out of order (RFC 2018, sec. 4). The SACK option
+    is carried by the pure ACKs only, so as not to grow the data segments
+    beyond the MTU. */
 void
-TcpSocketBase::AddOptions (TcpHeader&)
+TcpSocketBase::AddSackBlocks (TcpHeader& header)
 {
+  std::vector<TcpRxBuffer::Block> blocks = m_rxBuffer.GetBlocks ();
+  std::vector<TcpRxBuffer::Block>::reverse_iterator first = blocks.rend ();
+  for (std::vector<TcpRxBuffer::Block>::reverse_iterator i = blocks.rbegin (); i != blocks.rend (); ++i)
+    {
+      if (i->first <= m_sackRxSeq && m_sackRxSeq < i->second)
+        {
+          first = i;
+          header.AddSackBlock (*i);
+          break;
+        }
+    }
+  // The other blocks from the highest one
+  for (std::vector<TcpRxBuffer::Block>::reverse_iterator i = blocks.rbegin ();
+       i != blocks.rend () && header.GetSackBlocks ().size () < TcpHeader::MAX_SACK_BLOCKS; ++i)
+    {
+      if (i != first)
+        {
+          header.AddSackBlock (*i);
+        }
+    }
 }
 
 } // namespace ns3
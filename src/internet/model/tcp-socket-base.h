@@ -34,6 +34,7 @@
 #include "ns3/event-id.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
+#include "tcp-sack-scoreboard.h"
 #include "rtt-estimator.h"
 
 namespace ns3 {
@@ -143,9 +144,10 @@ protected:
   void ForwardIcmp6 (Ipv6Address icmpSource, uint8_t icmpTtl, uint8_t icmpType, uint8_t icmpCode, uint32_t icmpInfo);  
   bool SendPendingData (bool withAck = false); // Send as much as the window allows
   uint32_t SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool withAck); // Send a data packet
-  void SendEmptyPacket (uint8_t flags); // Send a empty packet that carries a flag, e.g. ACK
+  void SendEmptyPacket (uint8_t flags, uint32_t nAcks = 1); // Send a empty packet that carries a flag, e.g. ACK, or a batch of nAcks ACKs
   void SendRST (void); // Send reset and tear down this socket
   bool OutOfRange (SequenceNumber32 head, SequenceNumber32 tail) const; // Check if a sequence number range is within the rx window
+  void AddSackBlocks (TcpHeader& header); // Report the blocks received out of order in the SACK option of an ACK
 
   // Helper functions: Connection close
   int DoClose (void); // Close a socket by sending RST, FIN, or FIN+ACK, depend on the current state
@@ -158,6 +160,20 @@ protected:
   void CancelAllTimers (void); // Cancel all timer when endpoint is deleted
   void TimeWait (void);  // Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
 
+  // Timers: with LazyTimers, a cancelled or postponed timer keeps its
+  // event pending, and the event is scheduled again upon expiry if the
+  // deadline has moved in the meantime.
+  void ScheduleReTx (Time delay, uint8_t flags = 0); // Start the retransmission timer: ReTxTimeout(), or SendEmptyPacket(flags) if flags != 0
+  void CancelReTx (void); // Stop the retransmission timer
+  bool IsReTxRunning (void) const; // Is the retransmission timer running
+  Time GetReTxExpiry (void) const; // Expiration time of the retransmission timer
+  void ReTxExpired (void); // Lazy retransmission timer event
+  void ScheduleDelAck (Time delay); // Start the delayed ACK timer
+  void CancelDelAck (void); // Stop the delayed ACK timer
+  bool IsDelAckRunning (void) const; // Is the delayed ACK timer running
+  Time GetDelAckExpiry (void) const; // Expiration time of the delayed ACK timer
+  void DelAckExpired (void); // Lazy delayed ACK timer event
+
   // State transition functions
   void ProcessEstablished (Ptr<Packet>, const TcpHeader&); // Received a packet upon ESTABLISHED state
   void ProcessListen (Ptr<Packet>, const TcpHeader&, const Address&, const Address&); // Process the newly received ACK
@@ -187,8 +203,10 @@ protected:
   virtual void LastAckTimeout (void); // Timeout at LAST_ACK, close the connection
   virtual void PersistTimeout (void); // Send 1 byte probe to get an updated window size
   virtual void DoRetransmit (void); // Retransmit the oldest packet
+  virtual bool InFastRecovery (void) const; // In the loss recovery started by the dupacks
   virtual void ReadOptions (const TcpHeader&); // Read option from incoming packets
   virtual void AddOptions (TcpHeader&); // Add option to outgoing packets
+  uint8_t CalculateWindowScale (void) const; // Shift to advertise the whole Rx buffer
 
 protected:
   // Counters and events
@@ -197,6 +215,12 @@ protected:
   EventId           m_delAckEvent;     //< Delayed ACK timeout event
   EventId           m_persistEvent;    //< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent;   //< TIME_WAIT expiration event: Move this socket to CLOSED state
+  bool              m_lazyTimers;      //< Postpone and cancel the retransmission and delayed ACK timers without rescheduling their events
+  bool              m_retxRunning;     //< Lazy retransmission timer running
+  Time              m_retxDeadline;    //< Lazy retransmission timer expiration time
+  uint8_t           m_retxFlags;       //< Flags of the empty packet to retransmit, zero to call ReTxTimeout()
+  bool              m_delAckRunning;   //< Lazy delayed ACK timer running
+  Time              m_delAckDeadline;  //< Lazy delayed ACK timer expiration time
   uint32_t          m_dupAckCount;     //< Dupack counter
   uint32_t          m_delAckCount;     //< Delayed ACK counter
   uint32_t          m_delAckMaxCount;  //< Number of packet to fire an ACK before delay timeout
@@ -240,6 +264,23 @@ protected:
   uint32_t              m_segmentSize; //< Segment size
   uint16_t              m_maxWinSize;  //< Maximum window size to advertise
   TracedValue<uint32_t> m_rWnd;        //< Flow control window at remote side
+  bool                  m_winScalingEnabled; //< Offer and accept the window scale option
+  bool                  m_winScaling;        //< Window scaling negotiated on this connection
+  uint8_t               m_sndWindShift;      //< Shift of the windows received from the peer
+  uint8_t               m_rcvWindShift;      //< Shift of the windows advertised to the peer
+
+  // Segment offload
+  uint32_t              m_offloadSize;  //< Maximum payload of the super-segments, zero to send one packet per segment
+  bool                  m_sendDeferred; //< Hold off sending data until the last ACK of a batch is processed
+
+  // Selective acknowledgements: with SACK permitted, the window is filled
+  // against the pipe of RFC 6675, and the lost data is retransmitted
+  // before any new data
+  bool                  m_sackEnabled;   //< Offer and accept the SACK-permitted option
+  bool                  m_sackPermitted; //< SACK negotiated on this connection
+  TcpSackScoreboard     m_scoreboard;    //< Data SACKed by the peer
+  SequenceNumber32      m_highRxt;       //< Sequence number after the highest one retransmitted (HighRxt)
+  SequenceNumber32      m_sackRxSeq;     //< Sequence number of the last segment received out of order
 };
 
 } // namespace ns3
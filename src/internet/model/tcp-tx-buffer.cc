@@ -53,7 +53,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0)
 {
 }
 
@@ -61,6 +61,17 @@ TcpTxBuffer::~TcpTxBuffer (void)
 {
 }
 
+TcpTxBuffer::Fragment::Fragment (uint64_t offset, Ptr<Packet> packet)
+  : offset (offset), packet (packet)
+{
+}
+
+bool
+TcpTxBuffer::StartsAfter (uint64_t offset, Fragment const &fragment)
+{
+  return offset < fragment.offset;
+}
+
 SequenceNumber32
 TcpTxBuffer::HeadSequence (void) const
 {
@@ -107,7 +118,7 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          m_data.push_back (Fragment (m_headOffset + m_size, p));
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -143,56 +154,38 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
       return Create<Packet> (s);
     }
 
-  // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
+  // Find the packet holding the first byte, the last one starting at or
+  // before it, and extract data from the buffer
+  uint64_t offset = m_headOffset + (seq - m_firstByteSeq.Get ());
   NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  BufIterator i = std::upper_bound (m_data.begin (), m_data.end (), offset, &TcpTxBuffer::StartsAfter);
+  NS_ASSERT (i != m_data.begin ());
+  --i;
+  uint32_t packetOffset = offset - i->offset;
+  uint32_t fragmentLength = i->packet->GetSize () - packetOffset;
+  NS_LOG_LOGIC ("First byte found in packet at stream offset " << i->offset
+                                                              << ", packet len=" << i->packet->GetSize ());
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return i->packet->CreateFragment (packetOffset, s);
+    }
+  // The segment spans several packets: ns-3 packets are made of a single
+  // buffer, so the following ones are appended to the first fragment
+  Ptr<Packet> outPacket = i->packet->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  for (++i; remaining > 0; ++i)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      NS_ASSERT (i != m_data.end ());
+      uint32_t pktSize = i->packet->GetSize ();
+      if (pktSize >= remaining)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (i->packet->CreateFragment (0, remaining));
           break;
         }
-      else
-        {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-        }
-      count += pktSize;
+      outPacket->AddAtEnd (i->packet);
+      remaining -= pktSize;
     }
+  NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
 }
@@ -213,31 +206,18 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
-  NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  // Move the head of the data, and release the packets behind it. The
+  // packet holding the new head byte is kept as it is: the offset of its
+  // first byte still locates the data in it.
+  uint32_t removed = std::min (static_cast<uint32_t> (seq - m_firstByteSeq.Get ()), m_size);
+  m_size -= removed;
+  m_headOffset += removed;
+  m_firstByteSeq += removed;
+  while (!m_data.empty ()
+         && m_data.front ().offset + m_data.front ().packet->GetSize () <= m_headOffset)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
-        }
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.front ().packet->GetSize ());
+      m_data.pop_front ();
     }
   // Catching the case of ACKing a FIN
   if (m_size == 0)
@@ -21,7 +21,7 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +36,14 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets added by the application are kept as they are, in a deque
+ * indexed by the offset of their first byte from the start of the
+ * stream. The packet holding the first byte of a segment is found by a
+ * binary search. A segment within one packet is a fragment of it; a
+ * segment spanning several packets is built by appending them to its
+ * first fragment, which copies their data. Acknowledged packets are
+ * released from the head of the deque.
  */
 class TcpTxBuffer : public Object
 {
@@ -108,12 +116,30 @@ public:
   void DiscardUpTo (const SequenceNumber32& seq);
 
 private:
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  /**
+   * A packet added by the application, with the offset of its first
+   * byte from the start of the stream.
+   */
+  struct Fragment
+  {
+    Fragment (uint64_t offset, Ptr<Packet> packet);
+    uint64_t offset;    //< Offset of the first byte of the packet
+    Ptr<Packet> packet; //< The packet, possibly partly acknowledged
+  };
+  typedef std::deque<Fragment>::const_iterator BufIterator;
+
+  /**
+   * \param offset an offset in the stream
+   * \param fragment a fragment
+   * \returns true if the fragment starts after the offset
+   */
+  static bool StartsAfter (uint64_t offset, Fragment const &fragment);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //< Number of data bytes
   uint32_t m_maxBuffer;                         //< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //< Corresponding data (may be null)
+  uint64_t m_headOffset;                        //< Offset of the first byte in data in the stream
+  std::deque<Fragment> m_data;                  //< Corresponding data (may be empty)
 };
 
 } // namepsace ns3
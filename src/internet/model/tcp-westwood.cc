@@ -282,13 +282,23 @@ TcpWestwood::DupAck (const TcpHeader& header, uint32_t count)
       DoRetransmit ();
     }
   else if (m_inFastRec)
-    {// Increase cwnd for every additional DUPACK as in Reno
-      m_cWnd += m_segmentSize;
+    {// Increase cwnd for every additional DUPACK as in Reno, unless the pipe
+     // of SACK discounts it already
+      if (!m_sackPermitted)
+        {
+          m_cWnd += m_segmentSize;
+        }
       NS_LOG_INFO ("Dupack in fast recovery mode. Increase cwnd to " << m_cWnd);
       SendPendingData (m_connected);
     }
 }
 
+bool
+TcpWestwood::InFastRecovery (void) const
+{
+  return m_inFastRec;
+}
+
 void
 TcpWestwood::Retransmit (void)
 {
@@ -128,6 +128,11 @@ protected:
    */  
   virtual void Retransmit (void);
 
+  /**
+   * \return true during the fast recovery
+   */
+  virtual bool InFastRecovery (void) const;
+
   /**
    * Estimate the RTT, record the minimum value,
    * and run a clock on the RTT to trigger Westwood+ bandwidth sampling
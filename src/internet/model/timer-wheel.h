@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <list>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A timer wheel of items which all expire after the same timeout,
+ *        used by the IP layers for the timeouts of the reassembly buffers.
+ *
+ * The timeout is divided in a number of ticks. The wheel does not
+ * schedule any event: its owner calls Tick () once per tick, as long as
+ * the wheel is not empty, and handles the items Tick () returns. An item
+ * expires at the tick after the given number of ticks has elapsed, that
+ * is, between the timeout and the timeout plus one tick after it was
+ * inserted, at the precision of the ticks.
+ *
+ * \tparam T the type of the items.
+ */
+template <typename T>
+class TimerWheel
+{
+public:
+  /**
+   * The position of an item in the wheel, which removes it in constant
+   * time.
+   */
+  class Handle
+  {
+public:
+    Handle ();
+
+private:
+    friend class TimerWheel<T>;
+    uint32_t m_slot;
+    typename std::list<T *>::iterator m_it;
+  };
+
+  /**
+   * \param nTicks the number of ticks of the timeout.
+   */
+  TimerWheel (uint32_t nTicks);
+
+  /**
+   * \param item the item to add.
+   * \returns the handle of the item.
+   */
+  Handle Insert (T *item);
+  /**
+   * \param handle the handle of the item to remove, which must be in the
+   *        wheel.
+   */
+  void Remove (Handle const &handle);
+  /**
+   * Advance the wheel by one tick.
+   *
+   * \param expired the list to which the items which expire are
+   *        appended, in the order they were inserted. They are removed
+   *        from the wheel.
+   */
+  void Tick (std::list<T *> &expired);
+  /**
+   * Remove all the items.
+   *
+   * \param items the list to which the items are appended.
+   */
+  void Clear (std::list<T *> &items);
+  /**
+   * \returns the number of items in the wheel.
+   */
+  uint32_t GetN (void) const;
+
+private:
+  std::vector<std::list<T *> > m_slots;
+  uint32_t m_current;
+  uint32_t m_n;
+};
+
+template <typename T>
+TimerWheel<T>::Handle::Handle ()
+  : m_slot (0)
+{
+}
+
+template <typename T>
+TimerWheel<T>::TimerWheel (uint32_t nTicks)
+  : m_slots (nTicks + 1),
+    m_current (0),
+    m_n (0)
+{
+}
+
+template <typename T>
+typename TimerWheel<T>::Handle
+TimerWheel<T>::Insert (T *item)
+{
+  // the current slot is the last one the wheel reaches again.
+  Handle handle;
+  handle.m_slot = m_current;
+  handle.m_it = m_slots[m_current].insert (m_slots[m_current].end (), item);
+  m_n++;
+  return handle;
+}
+
+template <typename T>
+void
+TimerWheel<T>::Remove (Handle const &handle)
+{
+  m_slots[handle.m_slot].erase (handle.m_it);
+  m_n--;
+}
+
+template <typename T>
+void
+TimerWheel<T>::Tick (std::list<T *> &expired)
+{
+  m_current = (m_current + 1) % m_slots.size ();
+  m_n -= m_slots[m_current].size ();
+  expired.splice (expired.end (), m_slots[m_current]);
+}
+
+template <typename T>
+void
+TimerWheel<T>::Clear (std::list<T *> &items)
+{
+  for (uint32_t i = 0; i < m_slots.size (); ++i)
+    {
+      items.splice (items.end (), m_slots[i]);
+    }
+  m_n = 0;
+}
+
+template <typename T>
+uint32_t
+TimerWheel<T>::GetN (void) const
+{
+  return m_n;
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
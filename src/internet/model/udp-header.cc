@@ -20,6 +20,7 @@
 
 #include "udp-header.h"
 #include "ns3/address-utils.h"
+#include "ns3/packet.h"
 
 namespace ns3 {
 
@@ -210,4 +211,33 @@ UdpHeader::Deserialize (Buffer::Iterator start)
 }
 
 
+UdpHeaderView::UdpHeaderView (Ptr<const Packet> packet)
+  : m_data (packet->PeekContiguousData (4))
+{
+  if (m_data == 0 && packet->CopyData (m_storage, 4) == 4)
+    {
+      m_data = m_storage;
+    }
+}
+
+bool
+UdpHeaderView::IsValid (void) const
+{
+  return m_data != 0;
+}
+
+uint16_t
+UdpHeaderView::GetSourcePort (void) const
+{
+  NS_ASSERT (IsValid ());
+  return (m_data[0] << 8) | m_data[1];
+}
+
+uint16_t
+UdpHeaderView::GetDestinationPort (void) const
+{
+  NS_ASSERT (IsValid ());
+  return (m_data[2] << 8) | m_data[3];
+}
+
 } // namespace ns3
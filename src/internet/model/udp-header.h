@@ -26,8 +26,12 @@
 #include "ns3/header.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/ptr.h"
 
 namespace ns3 {
+
+class Packet;
+
 /**
  * \ingroup udp
  * \brief Packet header for UDP packets
@@ -140,6 +144,41 @@ private:
   bool m_goodChecksum;
 };
 
+/**
+ * \ingroup udp
+ * \brief Read-only view of the UDP header located at the start of a packet
+ *
+ * The ports are read directly from the bytes of the packet instead
+ * of deserializing a complete UdpHeader. A view must not outlive,
+ * nor be used after a modification of, the packet it was created from.
+ */
+class UdpHeaderView
+{
+public:
+  /**
+   * \param packet the packet which starts with a UDP header.
+   */
+  UdpHeaderView (Ptr<const Packet> packet);
+  /**
+   * \returns true if the packet is large enough to hold the ports.
+   */
+  bool IsValid (void) const;
+  /**
+   * \returns the source port for this UdpHeader
+   */
+  uint16_t GetSourcePort (void) const;
+  /**
+   * \returns the destination port for this UdpHeader
+   */
+  uint16_t GetDestinationPort (void) const;
+private:
+  UdpHeaderView (const UdpHeaderView &o);
+  UdpHeaderView &operator = (const UdpHeaderView &o);
+
+  const uint8_t *m_data;
+  uint8_t m_storage[4];
+};
+
 } // namespace ns3
 
 #endif /* UDP_HEADER */
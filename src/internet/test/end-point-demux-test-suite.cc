@@ -0,0 +1,372 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * A deterministic pseudo-random generator, so that the tests do not
+ * depend on the global seed.
+ */
+class Lcg
+{
+public:
+  Lcg () : m_state (12345) {}
+  uint32_t Next (uint32_t n)
+  {
+    m_state = m_state * 1103515245 + 12345;
+    return ((m_state >> 16) & 0x7fff) % n;
+  }
+private:
+  uint32_t m_state;
+};
+
+/**
+ * The lookup of Ipv4EndPointDemux, as a scan of all the endpoints in
+ * the order of their allocation.
+ */
+Ipv4EndPointDemux::EndPoints
+LookupIpv4 (Ipv4EndPointDemux::EndPoints endPoints, Ipv4Address daddr, uint16_t dport,
+            Ipv4Address saddr, uint16_t sport, Ptr<Ipv4Interface> incomingInterface)
+{
+  Ipv4EndPointDemux::EndPoints retval[4];
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;
+  for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ())
+          && daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = daddr.IsBroadcast () || subnetDirected;
+  for (Ipv4EndPointDemux::EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv4EndPoint *endP = *i;
+      if (endP->GetLocalPort () != dport
+          || (endP->GetBoundNetDevice () && endP->GetBoundNetDevice () != incomingInterface->GetDevice ()))
+        {
+          continue;
+        }
+      bool localWildCard = endP->GetLocalAddress () == Ipv4Address::GetAny ();
+      bool localExact = endP->GetLocalAddress () == daddr;
+      if (isBroadcast && !localWildCard)
+        {
+          localExact = endP->GetLocalAddress () == incomingInterfaceAddr;
+        }
+      bool peerExact = endP->GetPeerPort () == sport;
+      bool peerWildCard = endP->GetPeerPort () == 0;
+      bool remoteExact = endP->GetPeerAddress () == saddr;
+      bool remoteWildCard = endP->GetPeerAddress () == Ipv4Address::GetAny ();
+      if (!(localExact || localWildCard) || !(peerExact || peerWildCard) || !(remoteExact || remoteWildCard))
+        {
+          continue;
+        }
+      if (localWildCard && peerWildCard && remoteWildCard)
+        {
+          retval[0].push_back (endP);
+        }
+      if ((localExact || (isBroadcast && localWildCard)) && peerWildCard && remoteWildCard)
+        {
+          retval[1].push_back (endP);
+        }
+      if (localWildCard && peerExact && remoteExact)
+        {
+          retval[2].push_back (endP);
+        }
+      if (localExact && peerExact && remoteExact)
+        {
+          retval[3].push_back (endP);
+        }
+    }
+  for (uint32_t i = 3; i > 0; i--)
+    {
+      if (!retval[i].empty ())
+        {
+          return retval[i];
+        }
+    }
+  return retval[0];
+}
+
+/**
+ * The lookup of Ipv6EndPointDemux, as a scan of all the endpoints in
+ * the order of their allocation.
+ */
+Ipv6EndPointDemux::EndPoints
+LookupIpv6 (Ipv6EndPointDemux::EndPoints endPoints, Ipv6Address daddr, uint16_t dport,
+            Ipv6Address saddr, uint16_t sport, Ptr<Ipv6Interface> incomingInterface)
+{
+  Ipv6EndPointDemux::EndPoints retval[4];
+  for (Ipv6EndPointDemux::EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv6EndPoint *endP = *i;
+      if (endP->GetLocalPort () != dport
+          || (endP->GetBoundNetDevice () && endP->GetBoundNetDevice () != incomingInterface->GetDevice ()))
+        {
+          continue;
+        }
+      bool localWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
+      bool localExact = endP->GetLocalAddress () == daddr;
+      bool peerExact = endP->GetPeerPort () == sport;
+      bool peerWildCard = endP->GetPeerPort () == 0;
+      bool remoteExact = endP->GetPeerAddress () == saddr;
+      bool remoteWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
+      if (!(localExact || localWildCard) || !(peerExact || peerWildCard) || !(remoteExact || remoteWildCard))
+        {
+          continue;
+        }
+      if (localWildCard && peerWildCard && remoteWildCard)
+        {
+          retval[0].push_back (endP);
+        }
+      if (localExact && peerWildCard && remoteWildCard)
+        {
+          retval[1].push_back (endP);
+        }
+      if (localWildCard && peerExact && remoteExact)
+        {
+          retval[2].push_back (endP);
+        }
+      if (localExact && peerExact && remoteExact)
+        {
+          retval[3].push_back (endP);
+        }
+    }
+  for (uint32_t i = 3; i > 0; i--)
+    {
+      if (!retval[i].empty ())
+        {
+          return retval[i];
+        }
+    }
+  return retval[0];
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookups match a scan of the endpoints")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  Ptr<SimpleNetDevice> otherDevice = CreateObject<SimpleNetDevice> ();
+  otherDevice->SetAddress (Mac48Address::Allocate ());
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  interface->SetDevice (device);
+  interface->AddAddress (Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("255.255.255.0")));
+
+  // few addresses and ports, so that the endpoints often overlap.
+  Ipv4Address locals[] = { Ipv4Address::GetAny (), Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2"),
+                           Ipv4Address ("10.0.0.255"), Ipv4Address::GetBroadcast () };
+  Ipv4Address peers[] = { Ipv4Address::GetAny (), Ipv4Address ("10.0.1.1"), Ipv4Address ("10.0.1.2") };
+  uint16_t localPorts[] = { 80, 81 };
+  uint16_t peerPorts[] = { 0, 1000, 1001 };
+
+  Lcg rng;
+  Ipv4EndPointDemux demux;
+  std::vector<Ipv4EndPoint *> endPoints;
+  for (uint32_t step = 0; step < 2000; step++)
+    {
+      uint32_t action = rng.Next (10);
+      Ipv4Address local = locals[rng.Next (5)];
+      uint16_t localPort = localPorts[rng.Next (2)];
+      Ipv4Address peer = peers[rng.Next (3)];
+      uint16_t peerPort = peerPorts[rng.Next (3)];
+      if (action < 3 || endPoints.empty ())
+        {
+          Ipv4EndPoint *endPoint = rng.Next (2) == 0 ? demux.Allocate (local, localPort)
+            : demux.Allocate (local, localPort, peer, peerPort);
+          if (endPoint != 0)
+            {
+              if (rng.Next (8) == 0)
+                {
+                  endPoint->BindToNetDevice (rng.Next (2) == 0 ? device : otherDevice);
+                }
+              endPoints.push_back (endPoint);
+            }
+        }
+      else if (action < 5)
+        {
+          uint32_t i = rng.Next (endPoints.size ());
+          demux.DeAllocate (endPoints[i]);
+          endPoints.erase (endPoints.begin () + i);
+        }
+      else if (action < 7)
+        {
+          endPoints[rng.Next (endPoints.size ())]->SetPeer (peer, peerPort);
+        }
+      else if (action < 8)
+        {
+          endPoints[rng.Next (endPoints.size ())]->SetLocalAddress (local);
+        }
+      else
+        {
+          Ipv4EndPointDemux::EndPoints all = demux.GetAllEndPoints ();
+          NS_TEST_ASSERT_MSG_EQ (all.size (), endPoints.size (), "Wrong number of endpoints");
+          bool portLocal = false;
+          bool isLocal = false;
+          for (Ipv4EndPointDemux::EndPointsI i = all.begin (); i != all.end (); i++)
+            {
+              portLocal = portLocal || (*i)->GetLocalPort () == localPort;
+              isLocal = isLocal || ((*i)->GetLocalPort () == localPort && (*i)->GetLocalAddress () == local);
+            }
+          NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (localPort), portLocal, "Wrong LookupPortLocal");
+          NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (local, localPort), isLocal, "Wrong LookupLocal");
+
+          Ipv4Address daddr = locals[1 + rng.Next (4)];
+          Ipv4EndPointDemux::EndPoints expected = LookupIpv4 (all, daddr, localPort, peer, peerPort, interface);
+          Ipv4EndPointDemux::EndPoints found = demux.Lookup (daddr, localPort, peer, peerPort, interface);
+          NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong endpoints for " << daddr << ":" << localPort
+                                 << " from " << peer << ":" << peerPort);
+        }
+    }
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Ipv6EndPointDemux lookups match a scan of the end points")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  Ptr<SimpleNetDevice> otherDevice = CreateObject<SimpleNetDevice> ();
+  otherDevice->SetAddress (Mac48Address::Allocate ());
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  interface->SetDevice (device);
+
+  Ipv6Address locals[] = { Ipv6Address::GetAny (), Ipv6Address ("2001:1::1"), Ipv6Address ("2001:1::2"),
+                           Ipv6Address::GetAllRoutersMulticast () };
+  Ipv6Address peers[] = { Ipv6Address::GetAny (), Ipv6Address ("2001:2::1"), Ipv6Address ("2001:2::2") };
+  uint16_t localPorts[] = { 80, 81 };
+  uint16_t peerPorts[] = { 0, 1000, 1001 };
+
+  Lcg rng;
+  Ipv6EndPointDemux demux;
+  std::vector<Ipv6EndPoint *> endPoints;
+  for (uint32_t step = 0; step < 2000; step++)
+    {
+      uint32_t action = rng.Next (10);
+      Ipv6Address local = locals[rng.Next (4)];
+      uint16_t localPort = localPorts[rng.Next (2)];
+      Ipv6Address peer = peers[rng.Next (3)];
+      uint16_t peerPort = peerPorts[rng.Next (3)];
+      if (action < 3 || endPoints.empty ())
+        {
+          Ipv6EndPoint *endPoint = rng.Next (2) == 0 ? demux.Allocate (local, localPort)
+            : demux.Allocate (local, localPort, peer, peerPort);
+          if (endPoint != 0)
+            {
+              if (rng.Next (8) == 0)
+                {
+                  endPoint->BindToNetDevice (rng.Next (2) == 0 ? device : otherDevice);
+                }
+              endPoints.push_back (endPoint);
+            }
+        }
+      else if (action < 5)
+        {
+          uint32_t i = rng.Next (endPoints.size ());
+          demux.DeAllocate (endPoints[i]);
+          endPoints.erase (endPoints.begin () + i);
+        }
+      else if (action < 6)
+        {
+          endPoints[rng.Next (endPoints.size ())]->SetPeer (peer, peerPort);
+        }
+      else if (action < 7)
+        {
+          endPoints[rng.Next (endPoints.size ())]->SetLocalAddress (local);
+        }
+      else if (action < 8)
+        {
+          endPoints[rng.Next (endPoints.size ())]->SetLocalPort (localPort);
+        }
+      else
+        {
+          Ipv6EndPointDemux::EndPoints all = demux.GetEndPoints ();
+          NS_TEST_ASSERT_MSG_EQ (all.size (), endPoints.size (), "Wrong number of end points");
+          bool portLocal = false;
+          bool isLocal = false;
+          for (Ipv6EndPointDemux::EndPointsI i = all.begin (); i != all.end (); i++)
+            {
+              portLocal = portLocal || (*i)->GetLocalPort () == localPort;
+              isLocal = isLocal || ((*i)->GetLocalPort () == localPort && (*i)->GetLocalAddress () == local);
+            }
+          NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (localPort), portLocal, "Wrong LookupPortLocal");
+          NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (local, localPort), isLocal, "Wrong LookupLocal");
+
+          Ipv6Address daddr = locals[1 + rng.Next (3)];
+          Ipv6EndPointDemux::EndPoints expected = LookupIpv6 (all, daddr, localPort, peer, peerPort, interface);
+          Ipv6EndPointDemux::EndPoints found = demux.Lookup (daddr, localPort, peer, peerPort, interface);
+          NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong end points for " << daddr << ":" << localPort
+                                 << " from " << peer << ":" << peerPort);
+        }
+    }
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite () : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase (), TestCase::QUICK);
+  }
+} g_endPointDemuxTestSuite;
@@ -60,6 +60,21 @@ GlobalRouteManagerImplTestCase::DoRun (void)
       v = 0;
     }
 
+  // a vertex whose distance decreases is popped after the vertices
+  // already queued at its new distance, as with the sorted list.
+  SPFVertex *decreased = new SPFVertex;
+  decreased->SetDistanceFromRoot (9);
+  candidate.Push (decreased);
+  SPFVertex *queued = new SPFVertex;
+  queued->SetDistanceFromRoot (3);
+  candidate.Push (queued);
+  decreased->SetDistanceFromRoot (3);
+  candidate.Reorder ();
+  NS_TEST_ASSERT_MSG_EQ (candidate.Pop (), queued, "The vertex queued at distance 3 is not popped first");
+  NS_TEST_ASSERT_MSG_EQ (candidate.Pop (), decreased, "The decreased vertex is not popped second");
+  delete queued;
+  delete decreased;
+
   // Build fake link state database; four routers (0-3), 3 point-to-point
   // links
   //
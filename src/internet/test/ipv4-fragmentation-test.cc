@@ -33,6 +33,7 @@
 #include "ns3/drop-tail-queue.h"
 #include "ns3/socket.h"
 #include "ns3/udp-socket.h"
+#include "ns3/segment-offload-tag.h"
 
 #include "ns3/log.h"
 #include "ns3/node.h"
@@ -48,6 +49,7 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 #include <netinet/in.h>
 
 using namespace ns3;
@@ -82,6 +84,7 @@ class Ipv4FragmentationTest: public TestCase
   Ptr<Packet> m_sentPacketClient;
   Ptr<Packet> m_receivedPacketClient;
   Ptr<Packet> m_receivedPacketServer;
+  std::vector<Ptr<Packet> > m_receivedPacketsServer;
 
 
   Ptr<Socket> m_socketServer;
@@ -90,6 +93,8 @@ class Ipv4FragmentationTest: public TestCase
   uint8_t *m_data;
   uint32_t m_size;
   uint8_t m_icmpType;
+  uint32_t m_nTxPackets;
+  uint32_t m_nTaggedTxPackets;
 
 public:
   virtual void DoRun (void);
@@ -108,6 +113,9 @@ public:
 
   void SetFill (uint8_t *fill, uint32_t fillSize, uint32_t dataSize);
   Ptr<Packet> SendClient (void);
+  void SendClientData (uint32_t size);
+  void SendClientOffload (uint32_t size, uint32_t nPackets);
+  void TxTrace (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
 
 };
 
@@ -165,6 +173,7 @@ Ipv4FragmentationTest::HandleReadServer (Ptr<Socket> socket)
           packet->RemoveAllByteTags ();
 
           m_receivedPacketServer = packet->Copy();
+          m_receivedPacketsServer.push_back (m_receivedPacketServer);
         }
     }
 }
@@ -252,6 +261,31 @@ Ptr<Packet> Ipv4FragmentationTest::SendClient (void)
   return p;
 }
 
+void
+Ipv4FragmentationTest::SendClientData (uint32_t size)
+{
+  m_socketClient->Send (Create<Packet> (m_data, size));
+}
+
+void
+Ipv4FragmentationTest::SendClientOffload (uint32_t size, uint32_t nPackets)
+{
+  Ptr<Packet> p = Create<Packet> (m_data, size);
+  p->AddPacketTag (SegmentOffloadTag (nPackets, size));
+  m_socketClient->Send (p);
+}
+
+void
+Ipv4FragmentationTest::TxTrace (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  SegmentOffloadTag offload;
+  m_nTxPackets++;
+  if (p->PeekPacketTag (offload))
+    {
+      m_nTaggedTxPackets++;
+    }
+}
+
 void
 Ipv4FragmentationTest::DoRun (void)
 {
@@ -399,6 +433,50 @@ Ipv4FragmentationTest::DoRun (void)
     }
 
 
+  // Fourth test: normal channel, no errors, delays each 2 packets.
+  // Two packets are sent back to back: their fragments arrive interleaved,
+  // and are reassembled in two different packets.
+  serverDevErrorModel->Disable();
+  channel->SetJumpingMode(true);
+  SetFill (fillData, 78, 5000);
+  m_receivedPacketsServer.clear ();
+  Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv4FragmentationTest::SendClientData, this, 5000);
+  Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv4FragmentationTest::SendClientData, this, 3000);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacketsServer.size (), 2, "Server did not get two packets");
+  for (uint32_t i = 0; i < m_receivedPacketsServer.size (); i++)
+    {
+      uint8_t recvBuffer[5000];
+      uint32_t recvSize = m_receivedPacketsServer[i]->GetSize ();
+
+      NS_TEST_EXPECT_MSG_EQ (recvSize, (i == 0 ? 5000 : 3000), "Packet size not correct");
+
+      m_receivedPacketsServer[i]->CopyData(recvBuffer, 5000);
+      NS_TEST_EXPECT_MSG_EQ (memcmp(m_data, recvBuffer, recvSize),
+                             0, "Packet content differs");
+    }
+  channel->SetJumpingMode(false);
+
+  // Fifth test: normal channel, no errors, no delays.
+  // A packet standing for several packets (segment offload) is fragmented
+  // like the others by a device which does not support the offload, and
+  // its fragments do not carry the tag.
+  SetFill (fillData, 78, 5000);
+  m_receivedPacketServer = Create<Packet> ();
+  m_nTxPackets = 0;
+  m_nTaggedTxPackets = 0;
+  clientNode->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&Ipv4FragmentationTest::TxTrace, this));
+  Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv4FragmentationTest::SendClientOffload, this, 5000, 5);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacketServer->GetSize (), 5000, "Packet size not correct");
+  NS_TEST_EXPECT_MSG_GT (m_nTxPackets, 5, "Offloaded packet not fragmented");
+  NS_TEST_EXPECT_MSG_EQ (m_nTaggedTxPackets, 0, "Fragments of an offloaded packet tagged");
+
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
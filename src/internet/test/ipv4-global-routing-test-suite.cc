@@ -0,0 +1,421 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <set>
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/simulator.h"
+#include "ns3/udp-header.h"
+#include "ns3/boolean.h"
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * A deterministic pseudo-random generator, so that the test does not
+ * depend on the global seed.
+ */
+class Lcg
+{
+public:
+  Lcg () : m_state (54321) {}
+  uint32_t Next (void)
+  {
+    m_state = m_state * 1103515245 + 12345;
+    return (m_state >> 16) & 0x7fff;
+  }
+private:
+  uint32_t m_state;
+};
+
+typedef std::vector<Ipv4RoutingTableEntry> Entries;
+
+/**
+ * \returns the index of the first route of the entries to dest, or -1.
+ */
+int32_t
+FindRoute (Entries const &entries, Ipv4Address dest, Ptr<NetDevice> oif, Ptr<Ipv4> ipv4)
+{
+  for (uint32_t i = 0; i < entries.size (); ++i)
+    {
+      if (entries[i].GetDestNetworkMask ().IsMatch (dest, entries[i].GetDestNetwork ())
+          && (oif == 0 || oif == ipv4->GetNetDevice (entries[i].GetInterface ())))
+        {
+          return i;
+        }
+    }
+  return -1;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+class Ipv4GlobalRoutingLookupTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingLookupTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingLookupTestCase::Ipv4GlobalRoutingLookupTestCase ()
+  : TestCase ("Check that the indexed lookup of Ipv4GlobalRouting selects the routes as a linear search")
+{
+}
+
+void
+Ipv4GlobalRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  ipv4->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv4);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)), Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+    }
+
+  // the routes added, in the order of the routing table.
+  Entries host;
+  Entries network;
+  Entries external;
+  Lcg rng;
+  for (uint32_t round = 0; round < 2000; ++round)
+    {
+      uint32_t action = rng.Next () % 10;
+      uint32_t interface = 1 + rng.Next () % 3;
+      Ipv4Address gateway (0xc0a80002 + ((interface - 1) << 8) + (rng.Next () % 4));
+      Ipv4Address dest ((rng.Next () % 4) << 30 | (rng.Next () % 4) << 20 | (rng.Next () % 8));
+      uint32_t length = rng.Next () % 33;
+      Ipv4Mask mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+      if (action < 3)
+        {
+          routing->AddHostRouteTo (dest, gateway, interface);
+          host.push_back (Ipv4RoutingTableEntry::CreateHostRouteTo (dest, gateway, interface));
+        }
+      else if (action < 6)
+        {
+          routing->AddNetworkRouteTo (dest, mask, gateway, interface);
+          network.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (dest, mask, gateway, interface));
+        }
+      else if (action < 8)
+        {
+          routing->AddASExternalRouteTo (dest, mask, gateway, interface);
+          external.push_back (Ipv4RoutingTableEntry::CreateNetworkRouteTo (dest, mask, gateway, interface));
+        }
+      else if (routing->GetNRoutes () > 0)
+        {
+          uint32_t index = rng.Next () % routing->GetNRoutes ();
+          routing->RemoveRoute (index);
+          if (index < host.size ())
+            {
+              host.erase (host.begin () + index);
+            }
+          else if (index < host.size () + network.size ())
+            {
+              network.erase (network.begin () + index - host.size ());
+            }
+          else
+            {
+              external.erase (external.begin () + index - host.size () - network.size ());
+            }
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (routing->GetNRoutes (), host.size () + network.size () + external.size (),
+                             "Wrong number of routes at round " << round);
+      if (round % 100 == 0)
+        {
+          Entries all (host);
+          all.insert (all.end (), network.begin (), network.end ());
+          all.insert (all.end (), external.begin (), external.end ());
+          for (uint32_t j = 0; j < all.size (); ++j)
+            {
+              Ipv4RoutingTableEntry *route = routing->GetRoute (j);
+              NS_TEST_ASSERT_MSG_EQ (route->GetDest (), all[j].GetDest (), "Wrong route " << j << " at round " << round);
+              NS_TEST_ASSERT_MSG_EQ (route->GetDestNetworkMask (), all[j].GetDestNetworkMask (), "Wrong route " << j);
+              NS_TEST_ASSERT_MSG_EQ (route->GetGateway (), all[j].GetGateway (), "Wrong route " << j);
+              NS_TEST_ASSERT_MSG_EQ (route->GetInterface (), all[j].GetInterface (), "Wrong route " << j);
+            }
+        }
+
+      for (uint32_t i = 0; i < 4; ++i)
+        {
+          Ipv4Address dest ((rng.Next () % 4) << 30 | (rng.Next () % 4) << 20 | (rng.Next () % 8));
+          Ptr<NetDevice> oif = (i % 2 == 0) ? 0 : ipv4->GetNetDevice (1 + rng.Next () % 3);
+
+          // host routes, then network routes, then external routes, each
+          // in the order in which they were added.
+          Ipv4RoutingTableEntry const *expected = 0;
+          Entries const *tables[] = { &host, &network, &external };
+          for (uint32_t t = 0; t < 3 && expected == 0; ++t)
+            {
+              int32_t j = FindRoute (*tables[t], dest, oif, ipv4);
+              if (j >= 0)
+                {
+                  expected = &(*tables[t])[j];
+                }
+            }
+
+          Ipv4Header header;
+          header.SetDestination (dest);
+          Socket::SocketErrno error;
+          Ptr<Ipv4Route> route = routing->RouteOutput (0, header, oif, error);
+          NS_TEST_ASSERT_MSG_EQ ((route != 0), (expected != 0), "Route to " << dest << " at round " << round);
+          if (route != 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (route->GetGateway (), expected->GetGateway (), "Wrong route to " << dest << " at round " << round);
+              NS_TEST_ASSERT_MSG_EQ (route->GetOutputDevice (), ipv4->GetNetDevice (expected->GetInterface ()),
+                                     "Wrong device to " << dest << " at round " << round);
+            }
+        }
+    }
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class Ipv4GlobalRoutingFlowEcmpTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingFlowEcmpTestCase ();
+  virtual void DoRun (void);
+private:
+  void Forward (Ptr<Ipv4Route> route, Ptr<const Packet> p, Ipv4Header const &header);
+  /// \returns the gateway selected to forward the packet.
+  Ipv4Address RouteInput (uint16_t sourcePort, bool fragment);
+
+  Ptr<Ipv4L3Protocol> m_ipv4;
+  Ptr<Ipv4GlobalRouting> m_routing;
+  Ipv4Address m_gateway;
+};
+
+Ipv4GlobalRoutingFlowEcmpTestCase::Ipv4GlobalRoutingFlowEcmpTestCase ()
+  : TestCase ("Check that the flow ECMP routing of Ipv4GlobalRouting keeps the flows on one path and spreads them")
+{
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::Forward (Ptr<Ipv4Route> route, Ptr<const Packet> p, Ipv4Header const &header)
+{
+  m_gateway = route->GetGateway ();
+}
+
+Ipv4Address
+Ipv4GlobalRoutingFlowEcmpTestCase::RouteInput (uint16_t sourcePort, bool fragment)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udp;
+  udp.SetSourcePort (sourcePort);
+  udp.SetDestinationPort (9);
+  p->AddHeader (udp);
+  Ipv4Header header;
+  header.SetSource (Ipv4Address ("192.168.0.10"));
+  header.SetDestination (Ipv4Address ("10.1.2.3"));
+  header.SetProtocol (17);
+  if (fragment)
+    {
+      header.SetMoreFragments ();
+    }
+  m_gateway = Ipv4Address ();
+  m_routing->RouteInput (p, header, m_ipv4->GetNetDevice (1),
+                         MakeCallback (&Ipv4GlobalRoutingFlowEcmpTestCase::Forward, this),
+                         Ipv4RoutingProtocol::MulticastForwardCallback (),
+                         Ipv4RoutingProtocol::LocalDeliverCallback (),
+                         Ipv4RoutingProtocol::ErrorCallback ());
+  return m_gateway;
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  m_ipv4 = CreateObject<Ipv4L3Protocol> ();
+  m_routing = CreateObject<Ipv4GlobalRouting> ();
+  m_routing->SetAttribute ("FlowEcmpRouting", BooleanValue (true));
+  m_ipv4->SetRoutingProtocol (m_routing);
+  node->AggregateObject (m_ipv4);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = m_ipv4->AddInterface (device);
+      m_ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)), Ipv4Mask ("255.255.255.0")));
+      m_ipv4->SetUp (interface);
+    }
+
+  // four equal-cost routes, stored as one group of next hops.
+  Ipv4Address gateways[] = { Ipv4Address ("192.168.0.2"), Ipv4Address ("192.168.0.3"),
+                             Ipv4Address ("192.168.1.2"), Ipv4Address ("192.168.2.2") };
+  uint32_t interfaces[] = { 1, 1, 2, 3 };
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      m_routing->AddNetworkRouteTo (Ipv4Address ("10.0.0.0"), Ipv4Mask ("255.0.0.0"), gateways[i], interfaces[i]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_routing->GetNRoutes (), 4, "Wrong number of routes");
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_routing->GetRoute (i)->GetGateway (), gateways[i], "Wrong route " << i);
+      NS_TEST_ASSERT_MSG_EQ (m_routing->GetRoute (i)->GetInterface (), interfaces[i], "Wrong route " << i);
+    }
+
+  // the flows of the node, without ports.
+  std::set<Ipv4Address> used;
+  for (uint32_t i = 0; i < 64; ++i)
+    {
+      Ipv4Header header;
+      header.SetSource (Ipv4Address ("192.168.0.1"));
+      header.SetDestination (Ipv4Address (0x0a000000 + i));
+      header.SetProtocol (6);
+      Socket::SocketErrno error;
+      Ptr<Ipv4Route> route = m_routing->RouteOutput (0, header, 0, error);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route to " << header.GetDestination ());
+      for (uint32_t j = 0; j < 3; ++j)
+        {
+          Ptr<Ipv4Route> again = m_routing->RouteOutput (0, header, 0, error);
+          NS_TEST_ASSERT_MSG_EQ (again->GetGateway (), route->GetGateway (), "Flow moved to another path");
+        }
+      used.insert (route->GetGateway ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (used.size (), 4, "The flows do not use all the paths");
+
+  // the forwarded flows, told apart by their ports.
+  used.clear ();
+  for (uint16_t port = 1000; port < 1064; ++port)
+    {
+      Ipv4Address gateway = RouteInput (port, false);
+      NS_TEST_ASSERT_MSG_NE (gateway, Ipv4Address (), "No route for port " << port);
+      NS_TEST_ASSERT_MSG_EQ (RouteInput (port, false), gateway, "Flow moved to another path");
+      used.insert (gateway);
+    }
+  NS_TEST_ASSERT_MSG_EQ (used.size (), 4, "The flows do not use all the paths");
+
+  // the fragments of a packet follow one path whatever their payload.
+  used.clear ();
+  for (uint16_t port = 1000; port < 1064; ++port)
+    {
+      used.insert (RouteInput (port, true));
+    }
+  NS_TEST_ASSERT_MSG_EQ (used.size (), 1, "The fragments do not follow one path");
+
+  m_ipv4 = 0;
+  m_routing = 0;
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class Ipv4GlobalRoutingEntriesTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingEntriesTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ptr<Ipv4Route> Lookup (Ipv4Address dest);
+
+  Ptr<Ipv4GlobalRouting> m_routing;
+};
+
+Ipv4GlobalRoutingEntriesTestCase::Ipv4GlobalRoutingEntriesTestCase ()
+  : TestCase ("Check that the entries returned by Ipv4GlobalRouting::GetRoute are kept with their routes")
+{
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRoutingEntriesTestCase::Lookup (Ipv4Address dest)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  return m_routing->RouteOutput (0, header, 0, error);
+}
+
+void
+Ipv4GlobalRoutingEntriesTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  m_routing = CreateObject<Ipv4GlobalRouting> ();
+  ipv4->SetRoutingProtocol (m_routing);
+  node->AggregateObject (ipv4);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)), Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+    }
+
+  m_routing->AddHostRouteTo (Ipv4Address ("10.1.1.1"), Ipv4Address ("192.168.0.2"), 1);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("10.2.0.0"), Ipv4Mask ("255.255.0.0"), Ipv4Address ("192.168.1.2"), 2);
+  m_routing->AddNetworkRouteTo (Ipv4Address ("10.3.0.0"), Ipv4Mask ("255.255.0.0"), Ipv4Address ("192.168.2.2"), 3);
+
+  // the entries of two routes are kept together, and stay the same.
+  Ipv4RoutingTableEntry *first = m_routing->GetRoute (1);
+  Ipv4RoutingTableEntry *second = m_routing->GetRoute (2);
+  NS_TEST_ASSERT_MSG_NE (first, second, "Two routes share their entry");
+  NS_TEST_ASSERT_MSG_EQ (first->GetDest (), Ipv4Address ("10.2.0.0"), "Wrong first entry");
+  NS_TEST_ASSERT_MSG_EQ (second->GetDest (), Ipv4Address ("10.3.0.0"), "Wrong second entry");
+  NS_TEST_ASSERT_MSG_EQ (m_routing->GetRoute (1), first, "The first entry changed");
+
+  // the changes made to an entry apply to its route.
+  *second = Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address ("10.3.0.0"), Ipv4Mask ("255.255.0.0"),
+                                                         Ipv4Address ("192.168.0.9"), 1);
+  Ptr<Ipv4Route> route = Lookup (Ipv4Address ("10.3.0.1"));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to 10.3.0.1");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), Ipv4Address ("192.168.0.9"), "The changed gateway is not used");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), ipv4->GetNetDevice (1), "The changed interface is not used");
+  NS_TEST_ASSERT_MSG_EQ (m_routing->GetRoute (2), second, "The changed entry was replaced");
+
+  // removing a route keeps the entries of the others.
+  m_routing->RemoveRoute (1);
+  NS_TEST_ASSERT_MSG_EQ (m_routing->GetNRoutes (), 2, "Wrong number of routes");
+  NS_TEST_ASSERT_MSG_EQ (m_routing->GetRoute (1), second, "The entry moved with the removal of another route");
+  NS_TEST_EXPECT_MSG_EQ (second->GetGateway (), Ipv4Address ("192.168.0.9"), "The change of the entry was lost");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Ipv4Address ("10.2.0.1")), 0, "The removed route is used");
+  route = Lookup (Ipv4Address ("10.3.0.1"));
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to 10.3.0.1 after the removal");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), Ipv4Address ("192.168.0.9"), "Wrong gateway after the removal");
+
+  m_routing = 0;
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class Ipv4GlobalRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4GlobalRoutingTestSuite () : TestSuite ("ipv4-global-routing", UNIT)
+  {
+    AddTestCase (new Ipv4GlobalRoutingLookupTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingFlowEcmpTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingEntriesTestCase, TestCase::QUICK);
+  }
+} g_ipv4GlobalRoutingTestSuite;
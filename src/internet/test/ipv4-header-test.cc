@@ -38,6 +38,8 @@
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/ipv4-static-routing.h"
+#include "ns3/udp-header.h"
+#include "ns3/tcp-header.h"
 
 #include <string>
 #include <sstream>
@@ -255,6 +257,131 @@ Ipv4HeaderTest::DoRun (void)
  
   Simulator::Destroy ();
 }
+
+class Ipv4HeaderViewTest : public TestCase
+{
+public:
+  Ipv4HeaderViewTest ();
+  virtual void DoRun (void);
+};
+
+Ipv4HeaderViewTest::Ipv4HeaderViewTest ()
+  : TestCase ("Ipv4, UDP and TCP header views")
+{
+}
+
+void
+Ipv4HeaderViewTest::DoRun (void)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.1.2"));
+  ipHeader.SetProtocol (17);
+  ipHeader.SetTtl (33);
+  ipHeader.SetIdentification (4321);
+  ipHeader.SetPayloadSize (108);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (1234);
+  udpHeader.SetDestinationPort (80);
+
+  // the headers are stored contiguously in front of the payload.
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (udpHeader);
+  p->AddHeader (ipHeader);
+  Ipv4HeaderView ipView (p);
+  NS_TEST_ASSERT_MSG_EQ (ipView.IsValid (), true, "Ipv4 view not valid");
+  NS_TEST_EXPECT_MSG_EQ (ipView.GetSerializedSize (), 20, "Wrong header size");
+  NS_TEST_EXPECT_MSG_EQ (ipView.GetPayloadSize (), 108, "Wrong payload size");
+  NS_TEST_EXPECT_MSG_EQ (ipView.GetIdentification (), 4321, "Wrong identification");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (ipView.GetTtl ()), 33, "Wrong ttl");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (ipView.GetProtocol ()), 17, "Wrong protocol");
+  NS_TEST_EXPECT_MSG_EQ (ipView.GetSource (), Ipv4Address ("10.0.0.1"), "Wrong source");
+  NS_TEST_EXPECT_MSG_EQ (ipView.GetDestination (), Ipv4Address ("10.0.1.2"), "Wrong destination");
+
+  p->RemoveHeader (ipHeader);
+  UdpHeaderView udpView (p);
+  NS_TEST_ASSERT_MSG_EQ (udpView.IsValid (), true, "UDP view not valid");
+  NS_TEST_EXPECT_MSG_EQ (udpView.GetSourcePort (), 1234, "Wrong source port");
+  NS_TEST_EXPECT_MSG_EQ (udpView.GetDestinationPort (), 80, "Wrong destination port");
+
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (5000);
+  tcpHeader.SetDestinationPort (22);
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (0x12345678));
+  tcpHeader.SetFlags (TcpHeader::SYN | TcpHeader::ACK);
+  p = Create<Packet> (10);
+  p->AddHeader (tcpHeader);
+  TcpHeaderView tcpView (p);
+  NS_TEST_ASSERT_MSG_EQ (tcpView.IsValid (), true, "TCP view not valid");
+  NS_TEST_EXPECT_MSG_EQ (tcpView.GetSourcePort (), 5000, "Wrong source port");
+  NS_TEST_EXPECT_MSG_EQ (tcpView.GetDestinationPort (), 22, "Wrong destination port");
+  NS_TEST_EXPECT_MSG_EQ (tcpView.GetSequenceNumber (), SequenceNumber32 (0x12345678), "Wrong sequence number");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (tcpView.GetFlags ()), uint32_t (TcpHeader::SYN | TcpHeader::ACK), "Wrong flags");
+
+  // bytes which are not stored contiguously are copied.
+  p = Create<Packet> (40);
+  Ipv4HeaderView zeroView (p);
+  NS_TEST_ASSERT_MSG_EQ (zeroView.IsValid (), true, "Ipv4 view not valid");
+  NS_TEST_EXPECT_MSG_EQ (zeroView.GetDestination (), Ipv4Address ("0.0.0.0"), "Wrong destination");
+
+  p = Create<Packet> (10);
+  Ipv4HeaderView shortView (p);
+  NS_TEST_EXPECT_MSG_EQ (shortView.IsValid (), false, "Ipv4 view of a short packet is valid");
+}
+
+class Ipv4HeaderTtlTest : public TestCase
+{
+public:
+  Ipv4HeaderTtlTest ();
+  virtual void DoRun (void);
+};
+
+Ipv4HeaderTtlTest::Ipv4HeaderTtlTest ()
+  : TestCase ("Incremental checksum update of Ipv4Header::DecrementTtl")
+{
+}
+
+void
+Ipv4HeaderTtlTest::DoRun (void)
+{
+  for (uint32_t ttl = 1; ttl < 256; ttl += 3)
+    {
+      Ipv4Header sent;
+      sent.EnableChecksum ();
+      sent.SetSource (Ipv4Address ("10.0.0.1"));
+      sent.SetDestination (Ipv4Address ("192.168.250.3"));
+      sent.SetProtocol (ttl);
+      sent.SetTtl (ttl);
+      sent.SetIdentification (ttl * 257);
+      sent.SetPayloadSize (1000);
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddHeader (sent);
+
+      Ipv4Header received;
+      received.EnableChecksum ();
+      p->RemoveHeader (received);
+      NS_TEST_ASSERT_MSG_EQ (received.IsChecksumOk (), true, "Bad checksum");
+      received.DecrementTtl ();
+      p->AddHeader (received);
+
+      // the checksum of the forwarded header must be the one a full
+      // computation gives.
+      Ipv4Header forwarded;
+      forwarded.EnableChecksum ();
+      p->RemoveHeader (forwarded);
+      NS_TEST_EXPECT_MSG_EQ (forwarded.IsChecksumOk (), true, "Bad checksum after DecrementTtl, ttl=" << ttl);
+      NS_TEST_EXPECT_MSG_EQ (uint32_t (forwarded.GetTtl ()), ttl - 1, "Wrong ttl");
+
+      // any other change falls back to the full computation.
+      forwarded.DecrementTtl ();
+      forwarded.SetSource (Ipv4Address ("10.0.0.2"));
+      p->AddHeader (forwarded);
+      Ipv4Header modified;
+      modified.EnableChecksum ();
+      p->RemoveHeader (modified);
+      NS_TEST_EXPECT_MSG_EQ (modified.IsChecksumOk (), true, "Bad checksum after SetSource, ttl=" << ttl);
+    }
+}
 //-----------------------------------------------------------------------------
 class Ipv4HeaderTestSuite : public TestSuite
 {
@@ -262,5 +389,7 @@ public:
   Ipv4HeaderTestSuite () : TestSuite ("ipv4-header", UNIT)
   {
     AddTestCase (new Ipv4HeaderTest, TestCase::QUICK);
+    AddTestCase (new Ipv4HeaderViewTest, TestCase::QUICK);
+    AddTestCase (new Ipv4HeaderTtlTest, TestCase::QUICK);
   }
 } g_ipv4HeaderTestSuite;
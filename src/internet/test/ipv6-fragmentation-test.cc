@@ -35,6 +35,7 @@
 #include "ns3/drop-tail-queue.h"
 #include "ns3/socket.h"
 #include "ns3/udp-socket.h"
+#include "ns3/segment-offload-tag.h"
 
 #include "ns3/log.h"
 #include "ns3/node.h"
@@ -57,6 +58,7 @@
 
 #include <string>
 #include <limits>
+#include <vector>
 #include <netinet/in.h>
 
 using namespace ns3;
@@ -95,6 +97,7 @@ class Ipv6FragmentationTest : public TestCase
   Ptr<Packet> m_sentPacketClient;
   Ptr<Packet> m_receivedPacketClient;
   Ptr<Packet> m_receivedPacketServer;
+  std::vector<Ptr<Packet> > m_receivedPacketsServer;
 
 
   Ptr<Socket> m_socketServer;
@@ -103,6 +106,8 @@ class Ipv6FragmentationTest : public TestCase
   uint8_t *m_data;
   uint32_t m_size;
   uint8_t m_icmpType;
+  uint32_t m_nTxPackets;
+  uint32_t m_nTaggedTxPackets;
   uint8_t m_icmpCode;
 
 public:
@@ -122,6 +127,9 @@ public:
 
   void SetFill (uint8_t *fill, uint32_t fillSize, uint32_t dataSize);
   Ptr<Packet> SendClient (void);
+  void SendClientData (uint32_t size);
+  void SendClientOffload (uint32_t size, uint32_t nPackets);
+  void TxTrace (Ptr<const Packet> p, Ptr<Ipv6> ipv6, uint32_t interface);
 
 };
 
@@ -174,6 +182,7 @@ Ipv6FragmentationTest::HandleReadServer (Ptr<Socket> socket)
           packet->RemoveAllByteTags ();
 
           m_receivedPacketServer = packet->Copy ();
+          m_receivedPacketsServer.push_back (m_receivedPacketServer);
         }
     }
 }
@@ -262,6 +271,31 @@ Ptr<Packet> Ipv6FragmentationTest::SendClient (void)
   return p;
 }
 
+void
+Ipv6FragmentationTest::SendClientData (uint32_t size)
+{
+  m_socketClient->Send (Create<Packet> (m_data, size));
+}
+
+void
+Ipv6FragmentationTest::SendClientOffload (uint32_t size, uint32_t nPackets)
+{
+  Ptr<Packet> p = Create<Packet> (m_data, size);
+  p->AddPacketTag (SegmentOffloadTag (nPackets, size));
+  m_socketClient->Send (p);
+}
+
+void
+Ipv6FragmentationTest::TxTrace (Ptr<const Packet> p, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  SegmentOffloadTag offload;
+  m_nTxPackets++;
+  if (p->PeekPacketTag (offload))
+    {
+      m_nTaggedTxPackets++;
+    }
+}
+
 void
 Ipv6FragmentationTest::DoRun (void)
 {
@@ -409,6 +443,49 @@ Ipv6FragmentationTest::DoRun (void)
                              true, "Client did not receive ICMPv6::TIME_EXCEEDED " << int(m_icmpType) << int(m_icmpCode) );
     }
 
+  // Fourth test: normal channel, no errors, delays each 2 packets.
+  // Two packets are sent back to back: their fragments arrive interleaved,
+  // and are reassembled in two different packets.
+  serverDevErrorModel->Disable ();
+  channel->SetJumpingMode (true);
+  SetFill (fillData, 78, 5000);
+  m_receivedPacketsServer.clear ();
+  Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv6FragmentationTest::SendClientData, this, 5000);
+  Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv6FragmentationTest::SendClientData, this, 3000);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacketsServer.size (), 2, "Server did not get two packets");
+  for (uint32_t i = 0; i < m_receivedPacketsServer.size (); i++)
+    {
+      uint8_t recvBuffer[5000];
+      uint32_t recvSize = m_receivedPacketsServer[i]->GetSize ();
+
+      NS_TEST_EXPECT_MSG_EQ (recvSize, (i == 0 ? 5000 : 3000), "Packet size not correct");
+
+      m_receivedPacketsServer[i]->CopyData (recvBuffer, 5000);
+      NS_TEST_EXPECT_MSG_EQ (memcmp (m_data, recvBuffer, recvSize),
+                             0, "Packet content differs");
+    }
+  channel->SetJumpingMode (false);
+
+  // Fifth test: normal channel, no errors, no delays.
+  // A packet standing for several packets (segment offload) is fragmented
+  // like the others by a device which does not support the offload, and
+  // its fragments do not carry the tag.
+  SetFill (fillData, 78, 5000);
+  m_receivedPacketServer = Create<Packet> ();
+  m_nTxPackets = 0;
+  m_nTaggedTxPackets = 0;
+  clientNode->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext ("Tx", MakeCallback (&Ipv6FragmentationTest::TxTrace, this));
+  Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                  &Ipv6FragmentationTest::SendClientOffload, this, 5000, 5);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacketServer->GetSize (), 5000, "Packet size not correct");
+  NS_TEST_EXPECT_MSG_GT (m_nTxPackets, 5, "Offloaded packet not fragmented");
+  NS_TEST_EXPECT_MSG_EQ (m_nTaggedTxPackets, 0, "Fragments of an offloaded packet tagged");
 
   Simulator::Destroy ();
 }
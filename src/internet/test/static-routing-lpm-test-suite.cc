@@ -0,0 +1,327 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/lpm-trie.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6-routing-table-entry.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * A deterministic pseudo-random generator, so that the tests do not
+ * depend on the global seed.
+ */
+class Lcg
+{
+public:
+  Lcg () : m_state (12345) {}
+  uint32_t Next (void)
+  {
+    m_state = m_state * 1103515245 + 12345;
+    return (m_state >> 16) & 0x7fff;
+  }
+  uint32_t Next32 (void)
+  {
+    return (Next () << 17) ^ (Next () << 2) ^ Next ();
+  }
+private:
+  uint32_t m_state;
+};
+
+struct Prefix
+{
+  uint32_t key;
+  uint32_t length;
+  uint32_t value;
+};
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+class LpmTrieTestCase : public TestCase
+{
+public:
+  LpmTrieTestCase ();
+  virtual void DoRun (void);
+};
+
+LpmTrieTestCase::LpmTrieTestCase ()
+  : TestCase ("Check LpmTrie against a linear search")
+{
+}
+
+void
+LpmTrieTestCase::DoRun (void)
+{
+  std::vector<struct Prefix> prefixes;
+  LpmTrie<uint32_t> trie;
+  Lcg rng;
+
+  for (uint32_t round = 0; round < 2000; ++round)
+    {
+      if (prefixes.empty () || rng.Next () % 3 != 0)
+        {
+          // few distinct lengths and keys, so that prefixes nest and share.
+          struct Prefix p;
+          p.length = rng.Next () % 33;
+          p.key = (rng.Next () % 16) << 28 | (rng.Next () % 4) << 12;
+          p.key &= p.length == 0 ? 0 : 0xffffffff << (32 - p.length);
+          p.value = round;
+          prefixes.push_back (p);
+          uint8_t key[4] = { uint8_t (p.key >> 24), uint8_t (p.key >> 16), uint8_t (p.key >> 8), uint8_t (p.key) };
+          trie.Insert (key, p.length, p.value);
+        }
+      else
+        {
+          uint32_t i = rng.Next () % prefixes.size ();
+          struct Prefix p = prefixes[i];
+          prefixes.erase (prefixes.begin () + i);
+          uint8_t key[4] = { uint8_t (p.key >> 24), uint8_t (p.key >> 16), uint8_t (p.key >> 8), uint8_t (p.key) };
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (key, p.length, p.value), true, "Prefix not found");
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (key, p.length, p.value), false, "Prefix removed twice");
+        }
+
+      uint32_t address = (rng.Next () % 16) << 28 | (rng.Next () % 4) << 12 | (rng.Next () % 2);
+      uint8_t key[4] = { uint8_t (address >> 24), uint8_t (address >> 16), uint8_t (address >> 8), uint8_t (address) };
+      LpmTrie<uint32_t>::Values const *matches[33];
+      uint32_t n = trie.Match (key, 32, matches);
+
+      // the values of each matching length, in insertion order.
+      std::vector<uint32_t> got;
+      for (uint32_t k = 0; k < n; ++k)
+        {
+          got.insert (got.end (), matches[k]->begin (), matches[k]->end ());
+        }
+      std::vector<uint32_t> expected;
+      for (uint32_t length = 0; length <= 32; ++length)
+        {
+          for (uint32_t i = 0; i < prefixes.size (); ++i)
+            {
+              uint32_t mask = length == 0 ? 0 : 0xffffffff << (32 - length);
+              if (prefixes[i].length == length && (address & mask) == prefixes[i].key)
+                {
+                  expected.push_back (prefixes[i].value);
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (got.size (), expected.size (), "Wrong number of matches at round " << round);
+      for (uint32_t i = 0; i < got.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ (got[i], expected[i], "Wrong match at round " << round);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+class Ipv4StaticRoutingLpmTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLpmTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4StaticRoutingLpmTestCase::Ipv4StaticRoutingLpmTestCase ()
+  : TestCase ("Check that Ipv4StaticRouting selects the routes as a linear search")
+{
+}
+
+void
+Ipv4StaticRoutingLpmTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  Ptr<Ipv4StaticRouting> routing = CreateObject<Ipv4StaticRouting> ();
+  ipv4->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv4);
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)), Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+    }
+
+  Lcg rng;
+  for (uint32_t round = 0; round < 1000; ++round)
+    {
+      uint32_t action = rng.Next () % 8;
+      uint32_t interface = 1 + rng.Next () % 3;
+      Ipv4Address gateway (0xc0a80002 + ((interface - 1) << 8) + (rng.Next () % 8));
+      if (action < 5 || routing->GetNRoutes () < 4)
+        {
+          uint32_t length = rng.Next () % 33;
+          Ipv4Mask mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+          Ipv4Address network ((rng.Next () % 4) << 30 | (rng.Next () % 4) << 20 | (rng.Next () % 4));
+          routing->AddNetworkRouteTo (network, mask, gateway, interface, rng.Next () % 3);
+        }
+      else if (action == 5 && round % 50 == 0)
+        {
+          // a non-contiguous mask, removed below.
+          routing->AddNetworkRouteTo (Ipv4Address ("0.0.0.1"), Ipv4Mask ("0.0.0.255"), gateway, interface, 0);
+        }
+      else
+        {
+          routing->RemoveRoute (rng.Next () % routing->GetNRoutes ());
+        }
+
+      for (uint32_t i = 0; i < 4; ++i)
+        {
+          Ipv4Address dest ((rng.Next () % 4) << 30 | (rng.Next () % 4) << 20 | (rng.Next () % 4));
+          Ptr<NetDevice> oif = (i % 2 == 0) ? 0 : ipv4->GetNetDevice (1 + rng.Next () % 3);
+
+          // the linear search of the original implementation.
+          int32_t expected = -1;
+          uint16_t longestMask = 0;
+          uint32_t shortestMetric = 0xffffffff;
+          for (uint32_t j = 0; j < routing->GetNRoutes (); ++j)
+            {
+              Ipv4RoutingTableEntry route = routing->GetRoute (j);
+              uint32_t metric = routing->GetMetric (j);
+              uint16_t masklen = route.GetDestNetworkMask ().GetPrefixLength ();
+              if (!route.GetDestNetworkMask ().IsMatch (dest, route.GetDestNetwork ())
+                  || (oif != 0 && oif != ipv4->GetNetDevice (route.GetInterface ()))
+                  || masklen < longestMask)
+                {
+                  continue;
+                }
+              if (masklen > longestMask)
+                {
+                  shortestMetric = 0xffffffff;
+                }
+              longestMask = masklen;
+              if (metric > shortestMetric)
+                {
+                  continue;
+                }
+              shortestMetric = metric;
+              expected = j;
+            }
+
+          Ipv4Header header;
+          header.SetDestination (dest);
+          Socket::SocketErrno error;
+          Ptr<Ipv4Route> route = routing->RouteOutput (0, header, oif, error);
+          NS_TEST_ASSERT_MSG_EQ ((route != 0), (expected >= 0), "Route to " << dest << " at round " << round);
+          if (route != 0)
+            {
+              Ipv4RoutingTableEntry entry = routing->GetRoute (expected);
+              NS_TEST_ASSERT_MSG_EQ (route->GetGateway (), entry.GetGateway (), "Wrong route to " << dest << " at round " << round);
+              NS_TEST_ASSERT_MSG_EQ (route->GetOutputDevice (), ipv4->GetNetDevice (entry.GetInterface ()),
+                                     "Wrong device to " << dest << " at round " << round);
+            }
+        }
+    }
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class Ipv6StaticRoutingLpmTestCase : public TestCase
+{
+public:
+  Ipv6StaticRoutingLpmTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv6StaticRoutingLpmTestCase::Ipv6StaticRoutingLpmTestCase ()
+  : TestCase ("Check the longest prefix match of Ipv6StaticRouting")
+{
+}
+
+void
+Ipv6StaticRoutingLpmTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv6L3Protocol> ipv6 = CreateObject<Ipv6L3Protocol> ();
+  Ptr<Ipv6StaticRouting> routing = CreateObject<Ipv6StaticRouting> ();
+  ipv6->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv6);
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv6->AddInterface (device);
+      ipv6->SetUp (interface);
+    }
+
+  routing->SetDefaultRoute (Ipv6Address ("fe80::1"), 1);
+  routing->AddNetworkRouteTo (Ipv6Address ("2001:db8::"), Ipv6Prefix (32), Ipv6Address ("fe80::2"), 1, 5);
+  routing->AddNetworkRouteTo (Ipv6Address ("2001:db8::"), Ipv6Prefix (32), Ipv6Address ("fe80::3"), 2, 1);
+  routing->AddNetworkRouteTo (Ipv6Address ("2001:db8:1::"), Ipv6Prefix (48), Ipv6Address ("fe80::4"), 2, 0);
+  routing->AddHostRouteTo (Ipv6Address ("2001:db8:1::5"), Ipv6Address ("fe80::5"), 1, Ipv6Address ("::"), 0);
+
+  struct
+  {
+    char const *dest;
+    uint32_t oif;
+    char const *gateway;
+  } cases[] = {
+    { "2001:db8:1::5", 0, "fe80::5" },  // host route
+    { "2001:db8:1::6", 0, "fe80::4" },  // /48
+    { "2001:db8:1::5", 2, "fe80::4" },  // /128 on another interface
+    { "2001:db8:2::1", 0, "fe80::3" },  // /32, lowest metric
+    { "2001:db8:2::1", 1, "fe80::2" },  // /32 on the requested interface
+    { "2001:db9::1", 0, "fe80::1" },    // default route
+  };
+  for (uint32_t i = 0; i < sizeof (cases) / sizeof (cases[0]); ++i)
+    {
+      Ipv6Header header;
+      header.SetDestinationAddress (Ipv6Address (cases[i].dest));
+      Socket::SocketErrno error;
+      Ptr<NetDevice> oif = cases[i].oif == 0 ? 0 : ipv6->GetNetDevice (cases[i].oif);
+      Ptr<Ipv6Route> route = routing->RouteOutput (0, header, oif, error);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route to " << cases[i].dest);
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), Ipv6Address (cases[i].gateway), "Wrong route to " << cases[i].dest);
+    }
+
+  // the host route is the last one: removing it falls back to the /48.
+  routing->RemoveRoute (routing->GetNRoutes () - 1);
+  Ipv6Header header;
+  header.SetDestinationAddress (Ipv6Address ("2001:db8:1::5"));
+  Socket::SocketErrno error;
+  Ptr<Ipv6Route> route = routing->RouteOutput (0, header, 0, error);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to 2001:db8:1::5");
+  NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), Ipv6Address ("fe80::4"), "Wrong route after removal");
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class StaticRoutingLpmTestSuite : public TestSuite
+{
+public:
+  StaticRoutingLpmTestSuite () : TestSuite ("static-routing-lpm", UNIT)
+  {
+    AddTestCase (new LpmTrieTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4StaticRoutingLpmTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6StaticRoutingLpmTestCase, TestCase::QUICK);
+  }
+} g_staticRoutingLpmTestSuite;
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpRxBufferTestSuite");
+
+using namespace ns3;
+
+/**
+ * Adds overlapping segments of a stream to a TcpRxBuffer in random
+ * order, and checks the blocks and holes it reports, and the data it
+ * delivers, against a map of the bytes received.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the blocks and holes of the buffer against m_received.
+   *
+   * \param buffer the buffer
+   */
+  void CheckBlocks (TcpRxBuffer const &buffer);
+
+  std::vector<uint8_t> m_stream;  //!< The bytes of the stream
+  std::vector<bool> m_received;   //!< Whether each byte of the stream was received
+  uint32_t m_delivered;           //!< The number of bytes extracted from the buffer
+  SequenceNumber32 m_isn;         //!< The sequence number of the first byte of the stream
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("TcpRxBuffer reassembles segments received out of order")
+{
+}
+
+void
+TcpRxBufferTestCase::CheckBlocks (TcpRxBuffer const &buffer)
+{
+  // The expected blocks, from the first byte not received
+  uint32_t next = m_delivered;
+  while (next < m_stream.size () && m_received[next])
+    {
+      next++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextRxSequence (), m_isn + SequenceNumber32 (next), "Wrong RCV.NXT");
+  std::vector<TcpRxBuffer::Block> blocks;
+  std::vector<TcpRxBuffer::Block> holes;
+  uint32_t i = next;
+  while (i < m_stream.size ())
+    {
+      uint32_t start = i;
+      while (i < m_stream.size () && !m_received[i])
+        {
+          i++;
+        }
+      if (i == m_stream.size ())
+        {
+          break;
+        }
+      holes.push_back (TcpRxBuffer::Block (m_isn + SequenceNumber32 (start), m_isn + SequenceNumber32 (i)));
+      start = i;
+      while (i < m_stream.size () && m_received[i])
+        {
+          i++;
+        }
+      blocks.push_back (TcpRxBuffer::Block (m_isn + SequenceNumber32 (start), m_isn + SequenceNumber32 (i)));
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetNBlocks (), blocks.size (), "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ ((buffer.GetBlocks () == blocks), true, "Wrong blocks");
+  NS_TEST_ASSERT_MSG_EQ ((buffer.GetHoles () == holes), true, "Wrong holes");
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  const uint32_t size = 10000;
+  m_stream.resize (size);
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      m_stream[i] = rng->GetInteger (0, 255);
+    }
+  m_received.resize (size, false);
+  m_delivered = 0;
+  // An initial sequence number close to the wrap around
+  m_isn = SequenceNumber32 (0xffff0000);
+  TcpRxBuffer buffer (m_isn.GetValue ());
+  buffer.SetMaxBufferSize (65535);
+
+  TcpHeader header;
+  while (m_delivered < size)
+    {
+      // A segment somewhere in the window, often overlapping others
+      uint32_t start = m_delivered + rng->GetInteger (0, 4000);
+      uint32_t length = rng->GetInteger (1, 1500);
+      if (start >= size)
+        {
+          continue;
+        }
+      length = std::min (length, size - start);
+      header.SetSequenceNumber (m_isn + SequenceNumber32 (start));
+      bool added = buffer.Add (Create<Packet> (&m_stream[start], length), header);
+      bool expected = false;
+      for (uint32_t i = start; i < start + length && i < m_delivered + 65535; ++i)
+        {
+          expected = expected || !m_received[i];
+          m_received[i] = true;
+        }
+      NS_TEST_ASSERT_MSG_EQ (added, expected, "Wrong result of Add at " << start);
+      CheckBlocks (buffer);
+
+      // The application reads some of the data in sequence
+      Ptr<Packet> p = buffer.Extract (rng->GetInteger (1, 4000));
+      if (p != 0)
+        {
+          std::vector<uint8_t> data (p->GetSize ());
+          p->CopyData (&data[0], p->GetSize ());
+          for (uint32_t i = 0; i < data.size (); ++i)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((uint32_t)data[i], (uint32_t)m_stream[m_delivered + i],
+                                     "Wrong byte " << m_delivered + i << " delivered");
+            }
+          m_delivered += data.size ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer.Size (), (uint32_t)std::count (m_received.begin () + m_delivered, m_received.end (), true),
+                             "Wrong buffer occupancy");
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.Available (), 0u, "Data left in the buffer");
+}
+
+class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+} g_tcpRxBufferTestSuite;
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-sack-scoreboard.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackTestSuite");
+
+using namespace ns3;
+
+/**
+ * Serializes TCP headers with SACK and window scale options and checks the options
+ * survive the round trip through a packet.
+ */
+class TcpSackOptionTestCase : public TestCase
+{
+public:
+  TcpSackOptionTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpSackOptionTestCase::TcpSackOptionTestCase ()
+  : TestCase ("TcpHeader serializes the SACK and window scale options")
+{
+}
+
+void
+TcpSackOptionTestCase::DoRun (void)
+{
+  TcpHeader syn;
+  syn.SetFlags (TcpHeader::SYN);
+  syn.SetSackPermitted (true);
+  NS_TEST_ASSERT_MSG_EQ (syn.GetSerializedSize (), 24u, "Wrong size of a SYN with SACK-permitted");
+  Ptr<Packet> p = Create<Packet> (10);
+  p->AddHeader (syn);
+  TcpHeader received;
+  p->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (received.IsSackPermitted (), true, "SACK-permitted lost");
+  NS_TEST_ASSERT_MSG_EQ (received.GetSackBlocks ().size (), 0u, "Unexpected SACK blocks");
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 10u, "Wrong payload size");
+
+  syn.SetWindowScale (7);
+  NS_TEST_ASSERT_MSG_EQ (syn.GetSerializedSize (), 28u, "Wrong size of a SYN with window scale");
+  p = Create<Packet> ();
+  p->AddHeader (syn);
+  p->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (received.HasWindowScale (), true, "Window scale lost");
+  NS_TEST_ASSERT_MSG_EQ (received.GetWindowScale (), 7, "Wrong window scale");
+  NS_TEST_ASSERT_MSG_EQ (received.IsSackPermitted (), true, "SACK-permitted lost with window scale");
+
+  TcpHeader ack;
+  ack.SetFlags (TcpHeader::ACK);
+  ack.SetAckNumber (SequenceNumber32 (1000));
+  for (uint32_t i = 0; i < TcpHeader::MAX_SACK_BLOCKS; ++i)
+    {
+      ack.AddSackBlock (TcpHeader::SackBlock (SequenceNumber32 (2000 + 1000 * i),
+                                              SequenceNumber32 (2500 + 1000 * i)));
+    }
+  NS_TEST_ASSERT_MSG_EQ (ack.GetSerializedSize (), 20u + 4u + 8u * TcpHeader::MAX_SACK_BLOCKS,
+                         "Wrong size of an ACK with SACK blocks");
+  p = Create<Packet> ();
+  p->AddHeader (ack);
+  p->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (received.IsSackPermitted (), false, "Unexpected SACK-permitted");
+  NS_TEST_ASSERT_MSG_EQ (received.HasWindowScale (), false, "Unexpected window scale");
+  NS_TEST_ASSERT_MSG_EQ (received.GetAckNumber (), SequenceNumber32 (1000), "Wrong ACK number");
+  NS_TEST_ASSERT_MSG_EQ (received.GetSackBlocks ().size (), TcpHeader::MAX_SACK_BLOCKS, "Wrong number of SACK blocks");
+  for (uint32_t i = 0; i < received.GetSackBlocks ().size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (received.GetSackBlocks ()[i].first, SequenceNumber32 (2000 + 1000 * i), "Wrong SACK block");
+      NS_TEST_ASSERT_MSG_EQ (received.GetSackBlocks ()[i].second, SequenceNumber32 (2500 + 1000 * i), "Wrong SACK block");
+    }
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 0u, "Wrong payload size");
+
+  ack.ClearSackBlocks ();
+  NS_TEST_ASSERT_MSG_EQ (ack.GetSerializedSize (), 20u, "Options left after ClearSackBlocks");
+}
+
+/**
+ * Feeds ACKs with SACK blocks to a TcpSackScoreboard and checks the
+ * lost data and the pipe it reports.
+ */
+class TcpSackScoreboardTestCase : public TestCase
+{
+public:
+  TcpSackScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpSackScoreboardTestCase::TcpSackScoreboardTestCase ()
+  : TestCase ("TcpSackScoreboard finds the lost data and the pipe")
+{
+}
+
+void
+TcpSackScoreboardTestCase::DoRun (void)
+{
+  // Ten segments of 100 bytes sent from sequence number 0, of which the
+  // first and the fourth are lost.
+  TcpSackScoreboard scoreboard;
+  scoreboard.SetSegmentSize (100);
+  SequenceNumber32 head (0);
+  SequenceNumber32 highData (1000);
+  std::vector<TcpHeader::SackBlock> blocks;
+
+  // the second and third segments are SACKed: not enough for a loss
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (100), SequenceNumber32 (300)));
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.Update (head, highData, blocks), 200u, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetSackedBytes (), 200u, "Wrong SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.IsLost (SequenceNumber32 (0)), false, "Loss detected too early");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetPipe (head, highData, head), 800u, "Wrong pipe");
+
+  // the fifth segment makes three segments SACKed above the first one
+  blocks.clear ();
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (400), SequenceNumber32 (500)));
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (100), SequenceNumber32 (300)));
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.Update (head, highData, blocks), 100u, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetNBlocks (), 2u, "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.IsLost (SequenceNumber32 (0)), true, "First segment not lost");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.IsSacked (SequenceNumber32 (150)), true, "Second segment not SACKed");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.IsLost (SequenceNumber32 (300)), false, "Fourth segment lost too early");
+  SequenceNumber32 start;
+  uint32_t length;
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetNextLost (head, start, length), true, "No lost data");
+  NS_TEST_ASSERT_MSG_EQ (start, SequenceNumber32 (0), "Wrong lost data");
+  NS_TEST_ASSERT_MSG_EQ (length, 100u, "Wrong lost data length");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetPipe (head, highData, head), 600u, "Wrong pipe");
+  // once retransmitted, the first segment is in flight again
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetPipe (head, highData, SequenceNumber32 (100)), 700u, "Wrong pipe after retransmission");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetNextLost (SequenceNumber32 (100), start, length), false, "Unexpected lost data");
+
+  // three more segments SACKed above the fourth one
+  blocks.clear ();
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (400), SequenceNumber32 (800)));
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.Update (head, highData, blocks), 300u, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.IsLost (SequenceNumber32 (300)), true, "Fourth segment not lost");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetNextLost (SequenceNumber32 (100), start, length), true, "No lost data");
+  NS_TEST_ASSERT_MSG_EQ (start, SequenceNumber32 (300), "Wrong lost data");
+  NS_TEST_ASSERT_MSG_EQ (length, 100u, "Wrong lost data length");
+
+  // the retransmission of the first segment is acknowledged: the blocks
+  // below the cumulative ACK are forgotten
+  head = SequenceNumber32 (300);
+  blocks.clear ();
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (400), SequenceNumber32 (800)));
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.Update (head, highData, blocks), 0u, "Wrong newly SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetNBlocks (), 1u, "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetSackedBytes (), 400u, "Wrong SACKed bytes");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetPipe (head, highData, SequenceNumber32 (100)), 200u, "Wrong pipe");
+  // after a timeout, the data sent again from the head up to the middle
+  // of the block is in flight, but not the SACKed data above it
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetPipe (head, SequenceNumber32 (500), SequenceNumber32 (500)), 100u, "Wrong pipe after timeout");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.SkipSacked (SequenceNumber32 (500)), SequenceNumber32 (800), "SACKed data not skipped");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.SkipSacked (SequenceNumber32 (300)), SequenceNumber32 (300), "Lost data skipped");
+
+  scoreboard.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.GetSackedBytes (), 0u, "Blocks left after Clear");
+  NS_TEST_ASSERT_MSG_EQ (scoreboard.IsLost (SequenceNumber32 (300)), false, "Loss left after Clear");
+}
+
+class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ()
+    : TestSuite ("tcp-sack", UNIT)
+  {
+    AddTestCase (new TcpSackOptionTestCase, TestCase::QUICK);
+    AddTestCase (new TcpSackScoreboardTestCase, TestCase::QUICK);
+  }
+} g_tcpSackTestSuite;
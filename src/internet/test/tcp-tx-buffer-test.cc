@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpTxBufferTestSuite");
+
+using namespace ns3;
+
+/**
+ * Adds packets of random sizes to a TcpTxBuffer, extracts segments of
+ * random sizes from random sequence numbers and acknowledges the data
+ * in random steps, and checks the bytes of the segments against those
+ * added.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param buffer the buffer
+   * \param numBytes the number of bytes to extract
+   * \param seq the sequence number of the first byte to extract
+   */
+  void CheckCopy (Ptr<TcpTxBuffer> buffer, uint32_t numBytes, SequenceNumber32 seq);
+
+  std::vector<uint8_t> m_stream; //!< The bytes added to the buffer
+  SequenceNumber32 m_isn;        //!< The sequence number of the first byte of the stream
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Segments extracted from TcpTxBuffer hold the data added to it")
+{
+}
+
+void
+TcpTxBufferTestCase::CheckCopy (Ptr<TcpTxBuffer> buffer, uint32_t numBytes, SequenceNumber32 seq)
+{
+  Ptr<Packet> p = buffer->CopyFromSequence (numBytes, seq);
+  uint32_t expected = std::min (numBytes, buffer->SizeFromSequence (seq));
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), expected, "Wrong size of segment at " << seq);
+  std::vector<uint8_t> data (expected + 1);
+  p->CopyData (&data[0], expected);
+  uint32_t start = seq - m_isn;
+  for (uint32_t i = 0; i < expected; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t)data[i], (uint32_t)m_stream[start + i],
+                             "Wrong byte " << i << " of segment at " << seq);
+    }
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  // An initial sequence number close to the wrap around
+  m_isn = SequenceNumber32 (0xffff0000);
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> ();
+  buffer->SetHeadSequence (m_isn);
+  buffer->SetMaxBufferSize (16384);
+
+  for (uint32_t step = 0; step < 5000; ++step)
+    {
+      uint32_t size = rng->GetInteger (1, 2000);
+      std::vector<uint8_t> data (size);
+      for (uint32_t i = 0; i < size; ++i)
+        {
+          data[i] = rng->GetInteger (0, 255);
+        }
+      Ptr<Packet> p = Create<Packet> (&data[0], size);
+      if (buffer->Add (p))
+        {
+          m_stream.insert (m_stream.end (), data.begin (), data.end ());
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer->TailSequence (), m_isn + SequenceNumber32 (m_stream.size ()),
+                             "Wrong tail sequence");
+
+      for (uint32_t k = 0; k < 4 && buffer->Size () > 0; ++k)
+        {
+          uint32_t offset = rng->GetInteger (0, buffer->Size () - 1);
+          CheckCopy (buffer, rng->GetInteger (1, 3000), buffer->HeadSequence () + SequenceNumber32 (offset));
+        }
+      CheckCopy (buffer, 536, buffer->TailSequence ());
+
+      uint32_t acked = rng->GetInteger (0, std::min (buffer->Size (), 3000u));
+      SequenceNumber32 head = buffer->HeadSequence () + SequenceNumber32 (acked);
+      buffer->DiscardUpTo (head);
+      NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), head, "Wrong head sequence");
+      NS_TEST_ASSERT_MSG_EQ (buffer->Size (), static_cast<uint32_t> (buffer->TailSequence () - head), "Wrong size");
+    }
+
+  // Acknowledge all the data and a FIN
+  SequenceNumber32 fin = buffer->TailSequence () + SequenceNumber32 (1);
+  buffer->DiscardUpTo (fin);
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0u, "Data left in the buffer");
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), fin, "Wrong head sequence after the FIN");
+}
+
+class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase, TestCase::QUICK);
+  }
+} g_tcpTxBufferTestSuite;
@@ -19,6 +19,7 @@
 #include <stdint.h>
 #include <string>
 #include <fstream>
+#include <algorithm>
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
@@ -28,6 +29,7 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/binary-trace-writer.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +37,28 @@ NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
 namespace ns3 {
 
+//
+// Apply the filter of the stream, if any, and write the event in binary
+// form if the stream is binary.  Returns true if the default sink has
+// nothing left to do.
+//
+static bool
+FilterOrWriteBinary (Ptr<OutputStreamWrapper> stream, char event, std::string const &context, Ptr<const Packet> p)
+{
+  Ptr<TraceFilter> filter = stream->GetTraceFilter ();
+  if (filter != 0 && !filter->Match (p))
+    {
+      return true;
+    }
+  Ptr<BinaryTraceWriter> writer = stream->GetBinaryTraceWriter ();
+  if (writer != 0)
+    {
+      writer->Write (event, context, p);
+      return true;
+    }
+  return false;
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -59,6 +83,15 @@ PcapHelper::CreateFile (
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
+  if (m_filter != 0)
+    {
+      file->SetTraceFilter (m_filter->Copy ());
+      if (m_filter->GetSnapLen () != 0)
+        {
+          snapLen = std::min (snapLen, m_filter->GetSnapLen ());
+        }
+    }
+
   file->Init (dataLinkType, snapLen, tzCorrection);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Init " << filename);
 
@@ -76,6 +109,13 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::SetTraceFilter (Ptr<TraceFilter> filter)
+{
+  NS_LOG_FUNCTION (filter);
+  m_filter = filter;
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -186,6 +226,10 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   NS_LOG_FUNCTION (filename << filemode);
 
   Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
+  if (m_filter != 0)
+    {
+      StreamWrapper->SetTraceFilter (m_filter->Copy ());
+    }
 
   //
   // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -201,6 +245,23 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+void
+AsciiTraceHelper::SetTraceFilter (Ptr<TraceFilter> filter)
+{
+  NS_LOG_FUNCTION (filter);
+  m_filter = filter;
+}
+
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, bool snapshots)
+{
+  NS_LOG_FUNCTION (filename << snapshots);
+
+  Ptr<OutputStreamWrapper> streamWrapper = Create<OutputStreamWrapper> (filename, std::ios::out | std::ios::binary);
+  streamWrapper->SetBinaryTraceWriter (Create<BinaryTraceWriter> (streamWrapper->GetStream (), snapshots));
+  return streamWrapper;
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -303,6 +364,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, '+', "", p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -310,6 +375,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, '+', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -329,6 +398,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, 'd', "", p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -336,6 +409,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, 'd', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -356,6 +433,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, '-', "", p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -363,6 +444,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, '-', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -380,6 +465,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, 'r', "", p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -387,6 +476,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (FilterOrWriteBinary (stream, 'r', context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -413,6 +506,24 @@ PcapHelperForDevice::EnablePcap (std::string prefix, NetDeviceContainer d, bool
     }
 }
 
+void
+PcapHelperForDevice::EnablePcap (std::string prefix, Ptr<NetDevice> nd, Ptr<TraceFilter> filter,
+                                 bool promiscuous, bool explicitFilename)
+{
+  m_pcapFilter = filter;
+  EnablePcapInternal (prefix, nd, promiscuous, explicitFilename);
+  m_pcapFilter = 0;
+}
+
+void
+PcapHelperForDevice::EnablePcap (std::string prefix, NetDeviceContainer d, Ptr<TraceFilter> filter, bool promiscuous)
+{
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      EnablePcap (prefix, *i, filter, promiscuous);
+    }
+}
+
 void
 PcapHelperForDevice::EnablePcap (std::string prefix, NodeContainer n, bool promiscuous)
 {
@@ -464,6 +575,29 @@ AsciiTraceHelperForDevice::EnableAscii (std::string prefix, Ptr<NetDevice> nd, b
   EnableAsciiInternal (Ptr<OutputStreamWrapper> (), prefix, nd, explicitFilename);
 }
 
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::EnableAscii (std::string prefix, Ptr<NetDevice> nd, Ptr<TraceFilter> filter, bool explicitFilename)
+{
+  m_asciiFilter = filter;
+  EnableAsciiInternal (Ptr<OutputStreamWrapper> (), prefix, nd, explicitFilename);
+  m_asciiFilter = 0;
+}
+
+//
+// Public API
+//
+void
+AsciiTraceHelperForDevice::EnableAscii (std::string prefix, NetDeviceContainer d, Ptr<TraceFilter> filter)
+{
+  for (NetDeviceContainer::Iterator i = d.Begin (); i != d.End (); ++i)
+    {
+      EnableAscii (prefix, *i, filter);
+    }
+}
+
 //
 // Public API
 //
@@ -25,6 +25,7 @@
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/trace-filter.h"
 
 namespace ns3 {
 
@@ -82,6 +83,12 @@ public:
    */
   Ptr<PcapFileWrapper> CreateFile (std::string filename, std::ios::openmode filemode,
                                    uint32_t dataLinkType,  uint32_t snapLen = 65535, int32_t tzCorrection = 0);
+  /**
+   * @brief Set the filter copied to each pcap file created by this helper.
+   *
+   * @param filter The filter, or zero to write all the packets.
+   */
+  void SetTraceFilter (Ptr<TraceFilter> filter);
   /**
    * @brief Hook a trace source to the default trace sink
    */
@@ -89,6 +96,7 @@ public:
 
 private:
   static void DefaultSink (Ptr<PcapFileWrapper> file, Ptr<const Packet> p);
+  Ptr<TraceFilter> m_filter;
 };
 
 template <typename T> void
@@ -155,6 +163,23 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create an output stream object to which the default trace sinks
+   * write compact binary records instead of formatted text.
+   *
+   * The stream can be passed to the EnableAscii methods which take a
+   * Ptr<OutputStreamWrapper>. The resulting file can be converted back to
+   * the ascii format with BinaryTraceWriter::ConvertToAscii or with the
+   * binary-trace-to-ascii program. Only the default trace sinks know about
+   * the binary format: the stream must not be given to trace sinks which
+   * write directly to its std::ostream.
+   *
+   * @param filename the name of the file to create.
+   * @param snapshots whether to store the serialized packet of each event,
+   * which is required to convert the trace back to the exact ascii output.
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename, bool snapshots = true);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -226,6 +251,17 @@ public:
 
   static void DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> file, Ptr<const Packet> p);
   static void DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> file, std::string context, Ptr<const Packet> p);
+
+  /**
+   * @brief Set the filter copied to each ascii trace file created by this
+   * helper.
+   *
+   * @param filter The filter, or zero to write the events of all the packets.
+   */
+  void SetTraceFilter (Ptr<TraceFilter> filter);
+
+private:
+  Ptr<TraceFilter> m_filter;
 };
 
 template <typename T> void
@@ -375,6 +411,33 @@ public:
    */
   void EnablePcap (std::string prefix, NetDeviceContainer d, bool promiscuous = false);
 
+  /**
+   * @brief Enable pcap output on the indicated net device, writing only the
+   * packets selected by a filter.
+   *
+   * The filter is applied before the packets are serialized, and its snap
+   * length, if any, replaces the snap length of the file.
+   *
+   * @param prefix Filename prefix to use for pcap files.
+   * @param nd Net device for which you want to enable tracing.
+   * @param filter The filter copied to each pcap file created for the device.
+   * @param promiscuous If true capture all possible packets available at the device.
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  void EnablePcap (std::string prefix, Ptr<NetDevice> nd, Ptr<TraceFilter> filter,
+                   bool promiscuous = false, bool explicitFilename = false);
+
+  /**
+   * @brief Enable pcap output on each device in the container which is of the
+   * appropriate type, writing only the packets selected by a filter.
+   *
+   * @param prefix Filename prefix to use for pcap files.
+   * @param d container of devices
+   * @param filter The filter copied to each pcap file created.
+   * @param promiscuous If true capture all possible packets available at the device.
+   */
+  void EnablePcap (std::string prefix, NetDeviceContainer d, Ptr<TraceFilter> filter, bool promiscuous = false);
+
   /**
    * @brief Enable pcap output on each device (which is of the appropriate type)
    * in the nodes provided in the container.
@@ -404,6 +467,13 @@ public:
    * @param promiscuous If true capture all possible packets available at the device.
    */
   void EnablePcapAll (std::string prefix, bool promiscuous = false);
+
+protected:
+  /**
+   * The filter given to EnablePcap while EnablePcapInternal runs, or zero.
+   * The implementations of EnablePcapInternal give it to their PcapHelper.
+   */
+  Ptr<TraceFilter> m_pcapFilter;
 };
 
 /**
@@ -461,6 +531,28 @@ public:
    */
   void EnableAscii (std::string prefix, Ptr<NetDevice> nd, bool explicitFilename = false);
 
+  /**
+   * @brief Enable ascii trace output on the indicated net device, writing only
+   * the events of the packets selected by a filter.
+   *
+   * @param prefix Filename prefix to use for ascii files.
+   * @param nd Net device for which you want to enable tracing.
+   * @param filter The filter copied to each ascii file created for the device.
+   * @param explicitFilename Treat the prefix as an explicit filename if true
+   */
+  void EnableAscii (std::string prefix, Ptr<NetDevice> nd, Ptr<TraceFilter> filter, bool explicitFilename = false);
+
+  /**
+   * @brief Enable ascii trace output on each device in the container which is
+   * of the appropriate type, writing only the events of the packets selected by
+   * a filter.
+   *
+   * @param prefix Filename prefix to use for ascii files.
+   * @param d container of devices
+   * @param filter The filter copied to each ascii file created.
+   */
+  void EnableAscii (std::string prefix, NetDeviceContainer d, Ptr<TraceFilter> filter);
+
   /**
    * @brief Enable ascii trace output on the indicated net device.
    *
@@ -571,6 +663,14 @@ public:
    */
   void EnableAscii (Ptr<OutputStreamWrapper> stream, uint32_t nodeid, uint32_t deviceid);
 
+protected:
+  /**
+   * The filter given to EnableAscii while EnableAsciiInternal runs, or zero.
+   * The implementations of EnableAsciiInternal give it to their
+   * AsciiTraceHelper.
+   */
+  Ptr<TraceFilter> m_asciiFilter;
+
 private:
   /**
    * @internal Avoid code duplication.
@@ -17,10 +17,18 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include <algorithm>
+#include <cstring>
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
+#if defined (__AVX2__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
@@ -41,6 +49,84 @@ static struct Zeroes
   const uint32_t size;
 } g_zeroes;
 
+/**
+ * \returns the ones' complement sum of the 16-bit words of the buffer,
+ *          loaded in the byte order of the host, folded to 16 bits.
+ * \param data the start of the words.
+ * \param size the number of bytes to sum, even.
+ *
+ * The sum is independent of the alignment of data. The vectorized
+ * versions accumulate the words in 32-bit lanes, which cannot overflow
+ * within the 64KiB blocks the buffer is split into.
+ */
+uint16_t
+SumWords (uint8_t const *data, uint32_t size)
+{
+  uint64_t sum = 0;
+  while (size > 0)
+    {
+      uint32_t block = size < 0x10000 ? size : 0x10000;
+      uint8_t const *end = data + block;
+      size -= block;
+#if defined (__AVX2__)
+      __m256i zero = _mm256_setzero_si256 ();
+      __m256i acc = zero;
+      for (; data + 32 <= end; data += 32)
+        {
+          __m256i v = _mm256_loadu_si256 ((__m256i const *)data);
+          acc = _mm256_add_epi32 (acc, _mm256_unpacklo_epi16 (v, zero));
+          acc = _mm256_add_epi32 (acc, _mm256_unpackhi_epi16 (v, zero));
+        }
+      uint32_t lanes[8];
+      _mm256_storeu_si256 ((__m256i *)lanes, acc);
+      for (uint32_t i = 0; i < 8; ++i)
+        {
+          sum += lanes[i];
+        }
+#elif defined (__SSE2__)
+      __m128i zero = _mm_setzero_si128 ();
+      __m128i acc = zero;
+      for (; data + 16 <= end; data += 16)
+        {
+          __m128i v = _mm_loadu_si128 ((__m128i const *)data);
+          acc = _mm_add_epi32 (acc, _mm_unpacklo_epi16 (v, zero));
+          acc = _mm_add_epi32 (acc, _mm_unpackhi_epi16 (v, zero));
+        }
+      uint32_t lanes[4];
+      _mm_storeu_si128 ((__m128i *)lanes, acc);
+      for (uint32_t i = 0; i < 4; ++i)
+        {
+          sum += lanes[i];
+        }
+#endif
+      // the portable version, and the tail of the vectorized versions.
+      for (; data + 8 <= end; data += 8)
+        {
+          uint64_t v;
+          std::memcpy (&v, data, 8);
+          sum += (v & 0xffffffff) + (v >> 32);
+        }
+      for (; data < end; data += 2)
+        {
+          uint16_t v;
+          std::memcpy (&v, data, 2);
+          sum += v;
+        }
+    }
+  while (sum >> 16)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  return sum;
+}
+
+bool
+IsLittleEndian (void)
+{
+  uint16_t one = 1;
+  return *(uint8_t const *)&one == 1;
+}
+
 }
 
 namespace ns3 {
@@ -411,17 +497,38 @@ void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
-  if (m_data->m_count == 1 &&
-      m_end == m_zeroAreaEnd &&
-      m_end == m_data->m_dirtyEnd &&
+  if (m_end == m_zeroAreaEnd &&
       o.m_start == o.m_zeroAreaStart &&
-      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0 &&
+      ((m_data->m_count == 1 && m_end == m_data->m_dirtyEnd) || o.m_end == o.m_zeroAreaEnd))
     {
       /**
        * This is an optimization which kicks in when
        * we attempt to aggregate two buffers which contain
        * adjacent zero areas.
        */
+      if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+          /* The data is shared, e.g. by the fragments of a payload,
+           * and the other buffer is only zeros: copy the real bytes,
+           * but not the zero area.
+           */
+          struct Buffer::Data *newData = Buffer::Create (GetInternalSize ());
+          memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
+          m_data->m_count--;
+          if (m_data->m_count == 0)
+            {
+              Buffer::Recycle (m_data);
+            }
+          m_data = newData;
+          int32_t delta = -m_start;
+          m_zeroAreaStart += delta;
+          m_zeroAreaEnd += delta;
+          m_end += delta;
+          m_start += delta;
+          m_data->m_dirtyStart = m_start;
+          m_data->m_dirtyEnd = m_end;
+        }
       uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
       m_zeroAreaEnd += zeroSize;
       m_end = m_zeroAreaEnd;
@@ -735,6 +842,19 @@ Buffer::PeekData (void) const
   return m_data->m_data + m_start;
 }
 
+uint8_t const*
+Buffer::PeekContiguousData (uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (CheckInternalState ());
+  if (m_zeroAreaStart - m_start >= size ||
+      (m_zeroAreaStart == m_zeroAreaEnd && m_end - m_start >= size))
+    {
+      return m_data->m_data + m_start;
+    }
+  return 0;
+}
+
 void
 Buffer::CopyData (std::ostream *os, uint32_t size) const
 {
@@ -1165,14 +1285,65 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
 {
   NS_LOG_FUNCTION (this << size << initialChecksum);
-  /* see RFC 1071 to understand this code. */
-  uint32_t sum = initialChecksum;
-
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
-
-  if (size & 1)
-    sum += ReadU8 ();
+  NS_ASSERT_MSG (m_current >= m_dataStart &&
+                 m_current + size <= m_dataEnd,
+                 GetReadErrorMessage ());
+  /* see RFC 1071 to understand this code. The words are read as ReadU16
+   * reads them, that is, the first byte of each word is the low-order
+   * byte, and the contiguous spans before and after the zero area are
+   * summed at once.
+   */
+  uint64_t sum = initialChecksum;
+  // whether the next byte is the high-order byte of a word.
+  bool odd = false;
+  uint32_t remaining = size;
+  while (remaining > 0)
+    {
+      uint8_t const *data;
+      uint32_t span;
+      if (m_current < m_zeroStart)
+        {
+          data = m_data + m_current;
+          span = std::min (remaining, m_zeroStart - m_current);
+        }
+      else if (m_current < m_zeroEnd)
+        {
+          data = 0;
+          span = std::min (remaining, m_zeroEnd - m_current);
+        }
+      else
+        {
+          data = m_data + m_current - (m_zeroEnd - m_zeroStart);
+          span = remaining;
+        }
+      m_current += span;
+      remaining -= span;
+      if (data == 0)
+        {
+          odd ^= (span & 1);
+          continue;
+        }
+      uint8_t const *end = data + span;
+      if (odd)
+        {
+          sum += *data << 8;
+          data++;
+          odd = false;
+        }
+      uint32_t words = (end - data) & ~1U;
+      uint16_t partial = SumWords (data, words);
+      if (!IsLittleEndian ())
+        {
+          partial = (partial >> 8) | (partial << 8);
+        }
+      sum += partial;
+      data += words;
+      if (data < end)
+        {
+          sum += *data;
+          odd = true;
+        }
+    }
 
   while (sum >> 16)
     sum = (sum & 0xffff) + (sum >> 16);
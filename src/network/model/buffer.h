@@ -413,6 +413,18 @@ private:
    */
   uint8_t const*PeekData (void) const;
 
+  /**
+   * \param size the number of bytes requested.
+   * \return a pointer to the first \p size bytes of this buffer, or
+   *         zero if these bytes are not stored contiguously.
+   *
+   * Unlike Buffer::PeekData, this method never modifies the
+   * internal representation of the buffer: it fails if the
+   * requested bytes overlap the virtual zero area. The returned
+   * pointer is invalidated by any modification of this buffer.
+   */
+  uint8_t const*PeekContiguousData (uint32_t size) const;
+
   /**
    * \param start size to reserve
    * \returns true if the buffer needed resizing, false otherwise.
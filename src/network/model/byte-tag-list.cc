@@ -92,8 +92,8 @@ ByteTagList::Iterator::PrepareForNext (void)
       TagBuffer buf = TagBuffer (m_current, m_end);
       m_nextTid = buf.ReadU32 ();
       m_nextSize = buf.ReadU32 ();
-      m_nextStart = buf.ReadU32 ();
-      m_nextEnd = buf.ReadU32 ();
+      m_nextStart = buf.ReadU32 () + m_adjustment;
+      m_nextEnd = buf.ReadU32 () + m_adjustment;
       if (m_nextStart >= m_offsetEnd || m_nextEnd <= m_offsetStart)
         {
           m_current += 4 + 4 + 4 + 4 + m_nextSize;
@@ -104,13 +104,15 @@ ByteTagList::Iterator::PrepareForNext (void)
         }
     }
 }
-ByteTagList::Iterator::Iterator (uint8_t *start, uint8_t *end, int32_t offsetStart, int32_t offsetEnd)
+ByteTagList::Iterator::Iterator (uint8_t *start, uint8_t *end, int32_t offsetStart, int32_t offsetEnd,
+                                 int32_t adjustment)
   : m_current (start),
     m_end (end),
     m_offsetStart (offsetStart),
-    m_offsetEnd (offsetEnd)
+    m_offsetEnd (offsetEnd),
+    m_adjustment (adjustment)
 {
-  NS_LOG_FUNCTION (this << &start << &end << offsetStart << offsetEnd);
+  NS_LOG_FUNCTION (this << &start << &end << offsetStart << offsetEnd << adjustment);
   PrepareForNext ();
 }
 
@@ -124,12 +126,14 @@ ByteTagList::Iterator::GetOffsetStart (void) const
 
 ByteTagList::ByteTagList ()
   : m_used (0),
+    m_adjustment (0),
     m_data (0)
 {
   NS_LOG_FUNCTION (this);
 }
 ByteTagList::ByteTagList (const ByteTagList &o)
   : m_used (o.m_used),
+    m_adjustment (o.m_adjustment),
     m_data (o.m_data)
 {
   NS_LOG_FUNCTION (this << &o);
@@ -149,6 +153,7 @@ ByteTagList::operator = (const ByteTagList &o)
   Deallocate (m_data);
   m_data = o.m_data;
   m_used = o.m_used;
+  m_adjustment = o.m_adjustment;
   if (m_data != 0)
     {
       m_data->count++;
@@ -186,8 +191,8 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
                              &m_data->data[spaceNeeded]);
   tag.WriteU32 (tid.GetUid ());
   tag.WriteU32 (bufferSize);
-  tag.WriteU32 (start);
-  tag.WriteU32 (end);
+  tag.WriteU32 (start - m_adjustment);
+  tag.WriteU32 (end - m_adjustment);
   m_used = spaceNeeded;
   m_data->dirty = m_used;
   return tag;
@@ -213,6 +218,7 @@ ByteTagList::RemoveAll (void)
   Deallocate (m_data);
   m_data = 0;
   m_used = 0;
+  m_adjustment = 0;
 }
 
 ByteTagList::Iterator 
@@ -230,11 +236,12 @@ ByteTagList::Begin (int32_t offsetStart, int32_t offsetEnd) const
   NS_LOG_FUNCTION (this << offsetStart << offsetEnd);
   if (m_data == 0)
     {
-      return Iterator (0, 0, offsetStart, offsetEnd);
+      return Iterator (0, 0, offsetStart, offsetEnd, m_adjustment);
     }
   else
     {
-      return Iterator (m_data->data, &m_data->data[m_used], offsetStart, offsetEnd);
+      return Iterator (m_data->data, &m_data->data[m_used], offsetStart, offsetEnd,
+                       m_adjustment);
     }
 }
 
@@ -274,7 +281,8 @@ void
 ByteTagList::AddAtEnd (int32_t adjustment, int32_t appendOffset)
 {
   NS_LOG_FUNCTION (this << adjustment << appendOffset);
-  if (adjustment == 0 && !IsDirtyAtEnd (appendOffset))
+  m_adjustment += adjustment;
+  if (!IsDirtyAtEnd (appendOffset))
     {
       return;
     }
@@ -283,8 +291,6 @@ ByteTagList::AddAtEnd (int32_t adjustment, int32_t appendOffset)
   while (i.HasNext ())
     {
       ByteTagList::Iterator::Item item = i.Next ();
-      item.start += adjustment;
-      item.end += adjustment;
 
       if (item.start >= appendOffset)
         {
@@ -308,7 +314,8 @@ void
 ByteTagList::AddAtStart (int32_t adjustment, int32_t prependOffset)
 {
   NS_LOG_FUNCTION (this << adjustment << prependOffset);
-  if (adjustment == 0 && !IsDirtyAtStart (prependOffset))
+  m_adjustment += adjustment;
+  if (!IsDirtyAtStart (prependOffset))
     {
       return;
     }
@@ -317,8 +324,6 @@ ByteTagList::AddAtStart (int32_t adjustment, int32_t prependOffset)
   while (i.HasNext ())
     {
       ByteTagList::Iterator::Item item = i.Next ();
-      item.start += adjustment;
-      item.end += adjustment;
 
       if (item.end <= prependOffset)
         {
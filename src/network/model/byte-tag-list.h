@@ -59,6 +59,12 @@ struct ByteTagListData;
  *     the Packet class calls ByteTagList::AddAtEnd and ByteTagList::AddAtStart to update
  *     the byte offsets of each tag in the ByteTagList.
  *
+ *   - The offsets stored in the tag byte buffer are relative to m_adjustment,
+ *     which is private to each ByteTagList instance. Shifting the origin of
+ *     the offsets thus only updates m_adjustment: the tag byte buffer is
+ *     rewritten (and unshared) only when some tags actually need to be
+ *     trimmed or dropped because they overlap the newly-added bytes.
+ *
  *   - Whenever bytes are removed from the packet byte buffer, the ByteTagList offsets
  *     are never updated because we rely on the fact that they will be updated in
  *     either the next call to Packet::AddHeader or Packet::AddTrailer or when
@@ -89,12 +95,14 @@ private:
     uint32_t GetOffsetStart (void) const;
 private:
     friend class ByteTagList;
-    Iterator (uint8_t *start, uint8_t *end, int32_t offsetStart, int32_t offsetEnd);
+    Iterator (uint8_t *start, uint8_t *end, int32_t offsetStart, int32_t offsetEnd,
+              int32_t adjustment);
     void PrepareForNext (void);
     uint8_t *m_current;
     uint8_t *m_end;
     int32_t m_offsetStart;
     int32_t m_offsetEnd;
+    int32_t m_adjustment;
     uint32_t m_nextTid;
     uint32_t m_nextSize;
     int32_t m_nextStart;
@@ -162,6 +170,7 @@ private:
   void Deallocate (struct ByteTagListData *data);
 
   uint16_t m_used;
+  int32_t m_adjustment;
   struct ByteTagListData *m_data;
 };
 
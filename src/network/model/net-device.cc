@@ -42,4 +42,10 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SupportsSegmentOffload (void) const
+{
+  return false;
+}
+
 } // namespace ns3
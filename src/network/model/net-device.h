@@ -331,6 +331,16 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface transmits a packet with a
+   * SegmentOffloadTag as all the packets it stands for, whatever its
+   * size, false otherwise.
+   *
+   * The packets larger than the MTU which are sent through the other
+   * interfaces are fragmented.  The default implementation returns false.
+   */
+  virtual bool SupportsSegmentOffload (void) const;
+
 };
 
 } // namespace ns3
@@ -34,9 +34,12 @@ namespace ns3 {
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
+uint32_t PacketMetadata::m_samplingInterval = 1;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+PacketMetadata::DataFreeList PacketMetadata::m_freeLists[PacketMetadata::SIZE_CLASSES];
+// m_count starts at one so that this buffer is never recycled and,
+// with m_size set to zero, any attempt to write to it triggers a copy.
+struct PacketMetadata::Data PacketMetadata::m_emptyData = { 1, 0, 0, { 0 } };
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -70,6 +73,31 @@ PacketMetadata::EnableChecking (void)
   m_enableChecking = true;
 }
 
+void
+PacketMetadata::EnableSampling (uint32_t interval)
+{
+  NS_LOG_FUNCTION (interval);
+  NS_ASSERT (interval > 0);
+  Enable ();
+  m_samplingInterval = interval;
+}
+
+void
+PacketMetadata::Skip (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_data->m_count--;
+  if (m_data->m_count == 0)
+    {
+      PacketMetadata::Recycle (m_data);
+    }
+  m_data = &m_emptyData;
+  m_emptyData.m_count++;
+  m_head = 0xffff;
+  m_tail = 0xffff;
+  m_used = 0;
+}
+
 void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
@@ -184,6 +212,15 @@ PacketMetadata::GetUleb128Size (uint32_t value) const
   return 5;
 }
 uint32_t
+PacketMetadata::GetPacketUidDelta (uint64_t packetUid) const
+{
+  NS_LOG_FUNCTION (this << packetUid);
+  // zigzag encoding: small positive and negative differences
+  // both map to small unsigned values.
+  int32_t delta = static_cast<int32_t> (packetUid - m_packetUid);
+  return (static_cast<uint32_t> (delta) << 1) ^ static_cast<uint32_t> (delta >> 31);
+}
+uint32_t
 PacketMetadata::ReadUleb128 (const uint8_t **pBuffer) const
 {
   NS_LOG_FUNCTION (this << &pBuffer);
@@ -416,7 +453,9 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   uint32_t sizeSize = GetUleb128Size (item->size);
   uint32_t fragStartSize = GetUleb128Size (extraItem->fragmentStart);
   uint32_t fragEndSize = GetUleb128Size (extraItem->fragmentEnd);
-  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
+  uint32_t packetUidDelta = GetPacketUidDelta (extraItem->packetUid);
+  uint32_t packetUidSize = GetUleb128Size (packetUidDelta);
+  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + packetUidSize;
 
   if (m_used + n > m_data->m_size ||
       (m_head != 0xffff &&
@@ -442,7 +481,7 @@ PacketMetadata::AddBig (uint32_t next, uint32_t prev,
   buffer += fragStartSize;
   AppendValue (extraItem->fragmentEnd, buffer);
   buffer += fragEndSize;
-  Append32 (extraItem->packetUid, buffer);
+  AppendValue (packetUidDelta, buffer);
 
   return n;
 }
@@ -480,7 +519,9 @@ PacketMetadata::ReplaceTail (PacketMetadata::SmallItem *item,
   uint32_t sizeSize = GetUleb128Size (item->size);
   uint32_t fragStartSize = GetUleb128Size (extraItem->fragmentStart);
   uint32_t fragEndSize = GetUleb128Size (extraItem->fragmentEnd);
-  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
+  uint32_t packetUidDelta = GetPacketUidDelta (extraItem->packetUid);
+  uint32_t packetUidSize = GetUleb128Size (packetUidDelta);
+  uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + packetUidSize;
 
   if (available >= n &&
       m_data->m_count == 1)
@@ -500,7 +541,8 @@ PacketMetadata::ReplaceTail (PacketMetadata::SmallItem *item,
       buffer += fragStartSize;
       AppendValue (extraItem->fragmentEnd, buffer);
       buffer += fragEndSize;
-      Append32 (extraItem->packetUid, buffer);
+      AppendValue (packetUidDelta, buffer);
+      buffer += packetUidSize;
       m_used = std::max (m_used, (uint16_t)(buffer - &m_data->m_data[0]));
       m_data->m_dirtyEnd = m_used;
       return;
@@ -562,11 +604,9 @@ PacketMetadata::ReadItems (uint16_t current,
     {
       extraItem->fragmentStart = ReadUleb128 (&buffer);
       extraItem->fragmentEnd = ReadUleb128 (&buffer);
-      extraItem->packetUid = buffer[0];
-      extraItem->packetUid |= buffer[1] << 8;
-      extraItem->packetUid |= buffer[2] << 16;
-      extraItem->packetUid |= buffer[3] << 24;
-      buffer += 4;
+      uint32_t packetUidDelta = ReadUleb128 (&buffer);
+      int32_t delta = static_cast<int32_t> ((packetUidDelta >> 1) ^ (~(packetUidDelta & 0x1) + 1));
+      extraItem->packetUid = m_packetUid + delta;
     }
   else
     {
@@ -578,51 +618,59 @@ PacketMetadata::ReadItems (uint16_t current,
   return buffer - &m_data->m_data[current];
 }
 
-struct PacketMetadata::Data *
-PacketMetadata::Create (uint32_t size)
+uint32_t
+PacketMetadata::GetSizeClass (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
-  NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
-  if (size > m_maxSize)
-    {
-      m_maxSize = size;
-    }
-  while (!m_freeList.empty ()) 
+  uint32_t sizeClass = 0;
+  while (sizeClass < SIZE_CLASSES - 1 &&
+         (16U << sizeClass) < size)
     {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
-      if (data->m_size >= size) 
-        {
-          NS_LOG_LOGIC ("create found size="<<data->m_size);
-          data->m_count = 1;
-          return data;
-        }
-      PacketMetadata::Deallocate (data);
-      NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
+      sizeClass++;
     }
-  NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
-  return PacketMetadata::Allocate (m_maxSize);
+  return sizeClass;
+}
+
+struct PacketMetadata::Data *
+PacketMetadata::Create (uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+  NS_ASSERT (size <= 0xffff);
+  uint32_t sizeClass = GetSizeClass (size);
+  DataFreeList &freeList = m_freeLists[sizeClass];
+  NS_LOG_LOGIC ("create size="<<size<<", class="<<sizeClass<<", list="<<freeList.size ());
+  if (!freeList.empty ())
+    {
+      struct PacketMetadata::Data *data = freeList.back ();
+      freeList.pop_back ();
+      data->m_count = 1;
+      return data;
+    }
+  uint32_t classSize = (sizeClass == SIZE_CLASSES - 1) ? 0xffff : (16U << sizeClass);
+  NS_LOG_LOGIC ("create alloc size="<<classSize);
+  return PacketMetadata::Allocate (classSize);
 }
 
 void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
+  NS_ASSERT (data != &m_emptyData);
   if (!m_enable)
     {
       PacketMetadata::Deallocate (data);
       return;
     } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
-      data->m_size < m_maxSize) 
+  DataFreeList &freeList = m_freeLists[GetSizeClass (data->m_size)];
+  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<freeList.size ());
+  if (freeList.size () > 1000)
     {
       PacketMetadata::Deallocate (data);
     } 
   else 
     {
-      m_freeList.push_back (data);
+      freeList.push_back (data);
     }
 }
 
@@ -680,6 +728,10 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
 
   struct PacketMetadata::SmallItem item;
   item.next = m_head;
@@ -702,6 +754,10 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_head, &item, &extraItem);
@@ -750,6 +806,10 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
   struct PacketMetadata::SmallItem item;
   item.next = 0xffff;
   item.prev = m_tail;
@@ -772,6 +832,10 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_tail, &item, &extraItem);
@@ -819,6 +883,10 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
   if (m_tail == 0xffff)
     {
       // We have no items so 'AddAtEnd' is 
@@ -827,6 +895,13 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
       NS_ASSERT (IsStateOk ());
       return;
     }
+  if (o.IsSkipped ())
+    {
+      // the other packet was not sampled: we cannot describe
+      // the result anymore so we stop tracking it too.
+      Skip ();
+      return;
+    }
   if (o.m_head == 0xffff)
     {
       NS_ASSERT (o.m_tail == 0xffff);
@@ -907,6 +982,10 @@ PacketMetadata::RemoveAtStart (uint32_t start)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
   NS_ASSERT (m_data != 0);
   uint32_t leftToRemove = start;
   uint16_t current = m_head;
@@ -970,6 +1049,10 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
       m_metadataSkipped = true;
       return;
     }
+  if (IsSkipped ())
+    {
+      return;
+    }
   NS_ASSERT (m_data != 0);
 
   uint32_t leftToRemove = end;
@@ -1157,7 +1240,7 @@ PacketMetadata::GetSerializedSize (void) const
   // if packet-metadata not enabled, total size
   // is simply 4-bytes for itself plus 8-bytes 
   // for packet uid
-  if (!m_enable)
+  if (!m_enable || IsSkipped ())
     {
       return totalSize;
     }
@@ -75,6 +75,17 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * The struct PacketMetadata::Data buffers are taken from a set of
+ * per-size-class free lists: each buffer is rounded up to the next
+ * power of two so that a growing packet reallocates its buffer
+ * a logarithmic number of times, and small packets never pay for the
+ * largest buffer ever seen.
+ *
+ * When metadata is disabled, or when this packet was not picked by
+ * PacketMetadata::EnableSampling, no buffer is allocated at all: the
+ * instance shares a single, empty, static struct PacketMetadata::Data
+ * and every operation on it is a no-op.
  */
 class PacketMetadata 
 {
@@ -127,6 +138,14 @@ private:
 
   static void Enable (void);
   static void EnableChecking (void);
+  /**
+   * \param interval the sampling interval.
+   *
+   * Enable metadata, but record it only for the packets whose
+   * uid is a multiple of \p interval: the other packets cost no more
+   * than when metadata is disabled, and print nothing.
+   */
+  static void EnableSampling (uint32_t interval);
 
   inline PacketMetadata (uint64_t uid, uint32_t size);
   inline PacketMetadata (PacketMetadata const &o);
@@ -287,7 +306,9 @@ private:
     /* the packetUid of the packet in which this header or trailer
        was first added. It could be different from the m_packetUid
        field if the user has aggregated multiple packets into one.
-       stored as a fixed-size 64 bit integer.
+       stored as the zigzag-encoded difference from m_packetUid
+       in a variable-size 32 bit integer: a single byte in the
+       common case where both uids are equal.
      */
     uint64_t packetUid;
   };
@@ -313,6 +334,7 @@ public:
   inline void UpdateHead (uint16_t written);
   inline void UpdateTail (uint16_t written);
   inline uint32_t GetUleb128Size (uint32_t value) const;
+  inline uint32_t GetPacketUidDelta (uint64_t packetUid) const;
   uint32_t ReadUleb128 (const uint8_t **pBuffer) const;
   inline void Append16 (uint16_t value, uint8_t *buffer);
   inline void Append32 (uint32_t value, uint8_t *buffer);
@@ -325,26 +347,39 @@ public:
                       struct PacketMetadata::SmallItem *item,
                       struct PacketMetadata::ExtraItem *extraItem) const;
   void DoAddHeader (uint32_t uid, uint32_t size);
+  inline bool IsSkipped (void) const;
+  void Skip (void);
   bool IsStateOk (void) const;
   bool IsPointerOk (uint16_t pointer) const;
   bool IsSharedPointerOk (uint16_t pointer) const;
 
 
+  static inline bool IsSampled (uint64_t uid);
+  static uint32_t GetSizeClass (uint32_t size);
   static struct PacketMetadata::Data *Create (uint32_t size);
   static void Recycle (struct PacketMetadata::Data *data);
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList;
+  /**
+   * the number of size classes of PacketMetadata::Data buffers:
+   * 16 to 32768 bytes in powers of two, plus 65535 bytes.
+   */
+  enum PacketMetadata_e {
+    SIZE_CLASSES = 13
+  };
+
+  static DataFreeList m_freeLists[SIZE_CLASSES];
+  static struct PacketMetadata::Data m_emptyData;
   static bool m_enable;
   static bool m_enableChecking;
+  static uint32_t m_samplingInterval;
 
   // set to true when adding metadata to a packet is skipped because
   // m_enable is false; used to detect enabling of metadata in the
   // middle of a simulation, which isn't allowed.
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize;
   static uint16_t m_chunkUid;
 
   struct Data *m_data;
@@ -363,14 +398,34 @@ public:
 
 namespace ns3 {
 
+bool
+PacketMetadata::IsSampled (uint64_t uid)
+{
+  return m_samplingInterval == 1 ||
+         (static_cast<uint32_t> (uid) % m_samplingInterval) == 0;
+}
+bool
+PacketMetadata::IsSkipped (void) const
+{
+  return m_data == &m_emptyData;
+}
+
 PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
-  : m_data (PacketMetadata::Create (10)),
+  : m_data (&m_emptyData),
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
     m_packetUid (uid)
 {
-  memset (m_data->m_data, 0xff, 4);
+  if (m_enable && IsSampled (uid))
+    {
+      m_data = PacketMetadata::Create (10);
+      memset (m_data->m_data, 0xff, 4);
+    }
+  else
+    {
+      m_emptyData.m_count++;
+    }
   if (size > 0)
     {
       DoAddHeader (0, size);
@@ -157,6 +157,20 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove (Tag & tag)
 {
+  uint32_t i = FindInline (tag.GetInstanceTypeId ());
+  if (i < m_nInline)
+    {
+      NS_LOG_INFO ("found tid inline, removing");
+      tag.Deserialize (TagBuffer (m_inline[i].data,
+                                  m_inline[i].data + TagData::MAX_SIZE));
+      // keep the remaining inline tags in order
+      for (++i; i < m_nInline; ++i)
+        {
+          m_inline[i - 1] = m_inline[i];
+        }
+      m_nInline--;
+      return true;
+    }
   return COWTraverse (tag, &PacketTagList::RemoveWriter);
 }
 
@@ -196,6 +210,14 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  uint32_t i = FindInline (tag.GetInstanceTypeId ());
+  if (i < m_nInline)
+    {
+      NS_LOG_INFO ("found tid inline, rewriting");
+      tag.Serialize (TagBuffer (m_inline[i].data,
+                                m_inline[i].data + tag.GetSerializedSize ()));
+      return true;
+    }
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
   if (!found)
     {
@@ -245,10 +267,24 @@ PacketTagList::Add (const Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   // ensure this id was not yet added
+  NS_ASSERT (FindInline (tag.GetInstanceTypeId ()) == INLINE_SIZE);
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
     {
       NS_ASSERT (cur->tid != tag.GetInstanceTypeId ());
     }
+  // store inline while there is room, and nothing has spilled over
+  if (m_next == 0 && m_nInline < INLINE_SIZE)
+    {
+      PacketTagList *self = const_cast<PacketTagList *> (this);
+      struct TagData * slot = &self->m_inline[m_nInline];
+      slot->count = 1;
+      slot->next = 0;
+      slot->tid = tag.GetInstanceTypeId ();
+      NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
+      tag.Serialize (TagBuffer (slot->data, slot->data + tag.GetSerializedSize ()));
+      self->m_nInline++;
+      return;
+    }
   struct TagData * head = new struct TagData ();
   head->count = 1;
   head->next = 0;
@@ -265,6 +301,13 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  uint32_t i = FindInline (tid);
+  if (i < m_nInline)
+    {
+      tag.Deserialize (TagBuffer (const_cast<uint8_t *> (m_inline[i].data),
+                                  const_cast<uint8_t *> (m_inline[i].data) + TagData::MAX_SIZE));
+      return true;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
     {
       if (cur->tid == tid) 
@@ -284,5 +327,17 @@ PacketTagList::Head (void) const
   return m_next;
 }
 
+const struct PacketTagList::TagData *
+PacketTagList::InlineBegin (void) const
+{
+  return m_inline;
+}
+
+uint32_t
+PacketTagList::GetInlineSize (void) const
+{
+  return m_nInline;
+}
+
 } /* namespace ns3 */
 
@@ -120,6 +120,26 @@ class Tag;
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
  *
+ * \par <b> Inline storage: </b>
+ *
+ *   - The first #INLINE_SIZE tags added to an empty list are not
+ *     put on the tree at all, but stored by value in the #m_inline
+ *     array of the PacketTagList itself.  Only tags added once the
+ *     inline array is full spill over onto the copy-on-write tree
+ *     described above.
+ *
+ *   - Most packets carry only a handful of tags (\c QosTag,
+ *     \c FlowIdTag, \c SnrTag, ...) so in the common case #Add,
+ *     #Peek, #Remove and #Replace never touch the heap.
+ *
+ *   - Copy constructor and assignment copy the inline tags by value,
+ *     and share the spill-over branch as before.
+ *
+ *   - A tag is only ever stored inline when nothing has spilled over,
+ *     so spilled tags are always more recent than inline tags.  Tags
+ *     therefore keep their most-recent-first order: first the spill-over
+ *     branch from #Head, then the inline tags from last to first.
+ *
  * \par <b> Memory Management: </b>
  * \n
  * Packet tags must serialize to a finite maximum size, see TagData
@@ -167,6 +187,18 @@ public:
     uint32_t count;           /**< Number of incoming links */
   };  /* struct TagData */
 
+  /**
+   * \brief Number of tags stored inline
+   *
+   * The number of tags which can be stored directly in the
+   * PacketTagList, before further tags spill over onto the
+   * heap-allocated, shared list of TagData.
+   */
+  enum PacketTagList_e
+  {
+    INLINE_SIZE = 4           /**< Size of the inline array #m_inline */
+  };
+
   /**
    * Create a new PacketTagList.
    */
@@ -176,7 +208,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
+   * This copies the inline tags of \pname{o}, then makes a
+   * light-weight copy of the spill-over branch by
    * pointing to the same #struct TagData as \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
@@ -185,7 +218,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
+   * This copies the inline tags of \pname{o}, then makes a
+   * light-weight copy of the spill-over branch by #RemoveAll, then
    * pointing to the same #struct TagData as \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
@@ -233,11 +267,32 @@ public:
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to head of the spill-over tag list
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * \returns pointer to the first (oldest) tag stored inline
+   */
+  const struct PacketTagList::TagData *InlineBegin (void) const;
+  /**
+   * \returns the number of tags stored inline
+   */
+  uint32_t GetInlineSize (void) const;
 
 private:
+  /**
+   * Find a tag stored inline.
+   *
+   * \param [in] tid The tag type to find.
+   * \returns The index of \pname{tid} in #m_inline, or #INLINE_SIZE
+   *          if it is not stored inline.
+   */
+  inline uint32_t FindInline (TypeId tid) const;
+  /**
+   * Remove all tags from the spill-over list (up to the first merge).
+   */
+  inline void RemoveAllSpilled (void);
+
   /**
    * Typedef of method function pointer for copy-on-write operations
    *
@@ -287,7 +342,15 @@ private:
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
 
   /**
-   * Pointer to first #struct TagData on the list
+   * Tags stored by value, oldest first
+   */
+  struct TagData m_inline[INLINE_SIZE];
+  /**
+   * Number of tags in #m_inline
+   */
+  uint32_t m_nInline;
+  /**
+   * Pointer to first #struct TagData on the spill-over list
    */
   struct TagData *m_next;
 };
@@ -301,13 +364,19 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_nInline (0),
+    m_next ()
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_nInline (o.m_nInline),
+    m_next (o.m_next)
 {
+  for (uint32_t i = 0; i < m_nInline; ++i)
+    {
+      m_inline[i] = o.m_inline[i];
+    }
   if (m_next != 0)
     {
       m_next->count++;
@@ -318,11 +387,21 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
+  if (this == &o)
+    {
+      return *this;
+    }
+  m_nInline = o.m_nInline;
+  for (uint32_t i = 0; i < m_nInline; ++i)
+    {
+      m_inline[i] = o.m_inline[i];
+    }
+  // already sharing the same spill-over branch
   if (m_next == o.m_next) 
     {
       return *this;
     }
-  RemoveAll ();
+  RemoveAllSpilled ();
   m_next = o.m_next;
   if (m_next != 0) 
     {
@@ -333,11 +412,31 @@ PacketTagList::operator = (PacketTagList const &o)
 
 PacketTagList::~PacketTagList ()
 {
-  RemoveAll ();
+  RemoveAllSpilled ();
 }
 
 void
 PacketTagList::RemoveAll (void)
+{
+  m_nInline = 0;
+  RemoveAllSpilled ();
+}
+
+uint32_t
+PacketTagList::FindInline (TypeId tid) const
+{
+  for (uint32_t i = 0; i < m_nInline; ++i)
+    {
+      if (m_inline[i].tid == tid)
+        {
+          return i;
+        }
+    }
+  return INLINE_SIZE;
+}
+
+void
+PacketTagList::RemoveAllSpilled (void)
 {
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
@@ -81,19 +81,27 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList &list)
+  : m_current (list.Head ()),
+    m_inline (list.InlineBegin ()),
+    m_nInline (list.GetInlineSize ())
 {
 }
 bool
 PacketTagIterator::HasNext (void) const
 {
-  return m_current != 0;
+  return m_current != 0 || m_nInline != 0;
 }
 PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
+  if (m_current == 0)
+    {
+      // spill-over list exhausted, walk the inline tags from last to first
+      m_nInline--;
+      return PacketTagIterator::Item (&m_inline[m_nInline]);
+    }
   const struct PacketTagList::TagData *prev = m_current;
   m_current = m_current->next;
   return PacketTagIterator::Item (prev);
@@ -377,6 +385,13 @@ Packet::PeekData (void) const
   return data;
 }
 
+uint8_t const *
+Packet::PeekContiguousData (uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << size);
+  return m_buffer.PeekContiguousData (size);
+}
+
 uint32_t 
 Packet::CopyData (uint8_t *buffer, uint32_t size) const
 {
@@ -562,6 +577,13 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::EnableSampledPrinting (uint32_t interval)
+{
+  NS_LOG_FUNCTION (interval);
+  PacketMetadata::EnableSampling (interval);
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
@@ -898,7 +920,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
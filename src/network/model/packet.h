@@ -147,8 +147,10 @@ private:
   Item Next (void);
 private:
   friend class Packet;
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const PacketTagList &list);
   const struct PacketTagList::TagData *m_current;
+  const struct PacketTagList::TagData *m_inline;
+  uint32_t m_nInline;
 };
 
 /**
@@ -350,6 +352,18 @@ public:
    */
   uint8_t const *PeekData (void) const NS_DEPRECATED;
 
+  /**
+   * \param size the number of bytes requested.
+   * \returns a pointer to the first \p size bytes of the packet,
+   *          or zero if they are not stored contiguously.
+   *
+   * This method allows read-only header views to access the
+   * fields of a header without deserializing it. If it returns
+   * zero, use CopyData"()" instead. The returned pointer is
+   * invalidated by any modification of this packet.
+   */
+  uint8_t const *PeekContiguousData (uint32_t size) const;
+
   /**
    * Copy the packet contents to a byte buffer.
    *
@@ -437,6 +451,16 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \param interval the sampling interval.
+   *
+   * Same as Packet::EnablePrinting but only one packet out of
+   * \p interval (based on its uid) keeps the metadata needed by the
+   * Print methods: the other packets print nothing and cost as little
+   * as when metadata is disabled. Packets built by concatenating a
+   * sampled packet with an unsampled one are not sampled.
+   */
+  static void EnableSampledPrinting (uint32_t interval);
 
   /**
    * \returns number of bytes required for packet
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-writer.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case to make sure that a binary trace converted to ascii is identical
+// to the trace written by the default ascii trace sinks.
+// ===========================================================================
+class BinaryTraceTestCase : public TestCase
+{
+public:
+  BinaryTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Trace (Ptr<OutputStreamWrapper> stream, uint32_t i);
+};
+
+BinaryTraceTestCase::BinaryTraceTestCase ()
+  : TestCase ("Check that a converted binary trace matches the ascii trace")
+{
+}
+
+void
+BinaryTraceTestCase::Trace (Ptr<OutputStreamWrapper> stream, uint32_t i)
+{
+  Ptr<Packet> p = Create<Packet> (100 + i);
+  LlcSnapHeader llc;
+  llc.SetType (0x0800);
+  p->AddHeader (llc);
+  EthernetHeader eth (false);
+  eth.SetLengthType (p->GetSize ());
+  p->AddHeader (eth);
+
+  std::ostringstream context;
+  context << "/NodeList/" << i % 3 << "/DeviceList/" << i % 2 << "/TxQueue/Enqueue";
+  switch (i % 8)
+    {
+    case 0:
+      AsciiTraceHelper::DefaultEnqueueSinkWithContext (stream, context.str (), p);
+      break;
+    case 1:
+      AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (stream, p);
+      break;
+    case 2:
+      AsciiTraceHelper::DefaultDequeueSinkWithContext (stream, context.str (), p);
+      break;
+    case 3:
+      AsciiTraceHelper::DefaultDequeueSinkWithoutContext (stream, p);
+      break;
+    case 4:
+      AsciiTraceHelper::DefaultDropSinkWithContext (stream, context.str (), p);
+      break;
+    case 5:
+      AsciiTraceHelper::DefaultDropSinkWithoutContext (stream, p);
+      break;
+    case 6:
+      AsciiTraceHelper::DefaultReceiveSinkWithContext (stream, context.str (), p);
+      break;
+    case 7:
+      AsciiTraceHelper::DefaultReceiveSinkWithoutContext (stream, p);
+      break;
+    }
+}
+
+void
+BinaryTraceTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+
+  std::ostringstream ascii;
+  std::ostringstream binary;
+  Ptr<OutputStreamWrapper> asciiStream = Create<OutputStreamWrapper> (&ascii);
+  Ptr<OutputStreamWrapper> binaryStream = Create<OutputStreamWrapper> (&binary);
+  binaryStream->SetBinaryTraceWriter (Create<BinaryTraceWriter> (&binary, true));
+
+  for (uint32_t i = 0; i < 40; ++i)
+    {
+      Time t = MicroSeconds (1234567 * i);
+      Simulator::Schedule (t, &BinaryTraceTestCase::Trace, this, asciiStream, i);
+      Simulator::Schedule (t, &BinaryTraceTestCase::Trace, this, binaryStream, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::istringstream in (binary.str ());
+  std::ostringstream converted;
+  bool ok = BinaryTraceWriter::ConvertToAscii (in, converted);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Unable to convert the binary trace");
+  NS_TEST_EXPECT_MSG_EQ (converted.str (), ascii.str (), "Converted trace differs from the ascii trace");
+
+  //
+  // Without snapshots the records are fixed-size and only the uid and the
+  // size of the packets can be printed.
+  //
+  std::ostringstream compact;
+  Ptr<OutputStreamWrapper> compactStream = Create<OutputStreamWrapper> (&compact);
+  compactStream->SetBinaryTraceWriter (Create<BinaryTraceWriter> (&compact, false));
+  Ptr<Packet> p = Create<Packet> (10);
+  AsciiTraceHelper::DefaultReceiveSinkWithoutContext (compactStream, p);
+  NS_TEST_EXPECT_MSG_EQ (compact.str ().size (), 16 + 40, "Unexpected size of a record without snapshot");
+  std::istringstream compactIn (compact.str ());
+  std::ostringstream compactOut;
+  ok = BinaryTraceWriter::ConvertToAscii (compactIn, compactOut);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Unable to convert the binary trace without snapshots");
+  std::ostringstream expected;
+  expected << "r 0 uid=" << p->GetUid () << " size=10" << std::endl;
+  NS_TEST_EXPECT_MSG_EQ (compactOut.str (), expected.str (), "Unexpected conversion of a record without snapshot");
+
+  std::istringstream truncated (binary.str ().substr (0, binary.str ().size () - 1));
+  std::ostringstream ignored;
+  NS_TEST_EXPECT_MSG_EQ (BinaryTraceWriter::ConvertToAscii (truncated, ignored), false, "Truncated trace not detected");
+}
+
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite binaryTraceTestSuite;
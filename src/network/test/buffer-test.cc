@@ -302,6 +302,33 @@ BufferTest::DoRun (void)
   i.Write (buffer.Begin (), buffer.End ());
   ENSURE_WRITTEN_BYTES (other, 9, 0x1, 0x2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3, 0x4);
 
+  // The data is shared, and the other buffer is only zeros
+  buffer = Buffer ();
+  buffer.AddAtStart (2);
+  i = buffer.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  Buffer shared = buffer;
+  shared.AddAtEnd (Buffer (3));
+  ENSURE_WRITTEN_BYTES (shared, 5, 0x1, 0x2, 0x00, 0x00, 0x00);
+  i = shared.Begin ();
+  i.WriteU8 (0x3);
+  ENSURE_WRITTEN_BYTES (shared, 5, 0x3, 0x2, 0x00, 0x00, 0x00);
+  ENSURE_WRITTEN_BYTES (buffer, 2, 0x1, 0x2);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 2, "Shared buffer grown");
+
+  // The end of the buffer is before the end of the dirty area
+  buffer = Buffer ();
+  buffer.AddAtStart (3);
+  i = buffer.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  i.WriteU8 (0x3);
+  buffer.RemoveAtEnd (1);
+  buffer.AddAtEnd (Buffer (2));
+  ENSURE_WRITTEN_BYTES (buffer, 4, 0x1, 0x2, 0x00, 0x00);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 4, "Wrong size");
+
   /// \internal See \bugid{1001}
   std::string ct ("This is the next content of the buffer.");
   buffer = Buffer ();
@@ -323,6 +350,72 @@ BufferTest::DoRun (void)
   free (cBuf);
 }
 //-----------------------------------------------------------------------------
+class BufferChecksumTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  BufferChecksumTest ();
+};
+
+BufferChecksumTest::BufferChecksumTest ()
+  : TestCase ("Buffer::Iterator::CalculateIpChecksum") {
+}
+
+void
+BufferChecksumTest::DoRun (void)
+{
+  // a buffer with data before and after a zero area.
+  Buffer buffer (300);
+  buffer.AddAtStart (77);
+  buffer.AddAtEnd (101);
+  Buffer::Iterator i = buffer.Begin ();
+  for (uint32_t j = 0; j < 77; j++)
+    {
+      i.WriteU8 (j * 7 + 3);
+    }
+  i.Next (300);
+  for (uint32_t j = 0; j < 101; j++)
+    {
+      i.WriteU8 (255 - j * 5);
+    }
+
+  uint32_t offsets[] = { 0, 1, 2, 30, 76, 77, 78, 200, 377, 378, 400 };
+  uint32_t sizes[] = { 0, 1, 2, 3, 20, 33, 75, 76, 77, 301, 478 };
+  for (uint32_t o = 0; o < sizeof (offsets) / sizeof (offsets[0]); o++)
+    {
+      for (uint32_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+        {
+          uint32_t size = sizes[s];
+          if (offsets[o] + size > buffer.GetSize ())
+            {
+              continue;
+            }
+          // the reference implementation of RFC 1071.
+          Buffer::Iterator reference = buffer.Begin ();
+          reference.Next (offsets[o]);
+          uint32_t sum = 0x1234;
+          for (uint32_t j = 0; j < size / 2; j++)
+            {
+              sum += reference.ReadU16 ();
+            }
+          if (size & 1)
+            {
+              sum += reference.ReadU8 ();
+            }
+          while (sum >> 16)
+            {
+              sum = (sum & 0xffff) + (sum >> 16);
+            }
+          uint16_t expected = ~sum;
+
+          Buffer::Iterator it = buffer.Begin ();
+          it.Next (offsets[o]);
+          uint16_t checksum = it.CalculateIpChecksum (size, 0x1234);
+          NS_TEST_EXPECT_MSG_EQ (checksum, expected, "Wrong checksum of " << size << " bytes at " << offsets[o]);
+          NS_TEST_EXPECT_MSG_EQ (it.GetDistanceFrom (buffer.Begin ()), offsets[o] + size, "Iterator not advanced");
+        }
+    }
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -333,6 +426,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferChecksumTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite;
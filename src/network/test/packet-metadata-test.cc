@@ -17,6 +17,7 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include <algorithm>
 #include <cstdarg>
 #include <iostream>
 #include <sstream>
@@ -821,6 +822,41 @@ PacketMetadataTest::DoRun (void)
                                  p3->GetSize ());
   delete [] buf;
   NS_TEST_EXPECT_MSG_EQ (msg, std::string ("hello world"), "Could not find original data in received packet");
+
+  // items which come from another packet record the uid
+  // of that packet, which must survive copies and fragmentation.
+  p1 = Create<Packet> (10);
+  ADD_HEADER (p1, 2);
+  p2 = Create<Packet> (20);
+  ADD_HEADER (p2, 3);
+  p1->AddAtEnd (p2);
+  CHECK_HISTORY (p1, 4, 2, 10, 3, 20);
+  p3 = p1->CreateFragment (5, 25);
+  CHECK_HISTORY (p3, 3, 7, 3, 15);
+  p3->RemoveAtEnd (10);
+  CHECK_HISTORY (p3, 3, 7, 3, 5);
+
+  // sampled metadata: only one packet out of two is tracked.
+  PacketMetadata::EnableSampling (2);
+  p1 = Create<Packet> (10);
+  p2 = Create<Packet> (10);
+  if (p1->GetUid () % 2 != 0)
+    {
+      std::swap (p1, p2);
+    }
+  ADD_HEADER (p1, 2);
+  ADD_HEADER (p2, 2);
+  CHECK_HISTORY (p1, 2, 2, 10);
+  NS_TEST_EXPECT_MSG_EQ (p2->BeginItem ().HasNext (), false, "Unsampled packet has metadata");
+  REM_HEADER (p2, 2);
+  p2->RemoveAtStart (5);
+  NS_TEST_EXPECT_MSG_EQ (p2->BeginItem ().HasNext (), false, "Unsampled packet has metadata");
+  p3 = p1->Copy ();
+  p3->AddAtEnd (p2);
+  NS_TEST_EXPECT_MSG_EQ (p3->BeginItem ().HasNext (), false, "Mixed packet has metadata");
+  NS_TEST_EXPECT_MSG_EQ (p3->GetSize (), 17, "Mixed packet has wrong size");
+  CHECK_HISTORY (p1, 2, 2, 10);
+  PacketMetadata::EnableSampling (1);
 }
 //-----------------------------------------------------------------------------
 class PacketMetadataTestSuite : public TestSuite
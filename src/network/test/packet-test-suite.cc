@@ -674,6 +674,52 @@ PacketTagListTest::DoRun (void)
     ReplaceCheck (6);
     ReplaceCheck (7);
   }
+
+  { // Inline storage and spill-over
+
+    std::cout << GetName () << "check inline and spill-over order" << std::endl;
+    Ptr<Packet> p = Create<Packet> ();
+    p->AddPacketTag (t1);
+    p->AddPacketTag (t2);
+    p->AddPacketTag (t3);
+    p->AddPacketTag (t4);
+    p->AddPacketTag (t5);
+    p->AddPacketTag (t6);
+    p->RemovePacketTag (t2);   // inline, while others have spilled over
+    p->AddPacketTag (t7);      // must not reuse the inline slot
+    Ptr<Packet> copy = p->Copy ();
+    copy->RemovePacketTag (t5); // spilled over, shared with p
+    TypeId pOrder[] = { ATestTag<7>::GetTypeId (), ATestTag<6>::GetTypeId (),
+                        ATestTag<5>::GetTypeId (), ATestTag<4>::GetTypeId (),
+                        ATestTag<3>::GetTypeId (), ATestTag<1>::GetTypeId () };
+    TypeId copyOrder[] = { ATestTag<7>::GetTypeId (), ATestTag<6>::GetTypeId (),
+                           ATestTag<4>::GetTypeId (), ATestTag<3>::GetTypeId (),
+                           ATestTag<1>::GetTypeId () };
+    uint32_t n = 0;
+    PacketTagIterator i = p->GetPacketTagIterator ();
+    while (i.HasNext ())
+      {
+        TypeId tid = i.Next ().GetTypeId ();
+        NS_TEST_ASSERT_MSG_LT (n, 6, "too many tags in original");
+        NS_TEST_EXPECT_MSG_EQ (tid, pOrder[n], "original tag " << n);
+        ++n;
+      }
+    NS_TEST_EXPECT_MSG_EQ (n, 6, "original tag count");
+    n = 0;
+    i = copy->GetPacketTagIterator ();
+    while (i.HasNext ())
+      {
+        TypeId tid = i.Next ().GetTypeId ();
+        NS_TEST_ASSERT_MSG_LT (n, 5, "too many tags in copy");
+        NS_TEST_EXPECT_MSG_EQ (tid, copyOrder[n], "copy tag " << n);
+        ++n;
+      }
+    NS_TEST_EXPECT_MSG_EQ (n, 5, "copy tag count");
+    p->RemoveAllPacketTags ();
+    NS_TEST_EXPECT_MSG_EQ (p->GetPacketTagIterator ().HasNext (), false,
+                           "tags left after RemoveAll");
+    NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (t1), true, "copy lost t1");
+  }
   
   { // Timing
     std::cout << GetName () << "add+remove timing" << std::endl;
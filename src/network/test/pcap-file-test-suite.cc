@@ -16,15 +16,20 @@
  * Author:  Craig Dowell (craigdo@ee.washington.edu)
  */
 
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <fstream>
+#include <iterator>
 #include <cstring>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcap-async-writer.h"
+#include "ns3/pcap-mapped-file.h"
 
 using namespace ns3;
 
@@ -1066,6 +1071,79 @@ ReadFileTestCase::DoRun (void)
   f.Close ();
 }
 
+// ===========================================================================
+// Test case to make sure that PcapMappedFile iterates over the records of
+// a known good pcap file, and stops on a truncated record.
+// ===========================================================================
+class MappedFileTestCase : public TestCase
+{
+public:
+  MappedFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MappedFileTestCase::MappedFileTestCase ()
+  : TestCase ("Check to see that PcapMappedFile can read out a known good pcap file")
+{
+}
+
+void
+MappedFileTestCase::DoRun (void)
+{
+  PcapMappedFile f;
+  std::string filename = CreateDataDirFilename ("known.pcap");
+  NS_TEST_ASSERT_MSG_EQ (f.Open (filename), true, "Open (" << filename << ") returns error");
+  NS_TEST_ASSERT_MSG_EQ (f.GetDataLinkType (), 1, "Incorrect data link type read from known good pcap file");
+
+  PacketEntry *p = knownPackets;
+  uint32_t n = 0;
+  for (PcapMappedFile::Iterator i = f.Begin (); i != f.End (); ++i, ++p, ++n)
+    {
+      NS_TEST_ASSERT_MSG_LT (n, N_KNOWN_PACKETS, "Too many records in known good pcap file");
+      NS_TEST_ASSERT_MSG_EQ (i->GetTsSec (), p->tsSec, "Incorrectly read seconds timestap from known good pcap file");
+      NS_TEST_ASSERT_MSG_EQ (i->GetTsUsec (), p->tsUsec, "Incorrectly read microseconds timestap from known good pcap file");
+      NS_TEST_ASSERT_MSG_EQ (i->GetInclLen (), p->inclLen, "Incorrectly read included length from known good packet");
+      NS_TEST_ASSERT_MSG_EQ (i->GetOrigLen (), p->origLen, "Incorrectly read original length from known good packet");
+      // the known data was dumped without the 14 bytes of Ethernet header.
+      uint8_t const *data = i->GetData () + 14;
+      for (uint32_t j = 0; j < N_PACKET_BYTES; ++j)
+        {
+          uint16_t word = (data[2 * j] << 8) | data[2 * j + 1];
+          NS_TEST_ASSERT_MSG_EQ (word, p->data[j], "Incorrect data read from known good packet");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, N_KNOWN_PACKETS, "Incorrect number of records in known good pcap file");
+  f.Close ();
+
+  //
+  // Copy all but the last byte of the file: the last record must be
+  // reported as truncated, and the files must differ.
+  //
+  std::string truncated = CreateTempDirFilename ("truncated.pcap");
+  {
+    std::ifstream in (filename.c_str (), std::ios::binary);
+    std::string content ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+    std::ofstream out (truncated.c_str (), std::ios::binary);
+    out.write (content.data (), content.size () - 1);
+  }
+  NS_TEST_ASSERT_MSG_EQ (f.Open (truncated), true, "Open (" << truncated << ") returns error");
+  n = 0;
+  PcapMappedFile::Iterator i = f.Begin ();
+  for (; i != f.End (); ++i)
+    {
+      ++n;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, N_KNOWN_PACKETS - 1, "Truncated record returned by the iterator");
+  NS_TEST_EXPECT_MSG_EQ (i.IsTruncated (), true, "Truncated record not reported");
+  f.Close ();
+
+  uint32_t sec (0), usec (0);
+  NS_TEST_EXPECT_MSG_EQ (PcapFile::Diff (filename, truncated, sec, usec), true, "Truncated file must differ");
+  remove (truncated.c_str ());
+}
+
 // ===========================================================================
 // Test case to make sure that the Pcap::Diff method works as expected
 // ===========================================================================
@@ -1120,6 +1198,92 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that files written asynchronously, with more
+// files than file descriptors allowed, are identical to the same files
+// written synchronously.
+// ===========================================================================
+class AsyncWriteTestCase : public TestCase
+{
+public:
+  AsyncWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AsyncWriteTestCase::AsyncWriteTestCase ()
+  : TestCase ("Check that PcapFile::SetAsync writes the same files")
+{
+}
+
+void
+AsyncWriteTestCase::DoRun (void)
+{
+  const uint32_t nFiles = 3;
+  PcapAsyncWriter *writer = PcapAsyncWriter::Get ();
+  writer->SetBatchSize (100);
+  writer->SetMaxOpenFiles (1);
+  uint64_t written = writer->GetWrittenBytes ();
+
+  std::string asyncNames[nFiles];
+  std::string syncNames[nFiles];
+  PcapFile asyncFiles[nFiles];
+  PcapFile syncFiles[nFiles];
+  for (uint32_t i = 0; i < nFiles; ++i)
+    {
+      std::stringstream name;
+      name << "async-" << i;
+      asyncNames[i] = CreateTempDirFilename (name.str () + ".pcap");
+      syncNames[i] = CreateTempDirFilename (name.str () + "-sync.pcap");
+      asyncFiles[i].SetAsync (true);
+      asyncFiles[i].Open (asyncNames[i], std::ios::out);
+      NS_TEST_ASSERT_MSG_EQ (asyncFiles[i].Fail (), false, "Open (" << asyncNames[i] << ") returns error");
+      asyncFiles[i].Init (1, 64);
+      syncFiles[i].Open (syncNames[i], std::ios::out);
+      syncFiles[i].Init (1, 64);
+    }
+
+  uint8_t buffer[128];
+  for (uint32_t i = 0; i < 128; ++i)
+    {
+      buffer[i] = i;
+    }
+  // interleave the records so that each file is opened and closed
+  // several times by the writer.
+  for (uint32_t j = 0; j < 50; ++j)
+    {
+      for (uint32_t i = 0; i < nFiles; ++i)
+        {
+          asyncFiles[i].Write (j, i, buffer + i + j, 20 + j);
+          syncFiles[i].Write (j, i, buffer + i + j, 20 + j);
+        }
+    }
+
+  for (uint32_t i = 0; i < nFiles; ++i)
+    {
+      asyncFiles[i].Close ();
+      syncFiles[i].Close ();
+      uint32_t sec = 0, usec = 0;
+      bool diff = PcapFile::Diff (asyncNames[i], syncNames[i], sec, usec);
+      NS_TEST_EXPECT_MSG_EQ (diff, false, "Asynchronous file " << asyncNames[i] << " differs at " << sec << "." << usec);
+      remove (asyncNames[i].c_str ());
+      remove (syncNames[i].c_str ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (writer->GetBufferedBytes (), 0, "Data left in the writer after Close");
+  NS_TEST_EXPECT_MSG_EQ (writer->GetDroppedBytes (), 0, "Data lost by the writer");
+  // 24 bytes of file header plus 16 bytes of record header and 20 to 64 bytes of data.
+  uint64_t expected = nFiles * (24 + 50 * 16);
+  for (uint32_t j = 0; j < 50; ++j)
+    {
+      expected += nFiles * std::min<uint32_t> (20 + j, 64);
+    }
+  NS_TEST_EXPECT_MSG_EQ (writer->GetWrittenBytes () - written, expected, "Wrong number of bytes written");
+
+  writer->SetBatchSize (256 * 1024);
+  writer->SetMaxOpenFiles (64);
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1136,7 +1300,9 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new FileHeaderTestCase, TestCase::QUICK);
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
+  AddTestCase (new MappedFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new AsyncWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ring-buffer-queue.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+
+using namespace ns3;
+
+class RingBufferQueueTestCase : public TestCase
+{
+public:
+  RingBufferQueueTestCase ();
+  virtual void DoRun (void);
+};
+
+RingBufferQueueTestCase::RingBufferQueueTestCase ()
+  : TestCase ("Check that the ring buffer queue wraps around and drops as the drop tail queue")
+{
+}
+
+void
+RingBufferQueueTestCase::DoRun (void)
+{
+  Ptr<RingBufferQueue> queue = CreateObject<RingBufferQueue> ();
+  Ptr<DropTailQueue> reference = CreateObject<DropTailQueue> ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MaxPackets", UintegerValue (5)), true,
+                         "Verify that we can actually set the attribute");
+  reference->SetAttribute ("MaxPackets", UintegerValue (5));
+
+  // mix enqueues and dequeues so that the ring wraps around several times.
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      uint32_t n = 1 + (i * 7) % 4;
+      for (uint32_t j = 0; j < n; ++j)
+        {
+          Ptr<Packet> p = Create<Packet> (i * 10 + j);
+          NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (p), reference->Enqueue (p->Copy ()),
+                                 "Enqueue " << i << " differs from the drop tail queue");
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), reference->GetNPackets (), "Wrong number of packets");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), reference->GetNBytes (), "Wrong number of bytes");
+      for (uint32_t j = 0; j < (i * 3) % 4; ++j)
+        {
+          Ptr<Packet> p = queue->Dequeue ();
+          Ptr<Packet> expected = reference->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ ((p == 0), (expected == 0), "Dequeue " << i << " differs from the drop tail queue");
+          if (p != 0 && expected != 0)
+            {
+              NS_TEST_EXPECT_MSG_EQ (p->GetSize (), expected->GetSize (), "Packets dequeued out of order");
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), reference->GetTotalDroppedPackets (),
+                         "Wrong number of dropped packets");
+
+  queue->DequeueAll ();
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+  NS_TEST_EXPECT_MSG_EQ ((queue->Peek () == 0), true, "There are really no packets in there");
+
+  queue->SetAttribute ("Mode", EnumValue (Queue::QUEUE_MODE_BYTES));
+  queue->SetAttribute ("MaxBytes", UintegerValue (250));
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (100)), true, "Packet within the byte limit dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (100)), true, "Packet within the byte limit dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<Packet> (100)), false, "Packet over the byte limit enqueued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 200, "Wrong number of bytes");
+}
+
+class RingBufferQueueBurstTestCase : public TestCase
+{
+public:
+  RingBufferQueueBurstTestCase ();
+  virtual void DoRun (void);
+private:
+  void Dequeued (Ptr<const Packet> p);
+  uint32_t m_dequeued;
+};
+
+RingBufferQueueBurstTestCase::RingBufferQueueBurstTestCase ()
+  : TestCase ("Check DequeueBurst on the ring buffer and drop tail queues")
+{
+}
+
+void
+RingBufferQueueBurstTestCase::Dequeued (Ptr<const Packet> p)
+{
+  m_dequeued++;
+}
+
+void
+RingBufferQueueBurstTestCase::DoRun (void)
+{
+  Ptr<Queue> queues[2];
+  queues[0] = CreateObject<RingBufferQueue> ();
+  queues[1] = CreateObject<DropTailQueue> ();
+  for (uint32_t q = 0; q < 2; ++q)
+    {
+      m_dequeued = 0;
+      queues[q]->TraceConnectWithoutContext ("Dequeue", MakeCallback (&RingBufferQueueBurstTestCase::Dequeued, this));
+      std::vector<Ptr<Packet> > sent;
+      for (uint32_t i = 0; i < 10; ++i)
+        {
+          sent.push_back (Create<Packet> (100 + i));
+          queues[q]->Enqueue (sent.back ());
+        }
+
+      std::vector<Ptr<Packet> > burst;
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->DequeueBurst (burst, 4), 4, "Four packets should be removed");
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->GetNPackets (), 6, "There should be six packets in there");
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->GetNBytes (), 104 + 105 + 106 + 107 + 108 + 109, "Wrong number of bytes");
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->DequeueBurst (burst, 10), 6, "The six remaining packets should be removed");
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->IsEmpty (), true, "The queue should be empty");
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->GetNBytes (), 0, "There should be no bytes in there");
+      NS_TEST_EXPECT_MSG_EQ (queues[q]->DequeueBurst (burst, 10), 0, "No packet should be removed");
+      NS_TEST_ASSERT_MSG_EQ (burst.size (), sent.size (), "Not all the packets were dequeued");
+      for (uint32_t i = 0; i < sent.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (burst[i], sent[i], "Packets dequeued out of order");
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_dequeued, sent.size (), "The dequeue trace should fire once per packet");
+    }
+}
+
+static class RingBufferQueueTestSuite : public TestSuite
+{
+public:
+  RingBufferQueueTestSuite ()
+    : TestSuite ("ring-buffer-queue", UNIT)
+  {
+    AddTestCase (new RingBufferQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new RingBufferQueueBurstTestCase (), TestCase::QUICK);
+  }
+} g_ringBufferQueueTestSuite;
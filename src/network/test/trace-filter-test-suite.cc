@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/trace-filter.h"
+#include "ns3/trace-helper.h"
+#include "ns3/pcap-file.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/node.h"
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * \returns an Ethernet frame carrying an IPv4/UDP packet of the given
+ *          flow, or a raw IPv4 packet if ethernet is false.
+ */
+Ptr<Packet>
+CreateUdpPacket (uint32_t src, uint32_t dst, uint16_t srcPort, uint16_t dstPort,
+                 uint32_t payload, bool ethernet)
+{
+  std::vector<uint8_t> buffer (14 + 28 + payload, 0);
+  buffer[12] = 0x08;
+  uint8_t *ip = &buffer[14];
+  ip[0] = 0x45;
+  uint16_t totalLength = 28 + payload;
+  ip[2] = totalLength >> 8;
+  ip[3] = totalLength & 0xff;
+  ip[8] = 64;
+  ip[9] = 17;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      ip[12 + i] = src >> (24 - 8 * i);
+      ip[16 + i] = dst >> (24 - 8 * i);
+    }
+  ip[20] = srcPort >> 8;
+  ip[21] = srcPort & 0xff;
+  ip[22] = dstPort >> 8;
+  ip[23] = dstPort & 0xff;
+  if (ethernet)
+    {
+      return Create<Packet> (&buffer[0], buffer.size ());
+    }
+  return Create<Packet> (ip, buffer.size () - 14);
+}
+
+} // anonymous namespace
+
+// ===========================================================================
+// Test case to make sure that each criterion of the filter selects the
+// expected packets.
+// ===========================================================================
+class TraceFilterMatchTestCase : public TestCase
+{
+public:
+  TraceFilterMatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void CheckTimeWindow (Ptr<TraceFilter> filter, bool expected);
+};
+
+TraceFilterMatchTestCase::TraceFilterMatchTestCase ()
+  : TestCase ("Check the criteria of TraceFilter")
+{
+}
+
+void
+TraceFilterMatchTestCase::CheckTimeWindow (Ptr<TraceFilter> filter, bool expected)
+{
+  Ptr<Packet> p = Create<Packet> (10);
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (p), expected, "Wrong time window match at " << Simulator::Now ());
+}
+
+void
+TraceFilterMatchTestCase::DoRun (void)
+{
+  Ptr<TraceFilter> filter = Create<TraceFilter> ();
+  filter->SetSampling (3);
+  uint32_t matched = 0;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      matched += filter->Match (Create<Packet> (10)) ? 1 : 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ (matched, 4, "1-in-3 sampling of 10 packets must keep 4 packets");
+
+  filter = Create<TraceFilter> ();
+  filter->SetSizeRange (100, 200);
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (Create<Packet> (99)), false, "Packet too small matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (Create<Packet> (100)), true, "Packet in range not matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (Create<Packet> (201)), false, "Packet too large matched");
+
+  filter = Create<TraceFilter> ();
+  filter->SetFlow (Ipv4Address ("10.1.1.1"), Ipv4Address::GetAny (), 17, 0, 9);
+  uint32_t src = Ipv4Address ("10.1.1.1").Get ();
+  uint32_t dst = Ipv4Address ("10.1.1.2").Get ();
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (CreateUdpPacket (src, dst, 49153, 9, 100, true), 1), true,
+                         "Ethernet packet of the flow not matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (CreateUdpPacket (src, dst, 49153, 9, 100, true)), true,
+                         "Ethernet packet of the flow not detected");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (CreateUdpPacket (src, dst, 49153, 9, 100, false), 101), true,
+                         "Raw IPv4 packet of the flow not matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (CreateUdpPacket (src, dst, 49153, 9, 100, false)), true,
+                         "Raw IPv4 packet of the flow not detected");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (CreateUdpPacket (dst, src, 49153, 9, 100, true), 1), false,
+                         "Packet from another source matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (CreateUdpPacket (src, dst, 49153, 10, 100, true), 1), false,
+                         "Packet to another port matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (Create<Packet> (100), 1), false, "Packet without IPv4 header matched");
+  EthernetHeader ethernet (false);
+  ethernet.SetLengthType (0x0800);
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (ethernet, CreateUdpPacket (src, dst, 49153, 9, 100, false), 1), true,
+                         "Packet of the flow behind a separate header not matched");
+  NS_TEST_EXPECT_MSG_EQ (filter->Match (ethernet, CreateUdpPacket (src, dst, 49153, 10, 100, false), 1), false,
+                         "Packet to another port behind a separate header matched");
+
+  filter = Create<TraceFilter> ();
+  filter->SetTimeWindow (Seconds (1), Seconds (2));
+  Simulator::Schedule (Seconds (0.5), &TraceFilterMatchTestCase::CheckTimeWindow, this, filter, false);
+  Simulator::Schedule (Seconds (1.5), &TraceFilterMatchTestCase::CheckTimeWindow, this, filter, true);
+  Simulator::Schedule (Seconds (2.0), &TraceFilterMatchTestCase::CheckTimeWindow, this, filter, false);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * A device helper which only creates the pcap and ascii files of the
+ * devices, so that the test can write to them.
+ */
+class FileTraceHelper : public PcapHelperForDevice, public AsciiTraceHelperForDevice
+{
+public:
+  Ptr<PcapFileWrapper> m_file;
+  Ptr<OutputStreamWrapper> m_stream;
+private:
+  virtual void EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
+  {
+    PcapHelper pcapHelper;
+    pcapHelper.SetTraceFilter (m_pcapFilter);
+    m_file = pcapHelper.CreateFile (prefix, std::ios::out, PcapHelper::DLT_EN10MB);
+  }
+  virtual void EnableAsciiInternal (Ptr<OutputStreamWrapper> stream, std::string prefix,
+                                    Ptr<NetDevice> nd, bool explicitFilename)
+  {
+    AsciiTraceHelper asciiTraceHelper;
+    asciiTraceHelper.SetTraceFilter (m_asciiFilter);
+    m_stream = asciiTraceHelper.CreateFileStream (prefix);
+  }
+};
+
+// ===========================================================================
+// Test case to make sure that the filters given to the device helpers are
+// applied to the pcap and ascii files they create.
+// ===========================================================================
+class TraceFilterHelperTestCase : public TestCase
+{
+public:
+  TraceFilterHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TraceFilterHelperTestCase::TraceFilterHelperTestCase ()
+  : TestCase ("Check that the device helpers apply the trace filters")
+{
+}
+
+void
+TraceFilterHelperTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  node->AddDevice (device);
+
+  Ptr<TraceFilter> filter = Create<TraceFilter> ();
+  filter->SetSampling (2);
+  filter->SetSnapLen (64);
+
+  std::string pcapName = CreateTempDirFilename ("filtered.pcap");
+  std::string asciiName = CreateTempDirFilename ("filtered.tr");
+  FileTraceHelper helper;
+  helper.EnablePcap (pcapName, device, filter, false, true);
+  helper.EnableAscii (asciiName, device, filter, true);
+  NS_TEST_ASSERT_MSG_NE (helper.m_file, 0, "No pcap file created");
+  NS_TEST_ASSERT_MSG_NE (helper.m_file->GetTraceFilter (), 0, "No filter attached to the pcap file");
+  NS_TEST_EXPECT_MSG_EQ (helper.m_file->GetSnapLen (), 64, "Snap length of the filter not applied");
+
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      helper.m_file->Write (Seconds (i), p);
+      AsciiTraceHelper::DefaultReceiveSinkWithoutContext (helper.m_stream, p);
+    }
+  helper.m_file = 0;
+  helper.m_stream = 0;
+
+  PcapFile f;
+  f.Open (pcapName, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << pcapName << ") returns error");
+  uint8_t data[1000];
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  uint32_t n = 0;
+  while (true)
+    {
+      f.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (f.Fail ())
+        {
+          break;
+        }
+      NS_TEST_EXPECT_MSG_EQ (tsSec, 2 * n, "Wrong packet sampled");
+      NS_TEST_EXPECT_MSG_EQ (inclLen, 64, "Packet not truncated to the snap length");
+      NS_TEST_EXPECT_MSG_EQ (origLen, 1000, "Wrong original length");
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 5, "1-in-2 sampling of 10 packets must keep 5 packets");
+  f.Close ();
+
+  std::ifstream ascii (asciiName.c_str ());
+  std::string line;
+  n = 0;
+  while (std::getline (ascii, line))
+    {
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 5, "The ascii file is not sampled independently of the pcap file");
+
+  std::remove (pcapName.c_str ());
+  std::remove (asciiName.c_str ());
+  Simulator::Destroy ();
+}
+
+class TraceFilterTestSuite : public TestSuite
+{
+public:
+  TraceFilterTestSuite ();
+};
+
+TraceFilterTestSuite::TraceFilterTestSuite ()
+  : TestSuite ("trace-filter", UNIT)
+{
+  AddTestCase (new TraceFilterMatchTestCase, TestCase::QUICK);
+  AddTestCase (new TraceFilterHelperTestCase, TestCase::QUICK);
+}
+
+static TraceFilterTestSuite traceFilterTestSuite;
@@ -0,0 +1,258 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "binary-trace-writer.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceWriter");
+
+namespace ns3 {
+
+namespace {
+
+const uint32_t MAGIC = 0x4e334254;    /**< "N3BT" in the byte order of the writer */
+const uint16_t VERSION = 1;
+const uint32_t FILE_HEADER_SIZE = 16;
+const uint32_t RECORD_SIZE = 40;
+const uint32_t NO_INDEX = 0xffffffff;
+const char CONTEXT_EVENT = 'c';       /**< Record defining a context string */
+
+/**
+ * The in-memory view of one record, serialized field by field so that
+ * the layout does not depend on the padding rules of the compiler.
+ */
+struct Record
+{
+  double time;
+  uint64_t uid;
+  uint32_t node;
+  uint32_t device;
+  uint32_t size;
+  uint32_t context;
+  // the length of the snapshot or of the context string which follows.
+  uint32_t extra;
+  uint8_t event;
+};
+
+void
+WriteRecord (std::ostream &os, struct Record const &r)
+{
+  uint8_t buffer[RECORD_SIZE];
+  std::memset (buffer, 0, RECORD_SIZE);
+  std::memcpy (buffer, &r.time, 8);
+  std::memcpy (buffer + 8, &r.uid, 8);
+  std::memcpy (buffer + 16, &r.node, 4);
+  std::memcpy (buffer + 20, &r.device, 4);
+  std::memcpy (buffer + 24, &r.size, 4);
+  std::memcpy (buffer + 28, &r.context, 4);
+  std::memcpy (buffer + 32, &r.extra, 4);
+  buffer[36] = r.event;
+  os.write ((char const *)buffer, RECORD_SIZE);
+}
+
+bool
+ReadRecord (std::istream &is, struct Record &r)
+{
+  uint8_t buffer[RECORD_SIZE];
+  if (!is.read ((char *)buffer, RECORD_SIZE))
+    {
+      return false;
+    }
+  std::memcpy (&r.time, buffer, 8);
+  std::memcpy (&r.uid, buffer + 8, 8);
+  std::memcpy (&r.node, buffer + 16, 4);
+  std::memcpy (&r.device, buffer + 20, 4);
+  std::memcpy (&r.size, buffer + 24, 4);
+  std::memcpy (&r.context, buffer + 28, 4);
+  std::memcpy (&r.extra, buffer + 32, 4);
+  r.event = buffer[36];
+  return true;
+}
+
+} // anonymous namespace
+
+BinaryTraceWriter::BinaryTraceWriter (std::ostream *os, bool snapshots)
+  : m_os (os),
+    m_snapshots (snapshots)
+{
+  NS_LOG_FUNCTION (this << os << snapshots);
+  m_last = m_contexts.end ();
+  uint8_t header[FILE_HEADER_SIZE];
+  std::memset (header, 0, FILE_HEADER_SIZE);
+  std::memcpy (header, &MAGIC, 4);
+  std::memcpy (header + 4, &VERSION, 2);
+  uint16_t recordSize = RECORD_SIZE;
+  std::memcpy (header + 6, &recordSize, 2);
+  m_os->write ((char const *)header, FILE_HEADER_SIZE);
+}
+
+BinaryTraceWriter::Context const &
+BinaryTraceWriter::LookupContext (std::string const &context)
+{
+  if (m_last != m_contexts.end () && m_last->first == context)
+    {
+      return m_last->second;
+    }
+  m_last = m_contexts.find (context);
+  if (m_last != m_contexts.end ())
+    {
+      return m_last->second;
+    }
+
+  struct Context c;
+  c.id = m_contexts.size ();
+  c.node = NO_INDEX;
+  c.device = NO_INDEX;
+  unsigned int node, device;
+  int n = std::sscanf (context.c_str (), "/NodeList/%u/DeviceList/%u", &node, &device);
+  if (n >= 1)
+    {
+      c.node = node;
+    }
+  if (n == 2)
+    {
+      c.device = device;
+    }
+  m_last = m_contexts.insert (std::make_pair (context, c)).first;
+
+  struct Record r;
+  std::memset (&r, 0, sizeof (r));
+  r.context = c.id;
+  r.node = c.node;
+  r.device = c.device;
+  r.extra = context.size ();
+  r.event = CONTEXT_EVENT;
+  WriteRecord (*m_os, r);
+  m_os->write (context.data (), context.size ());
+  return m_last->second;
+}
+
+void
+BinaryTraceWriter::Write (char event, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << event << context << p);
+  struct Record r;
+  r.time = Simulator::Now ().GetSeconds ();
+  r.uid = p->GetUid ();
+  r.size = p->GetSize ();
+  r.event = event;
+  r.extra = 0;
+  if (context.empty ())
+    {
+      r.context = NO_INDEX;
+      r.node = Simulator::GetContext ();
+      r.device = NO_INDEX;
+    }
+  else
+    {
+      Context const &c = LookupContext (context);
+      r.context = c.id;
+      r.node = c.node;
+      r.device = c.device;
+    }
+  if (m_snapshots)
+    {
+      // Packet::Serialize works on 32-bit words.
+      r.extra = p->GetSerializedSize ();
+      m_snapshot.resize ((r.extra + 3) / 4);
+      uint8_t *buffer = reinterpret_cast<uint8_t *> (&m_snapshot[0]);
+      if (p->Serialize (buffer, r.extra) == 0)
+        {
+          r.extra = 0;
+        }
+      WriteRecord (*m_os, r);
+      m_os->write ((char const *)buffer, r.extra);
+    }
+  else
+    {
+      WriteRecord (*m_os, r);
+    }
+}
+
+bool
+BinaryTraceWriter::ConvertToAscii (std::istream &in, std::ostream &out)
+{
+  NS_LOG_FUNCTION (&in << &out);
+  uint8_t header[FILE_HEADER_SIZE];
+  if (!in.read ((char *)header, FILE_HEADER_SIZE))
+    {
+      return false;
+    }
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordSize;
+  std::memcpy (&magic, header, 4);
+  std::memcpy (&version, header + 4, 2);
+  std::memcpy (&recordSize, header + 6, 2);
+  if (magic != MAGIC || version != VERSION || recordSize != RECORD_SIZE)
+    {
+      NS_LOG_LOGIC ("Not a binary trace, or written by a host of different byte order");
+      return false;
+    }
+
+  std::vector<std::string> contexts;
+  std::vector<uint32_t> snapshot;
+  struct Record r;
+  while (ReadRecord (in, r))
+    {
+      if (r.event == CONTEXT_EVENT)
+        {
+          if (r.context != contexts.size ())
+            {
+              return false;
+            }
+          std::string context (r.extra, '\0');
+          if (r.extra > 0 && !in.read (&context[0], r.extra))
+            {
+              return false;
+            }
+          contexts.push_back (context);
+          continue;
+        }
+
+      out << r.event << " " << r.time << " ";
+      if (r.context != NO_INDEX)
+        {
+          if (r.context >= contexts.size ())
+            {
+              return false;
+            }
+          out << contexts[r.context] << " ";
+        }
+      if (r.extra > 0)
+        {
+          snapshot.resize ((r.extra + 3) / 4);
+          uint8_t *buffer = reinterpret_cast<uint8_t *> (&snapshot[0]);
+          if (!in.read ((char *)buffer, r.extra))
+            {
+              return false;
+            }
+          Ptr<Packet> p = Create<Packet> (buffer, r.extra, true);
+          out << *p << std::endl;
+        }
+      else
+        {
+          out << "uid=" << r.uid << " size=" << r.size << std::endl;
+        }
+    }
+  return in.eof () && in.gcount () == 0;
+}
+
+} // namespace ns3
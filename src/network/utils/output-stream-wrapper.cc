@@ -17,6 +17,8 @@
  */
 
 #include "output-stream-wrapper.h"
+#include "binary-trace-writer.h"
+#include "trace-filter.h"
 #include "ns3/log.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
@@ -50,6 +52,7 @@ OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::UnregisterStream (m_ostream);
+  m_binaryWriter = 0;
   if (m_destroyable) delete m_ostream;
   m_ostream = 0;
 }
@@ -61,4 +64,30 @@ OutputStreamWrapper::GetStream (void)
   return m_ostream;
 }
 
+void
+OutputStreamWrapper::SetBinaryTraceWriter (Ptr<BinaryTraceWriter> writer)
+{
+  NS_LOG_FUNCTION (this << writer);
+  m_binaryWriter = writer;
+}
+
+Ptr<BinaryTraceWriter>
+OutputStreamWrapper::GetBinaryTraceWriter (void) const
+{
+  return m_binaryWriter;
+}
+
+void
+OutputStreamWrapper::SetTraceFilter (Ptr<TraceFilter> filter)
+{
+  NS_LOG_FUNCTION (this << filter);
+  m_filter = filter;
+}
+
+Ptr<TraceFilter>
+OutputStreamWrapper::GetTraceFilter (void) const
+{
+  return m_filter;
+}
+
 } // namespace ns3
@@ -26,6 +26,9 @@
 
 namespace ns3 {
 
+class BinaryTraceWriter;
+class TraceFilter;
+
 /*
  * @brief A class encapsulating an STL output stream.
  *
@@ -83,9 +86,33 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * \param writer the writer used by the default trace sinks of
+   *        AsciiTraceHelper to record the events in binary form
+   *        instead of formatting them to the stream.
+   */
+  void SetBinaryTraceWriter (Ptr<BinaryTraceWriter> writer);
+  /**
+   * \returns the binary writer of this stream, or zero if the
+   *          events are written as text.
+   */
+  Ptr<BinaryTraceWriter> GetBinaryTraceWriter (void) const;
+  /**
+   * \param filter the filter which selects the packets written by the
+   *        default trace sinks of AsciiTraceHelper, or zero to write all
+   *        the packets.
+   */
+  void SetTraceFilter (Ptr<TraceFilter> filter);
+  /**
+   * \returns the filter of this stream, or zero if none.
+   */
+  Ptr<TraceFilter> GetTraceFilter (void) const;
+
 private:
   std::ostream *m_ostream;
   bool m_destroyable;
+  Ptr<BinaryTraceWriter> m_binaryWriter;
+  Ptr<TraceFilter> m_filter;
 };
 
 } // namespace ns3
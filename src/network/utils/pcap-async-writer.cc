@@ -0,0 +1,547 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <map>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include "ns3/core-config.h"
+#if defined (HAVE_SYS_UIO_H) && defined (HAVE_FCNTL_H) && defined (HAVE_UNISTD_H)
+#define PCAP_ASYNC_WRITER_WRITEV 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif /* HAVE_SYS_UIO_H && HAVE_FCNTL_H && HAVE_UNISTD_H */
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/singleton.h"
+#include "pcap-async-writer.h"
+
+#if defined (PCAP_ASYNC_WRITER_WRITEV) && !defined (IOV_MAX)
+#define IOV_MAX 16
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("PcapAsyncWriter");
+
+namespace ns3 {
+
+// how long the threads sleep before they check again for
+// work or completion when they missed a wake up.
+static const uint64_t WAIT_NS = 1000000;
+
+PcapAsyncWriter::PcapAsyncWriter ()
+  : m_batchSize (256 * 1024),
+    m_maxOpenFiles (64),
+    m_maxPendingBytes (64 * 1024 * 1024),
+    m_pendingBytes (0),
+    m_pendingBatches (0),
+    m_writtenBytes (0),
+    m_droppedBytes (0)
+#ifdef HAVE_PTHREAD_H
+    ,
+    m_stop (false),
+    m_thread (0)
+#endif /* HAVE_PTHREAD_H */
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapAsyncWriter::~PcapAsyncWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      {
+        CriticalSection cs (m_mutex);
+        m_stop = true;
+      }
+      m_wakeup.SetCondition (true);
+      m_wakeup.Signal ();
+      m_thread->Join ();
+      m_thread = 0;
+    }
+#endif /* HAVE_PTHREAD_H */
+  for (std::vector<struct Stream *>::iterator i = m_streams.begin (); i != m_streams.end (); ++i)
+    {
+      if (*i != 0)
+        {
+          CloseFile (*i);
+          delete (*i)->batch;
+          delete *i;
+        }
+    }
+  m_streams.clear ();
+}
+
+PcapAsyncWriter *
+PcapAsyncWriter::Get (void)
+{
+  return Singleton<PcapAsyncWriter>::Get ();
+}
+
+void
+PcapAsyncWriter::SetBatchSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (size > 0);
+  m_batchSize = size;
+}
+
+void
+PcapAsyncWriter::SetMaxOpenFiles (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT (n > 0);
+  m_maxOpenFiles = n;
+}
+
+void
+PcapAsyncWriter::SetMaxPendingBytes (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_maxPendingBytes = size;
+}
+
+uint32_t
+PcapAsyncWriter::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+#ifdef HAVE_PTHREAD_H
+  if (m_thread == 0)
+    {
+      m_thread = Create<SystemThread> (MakeCallback (&PcapAsyncWriter::Run, this));
+      m_thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+  struct Stream *stream = new struct Stream;
+  stream->filename = filename;
+  stream->batch = new std::vector<uint8_t>;
+  stream->batch->reserve (m_batchSize);
+  stream->pending = 0;
+#ifdef PCAP_ASYNC_WRITER_WRITEV
+  stream->fd = -1;
+#else
+  stream->file = 0;
+#endif /* PCAP_ASYNC_WRITER_WRITEV */
+  stream->created = false;
+  m_streams.push_back (stream);
+  return m_streams.size () - 1;
+}
+
+uint8_t *
+PcapAsyncWriter::Reserve (uint32_t stream, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << stream << size);
+  NS_ASSERT (stream < m_streams.size () && m_streams[stream] != 0);
+  struct Stream *s = m_streams[stream];
+  if (!s->batch->empty () && s->batch->size () + size > m_batchSize)
+    {
+      Submit (s, false);
+    }
+  uint32_t offset = s->batch->size ();
+  s->batch->resize (offset + size);
+  return &(*s->batch)[offset];
+}
+
+void
+PcapAsyncWriter::Write (uint32_t stream, uint8_t const *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << stream << &data << size);
+  if (size > 0)
+    {
+      std::memcpy (Reserve (stream, size), data, size);
+    }
+}
+
+void
+PcapAsyncWriter::Close (uint32_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  NS_ASSERT (stream < m_streams.size () && m_streams[stream] != 0);
+  struct Stream *s = m_streams[stream];
+  Submit (s, true);
+  WaitPending (s);
+  delete s;
+  m_streams[stream] = 0;
+}
+
+void
+PcapAsyncWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<struct Stream *>::iterator i = m_streams.begin (); i != m_streams.end (); ++i)
+    {
+      if (*i != 0 && !(*i)->batch->empty ())
+        {
+          Submit (*i, false);
+        }
+    }
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_done.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (m_pendingBatches == 0)
+          {
+            break;
+          }
+      }
+      m_done.TimedWait (WAIT_NS);
+    }
+#endif /* HAVE_PTHREAD_H */
+  LogErrors ();
+}
+
+uint64_t
+PcapAsyncWriter::GetBufferedBytes (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t buffered = 0;
+  for (std::vector<struct Stream *>::const_iterator i = m_streams.begin (); i != m_streams.end (); ++i)
+    {
+      if (*i != 0)
+        {
+          buffered += (*i)->batch->size ();
+        }
+    }
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  return buffered + m_pendingBytes;
+}
+
+uint64_t
+PcapAsyncWriter::GetWrittenBytes (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  return m_writtenBytes;
+}
+
+uint64_t
+PcapAsyncWriter::GetDroppedBytes (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  return m_droppedBytes;
+}
+
+void
+PcapAsyncWriter::Submit (struct Stream *stream, bool close)
+{
+  NS_LOG_FUNCTION (this << stream << close);
+  struct Batch batch;
+  batch.stream = stream;
+  batch.data = stream->batch;
+  batch.close = close;
+  uint32_t bytes = batch.data->size ();
+  if (close)
+    {
+      stream->batch = 0;
+    }
+  else
+    {
+      stream->batch = new std::vector<uint8_t>;
+      stream->batch->reserve (m_batchSize);
+    }
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_done.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (m_pendingBytes == 0 || m_pendingBytes + bytes <= m_maxPendingBytes)
+          {
+            m_queue.push_back (batch);
+            stream->pending++;
+            m_pendingBatches++;
+            m_pendingBytes += bytes;
+            break;
+          }
+      }
+      // the background thread is too far behind: wait for it.
+      m_done.TimedWait (WAIT_NS);
+    }
+  m_wakeup.SetCondition (true);
+  m_wakeup.Signal ();
+#else /* HAVE_PTHREAD_H */
+  stream->pending++;
+  m_pendingBatches++;
+  m_pendingBytes += bytes;
+  std::vector<struct Batch> work (1, batch);
+  Process (work);
+#endif /* HAVE_PTHREAD_H */
+  LogErrors ();
+}
+
+void
+PcapAsyncWriter::WaitPending (struct Stream *stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_done.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (stream->pending == 0)
+          {
+            break;
+          }
+      }
+      m_done.TimedWait (WAIT_NS);
+    }
+#else /* HAVE_PTHREAD_H */
+  NS_ASSERT (stream->pending == 0);
+#endif /* HAVE_PTHREAD_H */
+  LogErrors ();
+}
+
+// The functions below run in the background thread: they must not log,
+// because the log components are not thread-safe.
+#ifdef HAVE_PTHREAD_H
+void
+PcapAsyncWriter::Run (void)
+{
+  while (true)
+    {
+      m_wakeup.SetCondition (false);
+      std::vector<struct Batch> work;
+      bool stop;
+      {
+        CriticalSection cs (m_mutex);
+        work.swap (m_queue);
+        stop = m_stop;
+      }
+      if (!work.empty ())
+        {
+          Process (work);
+          m_done.SetCondition (true);
+          m_done.Broadcast ();
+        }
+      else if (stop)
+        {
+          break;
+        }
+      else
+        {
+          m_wakeup.TimedWait (WAIT_NS);
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+void
+PcapAsyncWriter::Process (std::vector<struct Batch> &work)
+{
+  // keep the batches of each stream in order, and write them together.
+  std::map<struct Stream *, std::vector<struct Batch> > streams;
+  for (std::vector<struct Batch>::const_iterator i = work.begin (); i != work.end (); ++i)
+    {
+      streams[i->stream].push_back (*i);
+    }
+  for (std::map<struct Stream *, std::vector<struct Batch> >::iterator i = streams.begin ();
+       i != streams.end (); ++i)
+    {
+      WriteBatches (i->first, i->second);
+    }
+}
+
+void
+PcapAsyncWriter::WriteBatches (struct Stream *stream, std::vector<struct Batch> &batches)
+{
+  uint64_t bytes = 0;
+  bool closing = false;
+  for (std::vector<struct Batch>::const_iterator i = batches.begin (); i != batches.end (); ++i)
+    {
+      bytes += i->data->size ();
+      closing |= i->close;
+    }
+
+  uint64_t written = 0;
+  if ((bytes > 0 || (closing && !stream->created)) && OpenFile (stream))
+    {
+#ifdef PCAP_ASYNC_WRITER_WRITEV
+      std::vector<struct iovec> iov;
+      for (std::vector<struct Batch>::const_iterator i = batches.begin (); i != batches.end (); ++i)
+        {
+          if (!i->data->empty ())
+            {
+              struct iovec v;
+              v.iov_base = &(*i->data)[0];
+              v.iov_len = i->data->size ();
+              iov.push_back (v);
+            }
+        }
+      uint32_t current = 0;
+      while (current < iov.size ())
+        {
+          int n = std::min<size_t> (iov.size () - current, IOV_MAX);
+          ssize_t result = writev (stream->fd, &iov[current], n);
+          if (result < 0)
+            {
+              if (errno == EINTR)
+                {
+                  continue;
+                }
+              AddError ("writev failed for " + stream->filename + ": " + std::strerror (errno));
+              break;
+            }
+          written += result;
+          while (current < iov.size () && static_cast<size_t> (result) >= iov[current].iov_len)
+            {
+              result -= iov[current].iov_len;
+              current++;
+            }
+          if (current < iov.size ())
+            {
+              iov[current].iov_base = static_cast<uint8_t *> (iov[current].iov_base) + result;
+              iov[current].iov_len -= result;
+            }
+        }
+#else /* PCAP_ASYNC_WRITER_WRITEV */
+      for (std::vector<struct Batch>::const_iterator i = batches.begin (); i != batches.end (); ++i)
+        {
+          if (i->data->empty ())
+            {
+              continue;
+            }
+          size_t result = std::fwrite (&(*i->data)[0], 1, i->data->size (), stream->file);
+          written += result;
+          if (result < i->data->size ())
+            {
+              AddError ("fwrite failed for " + stream->filename + ": " + std::strerror (errno));
+              break;
+            }
+        }
+      std::fflush (stream->file);
+#endif /* PCAP_ASYNC_WRITER_WRITEV */
+    }
+  if (closing)
+    {
+      CloseFile (stream);
+    }
+
+  for (std::vector<struct Batch>::iterator i = batches.begin (); i != batches.end (); ++i)
+    {
+      delete i->data;
+    }
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  m_writtenBytes += written;
+  m_droppedBytes += bytes - written;
+  m_pendingBytes -= bytes;
+  m_pendingBatches -= batches.size ();
+  // once pending reaches zero after a close, the stream may be
+  // deleted by the simulation thread at any time.
+  stream->pending -= batches.size ();
+}
+
+bool
+PcapAsyncWriter::OpenFile (struct Stream *stream)
+{
+#ifdef PCAP_ASYNC_WRITER_WRITEV
+  bool open = stream->fd >= 0;
+#else
+  bool open = stream->file != 0;
+#endif /* PCAP_ASYNC_WRITER_WRITEV */
+  if (open)
+    {
+      m_openFiles.erase (stream->lru);
+      m_openFiles.push_front (stream);
+      stream->lru = m_openFiles.begin ();
+      return true;
+    }
+  while (!m_openFiles.empty () && m_openFiles.size () >= m_maxOpenFiles)
+    {
+      CloseFile (m_openFiles.back ());
+    }
+#ifdef PCAP_ASYNC_WRITER_WRITEV
+  int flags = O_WRONLY | O_CREAT | (stream->created ? O_APPEND : O_TRUNC);
+  stream->fd = ::open (stream->filename.c_str (), flags, 0644);
+  open = stream->fd >= 0;
+#else
+  stream->file = std::fopen (stream->filename.c_str (), stream->created ? "ab" : "wb");
+  open = stream->file != 0;
+#endif /* PCAP_ASYNC_WRITER_WRITEV */
+  if (!open)
+    {
+      AddError ("could not open " + stream->filename + ": " + std::strerror (errno));
+      return false;
+    }
+  stream->created = true;
+  m_openFiles.push_front (stream);
+  stream->lru = m_openFiles.begin ();
+  return true;
+}
+
+void
+PcapAsyncWriter::CloseFile (struct Stream *stream)
+{
+#ifdef PCAP_ASYNC_WRITER_WRITEV
+  if (stream->fd >= 0)
+    {
+      close (stream->fd);
+      stream->fd = -1;
+      m_openFiles.erase (stream->lru);
+    }
+#else
+  if (stream->file != 0)
+    {
+      std::fclose (stream->file);
+      stream->file = 0;
+      m_openFiles.erase (stream->lru);
+    }
+#endif /* PCAP_ASYNC_WRITER_WRITEV */
+}
+
+void
+PcapAsyncWriter::AddError (std::string const &error)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  m_errors.push_back (error);
+}
+
+// Back in the simulation thread.
+void
+PcapAsyncWriter::LogErrors (void)
+{
+  std::vector<std::string> errors;
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+    errors.swap (m_errors);
+  }
+  for (std::vector<std::string>::const_iterator i = errors.begin (); i != errors.end (); ++i)
+    {
+      NS_LOG_WARN (*i);
+    }
+}
+
+} // namespace ns3
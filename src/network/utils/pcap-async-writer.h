@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_ASYNC_WRITER_H
+#define PCAP_ASYNC_WRITER_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <cstdio>
+#include <stdint.h>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+/**
+ * \brief Buffered writer shared by all the PcapFile instances
+ * opened in asynchronous mode.
+ *
+ * The bytes written to each file are accumulated in large batches
+ * by the simulation thread. Full batches are handed over to a
+ * background thread which writes all the pending batches of a file
+ * with a single writev call. The background thread keeps at most
+ * SetMaxOpenFiles file descriptors open at any time: the least
+ * recently written files are closed and re-opened in append mode
+ * when more data needs to be written to them, so that simulations
+ * with thousands of captures do not run out of file descriptors.
+ *
+ * If the background thread falls behind by more than
+ * SetMaxPendingBytes bytes, the simulation thread waits for it:
+ * records are never discarded because of a slow disk. The bytes
+ * which could not be written because of an I/O error are reported
+ * by GetDroppedBytes.
+ *
+ * When threads are not available, the batches are written
+ * synchronously by the simulation thread. When writev is not
+ * available, the batches are written one by one with stdio.
+ *
+ * The background thread never logs: the I/O errors it meets are
+ * queued and logged by the simulation thread the next time it
+ * hands over a batch or waits for the background thread.
+ */
+class PcapAsyncWriter
+{
+public:
+  PcapAsyncWriter ();
+  /**
+   * Write all the buffered data, stop the background thread and
+   * close all the files.
+   */
+  ~PcapAsyncWriter ();
+
+  /**
+   * \returns the writer shared by all asynchronous pcap files.
+   */
+  static PcapAsyncWriter *Get (void);
+
+  /**
+   * \param size the number of bytes accumulated for a file before
+   *        they are handed over to the background thread.
+   */
+  void SetBatchSize (uint32_t size);
+  /**
+   * \param n the maximum number of file descriptors kept open by
+   *        the background thread.
+   */
+  void SetMaxOpenFiles (uint32_t n);
+  /**
+   * \param size the maximum number of bytes handed over to the
+   *        background thread and not yet written.
+   */
+  void SetMaxPendingBytes (uint32_t size);
+
+  /**
+   * \param filename the name of the file to create.
+   * \returns the identifier of the new stream.
+   *
+   * The file is truncated when its first batch is written, or when
+   * the stream is closed if no data was ever written to it.
+   */
+  uint32_t Open (std::string const &filename);
+  /**
+   * \param stream the identifier returned by Open.
+   * \param data the bytes to write.
+   * \param size the number of bytes to write.
+   */
+  void Write (uint32_t stream, uint8_t const *data, uint32_t size);
+  /**
+   * \param stream the identifier returned by Open.
+   * \param size the number of bytes to reserve.
+   * \returns a pointer to \p size bytes which will be written to
+   *          the stream. It is invalidated by the next call to
+   *          Write, Reserve or Close for this stream.
+   */
+  uint8_t *Reserve (uint32_t stream, uint32_t size);
+  /**
+   * \param stream the identifier returned by Open.
+   *
+   * Write all the data of this stream, close its file and wait
+   * for the file to be complete.
+   */
+  void Close (uint32_t stream);
+  /**
+   * Write the data of all the streams and wait for the
+   * background thread to be done with it.
+   */
+  void Flush (void);
+
+  /**
+   * \returns the number of bytes received but not yet written.
+   */
+  uint64_t GetBufferedBytes (void);
+  /**
+   * \returns the number of bytes written to the files.
+   */
+  uint64_t GetWrittenBytes (void);
+  /**
+   * \returns the number of bytes lost because of I/O errors.
+   */
+  uint64_t GetDroppedBytes (void);
+
+private:
+  struct Stream
+  {
+    std::string filename;
+    // filled by the simulation thread only.
+    std::vector<uint8_t> *batch;
+    // the number of batches handed over and not yet written.
+    uint32_t pending;
+    // the fields below are used by the background thread only.
+#if defined (HAVE_SYS_UIO_H) && defined (HAVE_FCNTL_H) && defined (HAVE_UNISTD_H)
+    int fd;
+#else
+    std::FILE *file;
+#endif
+    bool created;
+    std::list<struct Stream *>::iterator lru;
+  };
+  struct Batch
+  {
+    struct Stream *stream;
+    std::vector<uint8_t> *data;
+    bool close;
+  };
+
+  void Submit (struct Stream *stream, bool close);
+  void WaitPending (struct Stream *stream);
+  void Process (std::vector<struct Batch> &work);
+  void WriteBatches (struct Stream *stream, std::vector<struct Batch> &batches);
+  bool OpenFile (struct Stream *stream);
+  void CloseFile (struct Stream *stream);
+  void AddError (std::string const &error);
+  void LogErrors (void);
+#ifdef HAVE_PTHREAD_H
+  void Run (void);
+#endif /* HAVE_PTHREAD_H */
+
+  std::vector<struct Stream *> m_streams;
+  std::vector<struct Batch> m_queue;
+  std::list<struct Stream *> m_openFiles;
+  std::vector<std::string> m_errors;
+  uint32_t m_batchSize;
+  uint32_t m_maxOpenFiles;
+  uint32_t m_maxPendingBytes;
+  uint64_t m_pendingBytes;
+  uint32_t m_pendingBatches;
+  uint64_t m_writtenBytes;
+  uint64_t m_droppedBytes;
+#ifdef HAVE_PTHREAD_H
+  bool m_stop;
+  Ptr<SystemThread> m_thread;
+  SystemMutex m_mutex;
+  SystemCondition m_wakeup;
+  SystemCondition m_done;
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* PCAP_ASYNC_WRITER_H */
@@ -18,6 +18,7 @@
 
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -39,6 +40,12 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("Async",
+                   "Write the file from a background thread shared by all pcap files "
+                   "(cf. ns3::PcapAsyncWriter). The file is complete only once closed.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_async),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -86,6 +93,7 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  m_file.SetAsync (m_async);
   m_file.Open (filename, mode);
 }
 
@@ -112,6 +120,10 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_filter != 0 && !m_filter->Match (p, m_file.GetDataLinkType ()))
+    {
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -123,6 +135,10 @@ void
 PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_filter != 0 && !m_filter->Match (header, p, m_file.GetDataLinkType ()))
+    {
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -134,6 +150,10 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_filter != 0 && !m_filter->Match (buffer, length, m_file.GetDataLinkType ()))
+    {
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -141,6 +161,19 @@ PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
   m_file.Write (s, us, buffer, length);
 }
 
+void
+PcapFileWrapper::SetTraceFilter (Ptr<TraceFilter> filter)
+{
+  NS_LOG_FUNCTION (this << filter);
+  m_filter = filter;
+}
+
+Ptr<TraceFilter>
+PcapFileWrapper::GetTraceFilter (void) const
+{
+  return m_filter;
+}
+
 uint32_t
 PcapFileWrapper::GetMagic (void)
 {
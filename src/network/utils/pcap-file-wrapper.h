@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "trace-filter.h"
 
 namespace ns3 {
 
@@ -194,9 +195,21 @@ public:
    */ 
   uint32_t GetDataLinkType (void);
 
+  /**
+   * \param filter the filter which selects the packets written by the
+   *        Write methods, or zero to write all the packets.
+   */
+  void SetTraceFilter (Ptr<TraceFilter> filter);
+  /**
+   * \returns the filter of this file, or zero if none.
+   */
+  Ptr<TraceFilter> GetTraceFilter (void) const;
+
 private:
   PcapFile m_file;
+  Ptr<TraceFilter> m_filter;
   uint32_t m_snapLen;
+  bool m_async;
 };
 
 } // namespace ns3
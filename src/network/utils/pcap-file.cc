@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 #include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
@@ -27,6 +28,8 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "pcap-async-writer.h"
+#include "pcap-mapped-file.h"
 #include "ns3/log.h"
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
@@ -49,7 +52,10 @@ const int32_t  SIGFIGS_DEFAULT = 0;           /**< Significant figures for times
 
 PcapFile::PcapFile ()
   : m_file (),
-    m_swapMode (false)
+    m_swapMode (false),
+    m_async (false),
+    m_asyncOpen (false),
+    m_asyncStream (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -87,9 +93,37 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_asyncOpen)
+    {
+      PcapAsyncWriter::Get ()->Close (m_asyncStream);
+      m_asyncOpen = false;
+      return;
+    }
   m_file.close ();
 }
 
+void
+PcapFile::SetAsync (bool async)
+{
+  NS_LOG_FUNCTION (this << async);
+  NS_ASSERT (!m_asyncOpen && !m_file.is_open ());
+  m_async = async;
+}
+
+void
+PcapFile::WriteRaw (void const *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << data << size);
+  if (m_asyncOpen)
+    {
+      PcapAsyncWriter::Get ()->Write (m_asyncStream, static_cast<uint8_t const *> (data), size);
+    }
+  else
+    {
+      m_file.write (static_cast<char const *> (data), size);
+    }
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -196,9 +230,13 @@ PcapFile::WriteFileHeader (void)
   NS_LOG_FUNCTION (this);
   //
   // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
+  // at the start of the file.  Asynchronous files are written sequentially,
+  // which is fine since Init is called before any record is written.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (!m_asyncOpen)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -226,13 +264,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteRaw (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteRaw (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteRaw (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteRaw (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteRaw (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteRaw (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteRaw (&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -318,6 +356,12 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
   //
   mode |= std::ios::binary;
 
+  if (m_async && !(mode & std::ios::in))
+    {
+      m_asyncStream = PcapAsyncWriter::Get ()->Open (filename);
+      m_asyncOpen = true;
+      return;
+    }
   m_file.open (filename.c_str (), mode);
   if (mode & std::ios::in)
     {
@@ -394,10 +438,10 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  WriteRaw (&header.m_tsSec, sizeof(header.m_tsSec));
+  WriteRaw (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  WriteRaw (&header.m_inclLen, sizeof(header.m_inclLen));
+  WriteRaw (&header.m_origLen, sizeof(header.m_origLen));
   return inclLen;
 }
 
@@ -406,7 +450,7 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
+  WriteRaw (data, inclLen);
 }
 
 void 
@@ -414,6 +458,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_asyncOpen)
+    {
+      p->CopyData (PcapAsyncWriter::Get ()->Reserve (m_asyncStream, inclLen), inclLen);
+      return;
+    }
   p->CopyData (&m_file, inclLen);
 }
 
@@ -429,6 +478,13 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Header &header, Ptr<const Pack
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_asyncOpen)
+    {
+      uint8_t *buffer = PcapAsyncWriter::Get ()->Reserve (m_asyncStream, inclLen);
+      headerBuffer.CopyData (buffer, toCopy);
+      p->CopyData (buffer + toCopy, inclLen - toCopy);
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
@@ -499,76 +555,54 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
                 uint32_t snapLen)
 {
   NS_LOG_FUNCTION (f1 << f2 << sec << usec << snapLen);
-  PcapFile pcap1, pcap2;
-  pcap1.Open (f1, std::ios::in);
-  pcap2.Open (f2, std::ios::in);
-  bool bad = pcap1.Fail () || pcap2.Fail ();
-  if (bad)
+  //
+  // Both files are mapped in memory and compared in place, which is much
+  // faster than reading them record by record on large captures.
+  //
+  PcapMappedFile pcap1, pcap2;
+  if (!pcap1.Open (f1) || !pcap2.Open (f2))
     {
       return true;
     }
 
-  uint8_t *data1 = new uint8_t [snapLen] ();
-  uint8_t *data2 = new uint8_t [snapLen] ();
-  uint32_t tsSec1 = 0;
-  uint32_t tsSec2 = 0;
-  uint32_t tsUsec1 = 0;
-  uint32_t tsUsec2 = 0;
-  uint32_t inclLen1 = 0;
-  uint32_t inclLen2 = 0;
-  uint32_t origLen1 = 0;
-  uint32_t origLen2 = 0;
-  uint32_t readLen1 = 0;
-  uint32_t readLen2 = 0;
+  PcapMappedFile::Iterator i1 = pcap1.Begin ();
+  PcapMappedFile::Iterator i2 = pcap2.Begin ();
+  PcapMappedFile::Iterator end1 = pcap1.End ();
+  PcapMappedFile::Iterator end2 = pcap2.End ();
   bool diff = false;
 
-  while (!pcap1.Eof () && !pcap2.Eof ())
+  while (i1 != end1 && i2 != end2)
     {
-      pcap1.Read (data1, snapLen, tsSec1, tsUsec1, inclLen1, origLen1, readLen1);
-      pcap2.Read (data2, snapLen, tsSec2, tsUsec2, inclLen2, origLen2, readLen2);
-
-      bool same = pcap1.Fail () == pcap2.Fail ();
-      if (!same)
-        {
-          diff = true;
-          break;
-        }
-      if (pcap1.Eof ())
-        {
-          break;
-        }
-
-      if (tsSec1 != tsSec2 || tsUsec1 != tsUsec2)
+      sec = i1->GetTsSec ();
+      usec = i1->GetTsUsec ();
+      if (i1->GetTsSec () != i2->GetTsSec () || i1->GetTsUsec () != i2->GetTsUsec ())
         {
           diff = true; // Next packet timestamps do not match
           break;
         }
 
+      uint32_t readLen1 = std::min (snapLen, i1->GetInclLen ());
+      uint32_t readLen2 = std::min (snapLen, i2->GetInclLen ());
       if (readLen1 != readLen2)
         {
           diff = true; // Packet lengths do not match
           break;
         }
 
-      if (std::memcmp (data1, data2, readLen1) != 0)
+      if (std::memcmp (i1->GetData (), i2->GetData (), readLen1) != 0)
         {
           diff = true; // Packet data do not match
           break;
         }
+      ++i1;
+      ++i2;
     }
-  sec = tsSec1;
-  usec = tsUsec1;
 
-  bad = pcap1.Fail () || pcap2.Fail ();
-  bool eof = pcap1.Eof () && pcap2.Eof ();
-  if (bad && !eof)
+  if (i1 != end1 || i2 != end2 || i1.IsTruncated () || i2.IsTruncated ())
     {
       diff = true;
     }
 
-  delete[] data1;
-  delete[] data2;
-
   return diff;
 }
 
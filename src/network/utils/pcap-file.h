@@ -60,6 +60,18 @@ public:
    */
   void Clear (void);
 
+  /**
+   * \param async whether the files opened for writing by this object
+   *        should be written asynchronously.
+   *
+   * In asynchronous mode, the records are accumulated in memory and
+   * written by a background thread shared by all pcap files (see
+   * ns3::PcapAsyncWriter). The content of the file is complete only
+   * after Close returns. Files opened for reading are not affected.
+   * This method must be called before Open.
+   */
+  void SetAsync (bool async);
+
   /**
    * Create a new pcap file or open an existing pcap file.  Semantics are
    * similar to the stdc++ io stream classes, but differ in that
@@ -282,6 +294,7 @@ private:
   void Swap (PcapFileHeader *from, PcapFileHeader *to);
   void Swap (PcapRecordHeader *from, PcapRecordHeader *to);
 
+  void WriteRaw (void const *data, uint32_t size);
   void WriteFileHeader (void);
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
   void ReadAndVerifyFileHeader (void);
@@ -290,6 +303,10 @@ private:
   std::fstream   m_file;
   PcapFileHeader m_fileHeader;
   bool m_swapMode;
+  bool m_async;
+  // true while a file is open on the asynchronous writer.
+  bool m_asyncOpen;
+  uint32_t m_asyncStream;
 };
 
 } // namespace ns3
@@ -0,0 +1,367 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/core-config.h"
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_SYS_STAT_H) && defined (HAVE_FCNTL_H) && defined (HAVE_UNISTD_H)
+#define PCAP_MAPPED_FILE_MMAP 1
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif /* HAVE_SYS_MMAN_H && HAVE_SYS_STAT_H && HAVE_FCNTL_H && HAVE_UNISTD_H */
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "pcap-mapped-file.h"
+//
+// This file is used as part of the ns-3 test framework, so please refrain from
+// adding any ns-3 specific constructs such as Packet to this file.
+//
+
+NS_LOG_COMPONENT_DEFINE ("PcapMappedFile");
+
+namespace ns3 {
+
+namespace {
+
+const uint32_t MAGIC = 0xa1b2c3d4;            /**< Magic number identifying standard pcap file format */
+const uint32_t SWAPPED_MAGIC = 0xd4c3b2a1;    /**< Looks this way if byte swapping is required */
+const uint32_t NS_MAGIC = 0xa1b23cd4;         /**< Magic number identifying nanosec resolution pcap file format */
+const uint32_t NS_SWAPPED_MAGIC = 0xd43cb2a1; /**< Looks this way if byte swapping is required */
+const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
+const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
+
+const uint32_t FILE_HEADER_SIZE = 24;
+const uint32_t RECORD_HEADER_SIZE = 16;
+
+} // anonymous namespace
+
+uint32_t
+PcapMappedFile::Record::GetTsSec (void) const
+{
+  return m_tsSec;
+}
+uint32_t
+PcapMappedFile::Record::GetTsUsec (void) const
+{
+  return m_tsUsec;
+}
+uint32_t
+PcapMappedFile::Record::GetInclLen (void) const
+{
+  return m_inclLen;
+}
+uint32_t
+PcapMappedFile::Record::GetOrigLen (void) const
+{
+  return m_origLen;
+}
+uint8_t const *
+PcapMappedFile::Record::GetData (void) const
+{
+  return m_data;
+}
+
+PcapMappedFile::Iterator::Iterator ()
+  : m_file (0),
+    m_offset (0),
+    m_truncated (false)
+{
+}
+
+PcapMappedFile::Iterator::Iterator (PcapMappedFile const *file, uint64_t offset)
+  : m_file (file),
+    m_offset (offset),
+    m_truncated (false)
+{
+  Load ();
+}
+
+void
+PcapMappedFile::Iterator::Load (void)
+{
+  uint64_t size = m_file->m_size;
+  if (m_offset == size)
+    {
+      return;
+    }
+  if (size - m_offset < RECORD_HEADER_SIZE)
+    {
+      m_offset = size;
+      m_truncated = true;
+      return;
+    }
+  m_record.m_tsSec = m_file->ReadU32 (m_offset);
+  m_record.m_tsUsec = m_file->ReadU32 (m_offset + 4);
+  m_record.m_inclLen = m_file->ReadU32 (m_offset + 8);
+  m_record.m_origLen = m_file->ReadU32 (m_offset + 12);
+  if (size - m_offset - RECORD_HEADER_SIZE < m_record.m_inclLen)
+    {
+      m_offset = size;
+      m_truncated = true;
+      return;
+    }
+  m_record.m_data = m_file->m_data + m_offset + RECORD_HEADER_SIZE;
+}
+
+PcapMappedFile::Record const &
+PcapMappedFile::Iterator::operator * (void) const
+{
+  NS_ASSERT (m_offset < m_file->m_size);
+  return m_record;
+}
+
+PcapMappedFile::Record const *
+PcapMappedFile::Iterator::operator -> (void) const
+{
+  NS_ASSERT (m_offset < m_file->m_size);
+  return &m_record;
+}
+
+PcapMappedFile::Iterator &
+PcapMappedFile::Iterator::operator ++ (void)
+{
+  NS_ASSERT (m_offset < m_file->m_size);
+  m_offset += RECORD_HEADER_SIZE + m_record.m_inclLen;
+  Load ();
+  return *this;
+}
+
+bool
+PcapMappedFile::Iterator::operator == (Iterator const &o) const
+{
+  return m_file == o.m_file && m_offset == o.m_offset;
+}
+
+bool
+PcapMappedFile::Iterator::operator != (Iterator const &o) const
+{
+  return !(*this == o);
+}
+
+bool
+PcapMappedFile::Iterator::IsTruncated (void) const
+{
+  return m_truncated;
+}
+
+PcapMappedFile::PcapMappedFile ()
+  : m_data (0),
+    m_size (0),
+    m_magic (0),
+    m_snapLen (0),
+    m_type (0),
+    m_zone (0),
+    m_swapMode (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapMappedFile::~PcapMappedFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapMappedFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+
+#ifdef PCAP_MAPPED_FILE_MMAP
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_LOGIC ("Unable to open " << filename);
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) < 0 || st.st_size < (off_t)FILE_HEADER_SIZE)
+    {
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping keeps a reference to the file.
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_LOGIC ("Unable to map " << filename);
+      return false;
+    }
+#ifdef MADV_SEQUENTIAL
+  madvise (data, st.st_size, MADV_SEQUENTIAL);
+#endif
+  m_data = static_cast<uint8_t const *> (data);
+  m_size = st.st_size;
+#else /* PCAP_MAPPED_FILE_MMAP */
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+      NS_LOG_LOGIC ("Unable to open " << filename);
+      return false;
+    }
+  file.seekg (0, std::ios::end);
+  std::streamoff size = file.tellg ();
+  file.seekg (0, std::ios::beg);
+  if (size < (std::streamoff)FILE_HEADER_SIZE)
+    {
+      return false;
+    }
+  uint8_t *data = new uint8_t[size];
+  if (!file.read (reinterpret_cast<char *> (data), size))
+    {
+      NS_LOG_LOGIC ("Unable to read " << filename);
+      delete [] data;
+      return false;
+    }
+  m_data = data;
+  m_size = size;
+#endif /* PCAP_MAPPED_FILE_MMAP */
+
+  std::memcpy (&m_magic, m_data, sizeof (m_magic));
+  if (m_magic != MAGIC && m_magic != SWAPPED_MAGIC
+      && m_magic != NS_MAGIC && m_magic != NS_SWAPPED_MAGIC)
+    {
+      Close ();
+      return false;
+    }
+  m_swapMode = m_magic == SWAPPED_MAGIC || m_magic == NS_SWAPPED_MAGIC;
+  if (m_swapMode)
+    {
+      m_magic = ReadU32 (0);
+    }
+
+  uint16_t major = ReadU16 (4);
+  uint16_t minor = ReadU16 (6);
+  m_zone = ReadU32 (8);
+  m_snapLen = ReadU32 (16);
+  m_type = ReadU32 (20);
+  if (major != VERSION_MAJOR || minor != VERSION_MINOR
+      || m_zone < -12 || m_zone > 12)
+    {
+      Close ();
+      return false;
+    }
+  return true;
+}
+
+void
+PcapMappedFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+#ifdef PCAP_MAPPED_FILE_MMAP
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+#else
+      delete [] m_data;
+#endif /* PCAP_MAPPED_FILE_MMAP */
+    }
+  m_data = 0;
+  m_size = 0;
+}
+
+bool
+PcapMappedFile::Fail (void) const
+{
+  return m_data == 0;
+}
+
+PcapMappedFile::Iterator
+PcapMappedFile::Begin (void) const
+{
+  NS_ASSERT (!Fail ());
+  return Iterator (this, FILE_HEADER_SIZE);
+}
+
+PcapMappedFile::Iterator
+PcapMappedFile::End (void) const
+{
+  NS_ASSERT (!Fail ());
+  Iterator end;
+  end.m_file = this;
+  end.m_offset = m_size;
+  return end;
+}
+
+uint32_t
+PcapMappedFile::GetMagic (void) const
+{
+  return m_magic;
+}
+
+uint32_t
+PcapMappedFile::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+uint32_t
+PcapMappedFile::GetDataLinkType (void) const
+{
+  return m_type;
+}
+
+int32_t
+PcapMappedFile::GetTimeZoneOffset (void) const
+{
+  return m_zone;
+}
+
+bool
+PcapMappedFile::GetSwapMode (void) const
+{
+  return m_swapMode;
+}
+
+bool
+PcapMappedFile::IsNanosecond (void) const
+{
+  return m_magic == NS_MAGIC;
+}
+
+uint16_t
+PcapMappedFile::ReadU16 (uint64_t offset) const
+{
+  uint16_t v;
+  std::memcpy (&v, m_data + offset, sizeof (v));
+  if (m_swapMode)
+    {
+      v = (v << 8) | (v >> 8);
+    }
+  return v;
+}
+
+uint32_t
+PcapMappedFile::ReadU32 (uint64_t offset) const
+{
+  // the records are not aligned in the file.
+  uint32_t v;
+  std::memcpy (&v, m_data + offset, sizeof (v));
+  if (m_swapMode)
+    {
+      v = ((v & 0x000000ff) << 24) | ((v & 0x0000ff00) << 8)
+        | ((v & 0x00ff0000) >> 8) | ((v & 0xff000000) >> 24);
+    }
+  return v;
+}
+
+} // namespace ns3
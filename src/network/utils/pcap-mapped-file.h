@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_MAPPED_FILE_H
+#define PCAP_MAPPED_FILE_H
+
+#include <string>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief A read-only pcap file mapped in memory.
+ *
+ * The records are accessed through a forward Iterator which yields
+ * views on the mapped file: no data is copied, and the pages of the
+ * file are only read from disk when the record data is accessed.
+ *
+ * When mmap is not available, the whole file is read in memory with
+ * a stream when it is opened instead.
+ *
+ * Like PcapFile, this class is used by the test framework and does
+ * not depend on ns-3 specific constructs such as Packet.
+ */
+class PcapMappedFile
+{
+public:
+  /**
+   * \brief A view on one record of the file.
+   *
+   * The view is valid as long as the file stays open.
+   */
+  class Record
+  {
+public:
+    uint32_t GetTsSec (void) const;
+    /**
+     * \returns the microseconds (or nanoseconds, see
+     *          PcapMappedFile::IsNanosecond) part of the timestamp.
+     */
+    uint32_t GetTsUsec (void) const;
+    /**
+     * \returns the number of bytes of packet data stored in the file.
+     */
+    uint32_t GetInclLen (void) const;
+    /**
+     * \returns the size of the packet when it was captured.
+     */
+    uint32_t GetOrigLen (void) const;
+    /**
+     * \returns a pointer to the GetInclLen bytes of packet data.
+     */
+    uint8_t const *GetData (void) const;
+private:
+    friend class PcapMappedFile;
+    uint32_t m_tsSec;
+    uint32_t m_tsUsec;
+    uint32_t m_inclLen;
+    uint32_t m_origLen;
+    uint8_t const *m_data;
+  };
+
+  /**
+   * \brief Forward iterator over the records of the file.
+   */
+  class Iterator
+  {
+public:
+    Iterator ();
+    Record const &operator * (void) const;
+    Record const *operator -> (void) const;
+    Iterator &operator ++ (void);
+    bool operator == (Iterator const &o) const;
+    bool operator != (Iterator const &o) const;
+    /**
+     * \returns true if this iterator reached the end of the file
+     *          on a record which does not fit in the file.
+     */
+    bool IsTruncated (void) const;
+private:
+    friend class PcapMappedFile;
+    Iterator (PcapMappedFile const *file, uint64_t offset);
+    void Load (void);
+    PcapMappedFile const *m_file;
+    uint64_t m_offset;
+    bool m_truncated;
+    Record m_record;
+  };
+
+  PcapMappedFile ();
+  ~PcapMappedFile ();
+
+  /**
+   * \param filename the file to map.
+   * \returns true if the file could be mapped and starts with a
+   *          valid pcap file header, false otherwise.
+   */
+  bool Open (std::string const &filename);
+  /**
+   * Unmap the file. All the iterators and records become invalid.
+   */
+  void Close (void);
+  /**
+   * \returns true if the last Open failed or if no file is open.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \returns an iterator on the first record of the file.
+   */
+  Iterator Begin (void) const;
+  /**
+   * \returns the iterator past the last record of the file.
+   */
+  Iterator End (void) const;
+
+  uint32_t GetMagic (void) const;
+  uint32_t GetSnapLen (void) const;
+  uint32_t GetDataLinkType (void) const;
+  int32_t GetTimeZoneOffset (void) const;
+  /**
+   * \returns true if the file was written with the opposite byte
+   *          order.
+   */
+  bool GetSwapMode (void) const;
+  /**
+   * \returns true if the timestamps of the records are in
+   *          nanoseconds rather than microseconds.
+   */
+  bool IsNanosecond (void) const;
+
+private:
+  PcapMappedFile (PcapMappedFile const &o);
+  PcapMappedFile &operator = (PcapMappedFile const &o);
+
+  uint16_t ReadU16 (uint64_t offset) const;
+  uint32_t ReadU32 (uint64_t offset) const;
+
+  uint8_t const *m_data;
+  uint64_t m_size;
+  uint32_t m_magic;
+  uint32_t m_snapLen;
+  uint32_t m_type;
+  int32_t m_zone;
+  bool m_swapMode;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_MAPPED_FILE_H */
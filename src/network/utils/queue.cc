@@ -103,6 +103,47 @@ Queue::Dequeue (void)
   return packet;
 }
 
+uint32_t
+Queue::DequeueBurst (std::vector<Ptr<Packet> > &packets, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+
+  uint32_t first = packets.size ();
+  uint32_t count = DoDequeueBurst (packets, n);
+  NS_ASSERT (packets.size () == first + count);
+  NS_ASSERT (m_nPackets >= count);
+
+  uint32_t bytes = 0;
+  for (uint32_t i = first; i < packets.size (); ++i)
+    {
+      bytes += packets[i]->GetSize ();
+      NS_LOG_LOGIC ("m_traceDequeue (packet)");
+      m_traceDequeue (packets[i]);
+    }
+  NS_ASSERT (m_nBytes >= bytes);
+  m_nBytes -= bytes;
+  m_nPackets -= count;
+  return count;
+}
+
+uint32_t
+Queue::DoDequeueBurst (std::vector<Ptr<Packet> > &packets, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  uint32_t count = 0;
+  while (count < n)
+    {
+      Ptr<Packet> packet = DoDequeue ();
+      if (packet == 0)
+        {
+          break;
+        }
+      packets.push_back (packet);
+      count++;
+    }
+  return count;
+}
+
 void
 Queue::DequeueAll (void)
 {
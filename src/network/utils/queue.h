@@ -26,6 +26,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
@@ -65,6 +66,17 @@ public:
    * \return 0 if the operation was not successful; the packet otherwise.
    */
   Ptr<Packet> Dequeue (void);
+  /**
+   * Remove up to n packets from the front of the Queue
+   * \param packets the vector the packets are appended to, in the order
+   *        in which they were enqueued
+   * \param n the maximum number of packets to remove
+   * \return the number of packets removed
+   *
+   * This is equivalent to calling Dequeue n times, but the subclass is
+   * called only once and the statistics are updated only once.
+   */
+  uint32_t DequeueBurst (std::vector<Ptr<Packet> > &packets, uint32_t n);
   /**
    * Get a copy of the item at the front of the queue without removing it
    * \return 0 if the operation was not successful; the packet otherwise.
@@ -154,6 +166,11 @@ private:
   virtual bool DoEnqueue (Ptr<Packet> p) = 0;
   virtual Ptr<Packet> DoDequeue (void) = 0;
   virtual Ptr<const Packet> DoPeek (void) const = 0;
+  /**
+   * The default implementation calls DoDequeue until n packets are
+   * removed or the queue is empty.
+   */
+  virtual uint32_t DoDequeueBurst (std::vector<Ptr<Packet> > &packets, uint32_t n);
 
 protected:
   // called by subclasses to notify parent of packet drops.
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ring-buffer-queue.h"
+
+NS_LOG_COMPONENT_DEFINE ("RingBufferQueue");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (RingBufferQueue);
+
+TypeId RingBufferQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RingBufferQueue")
+    .SetParent<Queue> ()
+    .AddConstructor<RingBufferQueue> ()
+    .AddAttribute ("Mode",
+                   "Whether to use bytes (see MaxBytes) or packets (see MaxPackets) as the maximum queue size metric.",
+                   EnumValue (QUEUE_MODE_PACKETS),
+                   MakeEnumAccessor (&RingBufferQueue::SetMode),
+                   MakeEnumChecker (QUEUE_MODE_BYTES, "QUEUE_MODE_BYTES",
+                                    QUEUE_MODE_PACKETS, "QUEUE_MODE_PACKETS"))
+    .AddAttribute ("MaxPackets",
+                   "The maximum number of packets accepted by this RingBufferQueue.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&RingBufferQueue::SetMaxPackets,
+                                         &RingBufferQueue::GetMaxPackets),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxBytes",
+                   "The maximum number of bytes accepted by this RingBufferQueue.",
+                   UintegerValue (100 * 65535),
+                   MakeUintegerAccessor (&RingBufferQueue::m_maxBytes),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+
+  return tid;
+}
+
+RingBufferQueue::RingBufferQueue () :
+  Queue (),
+  m_mask (0),
+  m_head (0),
+  m_count (0),
+  m_maxPackets (0),
+  m_bytesInQueue (0),
+  m_mode (QUEUE_MODE_PACKETS)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RingBufferQueue::~RingBufferQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+RingBufferQueue::SetMode (RingBufferQueue::QueueMode mode)
+{
+  NS_LOG_FUNCTION (this << mode);
+  m_mode = mode;
+}
+
+RingBufferQueue::QueueMode
+RingBufferQueue::GetMode (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_mode;
+}
+
+void
+RingBufferQueue::SetMaxPackets (uint32_t maxPackets)
+{
+  NS_LOG_FUNCTION (this << maxPackets);
+  NS_ABORT_MSG_IF (m_count != 0, "RingBufferQueue::SetMaxPackets(): the queue is not empty");
+  NS_ASSERT (maxPackets > 0 && maxPackets <= 0x80000000);
+  uint32_t size = 1;
+  while (size < maxPackets)
+    {
+      size <<= 1;
+    }
+  m_maxPackets = maxPackets;
+  m_ring.assign (size, 0);
+  m_mask = size - 1;
+  m_head = 0;
+}
+
+uint32_t
+RingBufferQueue::GetMaxPackets (void) const
+{
+  return m_maxPackets;
+}
+
+bool
+RingBufferQueue::DoEnqueue (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  if (m_count >= m_maxPackets)
+    {
+      NS_LOG_LOGIC ("Queue full (at max packets) -- droppping pkt");
+      Drop (p);
+      return false;
+    }
+
+  uint32_t size = p->GetSize ();
+  if (m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue + size >= m_maxBytes))
+    {
+      NS_LOG_LOGIC ("Queue full (packet would exceed max bytes) -- droppping pkt");
+      Drop (p);
+      return false;
+    }
+
+  m_ring[(m_head + m_count) & m_mask] = p;
+  m_count++;
+  m_bytesInQueue += size;
+
+  NS_LOG_LOGIC ("Number packets " << m_count);
+  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+
+  return true;
+}
+
+Ptr<Packet>
+RingBufferQueue::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_count == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  Ptr<Packet> p = m_ring[m_head];
+  m_ring[m_head] = 0;
+  m_head = (m_head + 1) & m_mask;
+  m_count--;
+  m_bytesInQueue -= p->GetSize ();
+
+  NS_LOG_LOGIC ("Popped " << p);
+
+  NS_LOG_LOGIC ("Number packets " << m_count);
+  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+
+  return p;
+}
+
+uint32_t
+RingBufferQueue::DoDequeueBurst (std::vector<Ptr<Packet> > &packets, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+
+  uint32_t count = std::min (n, m_count);
+  packets.reserve (packets.size () + count);
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      Ptr<Packet> &slot = m_ring[m_head];
+      m_bytesInQueue -= slot->GetSize ();
+      packets.push_back (slot);
+      slot = 0;
+      m_head = (m_head + 1) & m_mask;
+    }
+  m_count -= count;
+
+  NS_LOG_LOGIC ("Popped " << count << " packets");
+
+  NS_LOG_LOGIC ("Number packets " << m_count);
+  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+
+  return count;
+}
+
+Ptr<const Packet>
+RingBufferQueue::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_count == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  NS_LOG_LOGIC ("Number packets " << m_count);
+  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+
+  return m_ring[m_head];
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_QUEUE_H
+#define RING_BUFFER_QUEUE_H
+
+#include <vector>
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO packet queue that drops tail-end packets on overflow,
+ *        stored in a fixed-capacity ring buffer
+ *
+ * This queue behaves as DropTailQueue, but the packets are stored in a
+ * ring of MaxPackets slots (rounded up to a power of two) allocated
+ * when MaxPackets is set, so that enqueueing and dequeueing never
+ * allocate memory. The number of bytes in the queue is maintained on
+ * each operation, and DequeueBurst removes several packets in a single
+ * call, for devices which drain more than one packet per transmission
+ * opportunity.
+ *
+ * In QUEUE_MODE_BYTES, the packets are also dropped when all the slots
+ * of the ring are used: MaxPackets must then be large enough for the
+ * smallest packets expected.
+ */
+class RingBufferQueue : public Queue {
+public:
+  static TypeId GetTypeId (void);
+  /**
+   * \brief RingBufferQueue Constructor
+   *
+   * Creates a queue with a maximum size of 100 packets by default
+   */
+  RingBufferQueue ();
+
+  virtual ~RingBufferQueue ();
+
+  /**
+   * Set the operating mode of this queue.
+   *
+   * \param mode The operating mode of this queue.
+   */
+  void SetMode (RingBufferQueue::QueueMode mode);
+
+  /**
+   * Get the operating mode of this queue.
+   *
+   * \returns The operating mode of this queue.
+   */
+  RingBufferQueue::QueueMode GetMode (void) const;
+
+  /**
+   * Set the maximum number of packets, and reallocate the ring. The
+   * queue must be empty.
+   *
+   * \param maxPackets The maximum number of packets of this queue.
+   */
+  void SetMaxPackets (uint32_t maxPackets);
+
+  /**
+   * \returns The maximum number of packets of this queue.
+   */
+  uint32_t GetMaxPackets (void) const;
+
+private:
+  virtual bool DoEnqueue (Ptr<Packet> p);
+  virtual Ptr<Packet> DoDequeue (void);
+  virtual Ptr<const Packet> DoPeek (void) const;
+  virtual uint32_t DoDequeueBurst (std::vector<Ptr<Packet> > &packets, uint32_t n);
+
+  std::vector<Ptr<Packet> > m_ring;
+  uint32_t m_mask;
+  uint32_t m_head;
+  uint32_t m_count;
+  uint32_t m_maxPackets;
+  uint32_t m_maxBytes;
+  uint32_t m_bytesInQueue;
+  QueueMode m_mode;
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_QUEUE_H */
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "segment-offload-tag.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("SegmentOffloadTag");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SegmentOffloadTag);
+
+TypeId 
+SegmentOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SegmentOffloadTag")
+    .SetParent<Tag> ()
+    .AddConstructor<SegmentOffloadTag> ()
+  ;
+  return tid;
+}
+TypeId 
+SegmentOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t 
+SegmentOffloadTag::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 8;
+}
+void 
+SegmentOffloadTag::Serialize (TagBuffer buf) const
+{
+  NS_LOG_FUNCTION (this << &buf);
+  buf.WriteU32 (m_nPackets);
+  buf.WriteU32 (m_payloadSize);
+}
+void 
+SegmentOffloadTag::Deserialize (TagBuffer buf)
+{
+  NS_LOG_FUNCTION (this << &buf);
+  m_nPackets = buf.ReadU32 ();
+  m_payloadSize = buf.ReadU32 ();
+}
+void 
+SegmentOffloadTag::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "NPackets=" << m_nPackets << " PayloadSize=" << m_payloadSize;
+}
+SegmentOffloadTag::SegmentOffloadTag ()
+  : Tag (),
+    m_nPackets (1),
+    m_payloadSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SegmentOffloadTag::SegmentOffloadTag (uint32_t nPackets, uint32_t payloadSize)
+  : Tag (),
+    m_nPackets (nPackets),
+    m_payloadSize (payloadSize)
+{
+  NS_LOG_FUNCTION (this << nPackets << payloadSize);
+}
+
+void
+SegmentOffloadTag::SetNPackets (uint32_t nPackets)
+{
+  NS_LOG_FUNCTION (this << nPackets);
+  m_nPackets = nPackets;
+}
+uint32_t
+SegmentOffloadTag::GetNPackets (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_nPackets;
+}
+
+void
+SegmentOffloadTag::SetPayloadSize (uint32_t payloadSize)
+{
+  NS_LOG_FUNCTION (this << payloadSize);
+  m_payloadSize = payloadSize;
+}
+uint32_t
+SegmentOffloadTag::GetPayloadSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_payloadSize;
+}
+
+uint32_t
+SegmentOffloadTag::GetWireSize (uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (size >= m_payloadSize && m_nPackets > 0);
+  // Every packet carries the headers, that is, all but the payload
+  return size + (m_nPackets - 1) * (size - m_payloadSize);
+}
+
+} // namespace ns3
+
@@ -0,0 +1,311 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "trace-filter.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("TraceFilter");
+
+namespace ns3 {
+
+namespace {
+
+// the data link types of PcapHelper.
+const uint32_t DLT_EN10MB = 1;
+const uint32_t DLT_PPP = 9;
+const uint32_t DLT_RAW = 101;
+
+// enough for an 802.11 QoS header, LLC/SNAP, IPv4 options and ports.
+const uint32_t MAX_PEEK = 128;
+// the LLC/SNAP header of an IPv4 packet.
+const uint8_t LLC_SNAP_IPV4[] = { 0xaa, 0xaa, 0x03, 0x00, 0x00, 0x00, 0x08, 0x00 };
+const uint32_t MAX_LLC_OFFSET = 40;
+
+bool
+IsIpv4 (uint8_t const *buffer, uint32_t size, uint32_t offset)
+{
+  if (size < offset + 20)
+    {
+      return false;
+    }
+  uint8_t const *ip = buffer + offset;
+  uint32_t headerLength = (ip[0] & 0x0f) * 4;
+  uint32_t totalLength = (ip[2] << 8) | ip[3];
+  return (ip[0] >> 4) == 4 && headerLength >= 20 && totalLength >= headerLength;
+}
+
+/**
+ * \returns the offset of the IPv4 header in the buffer, or size if
+ *          none was found.
+ */
+uint32_t
+FindIpv4 (uint8_t const *buffer, uint32_t size, uint32_t dataLinkType)
+{
+  switch (dataLinkType)
+    {
+    case DLT_RAW:
+      return IsIpv4 (buffer, size, 0) ? 0 : size;
+    case DLT_PPP:
+      return size >= 2 && buffer[0] == 0x00 && buffer[1] == 0x21 && IsIpv4 (buffer, size, 2) ? 2 : size;
+    case DLT_EN10MB:
+      if (size >= 14 && buffer[12] == 0x08 && buffer[13] == 0x00)
+        {
+          return IsIpv4 (buffer, size, 14) ? 14 : size;
+        }
+      if (size >= 22 && std::equal (LLC_SNAP_IPV4, LLC_SNAP_IPV4 + 8, buffer + 14))
+        {
+          return IsIpv4 (buffer, size, 22) ? 22 : size;
+        }
+      return size;
+    default:
+      break;
+    }
+  if (IsIpv4 (buffer, size, 0))
+    {
+      return 0;
+    }
+  if (size >= 2 && buffer[0] == 0x00 && buffer[1] == 0x21 && IsIpv4 (buffer, size, 2))
+    {
+      return 2;
+    }
+  if (size >= 14 && buffer[12] == 0x08 && buffer[13] == 0x00 && IsIpv4 (buffer, size, 14))
+    {
+      return 14;
+    }
+  for (uint32_t i = 0; i <= MAX_LLC_OFFSET && i + 8 <= size; ++i)
+    {
+      if (std::equal (LLC_SNAP_IPV4, LLC_SNAP_IPV4 + 8, buffer + i) && IsIpv4 (buffer, size, i + 8))
+        {
+          return i + 8;
+        }
+    }
+  return size;
+}
+
+} // anonymous namespace
+
+TraceFilter::TraceFilter ()
+  : m_sampling (1),
+    m_count (0),
+    m_minSize (0),
+    m_maxSize (0xffffffff),
+    m_start (Seconds (0)),
+    m_stop (Time::Max ()),
+    m_hasFlow (false),
+    m_protocol (0),
+    m_sourcePort (0),
+    m_destinationPort (0),
+    m_snapLen (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TraceFilter::SetSampling (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT (n > 0);
+  m_sampling = n;
+}
+
+void
+TraceFilter::SetSizeRange (uint32_t min, uint32_t max)
+{
+  NS_LOG_FUNCTION (this << min << max);
+  m_minSize = min;
+  m_maxSize = max;
+}
+
+void
+TraceFilter::SetTimeWindow (Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << start << stop);
+  m_start = start;
+  m_stop = stop;
+}
+
+void
+TraceFilter::SetFlow (Ipv4Address source, Ipv4Address destination, uint8_t protocol,
+                      uint16_t sourcePort, uint16_t destinationPort)
+{
+  NS_LOG_FUNCTION (this << source << destination << (uint32_t)protocol << sourcePort << destinationPort);
+  m_hasFlow = true;
+  m_source = source;
+  m_destination = destination;
+  m_protocol = protocol;
+  m_sourcePort = sourcePort;
+  m_destinationPort = destinationPort;
+}
+
+void
+TraceFilter::SetSnapLen (uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << snapLen);
+  m_snapLen = snapLen;
+}
+
+uint32_t
+TraceFilter::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+Ptr<TraceFilter>
+TraceFilter::Copy (void) const
+{
+  Ptr<TraceFilter> copy = Create<TraceFilter> (*this);
+  copy->m_count = 0;
+  return copy;
+}
+
+bool
+TraceFilter::NeedsData (void) const
+{
+  return m_hasFlow;
+}
+
+bool
+TraceFilter::MatchSizeAndTime (uint32_t size) const
+{
+  if (size < m_minSize || size > m_maxSize)
+    {
+      return false;
+    }
+  Time now = Simulator::Now ();
+  return now >= m_start && now < m_stop;
+}
+
+bool
+TraceFilter::MatchFlow (uint8_t const *buffer, uint32_t size, uint32_t dataLinkType) const
+{
+  uint32_t offset = FindIpv4 (buffer, size, dataLinkType);
+  if (offset == size)
+    {
+      return false;
+    }
+  uint8_t const *ip = buffer + offset;
+  uint8_t protocol = ip[9];
+  if (m_protocol != 0 && protocol != m_protocol)
+    {
+      return false;
+    }
+  if (m_source != Ipv4Address::GetAny () && Ipv4Address::Deserialize (ip + 12) != m_source)
+    {
+      return false;
+    }
+  if (m_destination != Ipv4Address::GetAny () && Ipv4Address::Deserialize (ip + 16) != m_destination)
+    {
+      return false;
+    }
+  if (m_sourcePort == 0 && m_destinationPort == 0)
+    {
+      return true;
+    }
+  // only the first fragment of a TCP or UDP packet carries the ports.
+  uint16_t fragmentOffset = ((ip[6] & 0x1f) << 8) | ip[7];
+  uint32_t ports = offset + (ip[0] & 0x0f) * 4;
+  if ((protocol != 6 && protocol != 17) || fragmentOffset != 0 || size < ports + 4)
+    {
+      return false;
+    }
+  uint16_t sourcePort = (buffer[ports] << 8) | buffer[ports + 1];
+  uint16_t destinationPort = (buffer[ports + 2] << 8) | buffer[ports + 3];
+  return (m_sourcePort == 0 || sourcePort == m_sourcePort)
+         && (m_destinationPort == 0 || destinationPort == m_destinationPort);
+}
+
+bool
+TraceFilter::MatchSampling (void)
+{
+  bool match = m_count == 0;
+  m_count++;
+  if (m_count == m_sampling)
+    {
+      m_count = 0;
+    }
+  return match;
+}
+
+bool
+TraceFilter::Match (Ptr<const Packet> p, uint32_t dataLinkType)
+{
+  NS_LOG_FUNCTION (this << p << dataLinkType);
+  uint32_t size = p->GetSize ();
+  if (!MatchSizeAndTime (size))
+    {
+      return false;
+    }
+  if (m_hasFlow)
+    {
+      uint8_t buffer[MAX_PEEK];
+      uint32_t peek = p->CopyData (buffer, std::min (size, MAX_PEEK));
+      if (!MatchFlow (buffer, peek, dataLinkType))
+        {
+          return false;
+        }
+    }
+  return MatchSampling ();
+}
+
+bool
+TraceFilter::Match (Header const &header, Ptr<const Packet> p, uint32_t dataLinkType)
+{
+  NS_LOG_FUNCTION (this << &header << p << dataLinkType);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t size = headerSize + p->GetSize ();
+  if (!MatchSizeAndTime (size))
+    {
+      return false;
+    }
+  if (m_hasFlow)
+    {
+      // serialize the header alone, and peek at the start of the packet
+      // behind it.
+      Buffer serialized;
+      serialized.AddAtStart (headerSize);
+      header.Serialize (serialized.Begin ());
+      uint8_t buffer[MAX_PEEK];
+      uint32_t peek = serialized.CopyData (buffer, std::min (headerSize, MAX_PEEK));
+      peek += p->CopyData (buffer + peek, MAX_PEEK - peek);
+      if (!MatchFlow (buffer, peek, dataLinkType))
+        {
+          return false;
+        }
+    }
+  return MatchSampling ();
+}
+
+bool
+TraceFilter::Match (uint8_t const *buffer, uint32_t size, uint32_t dataLinkType)
+{
+  NS_LOG_FUNCTION (this << &buffer << size << dataLinkType);
+  if (!MatchSizeAndTime (size))
+    {
+      return false;
+    }
+  if (m_hasFlow && !MatchFlow (buffer, size, dataLinkType))
+    {
+      return false;
+    }
+  return MatchSampling ();
+}
+
+} // namespace ns3
@@ -18,13 +18,20 @@
  * Authors: Josh Pelkey <jpelkey@gatech.edu>
  */
 
-#include <queue>
 #include <iomanip>
+#include <set>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#ifdef HAVE_PTHREAD_H
+#include <unistd.h>
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#endif /* HAVE_PTHREAD_H */
 
 #include "ipv4-nix-vector-routing.h"
 
@@ -34,6 +41,257 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
+GlobalValue g_nixVectorRoutingThreads = GlobalValue ("NixVectorRoutingThreads",
+                                                     "The number of threads which precompute the nix-vectors, "
+                                                     "zero for one per processor.",
+                                                     UintegerValue (1),
+                                                     MakeUintegerChecker<uint32_t> ());
+
+namespace {
+
+const uint32_t NO_NODE = 0xffffffff;
+const uint32_t NO_DEVICE = 0xffffffff;
+
+/* a device of a node, as seen by the breadth first searches */
+struct TopologyDevice
+{
+  bool usable;                    // the interface and the link are up
+  bool counted;                   // the neighbors count in the nix-vectors
+  std::vector<uint32_t> adjacent; // the adjacent nodes, in neighbor order
+};
+
+/* the devices of each node */
+typedef std::vector<std::vector<TopologyDevice> > Topology;
+
+/* a path, as the neighbor indices added to its nix-vector */
+struct PathHops
+{
+  /* the neighbor index and the number of neighbors of each hop, from
+   * the destination to the source */
+  std::vector<std::pair<uint32_t, uint32_t> > indices;
+  /* the node and the device of the links through which it leaves
+   * each node */
+  std::vector<std::pair<uint32_t, uint32_t> > links;
+};
+
+/* the state of a breadth first search, kept from one search to the next */
+struct Search
+{
+  std::vector<uint32_t> parents;
+  std::vector<uint32_t> queue;
+};
+
+/*
+ * Breadth first search from the source, through the specific output
+ * device of the source if not NO_DEVICE, until the destination is found,
+ * or over all the reachable nodes if it is NO_NODE.  A node is reachable
+ * if search.parents is not NO_NODE for it.
+ */
+void
+SearchPaths (Topology const &topology, uint32_t source, uint32_t dest, uint32_t oif, Search &search)
+{
+  search.parents.assign (topology.size (), NO_NODE);
+  search.queue.clear ();
+  search.queue.push_back (source);
+  search.parents[source] = source;
+  for (uint32_t head = 0; head < search.queue.size (); head++)
+    {
+      uint32_t node = search.queue[head];
+      if (node == dest)
+        {
+          return;
+        }
+      std::vector<TopologyDevice> const &devices = topology[node];
+      uint32_t first = 0;
+      uint32_t last = devices.size ();
+      // if a specific output interface was given, make sure we go
+      // this way
+      if (node == source && oif != NO_DEVICE)
+        {
+          if (!devices[oif].usable)
+            {
+              return;
+            }
+          first = oif;
+          last = oif + 1;
+        }
+      for (uint32_t i = first; i < last; i++)
+        {
+          if (!devices[i].usable)
+            {
+              continue;
+            }
+          std::vector<uint32_t> const &adjacent = devices[i].adjacent;
+          for (std::vector<uint32_t>::const_iterator j = adjacent.begin (); j != adjacent.end (); j++)
+            {
+              if (search.parents[*j] == NO_NODE)
+                {
+                  search.parents[*j] = node;
+                  search.queue.push_back (*j);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Retraces the path from the source to the destination found by a
+ * breadth first search.
+ */
+void
+BuildPath (Topology const &topology, std::vector<uint32_t> const &parents,
+           uint32_t source, uint32_t dest, PathHops &path)
+{
+  path.indices.clear ();
+  path.links.clear ();
+  for (uint32_t node = dest; node != source; node = parents[node])
+    {
+      uint32_t parent = parents[node];
+      std::vector<TopologyDevice> const &devices = topology[parent];
+      uint32_t index = 0;
+      uint32_t totalNeighbors = 0;
+      for (uint32_t i = 0; i < devices.size (); i++)
+        {
+          std::vector<uint32_t> const &adjacent = devices[i].adjacent;
+          bool link = false;
+          for (uint32_t j = 0; j < adjacent.size (); j++)
+            {
+              if (adjacent[j] == node)
+                {
+                  link = true;
+                  if (devices[i].counted)
+                    {
+                      index = totalNeighbors + j;
+                    }
+                }
+            }
+          if (link)
+            {
+              path.links.push_back (std::make_pair (parent, i));
+            }
+          if (devices[i].counted)
+            {
+              totalNeighbors += adjacent.size ();
+            }
+        }
+      path.indices.push_back (std::make_pair (index, totalNeighbors));
+    }
+}
+
+Ptr<NixVector>
+CreateNixVector (PathHops const &path)
+{
+  Ptr<NixVector> nixVector = Create<NixVector> ();
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = path.indices.begin ();
+       i != path.indices.end (); i++)
+    {
+      nixVector->AddNeighborIndex (i->first, nixVector->BitCount (i->second));
+    }
+  return nixVector;
+}
+
+/* the paths from a source node to the destinations of its flows */
+struct PrecomputeTask
+{
+  uint32_t source;
+  std::vector<uint32_t> dests;
+  std::vector<PathHops> paths;      // empty if there is no path
+};
+
+/* runs the breadth first searches of the precomputation */
+class PrecomputeWorkers
+{
+public:
+  PrecomputeWorkers (Topology const &topology, std::vector<PrecomputeTask> &tasks)
+    : m_topology (topology),
+      m_tasks (tasks),
+      m_nextTask (0)
+  {
+  }
+  void Run (void)
+  {
+    Search search;
+    for (;;)
+      {
+        PrecomputeTask *task;
+        {
+#ifdef HAVE_PTHREAD_H
+          CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+          if (m_nextTask == m_tasks.size ())
+            {
+              return;
+            }
+          task = &m_tasks[m_nextTask++];
+        }
+        SearchPaths (m_topology, task->source, NO_NODE, NO_DEVICE, search);
+        task->paths.resize (task->dests.size ());
+        for (uint32_t i = 0; i < task->dests.size (); i++)
+          {
+            if (search.parents[task->dests[i]] != NO_NODE)
+              {
+                BuildPath (m_topology, search.parents, task->source, task->dests[i], task->paths[i]);
+              }
+          }
+      }
+  }
+private:
+  Topology const &m_topology;
+  std::vector<PrecomputeTask> &m_tasks;
+  uint32_t m_nextTask;
+#ifdef HAVE_PTHREAD_H
+  SystemMutex m_mutex;
+#endif /* HAVE_PTHREAD_H */
+};
+
+uint32_t
+GetNThreads (void)
+{
+  UintegerValue threads;
+  g_nixVectorRoutingThreads.GetValue (threads);
+#ifdef HAVE_PTHREAD_H
+  if (threads.Get () == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      return processors > 0 ? processors : 1;
+    }
+  return threads.Get ();
+#else
+  return 1;
+#endif /* HAVE_PTHREAD_H */
+}
+
+} // anonymous namespace
+
+/* a cached nix-vector */
+struct CachedPath
+{
+  Ptr<NixVector> nixVector;
+  std::vector<std::pair<uint32_t, uint32_t> > links;
+};
+
+struct Ipv4NixVectorRouting::SharedCache
+{
+  SharedCache ()
+    : topologyValid (false),
+      ipv4RouteCacheGeneration (0)
+  {
+  }
+  typedef std::pair<Ipv4Address, uint32_t> PathKey;  // destination, source node
+  typedef std::map<PathKey, CachedPath> PathMap;
+
+  Topology topology;
+  bool topologyValid;
+  Search search;
+  PathMap paths;
+  /* the paths which leave each node through each device */
+  std::map<std::pair<uint32_t, uint32_t>, std::set<PathKey> > links;
+  uint32_t ipv4RouteCacheGeneration;
+  /* the routing protocols which watch the devices of their node, until
+   * they are disposed: the node list is no longer usable then */
+  std::map<uint32_t, Ipv4NixVectorRouting *> agents;
+};
+
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
 {
@@ -45,7 +303,9 @@ Ipv4NixVectorRouting::GetTypeId (void)
 }
 
 Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_ipv4RouteCacheGeneration (GetSharedCache ().ipv4RouteCacheGeneration),
+    m_watchedDevices (0),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -70,6 +330,14 @@ Ipv4NixVectorRouting::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+  // the other nodes may still use the shared cache: only flush the
+  // paths from this node, whose index is reused by the next simulation.
+  if (m_node != 0)
+    {
+      FlushPathsOf (m_node->GetId ());
+      GetSharedCache ().agents.erase (m_node->GetId ());
+    }
+  GetSharedCache ().topologyValid = false;
   m_node = 0;
   m_ipv4 = 0;
 
@@ -85,37 +353,314 @@ Ipv4NixVectorRouting::SetNode (Ptr<Node> node)
   m_node = node;
 }
 
+Ipv4NixVectorRouting::SharedCache &
+Ipv4NixVectorRouting::GetSharedCache (void)
+{
+  static SharedCache cache;
+  return cache;
+}
+
 void
 Ipv4NixVectorRouting::FlushGlobalNixRoutingCache ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+  FlushAllPaths ();
+}
+
+void
+Ipv4NixVectorRouting::FlushAllPaths (void)
+{
+  NS_LOG_LOGIC ("Flushing Nix caches.");
+  SharedCache &cache = GetSharedCache ();
+  cache.paths.clear ();
+  cache.links.clear ();
+  cache.topologyValid = false;
+  // the Ipv4Route caches of the nodes are flushed when they are next used.
+  cache.ipv4RouteCacheGeneration++;
+}
+
+void
+Ipv4NixVectorRouting::FlushIpv4RouteCache ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_ipv4RouteCache.clear ();
+}
+
+void
+Ipv4NixVectorRouting::ReadTopology (void)
+{
+  SharedCache &cache = GetSharedCache ();
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  if (cache.topologyValid && cache.topology.size () == numberOfNodes)
     {
-      Ptr<Node> node = *i;
+      return;
+    }
+  NS_LOG_LOGIC ("Reading the topology of " << numberOfNodes << " nodes");
+  if (cache.topology.size () != numberOfNodes)
+    {
+      // the new nodes may shorten any path.
+      cache.paths.clear ();
+      cache.links.clear ();
+    }
+  cache.topology.assign (numberOfNodes, std::vector<TopologyDevice> ());
+  for (uint32_t i = 0; i < numberOfNodes; i++)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
       Ptr<Ipv4NixVectorRouting> rp = node->GetObject<Ipv4NixVectorRouting> ();
-      if (!rp)
+      if (rp)
         {
-          continue;
+          rp->WatchDevices ();
+        }
+      std::vector<TopologyDevice> &devices = cache.topology[i];
+      devices.resize (node->GetNDevices ());
+      for (uint32_t j = 0; j < devices.size (); j++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (j);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          TopologyDevice &device = devices[j];
+          device.usable = channel != 0 && localNetDevice->IsLinkUp ();
+          if (ipv4)
+            {
+              int32_t interfaceIndex = ipv4->GetInterfaceForDevice (localNetDevice);
+              device.usable = device.usable && interfaceIndex != -1 && ipv4->IsUp (interfaceIndex);
+            }
+          device.counted = channel != 0 && !localNetDevice->IsBridge ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          // this function takes in the local net dev, and channnel, and
+          // writes to the netDeviceContainer the adjacent net devs
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              device.adjacent.push_back ((*iter)->GetNode ()->GetId ());
+            }
         }
-      NS_LOG_LOGIC ("Flushing Nix caches.");
-      rp->FlushNixCache ();
-      rp->FlushIpv4RouteCache ();
     }
+  cache.topologyValid = true;
 }
 
 void
-Ipv4NixVectorRouting::FlushNixCache ()
+Ipv4NixVectorRouting::AddPath (Ipv4Address dest, uint32_t source, Ptr<NixVector> nixVector,
+                               std::vector<std::pair<uint32_t, uint32_t> > const &links)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-  m_nixCache.clear ();
+  SharedCache &cache = GetSharedCache ();
+  SharedCache::PathKey key (dest, source);
+  NS_ASSERT (nixVector != 0);
+  CachedPath &path = cache.paths[key];
+  NS_ASSERT (path.nixVector == 0 && path.links.empty ());
+  path.nixVector = nixVector;
+  path.links = links;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = links.begin (); i != links.end (); i++)
+    {
+      cache.links[*i].insert (key);
+    }
 }
 
 void
-Ipv4NixVectorRouting::FlushIpv4RouteCache ()
+Ipv4NixVectorRouting::FlushPathsThrough (uint32_t node, uint32_t device)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-  m_ipv4RouteCache.clear ();
+  NS_LOG_FUNCTION (node << device);
+  SharedCache &cache = GetSharedCache ();
+  cache.topologyValid = false;
+  std::map<std::pair<uint32_t, uint32_t>, std::set<SharedCache::PathKey> >::iterator i =
+    cache.links.find (std::make_pair (node, device));
+  if (i == cache.links.end ())
+    {
+      return;
+    }
+  std::set<SharedCache::PathKey> keys;
+  keys.swap (i->second);
+  cache.links.erase (i);
+  for (std::set<SharedCache::PathKey>::const_iterator j = keys.begin (); j != keys.end (); j++)
+    {
+      SharedCache::PathMap::iterator path = cache.paths.find (*j);
+      NS_ASSERT (path != cache.paths.end ());
+      NS_LOG_LOGIC ("Flushing the path from node " << j->second << " to " << j->first);
+      std::vector<std::pair<uint32_t, uint32_t> > const &links = path->second.links;
+      for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator k = links.begin (); k != links.end (); k++)
+        {
+          i = cache.links.find (*k);
+          if (i != cache.links.end ())
+            {
+              i->second.erase (*j);
+              if (i->second.empty ())
+                {
+                  cache.links.erase (i);
+                }
+            }
+          // the nodes of the path may have cached an Ipv4Route derived
+          // from its nix-vector.
+          std::map<uint32_t, Ipv4NixVectorRouting *>::const_iterator agent = cache.agents.find (k->first);
+          if (agent != cache.agents.end ())
+            {
+              agent->second->m_ipv4RouteCache.erase (j->first);
+            }
+        }
+      cache.paths.erase (path);
+    }
+}
+
+void
+Ipv4NixVectorRouting::FlushPathsTo (Ipv4Address dest)
+{
+  NS_LOG_FUNCTION (dest);
+  SharedCache &cache = GetSharedCache ();
+  SharedCache::PathMap::iterator begin = cache.paths.lower_bound (SharedCache::PathKey (dest, 0));
+  SharedCache::PathMap::iterator end = cache.paths.upper_bound (SharedCache::PathKey (dest, NO_NODE));
+  for (SharedCache::PathMap::iterator path = begin; path != end; path++)
+    {
+      std::vector<std::pair<uint32_t, uint32_t> > const &links = path->second.links;
+      for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator k = links.begin (); k != links.end (); k++)
+        {
+          std::map<std::pair<uint32_t, uint32_t>, std::set<SharedCache::PathKey> >::iterator i = cache.links.find (*k);
+          if (i != cache.links.end ())
+            {
+              i->second.erase (path->first);
+              if (i->second.empty ())
+                {
+                  cache.links.erase (i);
+                }
+            }
+        }
+    }
+  cache.paths.erase (begin, end);
+}
+
+void
+Ipv4NixVectorRouting::FlushPathsOf (uint32_t node)
+{
+  NS_LOG_FUNCTION (node);
+  // each path leaves its source through one of its devices.
+  SharedCache &cache = GetSharedCache ();
+  std::vector<uint32_t> devices;
+  std::map<std::pair<uint32_t, uint32_t>, std::set<SharedCache::PathKey> >::const_iterator i =
+    cache.links.lower_bound (std::make_pair (node, 0));
+  for (; i != cache.links.end () && i->first.first == node; i++)
+    {
+      devices.push_back (i->first.second);
+    }
+  for (std::vector<uint32_t>::const_iterator j = devices.begin (); j != devices.end (); j++)
+    {
+      FlushPathsThrough (node, *j);
+    }
+}
+
+void
+Ipv4NixVectorRouting::WatchDevices (void)
+{
+  if (m_node == 0)
+    {
+      return;
+    }
+  GetSharedCache ().agents[m_node->GetId ()] = this;
+  for (; m_watchedDevices < m_node->GetNDevices (); m_watchedDevices++)
+    {
+      m_node->GetDevice (m_watchedDevices)->AddLinkChangeCallback (
+        MakeBoundCallback (&Ipv4NixVectorRouting::NotifyLinkChange, m_node->GetId (), m_watchedDevices));
+    }
+}
+
+void
+Ipv4NixVectorRouting::NotifyLinkChange (uint32_t node, uint32_t device)
+{
+  NS_LOG_FUNCTION (node << device);
+  SharedCache &cache = GetSharedCache ();
+  std::map<uint32_t, Ipv4NixVectorRouting *>::const_iterator agent = cache.agents.find (node);
+  if (agent == cache.agents.end ())
+    {
+      return;
+    }
+  if (agent->second->m_node->GetDevice (device)->IsLinkUp ())
+    {
+      // a new link may shorten any path
+      FlushAllPaths ();
+    }
+  else
+    {
+      FlushPathsThrough (node, device);
+    }
+}
+
+void
+Ipv4NixVectorRouting::PrecomputeNixVectors (std::vector<std::pair<Ptr<Node>, Ipv4Address> > const &flows)
+{
+  NS_LOG_FUNCTION (flows.size ());
+  ReadTopology ();
+  SharedCache &cache = GetSharedCache ();
+
+  // the destinations of the flows from each source, grouped so that
+  // a single search finds all the paths from the source.
+  std::map<uint32_t, uint32_t> taskOfSource;
+  std::vector<PrecomputeTask> tasks;
+  std::vector<std::vector<Ipv4Address> > addresses;
+  std::set<SharedCache::PathKey> pending;
+  for (std::vector<std::pair<Ptr<Node>, Ipv4Address> >::const_iterator i = flows.begin (); i != flows.end (); i++)
+    {
+      uint32_t source = i->first->GetId ();
+      SharedCache::PathKey key (i->second, source);
+      if (cache.paths.find (key) != cache.paths.end () || !pending.insert (key).second)
+        {
+          continue;
+        }
+      Ptr<Node> destNode = GetNodeByIp (i->second);
+      if (destNode == 0 || destNode == i->first)
+        {
+          continue;
+        }
+      std::map<uint32_t, uint32_t>::const_iterator task = taskOfSource.find (source);
+      if (task == taskOfSource.end ())
+        {
+          task = taskOfSource.insert (std::make_pair (source, tasks.size ())).first;
+          tasks.push_back (PrecomputeTask ());
+          tasks.back ().source = source;
+          addresses.push_back (std::vector<Ipv4Address> ());
+        }
+      tasks[task->second].dests.push_back (destNode->GetId ());
+      addresses[task->second].push_back (i->second);
+    }
+
+  PrecomputeWorkers workers (cache.topology, tasks);
+#ifdef HAVE_PTHREAD_H
+  uint32_t n = std::min<uint32_t> (GetNThreads (), tasks.size ());
+  // the log messages of concurrent searches would be interleaved.
+  if (n > 1 && g_log.IsNoneEnabled ())
+    {
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&PrecomputeWorkers::Run, &workers)));
+          threads.back ()->Start ();
+        }
+      for (uint32_t i = 0; i < n; i++)
+        {
+          threads[i]->Join ();
+        }
+    }
+  else
+#endif /* HAVE_PTHREAD_H */
+    {
+      workers.Run ();
+    }
+
+  for (uint32_t i = 0; i < tasks.size (); i++)
+    {
+      for (uint32_t j = 0; j < tasks[i].dests.size (); j++)
+        {
+          PathHops const &path = tasks[i].paths[j];
+          if (path.indices.empty ())
+            {
+              NS_LOG_LOGIC ("No path from node " << tasks[i].source << " to " << addresses[i][j]);
+            }
+          else
+            {
+              AddPath (addresses[i][j], tasks[i].source, CreateNixVector (path), path.links);
+            }
+        }
+    }
 }
 
 Ptr<NixVector>
@@ -123,9 +668,8 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  Ptr<NixVector> nixVector = Create<NixVector> ();
-
-  // not in cache, must build the nix vector
+  // not in cache, must build the nix vector. The failures are not
+  // cached: a link to the destination may come up at any time.
   // First, we have to figure out the nodes 
   // associated with these IPs
   Ptr<Node> destNode = GetNodeByIp (dest);
@@ -143,40 +687,42 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
       NS_LOG_DEBUG ("Do not processs packets to self");
       return 0;
     }
-  else
-    {
-      // otherwise proceed as normal 
-      // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
 
-      BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
-
-      if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
-        {
-          return nixVector;
-        }
-      else
-        {
-          NS_LOG_ERROR ("No routing path exists");
-          return 0;
-        }
+  // otherwise proceed as normal 
+  // and build the nix vector
+  ReadTopology ();
+  SharedCache &cache = GetSharedCache ();
+  NS_LOG_LOGIC ("Going from Node " << source->GetId () << " to Node " << destNode->GetId ());
+  SearchPaths (cache.topology, source->GetId (), destNode->GetId (),
+               oif ? oif->GetIfIndex () : NO_DEVICE, cache.search);
+  if (cache.search.parents[destNode->GetId ()] == NO_NODE)
+    {
+      NS_LOG_ERROR ("No routing path exists");
+      return 0;
     }
+  PathHops path;
+  BuildPath (cache.topology, cache.search.parents, source->GetId (), destNode->GetId (), path);
+  Ptr<NixVector> nixVector = CreateNixVector (path);
+  AddPath (dest, source->GetId (), nixVector, path.links);
+  return nixVector;
 }
 
-Ptr<NixVector>
-Ipv4NixVectorRouting::GetNixVectorInCache (Ipv4Address address)
+bool
+Ipv4NixVectorRouting::GetNixVectorInCache (Ipv4Address address, Ptr<NixVector> &nixVector)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  NixMap_t::iterator iter = m_nixCache.find (address);
-  if (iter != m_nixCache.end ())
+  SharedCache &cache = GetSharedCache ();
+  SharedCache::PathMap::const_iterator iter = cache.paths.find (SharedCache::PathKey (address, m_node->GetId ()));
+  if (iter != cache.paths.end ())
     {
       NS_LOG_LOGIC ("Found Nix-vector in cache.");
-      return iter->second;
+      nixVector = iter->second.nixVector;
+      return true;
     }
 
   // not in cache
-  return 0;
+  return false;
 }
 
 Ptr<Ipv4Route>
@@ -184,6 +730,12 @@ Ipv4NixVectorRouting::GetIpv4RouteInCache (Ipv4Address address)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+  uint32_t generation = GetSharedCache ().ipv4RouteCacheGeneration;
+  if (m_ipv4RouteCacheGeneration != generation)
+    {
+      FlushIpv4RouteCache ();
+      m_ipv4RouteCacheGeneration = generation;
+    }
   Ipv4RouteMap_t::iterator iter = m_ipv4RouteCache.find (address);
   if (iter != m_ipv4RouteCache.end ())
     {
@@ -222,79 +774,6 @@ Ipv4NixVectorRouting::BuildNixVectorLocal (Ptr<NixVector> nixVector)
   return false;
 }
 
-bool
-Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  if (source == dest)
-    {
-      return true;
-    }
-
-  if (parentVector.at (dest) == 0)
-    {
-      return false;
-    }
-
-  Ptr<Node> parentNode = parentVector.at (dest);
-
-  uint32_t numberOfDevices = parentNode->GetNDevices ();
-  uint32_t destId = 0;
-  uint32_t totalNeighbors = 0;
-
-  // scan through the net devices on the parent node
-  // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
-    {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = parentNode->GetDevice (i);
-      if (localNetDevice->IsBridge ())
-        {
-          continue;
-        }
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
-        {
-          continue;
-        }
-
-      // this function takes in the local net dev, and channnel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-      // Finally we can get the adjacent nodes
-      // and scan through them.  If we find the 
-      // node that matches "dest" then we can add 
-      // the index  to the nix vector.
-      // the index corresponds to the neighbor index
-      uint32_t offset = 0;
-      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-        {
-          Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-          if (remoteNode->GetId () == dest)
-            {
-              destId = totalNeighbors + offset;
-            }
-          offset += 1;
-        }
-
-      totalNeighbors += netDeviceContainer.GetN ();
-    }
-  NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
-                               << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode->GetId ());
-  nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
-
-  // recurse through parent vector, grabbing the path 
-  // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
-  return true;
-}
-
 void
 Ipv4NixVectorRouting::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer)
 {
@@ -395,7 +874,7 @@ Ipv4NixVectorRouting::FindTotalNeighbors ()
 }
 
 Ptr<BridgeNetDevice>
-Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd) const
+Ipv4NixVectorRouting::NetDeviceIsBridged (Ptr<NetDevice> nd)
 {
   NS_LOG_FUNCTION (nd);
 
@@ -490,18 +969,12 @@ Ipv4NixVectorRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<
 
   NS_LOG_DEBUG ("Dest IP from header: " << header.GetDestination ());
   // check if cache
-  nixVectorInCache = GetNixVectorInCache (header.GetDestination ());
-
-  // not in cache
-  if (!nixVectorInCache)
+  if (!GetNixVectorInCache (header.GetDestination (), nixVectorInCache))
     {
       NS_LOG_LOGIC ("Nix-vector not in cache, build: ");
       // Build the nix-vector, given this node and the
-      // dest IP address
+      // dest IP address, and cache it
       nixVectorInCache = GetNixVector (m_node, header.GetDestination (), oif);
-
-      // cache it
-      m_nixCache.insert (NixMap_t::value_type (header.GetDestination (), nixVectorInCache));
     }
 
   // path exists
@@ -664,11 +1137,20 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
 {
 
   std::ostream* os = stream->GetStream ();
+  SharedCache &cache = GetSharedCache ();
+  NixMap_t nixCache;
+  for (SharedCache::PathMap::const_iterator it = cache.paths.begin (); it != cache.paths.end (); it++)
+    {
+      if (it->first.second == m_node->GetId () && it->second.nixVector != 0)
+        {
+          nixCache[it->first.first] = it->second.nixVector;
+        }
+    }
   *os << "NixCache:" << std::endl;
-  if (m_nixCache.size () > 0)
+  if (nixCache.size () > 0)
     {
       *os << "Destination     NixVector" << std::endl;
-      for (NixMap_t::const_iterator it = m_nixCache.begin (); it != m_nixCache.end (); it++)
+      for (NixMap_t::const_iterator it = nixCache.begin (); it != nixCache.end (); it++)
         {
           std::ostringstream dest;
           dest << it->first;
@@ -677,7 +1159,7 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
         }
     }
   *os << "Ipv4RouteCache:" << std::endl;
-  if (m_ipv4RouteCache.size () > 0)
+  if (m_ipv4RouteCache.size () > 0 && m_ipv4RouteCacheGeneration == cache.ipv4RouteCacheGeneration)
     {
       *os << "Destination     Gateway         Source            OutputDevice" << std::endl;
       for (Ipv4RouteMap_t::const_iterator it = m_ipv4RouteCache.begin (); it != m_ipv4RouteCache.end (); it++)
@@ -707,170 +1189,45 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
 void
 Ipv4NixVectorRouting::NotifyInterfaceUp (uint32_t i)
 {
+  // a new link may shorten any path
   FlushGlobalNixRoutingCache ();
 }
 void
 Ipv4NixVectorRouting::NotifyInterfaceDown (uint32_t i)
 {
-  FlushGlobalNixRoutingCache ();
+  // only the paths through the link are broken
+  Ptr<NetDevice> device = m_ipv4->GetNetDevice (i);
+  FlushPathsThrough (m_node->GetId (), device->GetIfIndex ());
+  if (m_ipv4RouteCacheGeneration != GetSharedCache ().ipv4RouteCacheGeneration)
+    {
+      // flushed when next used
+      return;
+    }
+  for (Ipv4RouteMap_t::iterator j = m_ipv4RouteCache.begin (); j != m_ipv4RouteCache.end (); )
+    {
+      if (j->second->GetOutputDevice () == device)
+        {
+          m_ipv4RouteCache.erase (j++);
+        }
+      else
+        {
+          j++;
+        }
+    }
 }
 void
 Ipv4NixVectorRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  FlushGlobalNixRoutingCache ();
+  // the gateways and sources of the Ipv4Routes may change
+  FlushPathsTo (address.GetLocal ());
+  GetSharedCache ().ipv4RouteCacheGeneration++;
 }
 void
 Ipv4NixVectorRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
-  FlushGlobalNixRoutingCache ();
-}
-
-bool
-Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source, 
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
-                           Ptr<NetDevice> oif)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  NS_LOG_LOGIC ("Going from Node " << source->GetId () << " to Node " << dest->GetId ());
-  std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
-
-  // reset the parent vector
-  parentVector.clear ();
-  parentVector.reserve (sizeof (Ptr<Node>)*numberOfNodes);
-  parentVector.insert (parentVector.begin (), sizeof (Ptr<Node>)*numberOfNodes, 0); // initialize to 0
-
-  // Add the source node to the queue, set its parent to itself 
-  greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
-
-  // BFS loop
-  while (greyNodeList.size () != 0)
-    {
-      Ptr<Node> currNode = greyNodeList.front ();
-      Ptr<Ipv4> ipv4 = currNode->GetObject<Ipv4> ();
- 
-      if (currNode == dest) 
-        {
-          NS_LOG_LOGIC ("Made it to Node " << currNode->GetId ());
-          return true;
-        }
-
-      // if this is the first iteration of the loop and a 
-      // specific output interface was given, make sure 
-      // we go this way
-      if (currNode == source && oif)
-        {
-          // make sure that we can go this way
-          if (ipv4)
-            {
-              uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (oif);
-              if (!(ipv4->IsUp (interfaceIndex)))
-                {
-                  NS_LOG_LOGIC ("Ipv4Interface is down");
-                  return false;
-                }
-            }
-          if (!(oif->IsLinkUp ()))
-            {
-              NS_LOG_LOGIC ("Link is down.");
-              return false;
-            }
-          Ptr<Channel> channel = oif->GetChannel ();
-          if (channel == 0)
-            { 
-              return false;
-            }
-
-          // this function takes in the local net dev, and channnel, and
-          // writes to the netDeviceContainer the adjacent net devs
-          NetDeviceContainer netDeviceContainer;
-          GetAdjacentNetDevices (oif, channel, netDeviceContainer);
-
-          // Finally we can get the adjacent nodes
-          // and scan through them.  We push them
-          // to the greyNode queue, if they aren't 
-          // already there.
-          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-            {
-              Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-              // check to see if this node has been pushed before
-              // by checking to see if it has a parent
-              // if it doesn't (null or 0), then set its parent and 
-              // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
-                {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
-                  greyNodeList.push (remoteNode);
-                }
-            }
-        }
-      else
-        {
-          // Iterate over the current node's adjacent vertices
-          // and push them into the queue
-          for (uint32_t i = 0; i < (currNode->GetNDevices ()); i++)
-            {
-              // Get a net device from the node
-              // as well as the channel, and figure
-              // out the adjacent net device
-              Ptr<NetDevice> localNetDevice = currNode->GetDevice (i);
-
-              // make sure that we can go this way
-              if (ipv4)
-                {
-                  uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (currNode->GetDevice (i));
-                  if (!(ipv4->IsUp (interfaceIndex)))
-                    {
-                      NS_LOG_LOGIC ("Ipv4Interface is down");
-                      continue;
-                    }
-                }
-              if (!(localNetDevice->IsLinkUp ()))
-                {
-                  NS_LOG_LOGIC ("Link is down.");
-                  continue;
-                }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
-                { 
-                  continue;
-                }
-
-              // this function takes in the local net dev, and channnel, and
-              // writes to the netDeviceContainer the adjacent net devs
-              NetDeviceContainer netDeviceContainer;
-              GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-              // Finally we can get the adjacent nodes
-              // and scan through them.  We push them
-              // to the greyNode queue, if they aren't 
-              // already there.
-              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-                {
-                  Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-                  // check to see if this node has been pushed before
-                  // by checking to see if it has a parent
-                  // if it doesn't (null or 0), then set its parent and 
-                  // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
-                    {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
-                      greyNodeList.push (remoteNode);
-                    }
-                }
-            }
-        }
-
-      // Pop off the head grey node.  We have all its children.
-      // It is now black.
-      greyNodeList.pop ();
-    }
-
-  // Didn't find the dest...
-  return false;
+  // the gateways and sources of the Ipv4Routes may change
+  FlushPathsTo (address.GetLocal ());
+  GetSharedCache ().ipv4RouteCacheGeneration++;
 }
 
 } // namespace ns3
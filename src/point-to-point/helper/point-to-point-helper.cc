@@ -89,6 +89,7 @@ PointToPointHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, b
     }
 
   PcapHelper pcapHelper;
+  pcapHelper.SetTraceFilter (m_pcapFilter);
 
   std::string filename;
   if (explicitFilename)
@@ -145,6 +146,7 @@ PointToPointHelper::EnableAsciiInternal (
       // name of the file given the prefix.
       //
       AsciiTraceHelper asciiTraceHelper;
+      asciiTraceHelper.SetTraceFilter (m_asciiFilter);
 
       std::string filename;
       if (explicitFilename)
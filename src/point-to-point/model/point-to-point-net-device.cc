@@ -17,6 +17,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
 #include "ns3/mac48-address.h"
@@ -26,6 +27,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/segment-offload-tag.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -196,6 +198,26 @@ PointToPointNetDevice::SetDataRate (DataRate bps)
   m_bps = bps;
 }
 
+DataRate
+PointToPointNetDevice::GetDataRate (void) const
+{
+  return m_bps;
+}
+
+void
+PointToPointNetDevice::SetBackgroundDataRate (DataRate bps)
+{
+  NS_LOG_FUNCTION (this << bps);
+  NS_ABORT_MSG_IF (bps >= m_bps, "The background traffic must leave some of the data rate to the packets");
+  m_backgroundBps = bps;
+}
+
+DataRate
+PointToPointNetDevice::GetBackgroundDataRate (void) const
+{
+  return m_backgroundBps;
+}
+
 void
 PointToPointNetDevice::SetInterframeGap (Time t)
 {
@@ -219,7 +241,22 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = Seconds (m_bps.CalculateTxTime (p->GetSize ()));
+  // the packets are transmitted at the rate the background traffic leaves;
+  // the data rate may have been lowered since the background rate was set.
+  DataRate bps = m_bps;
+  if (m_backgroundBps.GetBitRate () != 0)
+    {
+      NS_ABORT_MSG_IF (m_backgroundBps >= m_bps, "The background traffic " << m_backgroundBps
+                       << " leaves nothing of the data rate " << m_bps << " to the packets");
+      bps = DataRate (m_bps.GetBitRate () - m_backgroundBps.GetBitRate ());
+    }
+  Time txTime = Seconds (bps.CalculateTxTime (p->GetSize ()));
+  SegmentOffloadTag offload;
+  if (p->PeekPacketTag (offload))
+    { // Transmit all the packets the offloaded packet stands for
+      txTime = Seconds (bps.CalculateTxTime (offload.GetWireSize (p->GetSize ())))
+        + TimeStep (m_tInterframeGap.GetTimeStep () * (offload.GetNPackets () - 1));
+    }
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
@@ -562,6 +599,12 @@ PointToPointNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentOffload (void) const
+{
+  return true;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
@@ -86,6 +86,37 @@ public:
    */
   void SetDataRate (DataRate bps);
 
+  /**
+   * Get the Data Rate used for transmission of packets.
+   *
+   * @returns the data rate at which this object operates
+   */
+  DataRate GetDataRate (void) const;
+
+  /**
+   * Set the rate of the background traffic which shares the transmitter
+   * with the packets of the device.
+   *
+   * The background traffic is not made of packets: it only takes its rate
+   * from the data rate of the device, so that the packets are transmitted
+   * at the residual rate, and wait in the queue accordingly. This is how
+   * flow-level traffic models load the links without scheduling any
+   * per-packet event.
+   *
+   * @param bps the rate of the background traffic, lower than the data rate
+   * (the transmission of a packet aborts if the data rate is later set to
+   * the background rate or lower)
+   */
+  void SetBackgroundDataRate (DataRate bps);
+
+  /**
+   * Get the rate of the background traffic which shares the transmitter
+   * with the packets of the device.
+   *
+   * @returns the rate of the background traffic
+   */
+  DataRate GetBackgroundDataRate (void) const;
+
   /**
    * Set the interframe gap used to separate packets.  The interframe gap
    * defines the minimum space required between packets sent by this device.
@@ -184,6 +215,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentOffload (void) const;
 
 protected:
   void DoMpiReceive (Ptr<Packet> p);
@@ -269,6 +301,12 @@ private:
    */
   DataRate       m_bps;
 
+  /**
+   * The rate of the background traffic, which the packets do not use.
+   * @see SetBackgroundDataRate ()
+   */
+  DataRate       m_backgroundBps;
+
   /**
    * The interframe gap that the Net Device uses to throttle packet
    * transmission
@@ -3,6 +3,7 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/segment-offload-tag.h"
 
 using namespace ns3;
 
@@ -56,6 +57,141 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
+class PointToPointOffloadTest : public TestCase
+{
+public:
+  PointToPointOffloadTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t nPackets);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  Time m_received;
+};
+
+PointToPointOffloadTest::PointToPointOffloadTest ()
+  : TestCase ("PointToPoint transmission of offloaded packets")
+{
+}
+
+void
+PointToPointOffloadTest::SendOnePacket (Ptr<PointToPointNetDevice> device, uint32_t nPackets)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  if (nPackets > 1)
+    { // 880 bytes of payload, the other 120 bytes are the headers of each packet
+      p->AddPacketTag (SegmentOffloadTag (nPackets, 880));
+    }
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointOffloadTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_received = Simulator::Now ();
+  return true;
+}
+
+void
+PointToPointOffloadTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointOffloadTest::Receive, this));
+
+  // 1002 bytes with the PPP header: 1 us per byte
+  Simulator::Schedule (Seconds (1.0), &PointToPointOffloadTest::SendOnePacket, this, devA, 1);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_received, MicroSeconds (1001002), "Wrong transmission time");
+
+  // Four packets of 1002 - 880 = 122 bytes of headers and 220 bytes of payload
+  Simulator::Schedule (Seconds (1.0), &PointToPointOffloadTest::SendOnePacket, this, devA, 4);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_received, MicroSeconds (2001002 + 1002 + 3 * 122), "Wrong transmission time of the offloaded packet");
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
+class PointToPointBackgroundTest : public TestCase
+{
+public:
+  PointToPointBackgroundTest ();
+
+  virtual void DoRun (void);
+
+private:
+  void SendOnePacket (Ptr<PointToPointNetDevice> device);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  Time m_received;
+};
+
+PointToPointBackgroundTest::PointToPointBackgroundTest ()
+  : TestCase ("PointToPoint transmission with background traffic")
+{
+}
+
+void
+PointToPointBackgroundTest::SendOnePacket (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  device->Send (p, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointBackgroundTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_received = Simulator::Now ();
+  return true;
+}
+
+void
+PointToPointBackgroundTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devA->SetBackgroundDataRate (DataRate ("6Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBackgroundTest::Receive, this));
+
+  // 6 Mbps of background traffic leave 2 Mbps to the packets: 1002 bytes
+  // with the PPP header at 4 us per byte
+  Simulator::Schedule (Seconds (1.0), &PointToPointBackgroundTest::SendOnePacket, this, devA);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_received, MicroSeconds (1000000 + 4 * 1002), "Wrong transmission time with background traffic");
+
+  Simulator::Destroy ();
+}
+//-----------------------------------------------------------------------------
 class PointToPointTestSuite : public TestSuite
 {
 public:
@@ -66,6 +202,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointOffloadTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBackgroundTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite;
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Benchmarks of the time taken by the end point demultiplexers to
+ * allocate the end points of a server with many connections, and to
+ * find the end point of a received segment. Run them with
+ *
+ *   ./test.py --constrain=performance --suite=end-point-demux-performance --verbose
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <sys/time.h>
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+namespace {
+
+const uint16_t SERVER_PORT = 80;
+const uint32_t N_LOOKUPS = 100000;
+
+double
+GetRealTime (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/**
+ * The address and port of client i, spread over the 10.1.0.0/16
+ * network and its ephemeral ports.
+ */
+Ipv4Address
+GetClientIpv4 (uint32_t i)
+{
+  return Ipv4Address (0x0a010000 + 1 + i / 64);
+}
+
+Ipv6Address
+GetClientIpv6 (uint32_t i)
+{
+  uint8_t buffer[16] = { 0x20, 0x01, 0, 2 };
+  buffer[14] = (1 + i / 64) >> 8;
+  buffer[15] = (1 + i / 64) & 0xff;
+  return Ipv6Address (buffer);
+}
+
+uint16_t
+GetClientPort (uint32_t i)
+{
+  return 49152 + i % 64;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+class Ipv4EndPointDemuxPerformanceTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxPerformanceTestCase (uint32_t nConnections);
+  virtual void DoRun (void);
+private:
+  uint32_t m_nConnections;
+};
+
+Ipv4EndPointDemuxPerformanceTestCase::Ipv4EndPointDemuxPerformanceTestCase (uint32_t nConnections)
+  : TestCase ("Time taken by the lookups of Ipv4EndPointDemux"),
+    m_nConnections (nConnections)
+{
+}
+
+void
+Ipv4EndPointDemuxPerformanceTestCase::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  interface->SetDevice (device);
+  Ipv4Address server ("10.0.0.1");
+  interface->AddAddress (Ipv4InterfaceAddress (server, Ipv4Mask ("255.255.255.0")));
+
+  // a listener and its connections, as TcpSocketBase creates them.
+  Ipv4EndPointDemux demux;
+  double start = GetRealTime ();
+  demux.Allocate (SERVER_PORT);
+  for (uint32_t i = 0; i < m_nConnections; ++i)
+    {
+      demux.Allocate (server, SERVER_PORT, GetClientIpv4 (i), GetClientPort (i));
+    }
+  double allocation = GetRealTime () - start;
+
+  uint32_t found = 0;
+  start = GetRealTime ();
+  for (uint32_t i = 0; i < N_LOOKUPS; ++i)
+    {
+      uint32_t j = (i * 7919) % m_nConnections;
+      Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (server, SERVER_PORT, GetClientIpv4 (j),
+                                                             GetClientPort (j), interface);
+      if (endPoints.size () == 1 && endPoints.front ()->GetPeerAddress () == GetClientIpv4 (j))
+        {
+          found++;
+        }
+    }
+  double elapsed = GetRealTime () - start;
+  std::cout << m_nConnections << " IPv4 connections: " << std::setprecision (3)
+            << allocation / m_nConnections * 1e9 << " ns per allocation, "
+            << elapsed / N_LOOKUPS * 1e9 << " ns per lookup" << std::endl;
+  NS_TEST_ASSERT_MSG_EQ (found, N_LOOKUPS, "Missing connections");
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class Ipv6EndPointDemuxPerformanceTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxPerformanceTestCase (uint32_t nConnections);
+  virtual void DoRun (void);
+private:
+  uint32_t m_nConnections;
+};
+
+Ipv6EndPointDemuxPerformanceTestCase::Ipv6EndPointDemuxPerformanceTestCase (uint32_t nConnections)
+  : TestCase ("Time taken by the lookups of Ipv6EndPointDemux"),
+    m_nConnections (nConnections)
+{
+}
+
+void
+Ipv6EndPointDemuxPerformanceTestCase::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  interface->SetDevice (device);
+  Ipv6Address server ("2001:1::1");
+
+  Ipv6EndPointDemux demux;
+  double start = GetRealTime ();
+  demux.Allocate (SERVER_PORT);
+  for (uint32_t i = 0; i < m_nConnections; ++i)
+    {
+      demux.Allocate (server, SERVER_PORT, GetClientIpv6 (i), GetClientPort (i));
+    }
+  double allocation = GetRealTime () - start;
+
+  uint32_t found = 0;
+  start = GetRealTime ();
+  for (uint32_t i = 0; i < N_LOOKUPS; ++i)
+    {
+      uint32_t j = (i * 7919) % m_nConnections;
+      Ipv6EndPointDemux::EndPoints endPoints = demux.Lookup (server, SERVER_PORT, GetClientIpv6 (j),
+                                                             GetClientPort (j), interface);
+      if (endPoints.size () == 1 && endPoints.front ()->GetPeerAddress () == GetClientIpv6 (j))
+        {
+          found++;
+        }
+    }
+  double elapsed = GetRealTime () - start;
+  std::cout << m_nConnections << " IPv6 connections: " << std::setprecision (3)
+            << allocation / m_nConnections * 1e9 << " ns per allocation, "
+            << elapsed / N_LOOKUPS * 1e9 << " ns per lookup" << std::endl;
+  NS_TEST_ASSERT_MSG_EQ (found, N_LOOKUPS, "Missing connections");
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class EndPointDemuxPerformanceTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxPerformanceTestSuite () : TestSuite ("end-point-demux-performance", PERFORMANCE)
+  {
+    AddTestCase (new Ipv4EndPointDemuxPerformanceTestCase (100), TestCase::QUICK);
+    AddTestCase (new Ipv4EndPointDemuxPerformanceTestCase (1000), TestCase::QUICK);
+    AddTestCase (new Ipv4EndPointDemuxPerformanceTestCase (10000), TestCase::QUICK);
+    AddTestCase (new Ipv4EndPointDemuxPerformanceTestCase (50000), TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxPerformanceTestCase (1000), TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxPerformanceTestCase (50000), TestCase::QUICK);
+  }
+} g_endPointDemuxPerformanceTestSuite;
@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Benchmarks of the memory used by the routing tables of
+ * Ipv4GlobalRouting, and of the time taken by a route lookup, as a
+ * function of the number of routes. Run them with
+ *
+ *   ./test.py --constrain=performance --suite=global-routing-performance --verbose
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <vector>
+#include <cstdio>
+#include <sys/time.h>
+#include <unistd.h>
+#include "ns3/node.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/mac48-address.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+namespace {
+
+const uint32_t N_INTERFACES = 8;
+
+double
+GetRealTime (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/**
+ * \returns the resident memory of the process in bytes, or zero when
+ *          it is unknown.
+ */
+uint64_t
+GetResidentMemory (void)
+{
+  uint64_t size = 0;
+  uint64_t resident = 0;
+#ifdef __linux__
+  FILE *file = std::fopen ("/proc/self/statm", "r");
+  if (file != 0)
+    {
+      unsigned long s, r;
+      if (std::fscanf (file, "%lu %lu", &s, &r) == 2)
+        {
+          size = s;
+          resident = r * sysconf (_SC_PAGESIZE);
+        }
+      std::fclose (file);
+    }
+#endif
+  return size > 0 ? resident : 0;
+}
+
+/**
+ * The routes of node i of a topology of nodes numbered 10.x.y.1, with
+ * a host route to each node and a /30 network route to each
+ * point-to-point link, all of them through one of N_INTERFACES next hops.
+ */
+void
+AddRoutes (Ptr<Ipv4GlobalRouting> routing, uint32_t i, uint32_t nRoutes)
+{
+  for (uint32_t j = 0; j < nRoutes / 2; ++j)
+    {
+      uint32_t interface = 1 + (i + j) % N_INTERFACES;
+      Ipv4Address gateway (0xc0a80002 + ((interface - 1) << 8));
+      routing->AddHostRouteTo (Ipv4Address (0x0a000001 + (j << 8)), gateway, interface);
+      routing->AddNetworkRouteTo (Ipv4Address (0x0b000000 + (j << 2)), Ipv4Mask ("255.255.255.252"), gateway, interface);
+    }
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+class GlobalRoutingMemoryTestCase : public TestCase
+{
+public:
+  GlobalRoutingMemoryTestCase (uint32_t nNodes, uint32_t nRoutes);
+  virtual void DoRun (void);
+private:
+  uint32_t m_nNodes;
+  uint32_t m_nRoutes;
+};
+
+GlobalRoutingMemoryTestCase::GlobalRoutingMemoryTestCase (uint32_t nNodes, uint32_t nRoutes)
+  : TestCase ("Memory used by the routing tables of Ipv4GlobalRouting"),
+    m_nNodes (nNodes),
+    m_nRoutes (nRoutes)
+{
+}
+
+void
+GlobalRoutingMemoryTestCase::DoRun (void)
+{
+  uint64_t before = GetResidentMemory ();
+  double start = GetRealTime ();
+  std::vector<Ptr<Ipv4GlobalRouting> > routings;
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      routings.push_back (CreateObject<Ipv4GlobalRouting> ());
+      AddRoutes (routings.back (), i, m_nRoutes);
+    }
+  double build = GetRealTime () - start;
+  uint64_t after = GetResidentMemory ();
+
+  uint64_t total = (uint64_t)m_nNodes * m_nRoutes;
+  std::cout << m_nNodes << " nodes x " << m_nRoutes << " routes: built in " << build << " s";
+  if (before > 0)
+    {
+      std::cout << ", " << (after - before) / 1024 << " KiB, "
+                << std::setprecision (3) << double (after - before) / total << " bytes per route";
+    }
+  std::cout << std::endl;
+
+  // the legacy layout, one heap-allocated entry per route in a list.
+  before = GetResidentMemory ();
+  std::list<Ipv4RoutingTableEntry *> *legacy = new std::list<Ipv4RoutingTableEntry *> [m_nNodes];
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      for (uint32_t j = 0; j < m_nRoutes; ++j)
+        {
+          legacy[i].push_back (new Ipv4RoutingTableEntry ());
+        }
+    }
+  after = GetResidentMemory ();
+  if (before > 0)
+    {
+      std::cout << "  list of entries: " << (after - before) / 1024 << " KiB, "
+                << std::setprecision (3) << double (after - before) / total << " bytes per route" << std::endl;
+    }
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      for (std::list<Ipv4RoutingTableEntry *>::iterator j = legacy[i].begin (); j != legacy[i].end (); ++j)
+        {
+          delete *j;
+        }
+    }
+  delete [] legacy;
+
+  for (uint32_t i = 0; i < m_nNodes; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (routings[i]->GetNRoutes (), m_nRoutes / 2 * 2, "Wrong number of routes");
+      routings[i]->Dispose ();
+    }
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class GlobalRoutingLookupTestCase : public TestCase
+{
+public:
+  GlobalRoutingLookupTestCase (uint32_t nRoutes);
+  virtual void DoRun (void);
+private:
+  uint32_t m_nRoutes;
+};
+
+GlobalRoutingLookupTestCase::GlobalRoutingLookupTestCase (uint32_t nRoutes)
+  : TestCase ("Time taken by a route lookup of Ipv4GlobalRouting"),
+    m_nRoutes (nRoutes)
+{
+}
+
+void
+GlobalRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  ipv4->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv4);
+  for (uint32_t i = 0; i < N_INTERFACES; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (0xc0a80001 + (i << 8)), Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+    }
+  AddRoutes (routing, 0, m_nRoutes);
+
+  const uint32_t nLookups = 100000;
+  uint32_t found = 0;
+  double start = GetRealTime ();
+  for (uint32_t i = 0; i < nLookups; ++i)
+    {
+      // alternate between host and network routes.
+      uint32_t j = (i * 7919) % (m_nRoutes / 2);
+      Ipv4Header header;
+      header.SetDestination (Ipv4Address (i % 2 == 0 ? 0x0a000001 + (j << 8) : 0x0b000001 + (j << 2)));
+      Socket::SocketErrno error;
+      if (routing->RouteOutput (0, header, 0, error) != 0)
+        {
+          found++;
+        }
+    }
+  double elapsed = GetRealTime () - start;
+  std::cout << m_nRoutes << " routes: " << std::setprecision (3)
+            << elapsed / nLookups * 1e9 << " ns per lookup" << std::endl;
+  NS_TEST_ASSERT_MSG_EQ (found, nLookups, "Missing routes");
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+class GlobalRoutingPerformanceTestSuite : public TestSuite
+{
+public:
+  GlobalRoutingPerformanceTestSuite () : TestSuite ("global-routing-performance", PERFORMANCE)
+  {
+    AddTestCase (new GlobalRoutingMemoryTestCase (1000, 1000), TestCase::QUICK);
+    AddTestCase (new GlobalRoutingMemoryTestCase (1000, 10000), TestCase::EXTENSIVE);
+    AddTestCase (new GlobalRoutingLookupTestCase (100), TestCase::QUICK);
+    AddTestCase (new GlobalRoutingLookupTestCase (1000), TestCase::QUICK);
+    AddTestCase (new GlobalRoutingLookupTestCase (10000), TestCase::QUICK);
+  }
+} g_globalRoutingPerformanceTestSuite;
@@ -15,6 +15,9 @@
  */
 
 #include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/csma-helper.h"
@@ -24,6 +27,8 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
@@ -385,6 +390,138 @@ GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class GlobalRoutingSpfTestCase : public TestCase
+{
+public:
+  GlobalRoutingSpfTestCase ();
+  virtual ~GlobalRoutingSpfTestCase ();
+
+private:
+  typedef std::vector<std::vector<std::string> > Tables;
+  virtual void DoRun (void);
+  void GetTables (Tables &tables, bool sorted);
+  void Recompute (bool incremental);
+  NodeContainer m_nodes;
+};
+
+GlobalRoutingSpfTestCase::GlobalRoutingSpfTestCase ()
+  : TestCase ("Parallel and incremental SPF calculations")
+{
+}
+
+GlobalRoutingSpfTestCase::~GlobalRoutingSpfTestCase ()
+{
+}
+
+void
+GlobalRoutingSpfTestCase::GetTables (Tables &tables, bool sorted)
+{
+  tables.clear ();
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = m_nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      tables.push_back (std::vector<std::string> ());
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          std::ostringstream oss;
+          oss << *gr->GetRoute (j);
+          tables.back ().push_back (oss.str ());
+        }
+      if (sorted)
+        {
+          std::sort (tables.back ().begin (), tables.back ().end ());
+        }
+    }
+}
+
+void
+GlobalRoutingSpfTestCase::Recompute (bool incremental)
+{
+  Config::SetGlobal ("GlobalRoutingIncremental", BooleanValue (incremental));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+}
+
+// A ring of 24 routers with chords.  The tables
+// computed by 4 threads must be those computed by one, and the tables
+// recomputed incrementally after a link metric change or a link going down
+// must hold the same routes as the tables recomputed from scratch.
+void
+GlobalRoutingSpfTestCase::DoRun (void)
+{
+  const uint32_t n = 24;
+  m_nodes.Create (n);
+  InternetStackHelper internet;
+  internet.Install (m_nodes);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  // the interface at each end of the point-to-point links.
+  std::vector<std::pair<Ptr<Ipv4>, uint32_t> > interfaces;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      uint32_t peers[2] = { (i + 1) % n, (i * 7 + 3) % n };
+      for (uint32_t k = 0; k < (i % 2 == 0 ? 2u : 1u); k++)
+        {
+          if (peers[k] == i)
+            {
+              continue;
+            }
+          NetDeviceContainer devices = p2p.Install (m_nodes.Get (i), m_nodes.Get (peers[k]));
+          Ipv4InterfaceContainer addresses = ipv4.Assign (devices);
+          ipv4.NewNetwork ();
+          for (uint32_t j = 0; j < 2; j++)
+            {
+              std::pair<Ptr<Ipv4>, uint32_t> interface = addresses.Get (j);
+              interface.first->SetMetric (interface.second, (interfaces.size () * 13) % 17 + 1);
+              interfaces.push_back (interface);
+            }
+        }
+    }
+
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (1));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  Tables serial;
+  GetTables (serial, false);
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (4));
+  Recompute (false);
+  Tables parallel;
+  GetTables (parallel, false);
+  NS_TEST_ASSERT_MSG_EQ ((parallel == serial), true, "The parallel calculations found other routes");
+
+  Recompute (true);
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      std::pair<Ptr<Ipv4>, uint32_t> interface = interfaces[(i * 11) % interfaces.size ()];
+      if (i % 4 == 3)
+        {
+          interface.first->SetDown (interface.second);
+        }
+      else if (i == 6)
+        {
+          // a new external route makes all the routers recompute their tree.
+          m_nodes.Get (5)->GetObject<GlobalRouter> ()->InjectRoute (Ipv4Address ("192.168.0.0"),
+                                                                   Ipv4Mask ("255.255.0.0"));
+        }
+      else
+        {
+          interface.first->SetMetric (interface.second, i % 2 == 0 ? 1 : 50);
+        }
+      Recompute (true);
+      Tables incremental;
+      GetTables (incremental, true);
+      Recompute (false);
+      Tables full;
+      GetTables (full, true);
+      NS_TEST_ASSERT_MSG_EQ ((incremental == full), true, "The incremental calculation found other routes after change " << i);
+      // start again from a full calculation, which keeps the trees.
+      Recompute (true);
+    }
+
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (1));
+  Config::SetGlobal ("GlobalRoutingIncremental", BooleanValue (false));
+  Simulator::Destroy ();
+}
 
 class GlobalRoutingTestSuite : public TestSuite
 {
@@ -397,6 +534,7 @@ GlobalRoutingTestSuite::GlobalRoutingTestSuite ()
 {
   AddTestCase (new DynamicGlobalRoutingTestCase, TestCase::QUICK);
   AddTestCase (new GlobalRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new GlobalRoutingSpfTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
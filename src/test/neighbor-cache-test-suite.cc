@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/csma-helper.h"
+#include "ns3/csma-net-device.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/icmpv6-header.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/node-container.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test of NeighborCacheHelper: on a LAN whose neighbor caches are filled
+// with permanent entries, the hosts send their traffic without resolving
+// any address, neither with ARP nor with Neighbor Discovery. Without the
+// helper, the same traffic resolves the addresses first.
+// ===========================================================================
+//
+class NeighborCacheTestCase : public TestCase
+{
+public:
+  NeighborCacheTestCase (bool populate);
+  virtual ~NeighborCacheTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  void PhyTxBegin (Ptr<const Packet> p);
+  void SendTo (Ptr<Node> node, Address to);
+  void Receive (Ptr<Socket> socket);
+
+  bool m_populate;
+  uint32_t m_resolutions;
+  uint32_t m_received;
+};
+
+NeighborCacheTestCase::NeighborCacheTestCase (bool populate)
+  : TestCase (populate ? "Check that the hosts of a LAN with populated neighbor caches resolve no address"
+              : "Check that the hosts of a LAN resolve the addresses"),
+    m_populate (populate),
+    m_resolutions (0),
+    m_received (0)
+{
+}
+
+void
+NeighborCacheTestCase::PhyTxBegin (Ptr<const Packet> p)
+{
+  // the Duplicate Address Detection of IPv6 happens before the traffic.
+  if (Simulator::Now () < Seconds (1))
+    {
+      return;
+    }
+  Ptr<Packet> packet = p->Copy ();
+  EthernetHeader ethernet (false);
+  packet->RemoveHeader (ethernet);
+  if (ethernet.GetLengthType () == 0x0806)
+    {
+      m_resolutions++;
+    }
+  else if (ethernet.GetLengthType () == 0x86dd)
+    {
+      Ipv6Header ipv6;
+      packet->RemoveHeader (ipv6);
+      Icmpv6Header icmpv6;
+      if (ipv6.GetNextHeader () == Icmpv6L4Protocol::PROT_NUMBER
+          && packet->PeekHeader (icmpv6)
+          && (icmpv6.GetType () == Icmpv6Header::ICMPV6_ND_NEIGHBOR_SOLICITATION
+              || icmpv6.GetType () == Icmpv6Header::ICMPV6_ND_NEIGHBOR_ADVERTISEMENT))
+        {
+          m_resolutions++;
+        }
+    }
+}
+
+void
+NeighborCacheTestCase::SendTo (Ptr<Node> node, Address to)
+{
+  Ptr<Socket> socket = Socket::CreateSocket (node, UdpSocketFactory::GetTypeId ());
+  socket->SendTo (Create<Packet> (100), 0, to);
+}
+
+void
+NeighborCacheTestCase::Receive (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      m_received++;
+    }
+}
+
+void
+NeighborCacheTestCase::DoRun (void)
+{
+  uint32_t nNodes = 8;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  CsmaHelper csma;
+  NetDeviceContainer devices = csma.Install (nodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      devices.Get (i)->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&NeighborCacheTestCase::PhyTxBegin, this));
+    }
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4.Assign (devices);
+  Ipv6AddressHelper ipv6;
+  ipv6.NewNetwork (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6.Assign (devices);
+
+  if (m_populate)
+    {
+      NeighborCacheHelper::PopulateNeighborCaches (devices.Get (0)->GetChannel ());
+
+      // the permanent entries survive a flush of the cache.
+      Ptr<Ipv4L3Protocol> ipv4L3 = nodes.Get (1)->GetObject<Ipv4L3Protocol> ();
+      Ptr<ArpCache> cache = ipv4L3->GetInterface (ipv4L3->GetInterfaceForDevice (devices.Get (1)))->GetArpCache ();
+      cache->Flush ();
+      ArpCache::Entry *entry = cache->Lookup (ipv4Interfaces.GetAddress (0));
+      NS_TEST_ASSERT_MSG_NE (entry, 0, "The helper did not fill the ARP cache");
+      NS_TEST_ASSERT_MSG_EQ (entry->IsPermanent (), true, "The ARP cache entry is not permanent");
+      NS_TEST_ASSERT_MSG_EQ (entry->GetMacAddress (), devices.Get (0)->GetAddress (), "The ARP cache entry has a wrong address");
+    }
+
+  Ptr<Socket> sink4 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  sink4->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  sink4->SetRecvCallback (MakeCallback (&NeighborCacheTestCase::Receive, this));
+  Ptr<Socket> sink6 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  sink6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 9));
+  sink6->SetRecvCallback (MakeCallback (&NeighborCacheTestCase::Receive, this));
+
+  for (uint32_t i = 1; i < nNodes; i++)
+    {
+      Simulator::Schedule (Seconds (1), &NeighborCacheTestCase::SendTo, this, nodes.Get (i),
+                           InetSocketAddress (ipv4Interfaces.GetAddress (0), 9));
+      Simulator::Schedule (Seconds (1), &NeighborCacheTestCase::SendTo, this, nodes.Get (i),
+                           Inet6SocketAddress (ipv6Interfaces.GetAddress (0, 1), 9));
+    }
+
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 2 * (nNodes - 1), "The sink did not receive all the packets");
+  if (m_populate)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_resolutions, 0, "The hosts resolved addresses");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (m_resolutions, 0, "The hosts did not resolve the addresses");
+    }
+}
+
+class NeighborCacheTestSuite : public TestSuite
+{
+public:
+  NeighborCacheTestSuite ();
+};
+
+NeighborCacheTestSuite::NeighborCacheTestSuite ()
+  : TestSuite ("neighbor-cache", SYSTEM)
+{
+  AddTestCase (new NeighborCacheTestCase (false), TestCase::QUICK);
+  AddTestCase (new NeighborCacheTestCase (true), TestCase::QUICK);
+}
+
+static NeighborCacheTestSuite neighborCacheTestSuite;
@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv4-nix-vector-routing.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/mac48-address.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+namespace {
+
+void
+InstallNixVectorRouting (NodeContainer nodes)
+{
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (nodes);
+}
+
+NetDeviceContainer
+Connect (Ptr<Node> a, Ptr<Node> b, Ipv4AddressHelper &address)
+{
+  PointToPointHelper p2p;
+  NetDeviceContainer devices = p2p.Install (a, b);
+  address.Assign (devices);
+  address.NewNetwork ();
+  return devices;
+}
+
+/**
+ * \returns the route of the node to the destination, with the nix-vector
+ * given to the packet in \p nixVector.
+ */
+Ptr<Ipv4Route>
+RouteOutput (Ptr<Node> node, Ipv4Address destination, std::string *nixVector = 0)
+{
+  Ptr<Ipv4RoutingProtocol> routing = node->GetObject<Ipv4NixVectorRouting> ();
+  Ptr<Packet> p = Create<Packet> ();
+  Ipv4Header header;
+  header.SetDestination (destination);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = routing->RouteOutput (p, header, 0, sockerr);
+  if (nixVector != 0 && p->GetNixVector () != 0)
+    {
+      std::ostringstream oss;
+      oss << *p->GetNixVector ();
+      *nixVector = oss.str ();
+    }
+  return route;
+}
+
+} // anonymous namespace
+
+// ===========================================================================
+// The nix-vectors computed in advance are the ones found by the searches
+// of the first packets.
+// ===========================================================================
+class NixVectorPrecomputeTestCase : public TestCase
+{
+public:
+  NixVectorPrecomputeTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NixVectorPrecomputeTestCase::NixVectorPrecomputeTestCase ()
+  : TestCase ("Check the nix-vectors computed in advance")
+{
+}
+
+void
+NixVectorPrecomputeTestCase::DoRun (void)
+{
+  // n0 - n1 - n2 - n3
+  NodeContainer nodes;
+  nodes.Create (4);
+  InstallNixVectorRouting (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Connect (nodes.Get (0), nodes.Get (1), address);
+  Connect (nodes.Get (1), nodes.Get (2), address);
+  Connect (nodes.Get (2), nodes.Get (3), address);
+
+  std::vector<std::pair<Ptr<Node>, Ipv4Address> > flows;
+  flows.push_back (std::make_pair (nodes.Get (0), Ipv4Address ("10.1.3.2")));
+  flows.push_back (std::make_pair (nodes.Get (0), Ipv4Address ("10.1.2.2")));
+  flows.push_back (std::make_pair (nodes.Get (1), Ipv4Address ("10.1.3.2")));
+  flows.push_back (std::make_pair (nodes.Get (3), Ipv4Address ("10.1.1.1")));
+  // no node has this address
+  flows.push_back (std::make_pair (nodes.Get (0), Ipv4Address ("10.9.9.9")));
+  Ipv4NixVectorRouting::PrecomputeNixVectors (flows);
+
+  std::vector<std::string> precomputed (flows.size ());
+  std::vector<Ptr<NetDevice> > devices (flows.size ());
+  for (uint32_t i = 0; i < flows.size (); i++)
+    {
+      Ptr<Ipv4Route> route = RouteOutput (flows[i].first, flows[i].second, &precomputed[i]);
+      devices[i] = route ? route->GetOutputDevice () : 0;
+    }
+  NS_TEST_EXPECT_MSG_EQ (devices.back (), 0, "Route found to an unknown address");
+
+  nodes.Get (0)->GetObject<Ipv4NixVectorRouting> ()->FlushGlobalNixRoutingCache ();
+  for (uint32_t i = 0; i + 1 < flows.size (); i++)
+    {
+      std::string searched;
+      Ptr<Ipv4Route> route = RouteOutput (flows[i].first, flows[i].second, &searched);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route for the flow " << i);
+      NS_TEST_EXPECT_MSG_EQ (precomputed[i], searched, "Wrong precomputed nix-vector for the flow " << i);
+      NS_TEST_EXPECT_MSG_EQ (devices[i], route->GetOutputDevice (), "Wrong output device for the flow " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// An interface going down flushes the paths through it, which are
+// searched again around the link.
+// ===========================================================================
+class NixVectorFlushPathsTestCase : public TestCase
+{
+public:
+  NixVectorFlushPathsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NixVectorFlushPathsTestCase::NixVectorFlushPathsTestCase ()
+  : TestCase ("Check that the paths through an interface going down are flushed")
+{
+}
+
+void
+NixVectorFlushPathsTestCase::DoRun (void)
+{
+  // n0 - n1 - n2, and the longer n0 - n3 - n4 - n2
+  NodeContainer nodes;
+  nodes.Create (5);
+  InstallNixVectorRouting (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  NetDeviceContainer d01 = Connect (nodes.Get (0), nodes.Get (1), address);
+  NetDeviceContainer d12 = Connect (nodes.Get (1), nodes.Get (2), address);
+  NetDeviceContainer d03 = Connect (nodes.Get (0), nodes.Get (3), address);
+  Connect (nodes.Get (3), nodes.Get (4), address);
+  Connect (nodes.Get (4), nodes.Get (2), address);
+
+  Ipv4Address n1 ("10.1.1.2");
+  Ipv4Address n2 ("10.1.2.2");
+  Ptr<Ipv4Route> route = RouteOutput (nodes.Get (0), n2);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to n2");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), d01.Get (0), "The route to n2 does not go through n1");
+  route = RouteOutput (nodes.Get (0), n1);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to n1");
+
+  // the link n1 - n2 goes down on the side of n1
+  Ptr<Ipv4> ipv4 = nodes.Get (1)->GetObject<Ipv4> ();
+  ipv4->SetDown (ipv4->GetInterfaceForDevice (d12.Get (0)));
+
+  route = RouteOutput (nodes.Get (0), n2);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to n2 around the link which went down");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), d03.Get (0), "The route to n2 does not go through n3");
+  route = RouteOutput (nodes.Get (0), n1);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route to n1 after the link n1 - n2 went down");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), d01.Get (0), "The route to n1 changed");
+
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// A destination is reachable as soon as the link to it comes up, even if
+// it was looked up before.
+// ===========================================================================
+class NixVectorLinkUpTestCase : public TestCase
+{
+public:
+  NixVectorLinkUpTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+NixVectorLinkUpTestCase::NixVectorLinkUpTestCase ()
+  : TestCase ("Check that a link coming up after a failed lookup is used")
+{
+}
+
+void
+NixVectorLinkUpTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  InstallNixVectorRouting (nodes);
+  // devices which are not attached to a channel yet: their link is down.
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<PointToPointNetDevice> device = CreateObject<PointToPointNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetQueue (CreateObject<DropTailQueue> ());
+      nodes.Get (i)->AddDevice (device);
+      devices.Add (device);
+    }
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (devices);
+
+  Ipv4Address n1 ("10.1.1.2");
+  NS_TEST_EXPECT_MSG_EQ (RouteOutput (nodes.Get (0), n1), 0, "Route found without a link");
+
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  DynamicCast<PointToPointNetDevice> (devices.Get (0))->Attach (channel);
+  DynamicCast<PointToPointNetDevice> (devices.Get (1))->Attach (channel);
+
+  Ptr<Ipv4Route> route = RouteOutput (nodes.Get (0), n1);
+  NS_TEST_ASSERT_MSG_NE (route, 0, "No route once the link is up");
+  NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), devices.Get (0), "Wrong output device");
+
+  Simulator::Destroy ();
+}
+
+class Ipv4NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4NixVectorRoutingTestSuite ();
+};
+
+Ipv4NixVectorRoutingTestSuite::Ipv4NixVectorRoutingTestSuite ()
+  : TestSuite ("ipv4-nix-vector-routing", UNIT)
+{
+  AddTestCase (new NixVectorPrecomputeTestCase, TestCase::QUICK);
+  AddTestCase (new NixVectorFlushPathsTestCase, TestCase::QUICK);
+  AddTestCase (new NixVectorLinkUpTestCase, TestCase::QUICK);
+}
+
+static Ipv4NixVectorRoutingTestSuite g_ipv4NixVectorRoutingTestSuite;
@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+#include "ns3/queue.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpCubicTest");
+
+namespace {
+
+const uint32_t SEGMENT_SIZE = 1448;
+
+/**
+ * The outcome of a bulk transfer over one bottleneck link.
+ */
+struct TransferResult
+{
+  double utilization;       //!< Share of the link capacity used over the second half of the transfer
+  uint32_t drops;           //!< Packets dropped by the bottleneck queue
+};
+
+uint64_t g_rxBytes;
+uint64_t g_rxBytesAtHalf;
+uint32_t g_drops;
+
+void
+SinkRx (Ptr<const Packet> p, const Address &address)
+{
+  g_rxBytes += p->GetSize ();
+}
+
+void
+RecordHalf (void)
+{
+  g_rxBytesAtHalf = g_rxBytes;
+}
+
+void
+QueueDrop (Ptr<const Packet> p)
+{
+  g_drops++;
+}
+
+/**
+ * Run a bulk transfer over one link of the given rate and RTT, whose
+ * queue holds the given fraction of the bandwidth-delay product. The
+ * slow start is only ended by the losses, or by HyStart.
+ */
+TransferResult
+Transfer (std::string tcpModel, DataRate rate, Time rtt, double queueFraction,
+          uint32_t offloadSize, Time duration, bool hystart)
+{
+  g_rxBytes = 0;
+  g_rxBytesAtHalf = 0;
+  g_drops = 0;
+
+  uint32_t bdp = static_cast<uint32_t> (rate.GetBitRate () * rtt.GetSeconds () / 8);
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue (tcpModel));
+  Config::SetDefault ("ns3::TcpCubic::HyStart", BooleanValue (hystart));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (SEGMENT_SIZE));
+  Config::SetDefault ("ns3::TcpSocket::SlowStartThreshold", UintegerValue (0x7fffffff));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (4 * bdp));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (4 * bdp));
+  Config::SetDefault ("ns3::TcpSocketBase::WindowScaling", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentOffload", UintegerValue (offloadSize));
+  Config::SetDefault ("ns3::DropTailQueue::Mode", StringValue ("QUEUE_MODE_BYTES"));
+  Config::SetDefault ("ns3::DropTailQueue::MaxBytes",
+                      UintegerValue (std::max (static_cast<uint32_t> (queueFraction * bdp),
+                                               2 * std::max (offloadSize, SEGMENT_SIZE))));
+
+  //
+  // n0 ===== n1, the queue of n0 being the bottleneck
+  //
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", DataRateValue (rate));
+  pointToPoint.SetChannelAttribute ("Delay", TimeValue (Seconds (rtt.GetSeconds () / 2)));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+  devices.Get (0)->GetObject<PointToPointNetDevice> ()->GetQueue ()
+    ->TraceConnectWithoutContext ("Drop", MakeCallback (&QueueDrop));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("SendSize", UintegerValue (std::max (offloadSize, SEGMENT_SIZE)));
+  source.Install (nodes.Get (0)).Start (Seconds (0));
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&SinkRx));
+
+  Simulator::Schedule (Seconds (duration.GetSeconds () / 2), &RecordHalf);
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::TcpNewReno"));
+  Config::SetDefault ("ns3::TcpCubic::HyStart", BooleanValue (true));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+  Config::SetDefault ("ns3::TcpSocket::SlowStartThreshold", UintegerValue (0xffff));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (131072));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (131072));
+  Config::SetDefault ("ns3::TcpSocketBase::WindowScaling", BooleanValue (false));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (false));
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentOffload", UintegerValue (0));
+  Config::SetDefault ("ns3::DropTailQueue::Mode", StringValue ("QUEUE_MODE_PACKETS"));
+  Config::SetDefault ("ns3::DropTailQueue::MaxBytes", UintegerValue (100 * 65535));
+
+  TransferResult result;
+  result.utilization = (g_rxBytes - g_rxBytesAtHalf) * 8.0 / (duration.GetSeconds () / 2) / rate.GetBitRate ();
+  result.drops = g_drops;
+  return result;
+}
+
+} // anonymous namespace
+
+// ===========================================================================
+// Tests of the throughput of TcpCubic against the bandwidth-delay product:
+// over links of growing BDP with a small queue, CUBIC uses a large share
+// of the capacity, and no less than NewReno, which takes longer and longer
+// to grow its window back after the losses.
+// ===========================================================================
+//
+class Ns3TcpCubicThroughputTestCase : public TestCase
+{
+public:
+  Ns3TcpCubicThroughputTestCase (std::string rate, std::string rtt, uint32_t offloadSize,
+                                 Time duration, double minUtilization);
+  virtual ~Ns3TcpCubicThroughputTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  DataRate m_rate;
+  Time m_rtt;
+  uint32_t m_offloadSize;
+  Time m_duration;
+  double m_minUtilization;
+};
+
+Ns3TcpCubicThroughputTestCase::Ns3TcpCubicThroughputTestCase (std::string rate, std::string rtt, uint32_t offloadSize,
+                                                              Time duration, double minUtilization)
+  : TestCase ("Check the throughput of TcpCubic over " + rate + " with an RTT of " + rtt),
+    m_rate (rate),
+    m_rtt (rtt),
+    m_offloadSize (offloadSize),
+    m_duration (duration),
+    m_minUtilization (minUtilization)
+{
+}
+
+void
+Ns3TcpCubicThroughputTestCase::DoRun (void)
+{
+  TransferResult newReno = Transfer ("ns3::TcpNewReno", m_rate, m_rtt, 0.2, m_offloadSize, m_duration, true);
+  TransferResult cubic = Transfer ("ns3::TcpCubic", m_rate, m_rtt, 0.2, m_offloadSize, m_duration, true);
+  NS_LOG_INFO (m_rate.GetBitRate () << " b/s, RTT " << m_rtt.GetSeconds () << " s: utilization "
+                                    << newReno.utilization << " with NewReno, "
+                                    << cubic.utilization << " with CUBIC");
+  NS_TEST_ASSERT_MSG_GT (cubic.utilization, m_minUtilization, "CUBIC does not fill the link");
+  NS_TEST_ASSERT_MSG_EQ ((cubic.utilization >= newReno.utilization), true, "CUBIC is slower than NewReno");
+}
+
+// ===========================================================================
+// Test of HyStart: with a queue as large as the bandwidth-delay product,
+// the slow start of TcpCubic overflows the queue without HyStart, and
+// ends before any loss with HyStart.
+// ===========================================================================
+//
+class Ns3TcpCubicHystartTestCase : public TestCase
+{
+public:
+  Ns3TcpCubicHystartTestCase ();
+  virtual ~Ns3TcpCubicHystartTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+Ns3TcpCubicHystartTestCase::Ns3TcpCubicHystartTestCase ()
+  : TestCase ("Check that HyStart ends the slow start of TcpCubic before the losses")
+{
+}
+
+void
+Ns3TcpCubicHystartTestCase::DoRun (void)
+{
+  TransferResult slowStart = Transfer ("ns3::TcpCubic", DataRate ("50Mbps"), MilliSeconds (100), 1,
+                                       0, Seconds (4), false);
+  TransferResult hystart = Transfer ("ns3::TcpCubic", DataRate ("50Mbps"), MilliSeconds (100), 1,
+                                     0, Seconds (4), true);
+  NS_LOG_INFO (slowStart.drops << " drops without HyStart, " << hystart.drops << " with HyStart");
+  NS_TEST_ASSERT_MSG_GT (slowStart.drops, 0, "The slow start does not overflow the queue");
+  NS_TEST_ASSERT_MSG_EQ (hystart.drops, 0, "HyStart does not end the slow start before the losses");
+}
+
+class Ns3TcpCubicTestSuite : public TestSuite
+{
+public:
+  Ns3TcpCubicTestSuite ();
+};
+
+Ns3TcpCubicTestSuite::Ns3TcpCubicTestSuite ()
+  : TestSuite ("ns3-tcp-cubic", SYSTEM)
+{
+  AddTestCase (new Ns3TcpCubicThroughputTestCase ("10Mbps", "100ms", 0, Seconds (20), 0.9), TestCase::QUICK);
+  AddTestCase (new Ns3TcpCubicThroughputTestCase ("100Mbps", "100ms", 65000, Seconds (20), 0.6), TestCase::QUICK);
+  AddTestCase (new Ns3TcpCubicThroughputTestCase ("1Gbps", "50ms", 65000, Seconds (20), 0.7), TestCase::EXTENSIVE);
+  AddTestCase (new Ns3TcpCubicHystartTestCase, TestCase::QUICK);
+}
+
+static Ns3TcpCubicTestSuite ns3TcpCubicTestSuite;
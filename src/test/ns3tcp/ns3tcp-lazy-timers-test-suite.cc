@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpLazyTimersTest");
+
+// ===========================================================================
+// Tests of the lazy TCP timers: a transfer over a lossy link sends the same
+// packets at the same times whether the retransmission and delayed ACK
+// timers are lazy or not, including the retransmission timeouts of the
+// sender and the delayed ACKs of the receiver.
+// ===========================================================================
+//
+class Ns3TcpLazyTimersTestCase : public TestCase
+{
+public:
+  Ns3TcpLazyTimersTestCase ();
+  virtual ~Ns3TcpLazyTimersTestCase () {}
+
+private:
+  /* the time and the size of the packets sent or received by a node */
+  typedef std::vector<std::pair<int64_t, uint32_t> > Trace;
+
+  virtual void DoRun (void);
+  void Transfer (bool lazyTimers);
+  static void Record (Trace *trace, Ptr<const Packet> p);
+  /* the times at which the node sent a packet without receiving any:
+   * the expiries of its timers */
+  static std::set<int64_t> GetTimerTimes (Trace const &tx, Trace const &rx);
+
+  Trace m_senderTx;
+  Trace m_senderRx;
+  Trace m_receiverTx;
+  Trace m_receiverRx;
+  uint32_t m_totalRx;
+};
+
+Ns3TcpLazyTimersTestCase::Ns3TcpLazyTimersTestCase ()
+  : TestCase ("Check that the lazy TCP timers expire at the same times as the rescheduled ones"),
+    m_totalRx (0)
+{
+}
+
+void
+Ns3TcpLazyTimersTestCase::Record (Trace *trace, Ptr<const Packet> p)
+{
+  trace->push_back (std::make_pair (Simulator::Now ().GetTimeStep (), p->GetSize ()));
+}
+
+std::set<int64_t>
+Ns3TcpLazyTimersTestCase::GetTimerTimes (Trace const &tx, Trace const &rx)
+{
+  std::set<int64_t> rxTimes;
+  for (Trace::const_iterator i = rx.begin (); i != rx.end (); i++)
+    {
+      rxTimes.insert (i->first);
+    }
+  std::set<int64_t> timerTimes;
+  for (Trace::const_iterator i = tx.begin (); i != tx.end (); i++)
+    {
+      if (rxTimes.find (i->first) == rxTimes.end ())
+        {
+          timerTimes.insert (i->first);
+        }
+    }
+  return timerTimes;
+}
+
+void
+Ns3TcpLazyTimersTestCase::Transfer (bool lazyTimers)
+{
+  m_senderTx.clear ();
+  m_senderRx.clear ();
+  m_receiverTx.clear ();
+  m_receiverRx.clear ();
+
+  Config::SetDefault ("ns3::TcpSocketBase::LazyTimers", BooleanValue (lazyTimers));
+
+  //
+  // n0 ----- n1, with a burst of losses from n0 to n1 long enough for a
+  // retransmission timeout
+  //
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  std::list<uint32_t> losses;
+  for (uint32_t i = 30; i < 45; i++)
+    {
+      losses.push_back (i);
+    }
+  Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel> ();
+  errorModel->SetList (losses);
+  devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+
+  devices.Get (0)->TraceConnectWithoutContext ("MacTx", MakeBoundCallback (&Ns3TcpLazyTimersTestCase::Record, &m_senderTx));
+  devices.Get (0)->TraceConnectWithoutContext ("MacRx", MakeBoundCallback (&Ns3TcpLazyTimersTestCase::Record, &m_senderRx));
+  devices.Get (1)->TraceConnectWithoutContext ("MacTx", MakeBoundCallback (&Ns3TcpLazyTimersTestCase::Record, &m_receiverTx));
+  devices.Get (1)->TraceConnectWithoutContext ("MacRx", MakeBoundCallback (&Ns3TcpLazyTimersTestCase::Record, &m_receiverRx));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (100001));
+  source.Install (nodes.Get (0)).Start (Seconds (1));
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  m_totalRx = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::TcpSocketBase::LazyTimers", BooleanValue (false));
+}
+
+void
+Ns3TcpLazyTimersTestCase::DoRun (void)
+{
+  Transfer (false);
+  NS_TEST_ASSERT_MSG_EQ (m_totalRx, 100001, "Transfer without lazy timers incomplete");
+  Trace senderTx = m_senderTx;
+  Trace receiverTx = m_receiverTx;
+  std::set<int64_t> retxTimes = GetTimerTimes (m_senderTx, m_senderRx);
+  std::set<int64_t> delAckTimes = GetTimerTimes (m_receiverTx, m_receiverRx);
+  // the SYN sent when the application starts is not a timeout
+  retxTimes.erase (Seconds (1).GetTimeStep ());
+  NS_TEST_ASSERT_MSG_NE (retxTimes.size (), 0, "No retransmission timeout");
+  NS_TEST_ASSERT_MSG_NE (delAckTimes.size (), 0, "No delayed ACK");
+
+  Transfer (true);
+  NS_TEST_ASSERT_MSG_EQ (m_totalRx, 100001, "Transfer with lazy timers incomplete");
+  std::set<int64_t> lazyRetxTimes = GetTimerTimes (m_senderTx, m_senderRx);
+  lazyRetxTimes.erase (Seconds (1).GetTimeStep ());
+  NS_TEST_EXPECT_MSG_EQ ((lazyRetxTimes == retxTimes), true, "The retransmission timeouts moved");
+  NS_TEST_EXPECT_MSG_EQ ((GetTimerTimes (m_receiverTx, m_receiverRx) == delAckTimes), true, "The delayed ACKs moved");
+
+  // the packets sent at the same time may be in another order
+  std::sort (senderTx.begin (), senderTx.end ());
+  std::sort (m_senderTx.begin (), m_senderTx.end ());
+  std::sort (receiverTx.begin (), receiverTx.end ());
+  std::sort (m_receiverTx.begin (), m_receiverTx.end ());
+  NS_TEST_EXPECT_MSG_EQ ((m_senderTx == senderTx), true, "The sender sent other packets");
+  NS_TEST_EXPECT_MSG_EQ ((m_receiverTx == receiverTx), true, "The receiver sent other packets");
+}
+
+class Ns3TcpLazyTimersTestSuite : public TestSuite
+{
+public:
+  Ns3TcpLazyTimersTestSuite ();
+};
+
+Ns3TcpLazyTimersTestSuite::Ns3TcpLazyTimersTestSuite ()
+  : TestSuite ("ns3-tcp-lazy-timers", SYSTEM)
+{
+  AddTestCase (new Ns3TcpLazyTimersTestCase, TestCase::QUICK);
+}
+
+static Ns3TcpLazyTimersTestSuite ns3TcpLazyTimersTestSuite;
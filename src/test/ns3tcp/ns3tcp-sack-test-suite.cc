@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <list>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpSackTest");
+
+// ===========================================================================
+// Tests of the TCP selective acknowledgements: a bulk transfer which
+// loses several segments of one window completes with and without SACK,
+// and no later with SACK.
+// ===========================================================================
+//
+class Ns3TcpSackTestCase : public TestCase
+{
+public:
+  Ns3TcpSackTestCase (std::string tcpModel);
+  virtual ~Ns3TcpSackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  void Transfer (bool sack);
+  void SinkRx (Ptr<const Packet> p, const Address &address);
+
+  std::string m_tcpModel;
+  uint32_t m_totalRx;
+  Time m_lastRx;
+};
+
+Ns3TcpSackTestCase::Ns3TcpSackTestCase (std::string tcpModel)
+  : TestCase ("Check the recovery of several losses with " + tcpModel + " and SACK"),
+    m_tcpModel (tcpModel)
+{
+}
+
+void
+Ns3TcpSackTestCase::SinkRx (Ptr<const Packet> p, const Address &address)
+{
+  m_totalRx += p->GetSize ();
+  m_lastRx = Simulator::Now ();
+}
+
+void
+Ns3TcpSackTestCase::Transfer (bool sack)
+{
+  m_totalRx = 0;
+  m_lastRx = Seconds (0);
+
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue (m_tcpModel));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (sack));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1000));
+
+  //
+  // n0 ===== n1, 10 Mb/s, with four data segments of one window lost
+  // on their way to n1
+  //
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel> ();
+  std::list<uint32_t> drops;
+  drops.push_back (40);
+  drops.push_back (43);
+  drops.push_back (46);
+  drops.push_back (49);
+  errorModel->SetList (drops);
+  devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (500000));
+  source.Install (nodes.Get (0)).Start (Seconds (1));
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpSackTestCase::SinkRx, this));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::TcpNewReno"));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (false));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+}
+
+void
+Ns3TcpSackTestCase::DoRun (void)
+{
+  Transfer (false);
+  NS_TEST_ASSERT_MSG_EQ (m_totalRx, 500000, "Transfer without SACK incomplete");
+  Time duration = m_lastRx - Seconds (1);
+
+  Transfer (true);
+  NS_TEST_ASSERT_MSG_EQ (m_totalRx, 500000, "Transfer with SACK incomplete");
+  Time sackDuration = m_lastRx - Seconds (1);
+  NS_LOG_INFO (m_tcpModel << ": " << duration.GetSeconds () << " s without SACK, "
+                          << sackDuration.GetSeconds () << " s with SACK");
+  NS_TEST_ASSERT_MSG_EQ ((sackDuration <= duration), true, "The transfer is slower with SACK");
+}
+
+class Ns3TcpSackTestSuite : public TestSuite
+{
+public:
+  Ns3TcpSackTestSuite ();
+};
+
+Ns3TcpSackTestSuite::Ns3TcpSackTestSuite ()
+  : TestSuite ("ns3-tcp-sack", SYSTEM)
+{
+  AddTestCase (new Ns3TcpSackTestCase ("ns3::TcpNewReno"), TestCase::QUICK);
+  AddTestCase (new Ns3TcpSackTestCase ("ns3::TcpReno"), TestCase::QUICK);
+  AddTestCase (new Ns3TcpSackTestCase ("ns3::TcpTahoe"), TestCase::QUICK);
+  AddTestCase (new Ns3TcpSackTestCase ("ns3::TcpWestwood"), TestCase::QUICK);
+}
+
+static Ns3TcpSackTestSuite ns3TcpSackTestSuite;
@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpSegmentOffloadTest");
+
+// ===========================================================================
+// Tests of the TCP segment offload: a bulk transfer with super-segments
+// takes about the time it takes with one packet per segment, with far
+// fewer packets on the links.
+// ===========================================================================
+//
+class Ns3TcpSegmentOffloadTestCase : public TestCase
+{
+public:
+  Ns3TcpSegmentOffloadTestCase (bool csma);
+  virtual ~Ns3TcpSegmentOffloadTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  void Transfer (uint32_t offloadSize);
+  void SinkRx (Ptr<const Packet> p, const Address &address);
+  void BottleneckTx (Ptr<const Packet> p);
+
+  bool m_csma;
+  uint32_t m_totalRx;
+  Time m_lastRx;
+  uint32_t m_nBottleneckTx;
+};
+
+Ns3TcpSegmentOffloadTestCase::Ns3TcpSegmentOffloadTestCase (bool csma)
+  : TestCase (csma ? "Check the TCP segment offload over CSMA and point-to-point links"
+              : "Check the TCP segment offload over point-to-point links"),
+    m_csma (csma)
+{
+}
+
+void
+Ns3TcpSegmentOffloadTestCase::SinkRx (Ptr<const Packet> p, const Address &address)
+{
+  m_totalRx += p->GetSize ();
+  m_lastRx = Simulator::Now ();
+}
+
+void
+Ns3TcpSegmentOffloadTestCase::BottleneckTx (Ptr<const Packet> p)
+{
+  m_nBottleneckTx++;
+}
+
+void
+Ns3TcpSegmentOffloadTestCase::Transfer (uint32_t offloadSize)
+{
+  m_totalRx = 0;
+  m_lastRx = Seconds (0);
+  m_nBottleneckTx = 0;
+
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentOffload", UintegerValue (offloadSize));
+  Config::SetDefault ("ns3::DropTailQueue::Mode", StringValue ("QUEUE_MODE_BYTES"));
+  Config::SetDefault ("ns3::DropTailQueue::MaxBytes", UintegerValue (1000000));
+
+  //
+  // n0 ---- n1 ===== n2, with a 10 Mb/s bottleneck between n1 and n2
+  //
+  NodeContainer nodes;
+  nodes.Create (3);
+  NetDeviceContainer access;
+  if (m_csma)
+    {
+      CsmaHelper csma;
+      csma.SetChannelAttribute ("DataRate", StringValue ("1Gbps"));
+      access = csma.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+    }
+  else
+    {
+      PointToPointHelper pointToPoint;
+      pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+      pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+      access = pointToPoint.Install (nodes.Get (0), nodes.Get (1));
+    }
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  NetDeviceContainer bottleneck = pointToPoint.Install (nodes.Get (1), nodes.Get (2));
+  bottleneck.Get (0)->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&Ns3TcpSegmentOffloadTestCase::BottleneckTx, this));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (access);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (bottleneck);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 50000;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (1000000));
+  source.Install (nodes.Get (0)).Start (Seconds (1));
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (2));
+  sinkApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpSegmentOffloadTestCase::SinkRx, this));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::TcpSocketBase::SegmentOffload", UintegerValue (0));
+  Config::SetDefault ("ns3::DropTailQueue::Mode", StringValue ("QUEUE_MODE_PACKETS"));
+  Config::SetDefault ("ns3::DropTailQueue::MaxBytes", UintegerValue (100 * 65535));
+}
+
+void
+Ns3TcpSegmentOffloadTestCase::DoRun (void)
+{
+  Transfer (0);
+  NS_TEST_ASSERT_MSG_EQ (m_totalRx, 1000000, "Transfer without segment offload incomplete");
+  Time duration = m_lastRx - Seconds (1);
+  uint32_t nTx = m_nBottleneckTx;
+
+  Transfer (65000);
+  NS_TEST_ASSERT_MSG_EQ (m_totalRx, 1000000, "Transfer with segment offload incomplete");
+  Time offloadDuration = m_lastRx - Seconds (1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (offloadDuration.GetSeconds (), duration.GetSeconds (), duration.GetSeconds () * 0.05,
+                             "The segment offload changes the transfer time too much");
+  NS_TEST_ASSERT_MSG_LT (m_nBottleneckTx * 10, nTx, "Too many packets with segment offload");
+}
+
+class Ns3TcpSegmentOffloadTestSuite : public TestSuite
+{
+public:
+  Ns3TcpSegmentOffloadTestSuite ();
+};
+
+Ns3TcpSegmentOffloadTestSuite::Ns3TcpSegmentOffloadTestSuite ()
+  : TestSuite ("ns3-tcp-segment-offload", SYSTEM)
+{
+  AddTestCase (new Ns3TcpSegmentOffloadTestCase (false), TestCase::QUICK);
+  AddTestCase (new Ns3TcpSegmentOffloadTestCase (true), TestCase::QUICK);
+}
+
+static Ns3TcpSegmentOffloadTestSuite ns3TcpSegmentOffloadTestSuite;
@@ -438,6 +438,7 @@ YansWifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bo
   NS_ABORT_MSG_IF (phy == 0, "YansWifiPhyHelper::EnablePcapInternal(): Phy layer in WifiNetDevice must be set");
 
   PcapHelper pcapHelper;
+  pcapHelper.SetTraceFilter (m_pcapFilter);
 
   std::string filename;
   if (explicitFilename)
@@ -498,6 +499,7 @@ YansWifiPhyHelper::EnableAsciiInternal (
       // name of the file given the prefix.
       //
       AsciiTraceHelper asciiTraceHelper;
+      asciiTraceHelper.SetTraceFilter (m_asciiFilter);
 
       std::string filename;
       if (explicitFilename)
@@ -480,6 +480,7 @@ WimaxHelper::EnableAsciiInternal (Ptr<OutputStreamWrapper> stream,
       // name of the file given the prefix.
       //
       AsciiTraceHelper asciiTraceHelper;
+      asciiTraceHelper.SetTraceFilter (m_asciiFilter);
       std::string filename;
       if (explicitFilename)
         {
@@ -575,6 +576,7 @@ WimaxHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool exp
 
   Ptr<WimaxPhy> phy = device->GetPhy ();
   PcapHelper pcapHelper;
+  pcapHelper.SetTraceFilter (m_pcapFilter);
   std::string filename;
   if (explicitFilename)
     {
@@ -242,6 +242,83 @@ benchC (uint32_t n)
 }
 
 
+static void
+benchE (uint32_t n)
+{
+  BenchTag<4> qos;
+  BenchTag<5> flow;
+  BenchTag<8> snr;
+  BenchTag<16> bearer;
+
+  Ptr<Packet> p = Create<Packet> (2000);
+  p->AddPacketTag (qos);
+  p->AddPacketTag (flow);
+  p->AddPacketTag (snr);
+  for (uint32_t i = 0; i < n; i++) {
+    p->PeekPacketTag (qos);
+    p->PeekPacketTag (flow);
+    p->PeekPacketTag (snr);
+    p->PeekPacketTag (bearer);
+  }
+}
+
+static void
+benchF (uint32_t n)
+{
+  BenchTag<4> qos;
+  BenchTag<8> snr;
+  BenchTag<16> bearer;
+
+  Ptr<Packet> p = Create<Packet> (2000);
+  for (uint32_t i = 0; i < n; i++) {
+    p->AddPacketTag (qos);
+    p->AddPacketTag (snr);
+    p->AddPacketTag (bearer);
+    p->RemovePacketTag (snr);
+    p->RemovePacketTag (qos);
+    p->RemovePacketTag (bearer);
+  }
+}
+
+static void
+benchG (uint32_t n)
+{
+  BenchHeader<8> udp;
+  BenchTag<4> qos;
+  BenchTag<8> snr;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (2000);
+    p->AddPacketTag (qos);
+    p->AddPacketTag (snr);
+    Ptr<Packet> o = p->Copy ();
+    o->RemovePacketTag (snr);
+    o->PeekPacketTag (qos);
+    o->AddPacketTag (snr);
+    p->AddHeader (udp);
+  }
+}
+
+static void
+benchH (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  BenchTag<4> flow;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (2000);
+    p->AddByteTag (flow);
+    p->AddHeader (udp);
+    p->AddHeader (ipv4);
+    Ptr<Packet> o = p->Copy ();
+    o->RemoveHeader (ipv4);
+    o->AddHeader (ipv4);
+    o->RemoveHeader (ipv4);
+    o->RemoveHeader (udp);
+  }
+}
+
 static void
 runBench (void (*bench) (uint32_t), uint32_t n, char const *name)
 {
@@ -289,6 +366,10 @@ int main (int argc, char *argv[])
   runBench (&benchB, n, "Just add headers");
   runBench (&benchC, n, "Remove by func call");
   runBench (&benchD, n, "Intermixed add/remove headers and tags");
+  runBench (&benchE, n, "Peek three present and one missing packet tag");
+  runBench (&benchF, n, "Add and remove three packet tags");
+  runBench (&benchG, n, "Copy tagged packet, remove/peek/add tags");
+  runBench (&benchH, n, "Byte tag across header add/remove");
 
   return 0;
 }
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a trace written to a stream created by
+// AsciiTraceHelper::CreateBinaryFileStream to the ascii trace format.
+//
+//   ./waf --run "binary-trace-to-ascii --input=trace.btr --output=trace.tr"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include <iostream>
+#include <fstream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "The binary trace to convert", input);
+  cmd.AddValue ("output", "The ascii trace to write (default: standard output)", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "Usage: binary-trace-to-ascii --input=FILE [--output=FILE]" << std::endl;
+      exit (1);
+    }
+
+  // the snapshots are printed from their metadata, which is only
+  // deserialized when printing is enabled.
+  Packet::EnablePrinting ();
+
+  std::ifstream in (input.c_str (), std::ios::in | std::ios::binary);
+  if (!in)
+    {
+      std::cerr << "Unable to open " << input << std::endl;
+      exit (1);
+    }
+  std::ofstream file;
+  std::ostream *out = &std::cout;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file)
+        {
+          std::cerr << "Unable to open " << output << std::endl;
+          exit (1);
+        }
+      out = &file;
+    }
+
+  if (!BinaryTraceWriter::ConvertToAscii (in, *out))
+    {
+      std::cerr << input << " is not a valid binary trace" << std::endl;
+      exit (1);
+    }
+  return 0;
+}